@@ -341,6 +341,13 @@ endif ()
 if (WAMR_BUILD_FAST_JIT EQUAL 1 AND WAMR_BUILD_JIT EQUAL 1
     AND WAMR_BUILD_LAZY_JIT EQUAL 1)
   message ("     Multi-tier JIT enabled")
+elseif (WAMR_BUILD_TIERED_JIT EQUAL 1 AND WAMR_BUILD_JIT EQUAL 1
+        AND WAMR_BUILD_FAST_INTERP EQUAL 1)
+  add_definitions("-DWASM_ENABLE_TIERED_JIT=1")
+  message ("     Profile-driven tier-up from fast interpreter to LLVM JIT enabled")
+elseif (WAMR_BUILD_TIERED_JIT EQUAL 1)
+  message (WARNING "Profile-driven tier-up requires LLVM JIT, "
+                   "please enable WAMR_BUILD_JIT")
 endif ()
 ################## test modes ##################
 if (WAMR_BUILD_SPEC_TEST EQUAL 1)
@@ -519,6 +526,10 @@ if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_PERF_PROFILING EQUAL 1)
 else ()
   message ("     GC performance profiling disabled")
 endif ()
+if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_LAZY_SWEEP EQUAL 1)
+  add_definitions (-DWASM_ENABLE_GC_LAZY_SWEEP=1)
+  message ("     GC lazy sweep enabled")
+endif ()
 if (WAMR_BUILD_STRINGREF EQUAL 1)
   if (NOT DEFINED WAMR_STRINGREF_IMPL_SOURCE)
     message ("       Using WAMR builtin implementation for stringref")
@@ -769,6 +780,10 @@ if (WAMR_BUILD_INSTRUCTION_METERING EQUAL 1)
   message ("     Instruction metering enabled")
   add_definitions (-DWASM_ENABLE_INSTRUCTION_METERING=1)
 endif ()
+if (WAMR_BUILD_EPOCH_INTERRUPTION EQUAL 1)
+  message ("     Epoch interruption enabled")
+  add_definitions (-DWASM_ENABLE_EPOCH_INTERRUPTION=1)
+endif ()
 if (WAMR_BUILD_EXTENDED_CONST_EXPR EQUAL 1)
   message ("     Extended constant expression enabled")
   add_definitions(-DWASM_ENABLE_EXTENDED_CONST_EXPR=1)
@@ -783,6 +798,63 @@ if (WAMR_BUILD_BRANCH_HINTS EQUAL 1)
   message ("     Branch hints enabled")
   add_definitions(-DWASM_ENABLE_BRANCH_HINTS=1)
 endif ()
+if (WAMR_BUILD_INSTANCE_SNAPSHOT EQUAL 1)
+  message ("     Instance snapshot enabled")
+  add_definitions (-DWASM_ENABLE_INSTANCE_SNAPSHOT=1)
+endif ()
+if (WAMR_BUILD_LINEAR_MEMORY_POOL EQUAL 1)
+  message ("     Linear memory pool enabled")
+  add_definitions (-DWASM_ENABLE_LINEAR_MEMORY_POOL=1)
+endif ()
+if (WAMR_BUILD_LLVM_JIT_CACHE EQUAL 1)
+  if (WAMR_BUILD_JIT EQUAL 1)
+    message ("     LLVM JIT code cache enabled")
+    add_definitions (-DWASM_ENABLE_LLVM_JIT_CACHE=1)
+  else ()
+    message (WARNING "LLVM JIT code cache requires LLVM JIT, "
+                     "please enable WAMR_BUILD_JIT")
+  endif ()
+endif ()
+if (WAMR_BUILD_SUPERINSTRUCTIONS EQUAL 1)
+  if ((WAMR_BUILD_FAST_INTERP EQUAL 1) AND (WAMR_BUILD_INTERP EQUAL 1))
+    message ("     Fast interpreter superinstructions enabled")
+    add_definitions (-DWASM_ENABLE_SUPERINSTRUCTIONS=1)
+    if (DEFINED WAMR_BUILD_SUPERINSTRUCTION_SET)
+      message ("     Superinstruction set: ${WAMR_BUILD_SUPERINSTRUCTION_SET}")
+      add_definitions (
+        -DWASM_SUPERINSTRUCTION_SET=${WAMR_BUILD_SUPERINSTRUCTION_SET})
+    endif ()
+  else ()
+    message (WARNING "Superinstructions require fast interpreter, "
+                     "please enable WAMR_BUILD_FAST_INTERP")
+  endif ()
+endif ()
+
+if (WAMR_BUILD_LAZY_FUNC_VALIDATION EQUAL 1)
+  if ((WAMR_BUILD_INTERP EQUAL 1) AND NOT (WAMR_BUILD_JIT EQUAL 1)
+      AND NOT (WAMR_BUILD_FAST_JIT EQUAL 1)
+      AND NOT (WAMR_BUILD_WAMR_COMPILER EQUAL 1)
+      AND NOT (WAMR_BUILD_DEBUG_INTERP EQUAL 1))
+    message ("     Lazy function validation enabled")
+    add_definitions (-DWASM_ENABLE_LAZY_FUNC_VALIDATION=1)
+  else ()
+    message (WARNING "Lazy function validation only works with interpreter, "
+                     "please disable JIT, Fast JIT and debug interpreter")
+  endif ()
+endif ()
+if (WAMR_BUILD_THREAD_POOL EQUAL 1)
+  if (WAMR_BUILD_THREAD_MGR EQUAL 1)
+    message ("     Thread pool enabled")
+    add_definitions (-DWASM_ENABLE_THREAD_POOL=1)
+  else ()
+    message (WARNING "Thread pool requires the thread manager, "
+                     "please enable lib pthread or lib wasi-threads")
+  endif ()
+endif ()
+if (WAMR_BUILD_ALLOC_THREAD_CACHE EQUAL 1)
+  message ("     Thread local allocation cache of app heap enabled")
+  add_definitions (-DWASM_ENABLE_ALLOC_THREAD_CACHE=1)
+endif ()
 
 ########################################
 # Show Phase4 Wasm proposals status.
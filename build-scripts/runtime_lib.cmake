@@ -48,7 +48,13 @@ if (NOT DEFINED WAMR_BUILD_TARGET)
 endif ()
 
 ################ optional according to settings ################
-if (WAMR_BUILD_FAST_JIT EQUAL 1 OR WAMR_BUILD_JIT EQUAL 1)
+if (WAMR_BUILD_TIERED_JIT EQUAL 1 AND WAMR_BUILD_JIT EQUAL 1
+    AND NOT WAMR_BUILD_FAST_JIT EQUAL 1)
+    # Enable fast interpreter as the first tier of the tier-up to LLVM JIT
+    set (WAMR_BUILD_INTERP 1)
+    set (WAMR_BUILD_FAST_INTERP 1)
+    set (WAMR_BUILD_LAZY_JIT 1)
+elseif (WAMR_BUILD_FAST_JIT EQUAL 1 OR WAMR_BUILD_JIT EQUAL 1)
     # Enable classic interpreter if Fast JIT or LLVM JIT is enabled
     set (WAMR_BUILD_INTERP 1)
     set (WAMR_BUILD_FAST_INTERP 0)
@@ -156,7 +162,8 @@ if (WAMR_BUILD_LIB_RATS EQUAL 1)
     include (${IWASM_DIR}/libraries/lib-rats/lib_rats.cmake)
 endif ()
 
-if (WAMR_BUILD_WASM_CACHE EQUAL 1)
+if (WAMR_BUILD_WASM_CACHE EQUAL 1
+    OR (WAMR_BUILD_LLVM_JIT_CACHE EQUAL 1 AND WAMR_BUILD_JIT EQUAL 1))
     include (${WAMR_ROOT_DIR}/build-scripts/involve_boringssl.cmake)
 endif ()
 
@@ -63,10 +63,10 @@ endfunction()
 # and tests/wamr-test-suites/test_wamr.sh
 
 if(WAMR_BUILD_EXCE_HANDLING EQUAL 1)
-  check_aot_mode_error("Unsupported build configuration: EXCE_HANDLING + AOT")
-  check_fast_interp_error("Unsupported build configuration: EXCE_HANDLING + FAST_INTERP")
   check_fast_jit_error("Unsupported build configuration: EXCE_HANDLING + FAST_JIT")
-  check_llvm_jit_error("Unsupported build configuration: EXCE_HANDLING + JIT")
+  if(WAMR_BUILD_GC EQUAL 1)
+    check_fast_interp_error("Unsupported build configuration: EXCE_HANDLING + GC + FAST_INTERP")
+  endif()
 endif()
 
 if(WAMR_BUILD_GC EQUAL 1)
@@ -99,3 +99,25 @@ if(WAMR_BUILD_SIMD EQUAL 1)
   check_classic_interp_error("Unsupported build configuration: SIMD + CLASSIC_INTERP")
   check_fast_jit_error("Unsupported build configuration: SIMD + FAST_JIT")
 endif()
+
+if(WAMR_BUILD_TIERED_JIT EQUAL 1)
+  check_fast_jit_error("Unsupported build configuration: TIERED_JIT + FAST_JIT")
+  # The fast interpreter frames and the LLVM JIT frames can't be walked
+  # together, and the GC references and exceptions can't be passed
+  # between them
+  if(WAMR_BUILD_JIT EQUAL 1)
+    foreach(feature GC EXCE_HANDLING DUMP_CALL_STACK PERF_PROFILING AOT_STACK_FRAME)
+      if(WAMR_BUILD_${feature} EQUAL 1)
+        message(FATAL_ERROR "Unsupported build configuration: TIERED_JIT + ${feature}")
+      endif()
+    endforeach()
+  endif()
+endif()
+
+if(WAMR_BUILD_INSTRUCTION_METERING EQUAL 1)
+  check_fast_jit_error("Unsupported build configuration: INSTRUCTION_METERING + FAST_JIT")
+endif()
+
+if(WAMR_BUILD_EPOCH_INTERRUPTION EQUAL 1)
+  check_fast_jit_error("Unsupported build configuration: EPOCH_INTERRUPTION + FAST_JIT")
+endif()
@@ -84,7 +84,7 @@
 #endif
 
 #define AOT_MAGIC_NUMBER 0x746f6100
-#define AOT_CURRENT_VERSION 6
+#define AOT_CURRENT_VERSION 7
 
 #ifndef WASM_ENABLE_JIT
 #define WASM_ENABLE_JIT 0
@@ -228,6 +228,19 @@
 #define WASM_ENABLE_THREAD_MGR 0
 #endif
 
+/* Run the threads spawned by lib-pthread and lib wasi-threads in a pool
+   of reusable native threads, requires the thread manager */
+#ifndef WASM_ENABLE_THREAD_POOL
+#define WASM_ENABLE_THREAD_POOL 0
+#endif
+
+/* Cache the small objects freed by each thread to the app heap in the
+   shared memory, so that the threads don't lock the heap for each
+   allocation */
+#ifndef WASM_ENABLE_ALLOC_THREAD_CACHE
+#define WASM_ENABLE_ALLOC_THREAD_CACHE 0
+#endif
+
 /* Source debugging */
 #ifndef WASM_ENABLE_DEBUG_INTERP
 #define WASM_ENABLE_DEBUG_INTERP 0
@@ -294,6 +307,27 @@
 #define WASM_DEBUG_PREPROCESSOR 0
 #endif
 
+/* Enable the superinstructions of fast interpreter or not, an i32
+   comparison followed by br_if is fused into one instruction */
+#ifndef WASM_ENABLE_SUPERINSTRUCTIONS
+#define WASM_ENABLE_SUPERINSTRUCTIONS 0
+#endif
+
+/* The set of i32 comparisons fused with br_if when superinstructions
+   are enabled, bit n stands for the opcode WASM_OP_I32_EQZ + n, e.g.
+   0x1 for i32.eqz and 0x8 for i32.lt_s, it can be narrowed down to the
+   hot pairs reported by the opcode counter to keep the handler table
+   and the interpreter loop small */
+#ifndef WASM_SUPERINSTRUCTION_SET
+#define WASM_SUPERINSTRUCTION_SET 0x7FF
+#endif
+
+/* Validate and prepare the bytecode of a wasm function on its first call
+   rather than at load time, only for the interpreter */
+#ifndef WASM_ENABLE_LAZY_FUNC_VALIDATION
+#define WASM_ENABLE_LAZY_FUNC_VALIDATION 0
+#endif
+
 /* Enable opcode counter or not */
 #ifndef WASM_ENABLE_OPCODE_COUNTER
 #define WASM_ENABLE_OPCODE_COUNTER 0
@@ -337,6 +371,12 @@ unless used elsewhere */
 #define WASM_ENABLE_GC_PERF_PROFILING 0
 #endif
 
+/* Sweep the GC heap step by step when allocating memory from it rather
+   than sweeping the whole heap in each GC */
+#ifndef WASM_ENABLE_GC_LAZY_SWEEP
+#define WASM_ENABLE_GC_LAZY_SWEEP 0
+#endif
+
 /* Memory profiling */
 #ifndef WASM_ENABLE_MEMORY_PROFILING
 #define WASM_ENABLE_MEMORY_PROFILING 0
@@ -732,8 +772,44 @@ unless used elsewhere */
 #define WASM_ENABLE_INSTRUCTION_METERING 0
 #endif
 
+#ifndef WASM_ENABLE_EPOCH_INTERRUPTION
+#define WASM_ENABLE_EPOCH_INTERRUPTION 0
+#endif
+
 #ifndef WASM_ENABLE_EXTENDED_CONST_EXPR
 #define WASM_ENABLE_EXTENDED_CONST_EXPR 0
 #endif
 
+/* Support creating module instances from the snapshot of an initialized
+   instance, the linear memory is mapped copy-on-write if possible */
+#ifndef WASM_ENABLE_INSTANCE_SNAPSHOT
+#define WASM_ENABLE_INSTANCE_SNAPSHOT 0
+#endif
+
+/* Support reserving a pool of linear memory slots at runtime initialization
+   which are reused by module instances instead of mapping and unmapping
+   the linear memory for each instance */
+#ifndef WASM_ENABLE_LINEAR_MEMORY_POOL
+#define WASM_ENABLE_LINEAR_MEMORY_POOL 0
+#endif
+
+/* Profile-driven tier-up for the Multi-Tier JIT running mode: functions
+   start in the fast interpreter, and are compiled with LLVM JIT by the
+   backend threads when the count of their calls and loop back-edges
+   reaches the threshold below */
+#ifndef WASM_ENABLE_TIERED_JIT
+#define WASM_ENABLE_TIERED_JIT 0
+#endif
+
+/* The hotness count to compile a function with LLVM JIT */
+#ifndef WASM_TIERED_JIT_LLVM_JIT_THRESHOLD
+#define WASM_TIERED_JIT_LLVM_JIT_THRESHOLD 10000
+#endif
+
+/* Persistent LLVM JIT code cache: the wasm modules are compiled into AOT
+   files kept in a directory, and loaded from there the next time */
+#ifndef WASM_ENABLE_LLVM_JIT_CACHE
+#define WASM_ENABLE_LLVM_JIT_CACHE 0
+#endif
+
 #endif /* end of _CONFIG_H_ */
@@ -514,6 +514,51 @@ check_feature_flags(char *error_buf, uint32 error_buf_size,
     }
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING == 0
+    if (feature_flags & WASM_FEATURE_EXCEPTION_HANDLING) {
+        set_error_buf(error_buf, error_buf_size,
+                      "exception handling is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || defined(BH_PLATFORM_WINDOWS)
+    /* The traps are unwound by touching the exception check guard page,
+       the signal handler then jumps back to the entry of wasm function
+       call */
+    if (feature_flags & WASM_FEATURE_TRAP_UNWIND) {
+        set_error_buf(error_buf, error_buf_size,
+                      "trap unwinding is not supported in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_INSTRUCTION_METERING == 0
+    if (feature_flags & WASM_FEATURE_INSTRUCTION_METERING) {
+        set_error_buf(error_buf, error_buf_size,
+                      "instruction metering is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION == 0
+    if (feature_flags & WASM_FEATURE_EPOCH_INTERRUPTION) {
+        set_error_buf(error_buf, error_buf_size,
+                      "epoch interruption is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_GC == 0
+    /* The gc_tlab of exec_env is only kept with GC, see the static
+       asserts of its place in aot_runtime.c */
+    if (feature_flags & WASM_FEATURE_GC_TLAB) {
+        set_error_buf(error_buf, error_buf_size,
+                      "gc tlab is not enabled in this build");
+        return false;
+    }
+#endif
+
     return true;
 }
 
@@ -3016,15 +3061,11 @@ load_exports(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
                     return false;
                 }
                 break;
-#if WASM_ENABLE_TAGS != 0
-                /* TODO
-                case EXPORT_KIND_TAG:
-                    if (index >= module->import_tag_count + module->tag_count) {
-                        set_error_buf(error_buf, error_buf_size, "unknown tag");
-                        return false;
-                    }
-                    break;
-                */
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case EXPORT_KIND_TAG:
+                /* The tags aren't kept by AOT module, the exceptions are
+                   identified by the tag indexes resolved by the compiler */
+                break;
 #endif
             default:
                 set_error_buf(error_buf, error_buf_size, "invalid export kind");
@@ -4424,7 +4465,9 @@ aot_compatible_version(uint32 version)
      * refer to "AoT-compiled module compatibility among WAMR versions" in
      * ./doc/build_wasm_app.md
      */
-    return version == AOT_CURRENT_VERSION;
+    /* The version 6 files don't use the exec_env and module instance
+       fields added in version 7, e.g. with WASM_FEATURE_GC_TLAB */
+    return version == AOT_CURRENT_VERSION || version == 6;
 }
 
 static bool
@@ -4716,6 +4759,11 @@ aot_unload(AOTModule *module)
 #endif
 #endif
 
+#ifdef OS_ENABLE_FILE_MMAP
+    if (module->mapped_file_buf)
+        os_munmap(module->mapped_file_buf, (size_t)module->mapped_file_size);
+#endif
+
     wasm_runtime_free(module);
 }
 
@@ -192,6 +192,29 @@ typedef struct {
 #define REG_SHARED_HEAP_SYM()
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+#define REG_EXCE_HANDLING_SYM()             \
+    REG_SYM(wasm_runtime_throw_exception),  \
+    REG_SYM(wasm_runtime_get_exception_tag),\
+    REG_SYM(wasm_runtime_catch_exception),
+#else
+#define REG_EXCE_HANDLING_SYM()
+#endif
+
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+#define REG_INSTRUCTION_METERING_SYM()              \
+    REG_SYM(wasm_runtime_check_instruction_limit),
+#else
+#define REG_INSTRUCTION_METERING_SYM()
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+#define REG_EPOCH_INTERRUPTION_SYM()                \
+    REG_SYM(wasm_runtime_check_epoch_deadline),
+#else
+#define REG_EPOCH_INTERRUPTION_SYM()
+#endif
+
 #define REG_COMMON_SYMBOLS                \
     REG_SYM(aot_set_exception_with_id),   \
     REG_SYM(aot_invoke_native),           \
@@ -226,6 +249,9 @@ typedef struct {
     REG_GC_SYM()                          \
     REG_STRINGREF_SYM()                   \
     REG_SHARED_HEAP_SYM()                 \
+    REG_EXCE_HANDLING_SYM()               \
+    REG_INSTRUCTION_METERING_SYM()        \
+    REG_EPOCH_INTERRUPTION_SYM()          \
 
 #define CHECK_RELOC_OFFSET(data_size) do {              \
     if (!check_reloc_offset(target_section_size,        \
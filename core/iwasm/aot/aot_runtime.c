@@ -19,7 +19,8 @@
 
 /*
  * Note: These offsets need to match the values hardcoded in
- * AoT compilation code: aot_create_func_context, check_suspend_flags.
+ * AoT compilation code: aot_create_func_context, check_suspend_flags,
+ * aot_compile_op_struct_new, aot_compile_instruction_metering.
  */
 
 bh_static_assert(offsetof(WASMExecEnv, cur_frame) == 1 * sizeof(uintptr_t));
@@ -41,6 +42,13 @@ bh_static_assert(offsetof(WASMExecEnv, wasm_stack.top)
                  == 11 * sizeof(uintptr_t));
 bh_static_assert(offsetof(WASMExecEnv, wasm_stack.bottom)
                  == 12 * sizeof(uintptr_t));
+#if WASM_ENABLE_GC != 0
+bh_static_assert(offsetof(WASMExecEnv, gc_tlab.top) == 13 * sizeof(uintptr_t));
+bh_static_assert(offsetof(WASMExecEnv, gc_tlab.limit)
+                 == 14 * sizeof(uintptr_t));
+#endif
+bh_static_assert(offsetof(WASMExecEnv, instructions_to_execute)
+                 == 17 * sizeof(uintptr_t));
 
 bh_static_assert(offsetof(AOTModuleInstance, memories) == 1 * sizeof(uint64));
 bh_static_assert(offsetof(AOTModuleInstance, func_ptrs) == 5 * sizeof(uint64));
@@ -62,6 +70,8 @@ bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap_base_addr_adj)
 bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap_start_off) == 16);
 bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap_end_off) == 24);
 bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap) == 32);
+bh_static_assert(offsetof(AOTModuleInstanceExtra, epoch_ptr) == 40);
+bh_static_assert(offsetof(AOTModuleInstanceExtra, epoch_deadline) == 48);
 
 bh_static_assert(offsetof(WASMSharedHeap, next) == 0);
 bh_static_assert(offsetof(WASMSharedHeap, chain_next) == 8);
@@ -135,6 +145,30 @@ runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
     return mem;
 }
 
+/* Allocate the module instance structure, from an instance slot if the
+   instance slot pool is enabled and has a free slot large enough */
+static void *
+instance_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    void *mem;
+
+    if ((mem = wasm_runtime_instance_slot_malloc(size)))
+        return mem;
+#endif
+    return runtime_malloc(size, error_buf, error_buf_size);
+}
+
+static void
+instance_free(void *module_inst)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    if (wasm_runtime_instance_slot_free(module_inst))
+        return;
+#endif
+    wasm_runtime_free(module_inst);
+}
+
 #if WASM_ENABLE_AOT_STACK_FRAME != 0
 static bool
 is_tiny_frame(WASMExecEnv *exec_env)
@@ -1220,8 +1254,8 @@ aot_get_memory_with_idx(AOTModuleInstance *module_inst, uint32 mem_idx)
 static bool
 memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
                      AOTModule *module, uint32 heap_size,
-                     uint32 max_memory_pages, char *error_buf,
-                     uint32 error_buf_size)
+                     uint32 max_memory_pages, bool init_data_segs,
+                     char *error_buf, uint32 error_buf_size)
 {
     uint32 global_index, global_data_offset, length;
     uint32 i, memory_count = module->memory_count;
@@ -1263,9 +1297,9 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
         if (data_seg->is_passive)
             continue;
 #endif
-        if (parent != NULL)
+        if (parent != NULL || !init_data_segs)
             /* Ignore setting memory init data if the memory has been
-               initialized */
+               initialized or will be restored from a snapshot */
             continue;
 
         offset_flag = data_seg->offset.init_expr_type;
@@ -1920,6 +1954,11 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     uint32 stack_size = args->v1.default_stack_size;
     uint32 heap_size = args->v1.host_managed_heap_size;
     uint32 max_memory_pages = args->v1.max_memory_pages;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    const bool init_data_segs = !args->restore_from_snapshot;
+#else
+    const bool init_data_segs = true;
+#endif
 
     /* Align and validate heap size */
     heap_size = align_uint(heap_size, 8);
@@ -1954,7 +1993,7 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
 
     /* Allocate module instance, global data, table data and heap data */
     if (!(module_inst =
-              runtime_malloc(total_size, error_buf, error_buf_size))) {
+              instance_malloc(total_size, error_buf, error_buf_size))) {
         return NULL;
     }
 
@@ -1967,7 +2006,7 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
         (WASMModuleInstanceCommon *)module_inst, args->custom_data);
 #if WASM_ENABLE_THREAD_MGR != 0
     if (os_mutex_init(&extra->common.exception_lock) != 0) {
-        wasm_runtime_free(module_inst);
+        instance_free(module_inst);
         return NULL;
     }
 #endif
@@ -2074,7 +2113,8 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
 
     /* Initialize memory space */
     if (!memories_instantiate(module_inst, parent, module, heap_size,
-                              max_memory_pages, error_buf, error_buf_size))
+                              max_memory_pages, init_data_segs, error_buf,
+                              error_buf_size))
         goto fail;
 
     /* Initialize function pointers */
@@ -2141,6 +2181,12 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     /* After shared heap chain, will early stop if shared heap is NULL */
     extra->shared_heap = NULL;
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* No epoch deadline by default */
+    extra->epoch_ptr = wasm_runtime_get_epoch_addr();
+    extra->epoch_deadline = UINT64_MAX;
+#endif
+
 #if WASM_ENABLE_PERF_PROFILING != 0
     total_size = sizeof(AOTFuncPerfProfInfo)
                  * ((uint64)module->import_func_count + module->func_count);
@@ -2306,7 +2352,13 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     }
 #endif
 
-    if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
+    if (
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        /* The snapshot already contains the state after the start and
+           initialize functions were executed */
+        !args->restore_from_snapshot &&
+#endif
+        !execute_post_instantiate_functions(module_inst, is_sub_inst,
                                             exec_env_main)) {
         set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
         goto fail;
@@ -2440,8 +2492,12 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
 #if WASM_ENABLE_REF_TYPES != 0
     bh_bitmap_delete(common->elem_dropped);
 #endif
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    wasm_runtime_destroy_exception_values(
+        (WASMModuleInstanceCommon *)module_inst);
+#endif
 
-    wasm_runtime_free(module_inst);
+    instance_free(module_inst);
 }
 
 AOTFunctionInstance *
@@ -2572,7 +2628,9 @@ invoke_native_internal(WASMExecEnv *exec_env, void *func_ptr,
             (AOTModuleInstance *)exec_env->module_inst;
         void (*invoke_native)(void *func_ptr, void *exec_env, uint32 *argv,
                               uint32 *argv_ret) = func_type->quick_aot_entry;
+        exec_env->attachment = attachment;
         invoke_native(func_ptr, exec_env, argv, argv_ret);
+        exec_env->attachment = NULL;
         return !aot_copy_exception(module_inst, NULL);
     }
 #endif
@@ -3055,7 +3113,18 @@ aot_module_malloc_internal(AOTModuleInstance *module_inst,
     }
 
     if (memory_inst->heap_handle) {
-        addr = mem_allocator_malloc(memory_inst->heap_handle, (uint32)size);
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+        void *alloc_cache;
+
+        /* Only the threads sharing the memory contend for the heap */
+        if (exec_env && memory_inst->is_shared_memory
+            && (alloc_cache = wasm_exec_env_get_alloc_cache(
+                    exec_env, memory_inst->heap_handle)))
+            addr = mem_allocator_cache_malloc(alloc_cache, (uint32)size);
+        else
+#endif
+            addr =
+                mem_allocator_malloc(memory_inst->heap_handle, (uint32)size);
     }
     else if (module->malloc_func_index != (uint32)-1
              && module->free_func_index != (uint32)-1) {
@@ -3167,7 +3236,16 @@ aot_module_free_internal(AOTModuleInstance *module_inst, WASMExecEnv *exec_env,
 
         if (memory_inst->heap_handle && memory_inst->heap_data < addr
             && addr < memory_inst->heap_data_end) {
-            mem_allocator_free(memory_inst->heap_handle, addr);
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+            void *alloc_cache;
+
+            if (exec_env && memory_inst->is_shared_memory
+                && (alloc_cache = wasm_exec_env_get_alloc_cache(
+                        exec_env, memory_inst->heap_handle)))
+                mem_allocator_cache_free(alloc_cache, addr);
+            else
+#endif
+                mem_allocator_free(memory_inst->heap_handle, addr);
         }
         else if (module->malloc_func_index != (uint32)-1
                  && module->free_func_index != (uint32)-1
@@ -3315,9 +3393,16 @@ aot_invoke_native(WASMExecEnv *exec_env, uint32 func_idx, uint32 argc,
         }
 #endif
 #endif /* WASM_ENABLE_MULTI_MODULE != 0 */
-        ret =
-            wasm_runtime_invoke_native(exec_env, func_ptr, func_type, signature,
-                                       attachment, argv, argc, argv);
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+        if (import_func->quick_native_entry)
+            ret = wasm_runtime_invoke_quick_native(
+                exec_env, import_func->quick_native_entry, func_ptr,
+                attachment, argv, argv);
+        else
+#endif
+            ret = wasm_runtime_invoke_native(exec_env, func_ptr, func_type,
+                                             signature, attachment, argv, argc,
+                                             argv);
 #if WASM_ENABLE_MULTI_MODULE != 0 && WASM_ENABLE_AOT_STACK_FRAME != 0
         /* Free all frames allocated, note that some frames
            may be allocated in AOT code and haven't been
@@ -3412,6 +3497,12 @@ aot_call_indirect(WASMExecEnv *exec_env, uint32 tbl_idx, uint32 table_elem_idx,
         import_func = aot_module->import_funcs + func_idx;
         signature = import_func->signature;
         attachment = import_func->attachment;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+        /* The signature has no pointer/string params to convert, so
+           invoke_native_internal can take the quick entry of func_type */
+        if (import_func->quick_native_entry)
+            signature = NULL;
+#endif
         if (import_func->call_conv_raw) {
             ret = wasm_runtime_invoke_native_raw(exec_env, func_ptr, func_type,
                                                  signature, attachment, argv,
@@ -5497,6 +5588,13 @@ aot_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
     if (!ret)
         return ret;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    ret = wasm_runtime_exception_traverse_gc_rootset(
+        (WASMModuleInstanceCommon *)module_inst, heap);
+    if (!ret)
+        return ret;
+#endif
+
     return true;
 }
 #endif /* end of WASM_ENABLE_GC != 0 */
@@ -5709,6 +5807,11 @@ aot_resolve_import_func(AOTModule *module, AOTImportFunc *import_func)
             }
         }
     }
+#endif
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    if (import_func->func_ptr_linked && !import_func->call_conv_raw)
+        import_func->quick_native_entry = wasm_native_lookup_quick_native_entry(
+            import_func->func_type, import_func->signature);
 #endif
     return import_func->func_ptr_linked != NULL;
 }
@@ -35,6 +35,18 @@ extern "C" {
  * and not at the beginning of each function call */
 #define WASM_FEATURE_FRAME_PER_FUNCTION (1 << 12)
 #define WASM_FEATURE_FRAME_NO_FUNC_IDX (1 << 13)
+/* The traps unwind to the entry of wasm function call, and the exception
+ * isn't checked after calls */
+#define WASM_FEATURE_TRAP_UNWIND (1 << 14)
+/* The instructions are charged from the instruction count limit of
+ * exec_env at the end of each basic block */
+#define WASM_FEATURE_INSTRUCTION_METERING (1 << 15)
+/* The global epoch is compared with the epoch deadline of the module
+ * instance at the loop back-edges */
+#define WASM_FEATURE_EPOCH_INTERRUPTION (1 << 16)
+/* The small gc objects are allocated inline from the TLAB of exec_env,
+ * whose top and limit are at the pointer slots 13 and 14 of exec_env */
+#define WASM_FEATURE_GC_TLAB (1 << 17)
 
 typedef enum AOTSectionType {
     AOT_SECTION_TYPE_TARGET_INFO = 0,
@@ -127,6 +139,12 @@ typedef struct AOTModuleInstanceExtra {
     MemBound shared_heap_start_off;
     MemBound shared_heap_end_off;
     DefPointer(WASMSharedHeap *, shared_heap);
+    /*
+     * The global epoch counter and the epoch deadline of the instance,
+     * they are compared at the loop back-edges of the aot code
+     */
+    DefPointer(const uint64 *, epoch_ptr);
+    uint64 epoch_deadline;
 
     WASMModuleInstanceExtraCommon common;
 
@@ -349,6 +367,19 @@ typedef struct AOTModule {
     /* Whether the underlying wasm binary buffer can be freed */
     bool is_binary_freeable;
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    /* Whether the module is loaded from the LLVM JIT cache, it then
+       reports Mode_LLVM_JIT as its running mode */
+    bool is_llvm_jit_cache;
+#endif
+
+#ifdef OS_ENABLE_FILE_MMAP
+    /* The file mapped by wasm_runtime_load_from_file, which the module
+       refers to and which is unmapped when the module is unloaded */
+    uint8 *mapped_file_buf;
+    uint64 mapped_file_size;
+#endif
+
     /* `.data` sections merged into one mmaped to reduce the tlb cache miss */
     uint8 *merged_data_sections;
     uint32 merged_data_sections_size;
@@ -25,6 +25,16 @@ wasm_rtt_type_new(WASMType *defined_type, uint32 defined_type_idx,
 
     bh_assert(defined_type_idx < rtt_type_count);
 
+    /* The rtt type is created only once and never changed, look it up
+       without locking since it is required by each struct.new and
+       array.new of AOT/JIT code */
+    if ((rtt_type = rtt_types[defined_type_idx])) {
+#ifdef os_atomic_thread_fence
+        os_atomic_thread_fence(os_memory_order_acquire);
+#endif
+        return rtt_type;
+    }
+
     os_mutex_lock(rtt_type_lock);
 
     if (rtt_types[defined_type_idx]) {
@@ -38,6 +48,10 @@ wasm_rtt_type_new(WASMType *defined_type, uint32 defined_type_idx,
         rtt_type->defined_type = defined_type;
         rtt_type->root_type = defined_type->root_type;
 
+#ifdef os_atomic_thread_fence
+        /* Publish the rtt type after it is initialized */
+        os_atomic_thread_fence(os_memory_order_release);
+#endif
         rtt_types[defined_type_idx] = rtt_type;
     }
 
@@ -46,12 +60,25 @@ wasm_rtt_type_new(WASMType *defined_type, uint32 defined_type_idx,
 }
 
 static void *
-gc_obj_malloc(void *heap_handle, uint64 size)
+gc_obj_malloc_internal(void *heap_handle, WASMExecEnv *exec_env, uint64 size)
 {
     void *mem;
 
-    if (size >= UINT32_MAX
-        || !(mem = mem_allocator_malloc_with_gc(heap_handle, (uint32)size))) {
+    if (size >= UINT32_MAX) {
+        LOG_WARNING("warning: failed to allocate memory for gc object");
+        return NULL;
+    }
+
+    /* Allocate the object from the TLAB of the exec_env if it is
+       provided, which doesn't require locking the heap */
+    if (exec_env)
+        mem = mem_allocator_malloc_with_gc_tlab(heap_handle,
+                                                &exec_env->gc_tlab,
+                                                (uint32)size);
+    else
+        mem = mem_allocator_malloc_with_gc(heap_handle, (uint32)size);
+
+    if (!mem) {
         LOG_WARNING("warning: failed to allocate memory for gc object");
         return NULL;
     }
@@ -60,6 +87,9 @@ gc_obj_malloc(void *heap_handle, uint64 size)
     return mem;
 }
 
+#define gc_obj_malloc(heap_handle, size) \
+    gc_obj_malloc_internal(heap_handle, NULL, size)
+
 static void *
 get_gc_heap_handle(WASMExecEnv *exec_env)
 {
@@ -82,8 +112,9 @@ get_gc_heap_handle(WASMExecEnv *exec_env)
     return gc_heap_handle;
 }
 
-WASMStructObjectRef
-wasm_struct_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type)
+static WASMStructObjectRef
+struct_obj_new(void *heap_handle, WASMExecEnv *exec_env,
+               WASMRttTypeRef rtt_type)
 {
     WASMStructObjectRef struct_obj;
     WASMStructType *struct_type;
@@ -91,7 +122,8 @@ wasm_struct_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type)
     bh_assert(rtt_type->type_flag == WASM_TYPE_STRUCT);
 
     struct_type = (WASMStructType *)rtt_type->defined_type;
-    if (!(struct_obj = gc_obj_malloc(heap_handle, struct_type->total_size))) {
+    if (!(struct_obj = gc_obj_malloc_internal(heap_handle, exec_env,
+                                              struct_type->total_size))) {
         return NULL;
     }
 
@@ -100,11 +132,17 @@ wasm_struct_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type)
     return struct_obj;
 }
 
+WASMStructObjectRef
+wasm_struct_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type)
+{
+    return struct_obj_new(heap_handle, NULL, rtt_type);
+}
+
 WASMStructObjectRef
 wasm_struct_obj_new(WASMExecEnv *exec_env, WASMRttTypeRef rtt_type)
 {
     void *heap_handle = get_gc_heap_handle(exec_env);
-    return wasm_struct_obj_new_internal(heap_handle, rtt_type);
+    return struct_obj_new(heap_handle, exec_env, rtt_type);
 }
 
 void
@@ -199,9 +237,9 @@ wasm_struct_obj_get_field_count(const WASMStructObjectRef struct_obj)
     return struct_type->field_count;
 }
 
-WASMArrayObjectRef
-wasm_array_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type,
-                            uint32 length, WASMValue *init_value)
+static WASMArrayObjectRef
+array_obj_new(void *heap_handle, WASMExecEnv *exec_env,
+              WASMRttTypeRef rtt_type, uint32 length, WASMValue *init_value)
 {
     WASMArrayObjectRef array_obj;
     WASMArrayType *array_type;
@@ -229,7 +267,8 @@ wasm_array_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type,
 
     total_size =
         offsetof(WASMArrayObject, elem_data) + (uint64)elem_size * length;
-    if (!(array_obj = gc_obj_malloc(heap_handle, total_size))) {
+    if (!(array_obj =
+              gc_obj_malloc_internal(heap_handle, exec_env, total_size))) {
         return NULL;
     }
 
@@ -263,13 +302,19 @@ wasm_array_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type,
     return array_obj;
 }
 
+WASMArrayObjectRef
+wasm_array_obj_new_internal(void *heap_handle, WASMRttTypeRef rtt_type,
+                            uint32 length, WASMValue *init_value)
+{
+    return array_obj_new(heap_handle, NULL, rtt_type, length, init_value);
+}
+
 WASMArrayObjectRef
 wasm_array_obj_new(WASMExecEnv *exec_env, WASMRttTypeRef rtt_type,
                    uint32 length, WASMValue *init_value)
 {
     void *heap_handle = get_gc_heap_handle(exec_env);
-    return wasm_array_obj_new_internal(heap_handle, rtt_type, length,
-                                       init_value);
+    return array_obj_new(heap_handle, exec_env, rtt_type, length, init_value);
 }
 
 void
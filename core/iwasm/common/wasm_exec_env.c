@@ -5,7 +5,7 @@
 
 #include "wasm_exec_env.h"
 #include "wasm_runtime_common.h"
-#if WASM_ENABLE_GC != 0
+#if WASM_ENABLE_GC != 0 || WASM_ENABLE_ALLOC_THREAD_CACHE != 0
 #include "mem_alloc.h"
 #endif
 #if WASM_ENABLE_INTERP != 0
@@ -27,16 +27,12 @@
 #endif
 
 WASMExecEnv *
-wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
-                              uint32 stack_size)
+wasm_exec_env_create_in_buf_internal(
+    void *buf, struct WASMModuleInstanceCommon *module_inst, uint32 stack_size)
 {
     uint64 total_size =
         offsetof(WASMExecEnv, wasm_stack_u.bottom) + (uint64)stack_size;
-    WASMExecEnv *exec_env;
-
-    if (total_size >= UINT32_MAX
-        || !(exec_env = wasm_runtime_malloc((uint32)total_size)))
-        return NULL;
+    WASMExecEnv *exec_env = (WASMExecEnv *)buf;
 
     memset(exec_env, 0, (uint32)total_size);
 
@@ -85,9 +81,7 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
     wasm_runtime_dump_exec_env_mem_consumption(exec_env);
 #endif
 
-#if WASM_ENABLE_INSTRUCTION_METERING != 0
     exec_env->instructions_to_execute = -1;
-#endif
 
     return exec_env;
 
@@ -110,12 +104,32 @@ fail2:
     wasm_runtime_free(exec_env->argv_buf);
 fail1:
 #endif
-    wasm_runtime_free(exec_env);
     return NULL;
 }
 
+WASMExecEnv *
+wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
+                              uint32 stack_size)
+{
+    uint64 total_size =
+        offsetof(WASMExecEnv, wasm_stack_u.bottom) + (uint64)stack_size;
+    WASMExecEnv *exec_env;
+    void *buf;
+
+    if (total_size >= UINT32_MAX
+        || !(buf = wasm_runtime_malloc((uint32)total_size)))
+        return NULL;
+
+    if (!(exec_env = wasm_exec_env_create_in_buf_internal(buf, module_inst,
+                                                          stack_size))) {
+        wasm_runtime_free(buf);
+        return NULL;
+    }
+    return exec_env;
+}
+
 void
-wasm_exec_env_destroy_internal(WASMExecEnv *exec_env)
+wasm_exec_env_deinit_internal(WASMExecEnv *exec_env)
 {
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     os_munmap(exec_env->exce_check_guard_page, os_getpagesize());
@@ -130,6 +144,24 @@ wasm_exec_env_destroy_internal(WASMExecEnv *exec_env)
 #if WASM_ENABLE_AOT != 0
     wasm_runtime_free(exec_env->argv_buf);
 #endif
+#if WASM_ENABLE_GC != 0
+    /* The rest of the TLAB is reclaimed by the next GC */
+    mem_allocator_retire_gc_tlab(&exec_env->gc_tlab);
+#endif
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    if (exec_env->alloc_cache) {
+        /* The heap may have been destroyed before the exec_env, which
+           has detached the cache then */
+        mem_allocator_cache_destroy(exec_env->alloc_cache);
+        wasm_runtime_free(exec_env->alloc_cache);
+    }
+#endif
+}
+
+void
+wasm_exec_env_destroy_internal(WASMExecEnv *exec_env)
+{
+    wasm_exec_env_deinit_internal(exec_env);
     wasm_runtime_free(exec_env);
 }
 
@@ -231,6 +263,12 @@ wasm_exec_env_set_module_inst(WASMExecEnv *exec_env,
 {
 #if WASM_ENABLE_THREAD_MGR != 0
     wasm_cluster_traverse_lock(exec_env);
+#endif
+#if WASM_ENABLE_GC != 0
+    /* Don't allocate the objects of the new module instance from the
+       gc heap of the old one */
+    if (exec_env->module_inst != module_inst)
+        mem_allocator_retire_gc_tlab(&exec_env->gc_tlab);
 #endif
     exec_env->module_inst = module_inst;
 #if WASM_ENABLE_THREAD_MGR != 0
@@ -250,6 +288,10 @@ wasm_exec_env_restore_module_inst(
 
 #if WASM_ENABLE_THREAD_MGR != 0
     wasm_cluster_traverse_lock(exec_env);
+#endif
+#if WASM_ENABLE_GC != 0
+    if (old_module_inst_common != module_inst_common)
+        mem_allocator_retire_gc_tlab(&exec_env->gc_tlab);
 #endif
     exec_env->module_inst = module_inst_common;
     /*
@@ -313,6 +355,36 @@ wasm_exec_env_set_thread_arg(WASMExecEnv *exec_env, void *thread_arg)
 }
 #endif
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+void *
+wasm_exec_env_get_alloc_cache(WASMExecEnv *exec_env, void *heap_handle)
+{
+    mem_allocator_t allocator;
+    uint32 size;
+    void *buf;
+
+    if (exec_env->alloc_cache) {
+        allocator = mem_allocator_cache_get_allocator(exec_env->alloc_cache);
+        if (allocator == heap_handle)
+            return exec_env->alloc_cache;
+        if (allocator)
+            return NULL;
+        /* The heap cached is destroyed, cache the objects of this one */
+        return mem_allocator_cache_init(heap_handle, exec_env->alloc_cache,
+                                        mem_allocator_get_cache_struct_size());
+    }
+
+    size = mem_allocator_get_cache_struct_size();
+    if (!(buf = wasm_runtime_malloc(size)))
+        return NULL;
+
+    if (!(exec_env->alloc_cache =
+              mem_allocator_cache_init(heap_handle, buf, size)))
+        wasm_runtime_free(buf);
+    return exec_env->alloc_cache;
+}
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 void
 wasm_exec_env_push_jmpbuf(WASMExecEnv *exec_env, WASMJmpBuf *jmpbuf)
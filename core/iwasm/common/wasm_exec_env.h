@@ -42,9 +42,9 @@ typedef struct WASMExecEnv {
     struct WASMInterpFrame *cur_frame;
 
     /* Note: field module_inst, argv_buf, native_stack_boundary,
-       suspend_flags, aux_stack_boundary, aux_stack_bottom, and
-       native_symbol are used by AOTed code, don't change the
-       places of them */
+       suspend_flags, aux_stack_boundary, aux_stack_bottom,
+       native_symbol, wasm_stack, gc_tlab and instructions_to_execute
+       are used by AOTed code, don't change the places of them */
 
     /* The WASM module instance of current thread */
     struct WASMModuleInstanceCommon *module_inst;
@@ -87,11 +87,29 @@ typedef struct WASMExecEnv {
         uint8 *bottom;
     } wasm_stack;
 
-#if WASM_ENABLE_INSTRUCTION_METERING != 0
-    /* instructions to execute */
-    int instructions_to_execute;
+#if WASM_ENABLE_GC != 0
+    /* The thread-local allocation buffer of gc objects, AOTed code
+       allocates the small objects from it inline, and calls runtime
+       when it is exhausted. It has the same layout as gc_tlab_t of the
+       gc heap, see gc_alloc_wo_tlab. */
+    struct {
+        uint8 *top;
+        uint8 *limit;
+        void *heap;
+        void *next;
+    } gc_tlab;
+#else
+    /* Reserved for gc_tlab so that the place of instructions_to_execute
+       doesn't depend on WASM_ENABLE_GC of the runtime */
+    void *gc_tlab_reserved[4];
 #endif
 
+    /* The count of instructions which current thread can still execute,
+       -1 means no limit. It is always reserved so that its place used by
+       AOTed code doesn't depend on WASM_ENABLE_INSTRUCTION_METERING of
+       the runtime. */
+    int instructions_to_execute;
+
 #if WASM_ENABLE_FAST_JIT != 0
     /**
      * Cache for
@@ -125,6 +143,13 @@ typedef struct WASMExecEnv {
 
     /* whether the aux stack is allocated */
     bool is_aux_stack_allocated;
+
+#if WASM_ENABLE_THREAD_POOL != 0
+    /* the pooled native thread running current thread, and the exit
+       state kept for the threads joining current thread */
+    struct ThreadPoolWorker *pool_worker;
+    struct ThreadPoolJoinState *pool_join_state;
+#endif
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -132,10 +157,24 @@ typedef struct WASMExecEnv {
     struct WASMLocalObjectRef *cur_local_object_ref;
 #endif
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    /* The cache of the small objects freed by current thread to the
+       app heap in the shared memory, see wasm_exec_env_get_alloc_cache */
+    void *alloc_cache;
+#endif
+
 #if WASM_ENABLE_DEBUG_INTERP != 0
     WASMCurrentEnvStatus *current_status;
 #endif
 
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    /* The callback called when the instruction count limit is exhausted,
+       see wasm_runtime_set_instruction_limit_callback */
+    bool (*instruction_limit_callback)(struct WASMExecEnv *exec_env,
+                                       void *user_data);
+    void *instruction_limit_user_data;
+#endif
+
     /* attachment for native function */
     void *attachment;
 
@@ -191,6 +230,18 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
 void
 wasm_exec_env_destroy_internal(WASMExecEnv *exec_env);
 
+/* Create the exec_env in buf, whose size is at least
+   offsetof(WASMExecEnv, wasm_stack_u.bottom) + stack_size, the caller
+   keeps the ownership of buf */
+WASMExecEnv *
+wasm_exec_env_create_in_buf_internal(
+    void *buf, struct WASMModuleInstanceCommon *module_inst, uint32 stack_size);
+
+/* Destroy the exec_env created by wasm_exec_env_create_in_buf_internal,
+   except for its buffer, which can be used to create another one */
+void
+wasm_exec_env_deinit_internal(WASMExecEnv *exec_env);
+
 WASMExecEnv *
 wasm_exec_env_create(struct WASMModuleInstanceCommon *module_inst,
                      uint32 stack_size);
@@ -313,6 +364,18 @@ void
 wasm_exec_env_set_thread_arg(WASMExecEnv *exec_env, void *thread_arg);
 #endif
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/**
+ * Get the allocation cache of the exec_env for the heap, and create it if
+ * it isn't created yet. Each exec_env caches the objects of one heap only.
+ *
+ * @return the allocation cache, or NULL if the exec_env caches the objects
+ *         of another heap or the cache can't be created
+ */
+void *
+wasm_exec_env_get_alloc_cache(WASMExecEnv *exec_env, void *heap_handle);
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 void
 wasm_exec_env_push_jmpbuf(WASMExecEnv *exec_env, WASMJmpBuf *jmpbuf);
@@ -0,0 +1,489 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_instance_snapshot.h"
+#include "wasm_memory.h"
+#include "bh_log.h"
+#include "../interpreter/wasm_runtime.h"
+#if WASM_ENABLE_AOT != 0
+#include "../aot/aot_runtime.h"
+#endif
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+
+/*
+ * The captured linear memory content. If the platform supports memory
+ * backed files, the content is kept in such a file and mapped into the
+ * new instances copy-on-write, so that instantiating only costs the
+ * pages which are written later. Otherwise it is kept in a heap buffer
+ * and copied into the new instances.
+ */
+typedef struct WASMMemorySnapshot {
+    uint32 cur_page_count;
+    uint64 data_size;
+#ifdef OS_ENABLE_FILE_MMAP
+    os_file_handle file;
+#endif
+    uint8 *data;
+} WASMMemorySnapshot;
+
+typedef struct WASMTableSnapshot {
+    uint32 cur_size;
+    table_elem_type_t elems[1];
+} WASMTableSnapshot;
+
+struct WASMInstanceSnapshot {
+    WASMModuleCommon *module;
+    uint32 memory_count;
+    uint32 table_count;
+    WASMMemorySnapshot *memories;
+    WASMTableSnapshot **tables;
+    uint32 global_data_size;
+    uint8 *global_data;
+#if WASM_ENABLE_BULK_MEMORY != 0
+    bh_bitmap *data_dropped;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    bh_bitmap *elem_dropped;
+#endif
+};
+
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL) {
+        snprintf(error_buf, error_buf_size, "instance snapshot failed: %s",
+                 string);
+    }
+}
+
+static void *
+runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+    void *mem;
+
+    if (size >= UINT32_MAX || !(mem = wasm_runtime_malloc((uint32)size))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+
+    memset(mem, 0, (uint32)size);
+    return mem;
+}
+
+static bh_bitmap *
+bitmap_dup(const bh_bitmap *bitmap, char *error_buf, uint32 error_buf_size)
+{
+    uint64 size;
+    bh_bitmap *new_bitmap;
+
+    if (!bitmap)
+        return NULL;
+
+    size = offsetof(bh_bitmap, map)
+           + (bitmap->end_index - bitmap->begin_index + 7) / 8;
+    if ((new_bitmap = runtime_malloc(size, error_buf, error_buf_size)))
+        bh_memcpy_s(new_bitmap, (uint32)size, bitmap, (uint32)size);
+    return new_bitmap;
+}
+
+static void
+bitmap_restore(bh_bitmap *dst, const bh_bitmap *src)
+{
+    if (dst && src) {
+        bh_assert(dst->end_index - dst->begin_index
+                  == src->end_index - src->begin_index);
+        memcpy(dst->map, src->map, (src->end_index - src->begin_index + 7) / 8);
+    }
+}
+
+static bool
+check_instance_supported(WASMModuleInstance *module_inst, char *error_buf,
+                         uint32 error_buf_size)
+{
+    uint32 i;
+#if WASM_ENABLE_MULTI_MODULE != 0
+    bh_list *sub_module_inst_list = NULL;
+#endif
+
+#if WASM_ENABLE_GC != 0
+    /* The globals and tables may reference objects of the instance's
+       private gc heap */
+    (void)i;
+    (void)module_inst;
+    set_error_buf(error_buf, error_buf_size, "GC is enabled");
+    return false;
+#endif
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        sub_module_inst_list = module_inst->e->sub_module_inst_list;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        sub_module_inst_list =
+            ((AOTModuleInstanceExtra *)module_inst->e)->sub_module_inst_list;
+#endif
+    if (sub_module_inst_list && bh_list_length(sub_module_inst_list) > 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "instance with sub module instances");
+        return false;
+    }
+#endif
+
+    for (i = 0; i < module_inst->memory_count; i++) {
+        WASMMemoryInstance *memory = module_inst->memories[i];
+
+        if (memory->is_shared_memory) {
+            set_error_buf(error_buf, error_buf_size, "shared memory");
+            return false;
+        }
+        /* The app heap keeps native pointers to the linear memory */
+        if (memory->heap_handle) {
+            set_error_buf(error_buf, error_buf_size,
+                          "instance with host managed heap");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+is_zero_data(const uint8 *data, uint64 size)
+{
+    const uint64 *p = (const uint64 *)data;
+    uint64 i, n = size / sizeof(uint64);
+
+    for (i = 0; i < n; i++) {
+        if (p[i] != 0)
+            return false;
+    }
+    for (i = n * sizeof(uint64); i < size; i++) {
+        if (data[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+static bool
+capture_memory(WASMMemoryInstance *memory, WASMMemorySnapshot *snapshot,
+               char *error_buf, uint32 error_buf_size)
+{
+    uint64 data_size = memory->memory_data_size;
+#ifdef OS_ENABLE_FILE_MMAP
+    uint64 page_size = os_getpagesize();
+    uint64 file_size = (data_size + page_size - 1) & ~(page_size - 1);
+    uint64 offset, size;
+    uint8 *mapped;
+#endif
+
+    snapshot->cur_page_count = memory->cur_page_count;
+    snapshot->data_size = data_size;
+
+    if (data_size == 0)
+        return true;
+
+#ifdef OS_ENABLE_FILE_MMAP
+    snapshot->file = os_mem_file_create("wamr-instance-snapshot", file_size);
+    if (snapshot->file != os_get_invalid_handle()) {
+        mapped = os_mmap_file(NULL, file_size,
+                              MMAP_PROT_READ | MMAP_PROT_WRITE,
+                              MMAP_MAP_SHARED, snapshot->file, 0);
+        if (mapped) {
+            /* Only write the non-zero pages, the others are left as
+               holes of the file */
+            for (offset = 0; offset < data_size; offset += page_size) {
+                size = data_size - offset < page_size ? data_size - offset
+                                                      : page_size;
+                if (!is_zero_data(memory->memory_data + offset, size))
+                    memcpy(mapped + offset, memory->memory_data + offset,
+                           size);
+            }
+            os_munmap(mapped, file_size);
+            return true;
+        }
+
+        os_mem_file_destroy(snapshot->file);
+        snapshot->file = os_get_invalid_handle();
+    }
+    LOG_VERBOSE("Fall back to copy the memory data for instance snapshot");
+#endif
+
+    if (!(snapshot->data =
+              runtime_malloc(data_size, error_buf, error_buf_size)))
+        return false;
+    memcpy(snapshot->data, memory->memory_data, data_size);
+    return true;
+}
+
+static bool
+restore_memory(WASMModuleInstance *module_inst, uint32 memory_idx,
+               const WASMMemorySnapshot *snapshot, char *error_buf,
+               uint32 error_buf_size)
+{
+    WASMMemoryInstance *memory = module_inst->memories[memory_idx];
+#ifdef OS_ENABLE_FILE_MMAP
+    uint64 page_size = os_getpagesize();
+    uint64 file_size = (snapshot->data_size + page_size - 1) & ~(page_size - 1);
+#endif
+
+    if (memory->cur_page_count < snapshot->cur_page_count
+        && !wasm_enlarge_memory_with_idx(
+            module_inst, snapshot->cur_page_count - memory->cur_page_count,
+            memory_idx)) {
+        set_error_buf(error_buf, error_buf_size, "enlarge memory failed");
+        return false;
+    }
+
+    if (memory->cur_page_count != snapshot->cur_page_count
+        || memory->memory_data_size < snapshot->data_size) {
+        set_error_buf(error_buf, error_buf_size, "memory size mismatch");
+        return false;
+    }
+
+    if (snapshot->data_size == 0)
+        return true;
+
+#ifdef OS_ENABLE_FILE_MMAP
+    if (snapshot->file != os_get_invalid_handle()) {
+        uint8 *mapped;
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+        /* The whole address space of the linear memory is reserved and
+           enlarging memory never moves it, so the pages can be replaced
+           by the copy-on-write mapping of the snapshot. The slots of the
+           linear memory pool are reset by discarding their anonymous
+           pages, so they keep the mapping and get the data copied. */
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+        if (!wasm_runtime_memory_in_slot(memory->memory_data))
+#endif
+        {
+            if (os_mmap_file(memory->memory_data, file_size,
+                             MMAP_PROT_READ | MMAP_PROT_WRITE,
+                             MMAP_MAP_FIXED, snapshot->file, 0)) {
+                return true;
+            }
+            set_error_buf(error_buf, error_buf_size,
+                          "map memory data failed");
+            return false;
+        }
+#endif
+        mapped = os_mmap_file(NULL, file_size, MMAP_PROT_READ, MMAP_MAP_NONE,
+                              snapshot->file, 0);
+        if (!mapped) {
+            set_error_buf(error_buf, error_buf_size, "map memory data failed");
+            return false;
+        }
+        memcpy(memory->memory_data, mapped, snapshot->data_size);
+        os_munmap(mapped, file_size);
+        return true;
+    }
+#endif
+
+    memcpy(memory->memory_data, snapshot->data, snapshot->data_size);
+    return true;
+}
+
+WASMInstanceSnapshot *
+wasm_runtime_create_instance_snapshot(
+    WASMModuleInstanceCommon *module_inst_comm, char *error_buf,
+    uint32 error_buf_size)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMModuleInstanceExtraCommon *common;
+    WASMInstanceSnapshot *snapshot;
+    uint64 total_size;
+    uint32 i;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    if (!check_instance_supported(module_inst, error_buf, error_buf_size))
+        return NULL;
+
+    total_size =
+        sizeof(WASMInstanceSnapshot)
+        + sizeof(WASMMemorySnapshot) * (uint64)module_inst->memory_count
+        + sizeof(WASMTableSnapshot *) * (uint64)module_inst->table_count
+        + module_inst->global_data_size;
+    if (!(snapshot = runtime_malloc(total_size, error_buf, error_buf_size)))
+        return NULL;
+
+    snapshot->module = (WASMModuleCommon *)module_inst->module;
+    snapshot->memory_count = module_inst->memory_count;
+    snapshot->table_count = module_inst->table_count;
+    snapshot->memories = (WASMMemorySnapshot *)(snapshot + 1);
+    snapshot->tables =
+        (WASMTableSnapshot **)(snapshot->memories + snapshot->memory_count);
+    snapshot->global_data =
+        (uint8 *)(snapshot->tables + snapshot->table_count);
+    snapshot->global_data_size = module_inst->global_data_size;
+#ifdef OS_ENABLE_FILE_MMAP
+    for (i = 0; i < snapshot->memory_count; i++)
+        snapshot->memories[i].file = os_get_invalid_handle();
+#endif
+
+    for (i = 0; i < snapshot->memory_count; i++) {
+        if (!capture_memory(module_inst->memories[i], &snapshot->memories[i],
+                            error_buf, error_buf_size))
+            goto fail;
+    }
+
+    for (i = 0; i < snapshot->table_count; i++) {
+        WASMTableInstance *table = module_inst->tables[i];
+        WASMTableSnapshot *table_snapshot;
+
+        total_size = offsetof(WASMTableSnapshot, elems)
+                     + sizeof(table_elem_type_t) * (uint64)table->cur_size;
+        if (!(table_snapshot =
+                  runtime_malloc(total_size, error_buf, error_buf_size)))
+            goto fail;
+
+        table_snapshot->cur_size = table->cur_size;
+        bh_memcpy_s(table_snapshot->elems,
+                    (uint32)(sizeof(table_elem_type_t) * table->cur_size),
+                    table->elems,
+                    (uint32)(sizeof(table_elem_type_t) * table->cur_size));
+        snapshot->tables[i] = table_snapshot;
+    }
+
+    if (snapshot->global_data_size > 0)
+        bh_memcpy_s(snapshot->global_data, snapshot->global_data_size,
+                    module_inst->global_data, module_inst->global_data_size);
+
+    common = GetModuleInstanceExtraCommon(module_inst);
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (common->data_dropped
+        && !(snapshot->data_dropped =
+                 bitmap_dup(common->data_dropped, error_buf, error_buf_size)))
+        goto fail;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (common->elem_dropped
+        && !(snapshot->elem_dropped =
+                 bitmap_dup(common->elem_dropped, error_buf, error_buf_size)))
+        goto fail;
+#endif
+    (void)common;
+
+    return snapshot;
+
+fail:
+    wasm_runtime_destroy_instance_snapshot(snapshot);
+    return NULL;
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_snapshot(WASMInstanceSnapshot *snapshot,
+                                       const struct InstantiationArgs2 *args,
+                                       char *error_buf, uint32 error_buf_size)
+{
+    struct InstantiationArgs2 restore_args;
+    WASMModuleInstance *module_inst;
+    WASMModuleInstanceExtraCommon *common;
+    uint32 i;
+
+    if (!snapshot) {
+        set_error_buf(error_buf, error_buf_size, "invalid snapshot");
+        return NULL;
+    }
+
+    if (args)
+        restore_args = *args;
+    else
+        wasm_runtime_instantiation_args_set_defaults(&restore_args);
+    /* The app heap isn't supported, see check_instance_supported */
+    restore_args.v1.host_managed_heap_size = 0;
+    restore_args.restore_from_snapshot = true;
+
+    if (!(module_inst = (WASMModuleInstance *)wasm_runtime_instantiate_internal(
+              snapshot->module, NULL, NULL, &restore_args, error_buf,
+              error_buf_size)))
+        return NULL;
+
+    bh_assert(module_inst->memory_count == snapshot->memory_count);
+    bh_assert(module_inst->table_count == snapshot->table_count);
+    bh_assert(module_inst->global_data_size == snapshot->global_data_size);
+
+    for (i = 0; i < snapshot->memory_count; i++) {
+        if (!restore_memory(module_inst, i, &snapshot->memories[i], error_buf,
+                            error_buf_size))
+            goto fail;
+    }
+
+    for (i = 0; i < snapshot->table_count; i++) {
+        WASMTableInstance *table = module_inst->tables[i];
+        const WASMTableSnapshot *table_snapshot = snapshot->tables[i];
+
+        if (table_snapshot->cur_size > table->max_size) {
+            set_error_buf(error_buf, error_buf_size, "table size mismatch");
+            goto fail;
+        }
+        table->cur_size = table_snapshot->cur_size;
+        bh_memcpy_s(table->elems,
+                    (uint32)(sizeof(table_elem_type_t) * table->max_size),
+                    table_snapshot->elems,
+                    (uint32)(sizeof(table_elem_type_t)
+                             * table_snapshot->cur_size));
+    }
+
+    if (snapshot->global_data_size > 0)
+        bh_memcpy_s(module_inst->global_data, module_inst->global_data_size,
+                    snapshot->global_data, snapshot->global_data_size);
+
+    common = GetModuleInstanceExtraCommon(module_inst);
+#if WASM_ENABLE_BULK_MEMORY != 0
+    bitmap_restore(common->data_dropped, snapshot->data_dropped);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    bitmap_restore(common->elem_dropped, snapshot->elem_dropped);
+#endif
+    (void)common;
+
+    return (WASMModuleInstanceCommon *)module_inst;
+
+fail:
+    wasm_runtime_deinstantiate_internal((WASMModuleInstanceCommon *)module_inst,
+                                        false);
+    return NULL;
+}
+
+void
+wasm_runtime_destroy_instance_snapshot(WASMInstanceSnapshot *snapshot)
+{
+    uint32 i;
+
+    if (!snapshot)
+        return;
+
+    for (i = 0; i < snapshot->memory_count; i++) {
+#ifdef OS_ENABLE_FILE_MMAP
+        if (snapshot->memories[i].file != os_get_invalid_handle())
+            os_mem_file_destroy(snapshot->memories[i].file);
+#endif
+        if (snapshot->memories[i].data)
+            wasm_runtime_free(snapshot->memories[i].data);
+    }
+
+    for (i = 0; i < snapshot->table_count; i++) {
+        if (snapshot->tables[i])
+            wasm_runtime_free(snapshot->tables[i]);
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (snapshot->data_dropped)
+        wasm_runtime_free(snapshot->data_dropped);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (snapshot->elem_dropped)
+        wasm_runtime_free(snapshot->elem_dropped);
+#endif
+
+    wasm_runtime_free(snapshot);
+}
+
+#endif /* end of WASM_ENABLE_INSTANCE_SNAPSHOT != 0 */
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_INSTANCE_SNAPSHOT_H
+#define _WASM_INSTANCE_SNAPSHOT_H
+
+#include "wasm_runtime_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+
+typedef struct WASMInstanceSnapshot WASMInstanceSnapshot;
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMInstanceSnapshot *
+wasm_runtime_create_instance_snapshot(WASMModuleInstanceCommon *module_inst,
+                                      char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_snapshot(WASMInstanceSnapshot *snapshot,
+                                       const struct InstantiationArgs2 *args,
+                                       char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_instance_snapshot(WASMInstanceSnapshot *snapshot);
+
+#endif /* end of WASM_ENABLE_INSTANCE_SNAPSHOT != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_INSTANCE_SNAPSHOT_H */
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_jit_cache.h"
+#include "bh_log.h"
+#include "../interpreter/wasm_runtime.h"
+#include "../interpreter/wasm_loader.h"
+
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+#include "../aot/aot_runtime.h"
+#include "../compilation/aot.h"
+#include "../compilation/aot_llvm.h"
+#include "../compilation/aot_emit_aot_file.h"
+#include "../../version.h"
+#include <openssl/sha.h>
+
+/* The length of the cache file name: the hex string of the SHA-256
+   digest followed by ".aot" */
+#define JIT_CACHE_FILE_NAME_LEN (SHA256_DIGEST_LENGTH * 2 + 4)
+
+static char *jit_cache_dir = NULL;
+
+/* The build features which change the code generated for a wasm binary or
+   the runtime ABI the code depends on, an AOT file generated by a runtime
+   built with other features must not be reused */
+static const uint32 jit_cache_build_features[] = {
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    1,
+#else
+    0,
+#endif
+    WASM_DISABLE_STACK_HW_BOUND_CHECK,
+    WASM_ENABLE_BULK_MEMORY,
+    WASM_ENABLE_BULK_MEMORY_OPT,
+    WASM_ENABLE_SHARED_MEMORY,
+    WASM_ENABLE_THREAD_MGR,
+    WASM_ENABLE_TAIL_CALL,
+    WASM_ENABLE_SIMD,
+    WASM_ENABLE_REF_TYPES,
+    WASM_ENABLE_GC,
+    WASM_ENABLE_STRINGREF,
+    WASM_ENABLE_EXCE_HANDLING,
+    WASM_ENABLE_CALL_INDIRECT_OVERLONG,
+    WASM_ENABLE_MEMORY64,
+    WASM_ENABLE_MULTI_MEMORY,
+    WASM_ENABLE_SHARED_HEAP,
+    WASM_ENABLE_PERF_PROFILING,
+    WASM_ENABLE_DUMP_CALL_STACK,
+    WASM_ENABLE_AOT_STACK_FRAME,
+    WASM_ENABLE_MEMORY_PROFILING,
+    WASM_ENABLE_INSTRUCTION_METERING,
+    WASM_ENABLE_EPOCH_INTERRUPTION,
+};
+
+bool
+wasm_jit_cache_init(const char *cache_dir)
+{
+    uint32 size;
+
+    if (!cache_dir || cache_dir[0] == '\0')
+        return true;
+
+    size = (uint32)strlen(cache_dir) + 1;
+    if (!(jit_cache_dir = wasm_runtime_malloc(size))) {
+        LOG_ERROR("allocate memory for llvm jit cache dir failed");
+        return false;
+    }
+    bh_memcpy_s(jit_cache_dir, size, cache_dir, size);
+    return true;
+}
+
+void
+wasm_jit_cache_destroy(void)
+{
+    if (jit_cache_dir) {
+        wasm_runtime_free(jit_cache_dir);
+        jit_cache_dir = NULL;
+    }
+}
+
+/*
+ * The cache file is named with the SHA-256 digest of the wasm binary, the
+ * runtime version and build features, the host target and CPU features,
+ * and the LLVM JIT options, so that an AOT file is only reused by the runtime which would
+ * generate the same code for the wasm binary.
+ */
+bool
+wasm_jit_cache_get_file_path(const uint8 *buf, uint32 size, char *path,
+                             uint32 path_size)
+{
+    LLVMJITOptions *llvm_jit_options = wasm_runtime_get_llvm_jit_options();
+    RunningMode running_mode = wasm_runtime_get_default_running_mode();
+    uint32 options[7];
+    uint8 digest[SHA256_DIGEST_LENGTH];
+    char *triple, *cpu, *features;
+    SHA256_CTX sha256_ctx;
+    uint32 i;
+    int n;
+
+    if (!jit_cache_dir)
+        return false;
+
+    /* Only the modules run with LLVM JIT are cached, since the AOT module
+       loaded from the cache can't switch to the other running modes */
+    if (running_mode != Mode_LLVM_JIT
+#if WASM_ENABLE_FAST_JIT == 0 && WASM_ENABLE_TIERED_JIT == 0
+        && running_mode != Mode_Default
+#endif
+    )
+        return false;
+
+    options[0] = WAMR_VERSION_MAJOR;
+    options[1] = WAMR_VERSION_MINOR;
+    options[2] = WAMR_VERSION_PATCH;
+    options[3] = llvm_jit_options->opt_level;
+    options[4] = llvm_jit_options->size_level;
+    options[5] = llvm_jit_options->segue_flags;
+    options[6] = llvm_jit_options->quick_invoke_c_api_import ? 1 : 0;
+
+    triple = LLVMGetDefaultTargetTriple();
+    cpu = LLVMGetHostCPUName();
+    features = LLVMGetHostCPUFeatures();
+    if (!triple || !cpu || !features) {
+        LOG_WARNING("warning: failed to get the host target of llvm jit "
+                    "cache");
+        n = -1;
+    }
+    else {
+        SHA256_Init(&sha256_ctx);
+        SHA256_Update(&sha256_ctx, buf, size);
+        SHA256_Update(&sha256_ctx, options, sizeof(options));
+        SHA256_Update(&sha256_ctx, jit_cache_build_features,
+                      sizeof(jit_cache_build_features));
+        SHA256_Update(&sha256_ctx, triple, strlen(triple) + 1);
+        SHA256_Update(&sha256_ctx, cpu, strlen(cpu) + 1);
+        SHA256_Update(&sha256_ctx, features, strlen(features) + 1);
+        SHA256_Final(digest, &sha256_ctx);
+        n = snprintf(path, path_size, "%s/", jit_cache_dir);
+    }
+
+    if (triple)
+        LLVMDisposeMessage(triple);
+    if (cpu)
+        LLVMDisposeMessage(cpu);
+    if (features)
+        LLVMDisposeMessage(features);
+
+    if (n < 0)
+        return false;
+
+    if ((uint32)n + JIT_CACHE_FILE_NAME_LEN >= path_size) {
+        LOG_WARNING("warning: llvm jit cache dir %s is too long",
+                    jit_cache_dir);
+        return false;
+    }
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++, n += 2) {
+        snprintf(path + n, 3, "%02x", digest[i]);
+    }
+    bh_strcpy_s(path + n, path_size - (uint32)n, ".aot");
+    return true;
+}
+
+static WASMModuleCommon *
+load_aot_file(const char *path, uint8 *aot_file_buf, uint32 aot_file_size,
+              const LoadArgs *args)
+{
+    char error_buf[128];
+    LoadArgs load_args = *args;
+    AOTModule *module;
+
+    /* Let the loader copy what it needs, so as to free the buffer */
+    load_args.wasm_binary_freeable = true;
+    module = aot_load_from_aot_file(aot_file_buf, aot_file_size, &load_args,
+                                    error_buf, sizeof(error_buf));
+    if (!module) {
+        /* The file may be truncated or corrupted, remove it so that
+           it is generated again */
+        LOG_WARNING("warning: failed to load llvm jit cache file %s: %s",
+                    path, error_buf);
+        remove(path);
+        return NULL;
+    }
+
+    module->is_binary_freeable = true;
+    module->is_llvm_jit_cache = true;
+    return (WASMModuleCommon *)module;
+}
+
+WASMModuleCommon *
+wasm_jit_cache_load(const char *path, const LoadArgs *args)
+{
+    WASMModuleCommon *module;
+    uint8 *aot_file_buf = NULL;
+    FILE *file;
+    long file_size;
+
+    if (!(file = fopen(path, "rb")))
+        /* Not cached yet */
+        return NULL;
+
+    if (fseek(file, 0, SEEK_END) != 0 || (file_size = ftell(file)) <= 0
+        || (uint64)file_size > UINT32_MAX || fseek(file, 0, SEEK_SET) != 0
+        || !(aot_file_buf = wasm_runtime_malloc((uint32)file_size))
+        || fread(aot_file_buf, 1, (size_t)file_size, file)
+               != (size_t)file_size) {
+        LOG_WARNING("warning: failed to read llvm jit cache file %s", path);
+        fclose(file);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+        return NULL;
+    }
+    fclose(file);
+
+    module = load_aot_file(path, aot_file_buf, (uint32)file_size, args);
+    wasm_runtime_free(aot_file_buf);
+
+    if (module)
+        LOG_VERBOSE("Load module from llvm jit cache file %s", path);
+    return module;
+}
+
+/* Compile the wasm module into an AOT file for the host, with the same
+   options as init_llvm_jit_functions_stage1 of the loader except that
+   the code is emitted as an AOT file rather than added to ORC JIT */
+static uint8 *
+compile_aot_file(WASMModule *module, uint32 *p_aot_file_size)
+{
+    LLVMJITOptions *llvm_jit_options = wasm_runtime_get_llvm_jit_options();
+    AOTCompOption option = { 0 };
+    AOTCompData *comp_data;
+    AOTCompContext *comp_ctx = NULL;
+    uint8 *aot_file_buf = NULL;
+#if WASM_ENABLE_GC != 0
+    bool gc_enabled = true;
+#else
+    bool gc_enabled = false;
+#endif
+
+    if (!(comp_data = aot_create_comp_data(module, NULL, gc_enabled)))
+        return NULL;
+
+    option.output_format = AOT_FORMAT_FILE;
+    option.opt_level = llvm_jit_options->opt_level;
+    option.size_level = llvm_jit_options->size_level;
+    option.segue_flags = llvm_jit_options->segue_flags;
+    option.quick_invoke_c_api_import =
+        llvm_jit_options->quick_invoke_c_api_import;
+
+#ifndef OS_ENABLE_HW_BOUND_CHECK
+    option.bounds_checks = 1;
+    option.stack_bounds_checks = 1;
+#else
+    option.bounds_checks = 0;
+#if WASM_DISABLE_STACK_HW_BOUND_CHECK != 0
+    option.stack_bounds_checks = 1;
+#else
+    option.stack_bounds_checks = 0;
+#endif
+#endif
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    option.enable_bulk_memory = true;
+#endif
+#if WASM_ENABLE_BULK_MEMORY_OPT != 0
+    option.enable_bulk_memory_opt = true;
+#endif
+#if WASM_ENABLE_THREAD_MGR != 0
+    option.enable_thread_mgr = true;
+#endif
+#if WASM_ENABLE_TAIL_CALL != 0
+    option.enable_tail_call = true;
+#endif
+#if WASM_ENABLE_SIMD != 0
+    option.enable_simd = true;
+#endif
+#if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
+    option.enable_ref_types = true;
+#elif WASM_ENABLE_GC != 0
+    option.enable_gc = true;
+    option.enable_gc_tlab = true;
+#endif
+#if WASM_ENABLE_CALL_INDIRECT_OVERLONG != 0
+    option.enable_call_indirect_overlong = true;
+#endif
+    option.enable_aux_stack_check = true;
+#if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
+    || WASM_ENABLE_AOT_STACK_FRAME != 0
+    option.aux_stack_frame_type = AOT_STACK_FRAME_TYPE_STANDARD;
+    aot_call_stack_features_init_default(&option.call_stack_features);
+#endif
+#if WASM_ENABLE_PERF_PROFILING != 0
+    option.enable_perf_profiling = true;
+#endif
+#if WASM_ENABLE_MEMORY_PROFILING != 0
+    option.enable_memory_profiling = true;
+    option.enable_stack_estimation = true;
+#endif
+#if WASM_ENABLE_SHARED_HEAP != 0
+    option.enable_shared_heap = true;
+#endif
+
+    if ((comp_ctx = aot_create_comp_context(comp_data, &option))
+        && aot_compile_wasm(comp_ctx)) {
+        aot_file_buf =
+            aot_emit_aot_file_buf(comp_ctx, comp_data, p_aot_file_size);
+    }
+
+    if (comp_ctx)
+        aot_destroy_comp_context(comp_ctx);
+    aot_destroy_comp_data(comp_data);
+    return aot_file_buf;
+}
+
+static void
+save_aot_file(const char *path, const uint8 *aot_file_buf,
+              uint32 aot_file_size)
+{
+    char tmp_path[WASM_JIT_CACHE_PATH_SIZE + 8];
+    FILE *file = NULL;
+    bool tmp_file_created = false, ret = false;
+
+    /* Write into a temporary file and then rename it, so that the other
+       processes sharing the cache never read a partial file */
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path);
+    tmp_file_created = bh_mkstemp(tmp_path, sizeof(tmp_path));
+    if (tmp_file_created && (file = fopen(tmp_path, "wb"))) {
+        ret = fwrite(aot_file_buf, aot_file_size, 1, file) == 1;
+        ret = (fclose(file) == 0) && ret;
+    }
+    if (!ret || rename(tmp_path, path) != 0) {
+        LOG_WARNING("warning: failed to write llvm jit cache file %s", path);
+        if (tmp_file_created)
+            remove(tmp_path);
+    }
+    else {
+        LOG_VERBOSE("Save module to llvm jit cache file %s", path);
+    }
+}
+
+WASMModuleCommon *
+wasm_jit_cache_compile(const char *path, const uint8 *buf, uint32 size,
+                       const LoadArgs *args)
+{
+    char error_buf[128];
+    WASMModuleCommon *module = NULL;
+    WASMModule *wasm_module;
+    uint8 *wasm_buf, *aot_file_buf;
+    uint32 aot_file_size = 0;
+
+    /* The loader modifies the wasm binary in place, load a copy of it so
+       that the caller can still load the original one on failure */
+    if (!(wasm_buf = wasm_runtime_malloc(size))) {
+        LOG_WARNING("warning: allocate memory for llvm jit cache failed");
+        return NULL;
+    }
+    bh_memcpy_s(wasm_buf, size, buf, size);
+
+    if (!(wasm_module = wasm_loader_load_for_jit_cache(
+              wasm_buf, size, error_buf, sizeof(error_buf)))) {
+        /* Leave the error to be reported by the caller's loading */
+        wasm_runtime_free(wasm_buf);
+        return NULL;
+    }
+
+    aot_file_buf = compile_aot_file(wasm_module, &aot_file_size);
+    wasm_loader_unload(wasm_module);
+    wasm_runtime_free(wasm_buf);
+
+    if (!aot_file_buf) {
+        LOG_WARNING("warning: failed to compile llvm jit cache file: %s",
+                    aot_get_last_error());
+        return NULL;
+    }
+
+    save_aot_file(path, aot_file_buf, aot_file_size);
+    module = load_aot_file(path, aot_file_buf, aot_file_size, args);
+    wasm_runtime_free(aot_file_buf);
+    return module;
+}
+
+#endif /* end of WASM_ENABLE_LLVM_JIT_CACHE != 0 */
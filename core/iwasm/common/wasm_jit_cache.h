@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_JIT_CACHE_H
+#define _WASM_JIT_CACHE_H
+
+#include "wasm_runtime_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+
+/* The max size of the cache file path, including the cache directory */
+#define WASM_JIT_CACHE_PATH_SIZE 1024
+
+/**
+ * Set the directory of the persistent LLVM JIT code cache, the cache is
+ * disabled if the directory is NULL or empty.
+ *
+ * @param cache_dir the directory to store the cached AOT files
+ *
+ * @return true if success, false otherwise
+ */
+bool
+wasm_jit_cache_init(const char *cache_dir);
+
+void
+wasm_jit_cache_destroy(void);
+
+/**
+ * Get the path of the cache file of the wasm binary, it must be called
+ * before loading the wasm binary, which may be modified by the loader.
+ *
+ * @return true if success, false if the cache is disabled or the path
+ *         can't be got
+ */
+bool
+wasm_jit_cache_get_file_path(const uint8 *buf, uint32 size, char *path,
+                             uint32 path_size);
+
+/**
+ * Load the module from the cache file.
+ *
+ * @return the AOT module loaded, or NULL if there is no valid cache file
+ */
+WASMModuleCommon *
+wasm_jit_cache_load(const char *path, const LoadArgs *args);
+
+/**
+ * Compile the wasm binary into an AOT file, save it as the cache file and
+ * load the module from it, so that a cache miss costs one AOT compilation
+ * and no JIT compilation. Failing to save the cache file is only logged.
+ *
+ * @return the AOT module loaded, or NULL if the wasm binary can't be
+ *         compiled, in which case the caller loads it with LLVM JIT
+ */
+WASMModuleCommon *
+wasm_jit_cache_compile(const char *path, const uint8 *buf, uint32 size,
+                       const LoadArgs *args);
+
+#endif /* end of WASM_ENABLE_LLVM_JIT_CACHE != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_JIT_CACHE_H */
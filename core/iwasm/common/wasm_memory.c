@@ -69,6 +69,26 @@ static void (*free_func)(
 
 static unsigned int global_pool_size;
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0 && defined(os_thread_local_attribute)
+#define POOL_ALLOC_THREAD_CACHE 1
+/* The cache of the calling thread in front of the global pool heap, it
+   lives in the thread local storage rather than in the heap, since the
+   heap detaches it on destroy and it may be used again after that */
+static os_thread_local_attribute uint64 pool_alloc_cache_buf[64];
+static os_thread_local_attribute mem_allocator_cache_t pool_alloc_cache;
+
+static inline mem_allocator_cache_t
+get_pool_alloc_cache(void)
+{
+    /* The heap may have been destroyed, or be another one */
+    if (pool_alloc_cache && memory_mode == MEMORY_MODE_POOL
+        && mem_allocator_cache_get_allocator(pool_alloc_cache)
+               == pool_allocator)
+        return pool_alloc_cache;
+    return NULL;
+}
+#endif
+
 static uint64
 align_as_and_cast(uint64 size, uint64 alignment)
 {
@@ -845,6 +865,435 @@ wasm_runtime_shared_heap_free(WASMModuleInstanceCommon *module_inst, uint64 ptr)
 }
 #endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
 
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MEM_DISCARD) \
+    && WASM_MEM_ALLOC_WITH_USAGE == 0
+#define LINEAR_MEMORY_SLOT_SUPPORTED 1
+
+/* Each slot reserves the same address range as the linear memory mapped
+   by wasm_allocate_linear_memory, see the comment there */
+#define LINEAR_MEMORY_SLOT_SIZE (8 * (uint64)BH_GB)
+
+typedef struct LinearMemorySlot {
+    uint8 *base;
+    /* Size of the readable and writable region at the beginning of the
+       slot, the rest of the slot is kept inaccessible */
+    uint64 committed_size;
+} LinearMemorySlot;
+
+/* The slots, sorted by base address */
+static LinearMemorySlot *memory_slots = NULL;
+/* Stack of the free slot indexes, the slot released most recently
+   is reused first */
+static uint32 *memory_slot_free_list = NULL;
+static uint32 memory_slot_count = 0;
+static uint32 memory_slot_free_count = 0;
+static uint32 memory_slot_highmark = 0;
+static korp_mutex memory_slot_lock;
+
+static int
+memory_slot_cmp(const void *a, const void *b)
+{
+    uintptr_t base_a = (uintptr_t)((const LinearMemorySlot *)a)->base;
+    uintptr_t base_b = (uintptr_t)((const LinearMemorySlot *)b)->base;
+
+    return base_a < base_b ? -1 : (base_a > base_b ? 1 : 0);
+}
+
+static LinearMemorySlot *
+find_memory_slot(const uint8 *addr)
+{
+    uint32 low = 0, high = memory_slot_count, mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (addr < memory_slots[mid].base)
+            high = mid;
+        else if (addr >= memory_slots[mid].base + LINEAR_MEMORY_SLOT_SIZE)
+            low = mid + 1;
+        else
+            return &memory_slots[mid];
+    }
+    return NULL;
+}
+
+static void
+destroy_memory_slots(void)
+{
+    uint32 i;
+
+    if (!memory_slots)
+        return;
+
+    for (i = 0; i < memory_slot_count; i++) {
+        if (memory_slots[i].base)
+            os_munmap(memory_slots[i].base, LINEAR_MEMORY_SLOT_SIZE);
+    }
+    os_mutex_destroy(&memory_slot_lock);
+    wasm_runtime_free(memory_slots);
+
+    memory_slots = NULL;
+    memory_slot_free_list = NULL;
+    memory_slot_count = memory_slot_free_count = memory_slot_highmark = 0;
+}
+
+bool
+wasm_runtime_memory_slots_init(uint32 slot_count)
+{
+    uint64 total_size;
+    uint32 i;
+
+    if (slot_count == 0)
+        return true;
+
+    total_size =
+        (sizeof(LinearMemorySlot) + sizeof(uint32)) * (uint64)slot_count;
+    if (total_size >= UINT32_MAX
+        || !(memory_slots = wasm_runtime_malloc((uint32)total_size))) {
+        LOG_ERROR("Allocate linear memory slots failed");
+        return false;
+    }
+    memset(memory_slots, 0, (uint32)total_size);
+    memory_slot_free_list = (uint32 *)(memory_slots + slot_count);
+
+    if (os_mutex_init(&memory_slot_lock) != 0) {
+        wasm_runtime_free(memory_slots);
+        memory_slots = NULL;
+        return false;
+    }
+
+    memory_slot_count = slot_count;
+    for (i = 0; i < slot_count; i++) {
+        if (!(memory_slots[i].base =
+                  os_mmap(NULL, LINEAR_MEMORY_SLOT_SIZE, MMAP_PROT_NONE,
+                          MMAP_MAP_NONE, os_get_invalid_handle()))) {
+            LOG_ERROR("Reserve linear memory slot %" PRIu32 " failed", i);
+            destroy_memory_slots();
+            return false;
+        }
+    }
+
+    qsort(memory_slots, slot_count, sizeof(LinearMemorySlot),
+          memory_slot_cmp);
+
+    for (i = 0; i < slot_count; i++)
+        memory_slot_free_list[i] = slot_count - 1 - i;
+    memory_slot_free_count = slot_count;
+    return true;
+}
+
+bool
+wasm_runtime_memory_in_slot(const uint8 *memory_data)
+{
+    return find_memory_slot(memory_data) != NULL;
+}
+
+/* Map fresh inaccessible pages over the first reset_size bytes of the
+   slot, which drops the data and the protection of the previous user */
+static bool
+reset_memory_slot(LinearMemorySlot *slot, uint64 reset_size)
+{
+    if (reset_size > 0
+        && os_mmap(slot->base, reset_size, MMAP_PROT_NONE, MMAP_MAP_FIXED,
+                   os_get_invalid_handle())
+               != slot->base) {
+        LOG_ERROR("Reset linear memory slot %p failed", slot->base);
+        return false;
+    }
+    slot->committed_size = 0;
+    return true;
+}
+
+static void
+put_memory_slot(LinearMemorySlot *slot)
+{
+    os_mutex_lock(&memory_slot_lock);
+    memory_slot_free_list[memory_slot_free_count++] =
+        (uint32)(slot - memory_slots);
+    os_mutex_unlock(&memory_slot_lock);
+}
+
+static uint8 *
+acquire_memory_slot(uint64 commit_size)
+{
+    LinearMemorySlot *slot = NULL;
+    uint32 used_count;
+    int ret = 0;
+
+    if (memory_slot_count == 0)
+        return NULL;
+
+    os_mutex_lock(&memory_slot_lock);
+    if (memory_slot_free_count > 0) {
+        slot = memory_slots + memory_slot_free_list[--memory_slot_free_count];
+        used_count = memory_slot_count - memory_slot_free_count;
+        if (used_count > memory_slot_highmark)
+            memory_slot_highmark = used_count;
+    }
+    os_mutex_unlock(&memory_slot_lock);
+
+    if (!slot)
+        return NULL;
+
+    /* Only change the protection of the pages which differ from the
+       previous user of the slot */
+    if (slot->committed_size > commit_size) {
+        ret = os_mprotect(slot->base + commit_size,
+                          slot->committed_size - commit_size, MMAP_PROT_NONE);
+    }
+    else if (slot->committed_size < commit_size) {
+        ret = os_mprotect(slot->base + slot->committed_size,
+                          commit_size - slot->committed_size,
+                          MMAP_PROT_READ | MMAP_PROT_WRITE);
+    }
+
+    if (ret != 0) {
+        /* The protection of the pages is unknown now, reset the whole
+           committed range and return the slot to the pool, the memory
+           is then mapped outside of the pool */
+        LOG_WARNING("Change protection of linear memory slot %p failed",
+                    slot->base);
+        if (reset_memory_slot(slot, slot->committed_size > commit_size
+                                        ? slot->committed_size
+                                        : commit_size))
+            put_memory_slot(slot);
+        return NULL;
+    }
+
+    slot->committed_size = commit_size;
+    return slot->base;
+}
+
+static bool
+release_memory_slot(uint8 *memory_data, uint64 memory_data_size)
+{
+    LinearMemorySlot *slot = find_memory_slot(memory_data);
+    uint64 page_size = os_getpagesize();
+
+    if (!slot)
+        return false;
+
+    bh_assert(memory_data == slot->base);
+
+    /* The memory may have been enlarged since the slot was acquired,
+       so the accessible range is given by its current size */
+    memory_data_size = align_as_and_cast(memory_data_size, page_size);
+
+    /* Zero the pages but keep them accessible, so that instantiating
+       a module with the same memory size doesn't need to change the
+       protection of the slot again */
+    if (os_mem_discard(slot->base, memory_data_size) == 0) {
+        slot->committed_size = memory_data_size;
+    }
+    else {
+        /* Replace the pages with fresh inaccessible ones instead, the
+           data of the previous user must not leak to the next one */
+        LOG_WARNING("Discard linear memory slot %p failed", slot->base);
+        if (!reset_memory_slot(slot, slot->committed_size > memory_data_size
+                                         ? slot->committed_size
+                                         : memory_data_size))
+            /* Keep the slot reserved but out of the pool */
+            return true;
+    }
+
+    put_memory_slot(slot);
+    return true;
+}
+
+bool
+wasm_runtime_get_memory_slot_info(memory_slot_info_t *memory_slot_info)
+{
+    if (memory_slot_count == 0)
+        return false;
+
+    os_mutex_lock(&memory_slot_lock);
+    memory_slot_info->slot_count = memory_slot_count;
+    memory_slot_info->free_slot_count = memory_slot_free_count;
+    memory_slot_info->highmark_slot_count = memory_slot_highmark;
+    os_mutex_unlock(&memory_slot_lock);
+    return true;
+}
+#else  /* else of OS_ENABLE_HW_BOUND_CHECK && OS_ENABLE_MEM_DISCARD */
+bool
+wasm_runtime_memory_slots_init(uint32 slot_count)
+{
+    if (slot_count > 0)
+        LOG_WARNING("warning: linear memory slots are not supported on "
+                    "this platform or with WASM_MEM_ALLOC_WITH_USAGE");
+    return true;
+}
+
+bool
+wasm_runtime_memory_in_slot(const uint8 *memory_data)
+{
+    (void)memory_data;
+    return false;
+}
+#endif /* end of OS_ENABLE_HW_BOUND_CHECK && OS_ENABLE_MEM_DISCARD */
+
+/* The instance slots hold the module instance structures, which have the
+   memory instances, the global data and the table data appended, so they
+   also serve as the table slots. They are carved from one mapping. */
+static uint8 *instance_slots = NULL;
+static uint64 instance_slots_size = 0;
+/* Size of the instance held by each slot, the bytes to zero when the
+   slot is released */
+static uint32 *instance_slot_used_sizes = NULL;
+/* Stack of the free slot indexes, the slot released most recently
+   is reused first */
+static uint32 *instance_slot_free_list = NULL;
+static uint32 instance_slot_count = 0;
+static uint32 instance_slot_size = 0;
+static uint32 instance_slot_free_count = 0;
+static uint32 instance_slot_highmark = 0;
+static korp_mutex instance_slot_lock;
+
+static void
+destroy_instance_slots(void)
+{
+    if (!instance_slots)
+        return;
+
+    os_munmap(instance_slots, instance_slots_size);
+    os_mutex_destroy(&instance_slot_lock);
+    wasm_runtime_free(instance_slot_used_sizes);
+
+    instance_slots = NULL;
+    instance_slots_size = 0;
+    instance_slot_used_sizes = NULL;
+    instance_slot_free_list = NULL;
+    instance_slot_count = instance_slot_size = 0;
+    instance_slot_free_count = instance_slot_highmark = 0;
+}
+
+bool
+wasm_runtime_instance_slots_init(uint32 slot_count, uint32 slot_size)
+{
+    uint64 page_size = os_getpagesize(), total_size;
+    uint32 i;
+
+    if (slot_count == 0 || slot_size == 0)
+        return true;
+
+    slot_size = (uint32)align_as_and_cast(slot_size, page_size);
+    total_size = (uint64)slot_size * slot_count;
+    if (total_size >= UINT32_MAX
+        || !(instance_slots =
+                 os_mmap(NULL, total_size, MMAP_PROT_READ | MMAP_PROT_WRITE,
+                         MMAP_MAP_NONE, os_get_invalid_handle()))) {
+        LOG_ERROR("Reserve instance slots failed");
+        instance_slots = NULL;
+        return false;
+    }
+
+    if (!(instance_slot_used_sizes =
+              wasm_runtime_malloc(sizeof(uint32) * 2 * slot_count))) {
+        LOG_ERROR("Allocate instance slots failed");
+        os_munmap(instance_slots, total_size);
+        instance_slots = NULL;
+        return false;
+    }
+    memset(instance_slot_used_sizes, 0, sizeof(uint32) * 2 * slot_count);
+    instance_slot_free_list = instance_slot_used_sizes + slot_count;
+
+    if (os_mutex_init(&instance_slot_lock) != 0) {
+        wasm_runtime_free(instance_slot_used_sizes);
+        os_munmap(instance_slots, total_size);
+        instance_slots = NULL;
+        return false;
+    }
+
+    instance_slots_size = total_size;
+    instance_slot_count = slot_count;
+    instance_slot_size = slot_size;
+    for (i = 0; i < slot_count; i++)
+        instance_slot_free_list[i] = slot_count - 1 - i;
+    instance_slot_free_count = slot_count;
+    return true;
+}
+
+void *
+wasm_runtime_instance_slot_malloc(uint64 size)
+{
+    uint32 index, used_count;
+
+    if (instance_slot_count == 0 || size == 0 || size > instance_slot_size)
+        return NULL;
+
+    os_mutex_lock(&instance_slot_lock);
+    if (instance_slot_free_count == 0) {
+        os_mutex_unlock(&instance_slot_lock);
+        return NULL;
+    }
+    index = instance_slot_free_list[--instance_slot_free_count];
+    used_count = instance_slot_count - instance_slot_free_count;
+    if (used_count > instance_slot_highmark)
+        instance_slot_highmark = used_count;
+    os_mutex_unlock(&instance_slot_lock);
+
+    /* The slot was zeroed when it was released */
+    instance_slot_used_sizes[index] = (uint32)size;
+    return instance_slots + (uint64)instance_slot_size * index;
+}
+
+bool
+wasm_runtime_instance_slot_free(void *ptr)
+{
+    uint8 *addr = (uint8 *)ptr;
+    uint32 index;
+
+    if (!instance_slots || addr < instance_slots
+        || addr >= instance_slots + instance_slots_size)
+        return false;
+
+    index = (uint32)((uint64)(addr - instance_slots) / instance_slot_size);
+    bh_assert(addr == instance_slots + (uint64)instance_slot_size * index);
+
+#ifdef OS_ENABLE_MEM_DISCARD
+    if (os_mem_discard(addr, instance_slot_used_sizes[index]) != 0)
+#endif
+        memset(addr, 0, instance_slot_used_sizes[index]);
+    instance_slot_used_sizes[index] = 0;
+
+    os_mutex_lock(&instance_slot_lock);
+    instance_slot_free_list[instance_slot_free_count++] = index;
+    os_mutex_unlock(&instance_slot_lock);
+    return true;
+}
+
+bool
+wasm_runtime_get_instance_slot_info(memory_slot_info_t *instance_slot_info)
+{
+    if (instance_slot_count == 0)
+        return false;
+
+    os_mutex_lock(&instance_slot_lock);
+    instance_slot_info->slot_count = instance_slot_count;
+    instance_slot_info->free_slot_count = instance_slot_free_count;
+    instance_slot_info->highmark_slot_count = instance_slot_highmark;
+    os_mutex_unlock(&instance_slot_lock);
+    return true;
+}
+#endif /* end of WASM_ENABLE_LINEAR_MEMORY_POOL != 0 */
+
+#ifndef LINEAR_MEMORY_SLOT_SUPPORTED
+bool
+wasm_runtime_get_memory_slot_info(memory_slot_info_t *memory_slot_info)
+{
+    (void)memory_slot_info;
+    return false;
+}
+#endif
+
+#if WASM_ENABLE_LINEAR_MEMORY_POOL == 0
+bool
+wasm_runtime_get_instance_slot_info(memory_slot_info_t *instance_slot_info)
+{
+    (void)instance_slot_info;
+    return false;
+}
+#endif
+
 bool
 wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
                          const MemAllocOption *alloc_option)
@@ -918,6 +1367,12 @@ wasm_runtime_memory_destroy(void)
 #if WASM_ENABLE_SHARED_HEAP != 0
     destroy_shared_heaps();
 #endif
+#ifdef LINEAR_MEMORY_SLOT_SUPPORTED
+    destroy_memory_slots();
+#endif
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    destroy_instance_slots();
+#endif
 
     if (memory_mode == MEMORY_MODE_POOL) {
 #if BH_ENABLE_GC_VERIFY == 0
@@ -942,15 +1397,48 @@ wasm_runtime_memory_pool_size(void)
         return UINT32_MAX;
 }
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+void
+wasm_runtime_memory_init_thread_cache(void)
+{
+#ifdef POOL_ALLOC_THREAD_CACHE
+    if (memory_mode != MEMORY_MODE_POOL || get_pool_alloc_cache())
+        return;
+
+    /* The allocations go to the heap directly if it fails */
+    pool_alloc_cache = mem_allocator_cache_init(
+        pool_allocator, pool_alloc_cache_buf, sizeof(pool_alloc_cache_buf));
+#endif
+}
+
+void
+wasm_runtime_memory_destroy_thread_cache(void)
+{
+#ifdef POOL_ALLOC_THREAD_CACHE
+    if (get_pool_alloc_cache())
+        mem_allocator_cache_destroy(pool_alloc_cache);
+    pool_alloc_cache = NULL;
+#endif
+}
+#endif
+
 static inline void *
 wasm_runtime_malloc_internal(unsigned int size)
 {
+#ifdef POOL_ALLOC_THREAD_CACHE
+    mem_allocator_cache_t cache;
+#endif
+
     if (memory_mode == MEMORY_MODE_UNKNOWN) {
         LOG_WARNING(
             "wasm_runtime_malloc failed: memory hasn't been initialized.\n");
         return NULL;
     }
     else if (memory_mode == MEMORY_MODE_POOL) {
+#ifdef POOL_ALLOC_THREAD_CACHE
+        if ((cache = get_pool_alloc_cache()))
+            return mem_allocator_cache_malloc(cache, size);
+#endif
         return mem_allocator_malloc(pool_allocator, size);
     }
     else if (memory_mode == MEMORY_MODE_ALLOCATOR) {
@@ -1000,6 +1488,10 @@ wasm_runtime_realloc_internal(void *ptr, unsigned int size)
 static inline void
 wasm_runtime_free_internal(void *ptr)
 {
+#ifdef POOL_ALLOC_THREAD_CACHE
+    mem_allocator_cache_t cache;
+#endif
+
     if (!ptr) {
         LOG_WARNING("warning: wasm_runtime_free with NULL pointer\n");
 #if BH_ENABLE_GC_VERIFY != 0
@@ -1013,6 +1505,12 @@ wasm_runtime_free_internal(void *ptr)
                     "memory hasn't been initialize.\n");
     }
     else if (memory_mode == MEMORY_MODE_POOL) {
+#ifdef POOL_ALLOC_THREAD_CACHE
+        if ((cache = get_pool_alloc_cache())) {
+            mem_allocator_cache_free(cache, ptr);
+            return;
+        }
+#endif
         mem_allocator_free(pool_allocator, ptr);
     }
     else if (memory_mode == MEMORY_MODE_ALLOCATOR) {
@@ -2049,8 +2547,12 @@ wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 #endif
               memory_inst->memory_data);
 #else
-    wasm_munmap_linear_memory(memory_inst->memory_data,
-                              memory_inst->memory_data_size, map_size);
+#ifdef LINEAR_MEMORY_SLOT_SUPPORTED
+    if (!release_memory_slot(memory_inst->memory_data,
+                             memory_inst->memory_data_size))
+#endif
+        wasm_munmap_linear_memory(memory_inst->memory_data,
+                                  memory_inst->memory_data_size, map_size);
 #endif
 
     memory_inst->memory_data = NULL;
@@ -2103,10 +2605,19 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
                                   *memory_data_size))) {
             return BHT_ERROR;
         }
+#else
+#ifdef LINEAR_MEMORY_SLOT_SUPPORTED
+        /* Map a new region when all the slots are in use */
+        if (!(*data = acquire_memory_slot(*memory_data_size))
+            && !(*data =
+                     wasm_mmap_linear_memory(map_size, *memory_data_size))) {
+            return BHT_ERROR;
+        }
 #else
         if (!(*data = wasm_mmap_linear_memory(map_size, *memory_data_size))) {
             return BHT_ERROR;
         }
+#endif
 #endif
     }
 
@@ -130,9 +130,42 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
 void
 wasm_runtime_memory_destroy(void);
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/* Put a cache of freed small objects of the calling thread in front of
+   the global pool heap, the thread must destroy it before exiting */
+void
+wasm_runtime_memory_init_thread_cache(void);
+
+void
+wasm_runtime_memory_destroy_thread_cache(void);
+#endif
+
 unsigned
 wasm_runtime_memory_pool_size(void);
 
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+/* Reserve the linear memory slots, called at runtime initialization */
+bool
+wasm_runtime_memory_slots_init(uint32 slot_count);
+
+/* Whether the linear memory data is allocated from a reserved slot */
+bool
+wasm_runtime_memory_in_slot(const uint8 *memory_data);
+
+/* Reserve the instance slots, called at runtime initialization */
+bool
+wasm_runtime_instance_slots_init(uint32 slot_count, uint32 slot_size);
+
+/* Take a zeroed instance slot for a module instance structure of the
+   given size, return NULL if it doesn't fit or no slot is free */
+void *
+wasm_runtime_instance_slot_malloc(uint64 size);
+
+/* Return the slot to the pool, return false if ptr isn't in a slot */
+bool
+wasm_runtime_instance_slot_free(void *ptr);
+#endif
+
 void
 wasm_runtime_set_mem_bound_check_bytes(WASMMemoryInstance *memory,
                                        uint64 memory_data_size);
@@ -21,6 +21,10 @@
 
 static NativeSymbolsList g_native_symbols_list = NULL;
 
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+static NativeBitcodeList g_native_bitcode_list = NULL;
+#endif
+
 #if WASM_ENABLE_LIBC_WASI != 0
 static void *g_wasi_context_key;
 #endif /* WASM_ENABLE_LIBC_WASI */
@@ -324,6 +328,54 @@ wasm_native_unregister_natives(const char *module_name,
     return false;
 }
 
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+bool
+wasm_native_register_bitcode(const char *module_name, const uint8 *buf,
+                             uint32 size)
+{
+    NativeBitcodeNode *node;
+
+    if (!module_name || !buf || size == 0)
+        return false;
+
+    if (!(node = wasm_runtime_malloc(sizeof(NativeBitcodeNode))))
+        return false;
+
+    node->module_name = module_name;
+    node->buf = buf;
+    node->size = size;
+
+    /* Add to list head */
+    node->next = g_native_bitcode_list;
+    g_native_bitcode_list = node;
+    return true;
+}
+
+bool
+wasm_native_unregister_bitcode(const char *module_name, const uint8 *buf)
+{
+    NativeBitcodeNode **prevp;
+    NativeBitcodeNode *node;
+
+    prevp = &g_native_bitcode_list;
+    while ((node = *prevp) != NULL) {
+        if (node->buf == buf && !strcmp(node->module_name, module_name)) {
+            *prevp = node->next;
+            wasm_runtime_free(node);
+            return true;
+        }
+        prevp = &node->next;
+    }
+    return false;
+}
+
+NativeBitcodeList
+wasm_native_get_bitcode_list(void)
+{
+    return g_native_bitcode_list;
+}
+#endif
+
 #if WASM_ENABLE_MODULE_INST_CONTEXT != 0
 static uint32
 context_key_to_idx(void *key)
@@ -659,6 +711,14 @@ wasm_native_destroy()
     }
 
     g_native_symbols_list = NULL;
+
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+    while (g_native_bitcode_list) {
+        NativeBitcodeNode *bitcode_node = g_native_bitcode_list;
+        g_native_bitcode_list = bitcode_node->next;
+        wasm_runtime_free(bitcode_node);
+    }
+#endif
 }
 
 #if WASM_ENABLE_QUICK_AOT_ENTRY != 0
@@ -1568,4 +1628,17 @@ wasm_native_lookup_quick_aot_entry(const WASMFuncType *func_type)
 
     return NULL;
 }
+
+void *
+wasm_native_lookup_quick_native_entry(const WASMFuncType *func_type,
+                                      const char *signature)
+{
+    /* Pointer and string params must be validated and converted by
+       wasm_runtime_invoke_native, other params are passed as is, so
+       the quick entry of the function type can be used directly */
+    if (signature && (strchr(signature, '*') || strchr(signature, '$')))
+        return NULL;
+
+    return func_type->quick_aot_entry;
+}
 #endif /* end of WASM_ENABLE_QUICK_AOT_ENTRY != 0 */
@@ -22,6 +22,15 @@ typedef struct NativeSymbolsNode {
     bool call_conv_raw;
 } NativeSymbolsNode, *NativeSymbolsList;
 
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+typedef struct NativeBitcodeNode {
+    struct NativeBitcodeNode *next;
+    const char *module_name;
+    const uint8 *buf;
+    uint32 size;
+} NativeBitcodeNode, *NativeBitcodeList;
+#endif
+
 /**
  * Lookup global variable of a given import global
  * from libc builtin globals
@@ -69,6 +78,20 @@ bool
 wasm_native_unregister_natives(const char *module_name,
                                NativeSymbol *native_symbols);
 
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+bool
+wasm_native_register_bitcode(const char *module_name, const uint8 *buf,
+                             uint32 size);
+
+bool
+wasm_native_unregister_bitcode(const char *module_name, const uint8 *buf);
+
+/* Get the LLVM bitcode of host functions registered, which the LLVM
+   JIT and AOT compiler link into the module to inline import calls */
+NativeBitcodeList
+wasm_native_get_bitcode_list(void);
+#endif
+
 #if WASM_ENABLE_MODULE_INST_CONTEXT != 0
 struct WASMModuleInstanceCommon;
 
@@ -108,6 +131,12 @@ wasm_native_destroy(void);
 #if WASM_ENABLE_QUICK_AOT_ENTRY != 0
 void *
 wasm_native_lookup_quick_aot_entry(const WASMFuncType *func_type);
+
+/* Get the quick entry to call a native symbol linked with the given
+   signature, or NULL if its params require pointer/string conversion */
+void *
+wasm_native_lookup_quick_native_entry(const WASMFuncType *func_type,
+                                      const char *signature);
 #endif
 
 #ifdef __cplusplus
@@ -21,6 +21,7 @@
 #endif
 #if WASM_ENABLE_GC != 0
 #include "gc/gc_object.h"
+#include "mem_alloc.h"
 #endif
 #if WASM_ENABLE_THREAD_MGR != 0
 #include "../libraries/thread-mgr/thread_manager.h"
@@ -37,6 +38,9 @@
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
 #include "../compilation/aot_llvm.h"
 #endif
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+#include "wasm_jit_cache.h"
+#endif
 #include "../common/wasm_c_api_internal.h"
 #include "../../version.h"
 
@@ -735,6 +739,10 @@ wasm_runtime_destroy_internal(void)
     wasm_native_destroy();
     bh_platform_destroy();
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    wasm_jit_cache_destroy();
+#endif
+
     wasm_runtime_memory_destroy();
 }
 
@@ -790,6 +798,20 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
         return false;
     }
 
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    if (!wasm_runtime_memory_slots_init(init_args->linear_memory_slot_count)
+        || !wasm_runtime_instance_slots_init(init_args->instance_slot_count,
+                                             init_args->instance_slot_size)) {
+        wasm_runtime_memory_destroy();
+        return false;
+    }
+#else
+    if (init_args->linear_memory_slot_count > 0
+        || init_args->instance_slot_count > 0)
+        LOG_WARNING("warning: to enable linear memory and instance slots, "
+                    "please recompile with -DWAMR_BUILD_LINEAR_MEMORY_POOL=1");
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0
     jit_options.code_cache_size = init_args->fast_jit_code_cache_size;
 #endif
@@ -820,6 +842,17 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
         return false;
     }
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    if (!wasm_jit_cache_init(init_args->llvm_jit_cache_dir)) {
+        wasm_runtime_destroy();
+        return false;
+    }
+#else
+    if (init_args->llvm_jit_cache_dir)
+        LOG_WARNING("warning: to enable llvm jit code cache, please recompile "
+                    "with -DWAMR_BUILD_LLVM_JIT_CACHE=1");
+#endif
+
 #if WASM_ENABLE_DEBUG_INTERP != 0
     if (strlen(init_args->ip_addr))
         if (!wasm_debug_engine_init(init_args->ip_addr,
@@ -896,8 +929,9 @@ wasm_runtime_is_running_mode_supported(RunningMode running_mode)
 #endif
     }
     else if (running_mode == Mode_Multi_Tier_JIT) {
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
-    && WASM_ENABLE_LAZY_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+     && WASM_ENABLE_LAZY_JIT != 0)                         \
+    || WASM_ENABLE_TIERED_JIT != 0
         return true;
 #endif
     }
@@ -1510,6 +1544,21 @@ wasm_runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
     }
 
     if (package_type == Wasm_Module_Bytecode) {
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+        char cache_file_path[WASM_JIT_CACHE_PATH_SIZE];
+        bool jit_cache_enabled = wasm_jit_cache_get_file_path(
+            buf, size, cache_file_path, sizeof(cache_file_path));
+
+        /* Load the AOT file compiled from the wasm binary before, or
+           compile it now and load it instead of loading the wasm binary
+           with LLVM JIT */
+        if (jit_cache_enabled
+            && ((module_common = wasm_jit_cache_load(cache_file_path, args))
+                || (module_common = wasm_jit_cache_compile(
+                        cache_file_path, buf, size, args))))
+            return register_module_with_null_name(module_common, error_buf,
+                                                  error_buf_size);
+#endif
 #if WASM_ENABLE_INTERP != 0
         module_common =
             (WASMModuleCommon *)wasm_load(buf, size,
@@ -1542,6 +1591,156 @@ wasm_runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
                                           error_buf_size);
 }
 
+#ifdef OS_ENABLE_FILE_MMAP
+/* Map the module file with private copy-on-write pages, the loader only
+   writes to a few of them (e.g. to terminate the const strings) and the
+   others are shared with the page cache */
+static uint8 *
+map_module_file(const char *path, uint64 *p_size, char *error_buf,
+                uint32 error_buf_size)
+{
+    os_file_handle file;
+    uint64 size = 0;
+    uint8 *buf = NULL;
+    int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE;
+
+    if ((file = os_mmap_file_open(path, &size)) == os_get_invalid_handle()) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: open file failed");
+        return NULL;
+    }
+
+    if (size < 4 || size > UINT32_MAX) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: invalid file size");
+        goto fail;
+    }
+
+    if (!(buf = os_mmap_file(NULL, (size_t)size, map_prot, MMAP_MAP_NONE,
+                             file, 0))) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: mmap file failed");
+        goto fail;
+    }
+
+#if WASM_ENABLE_AOT != 0
+    /* The text of the XIP file is executed in place, map it again in the
+       low 2GB like the XIP buffer of iwasm, it is made executable and no
+       longer writable once the loader has patched it */
+    if (wasm_runtime_is_xip_file(buf, (uint32)size)) {
+        os_munmap(buf, (size_t)size);
+        if (!(buf = os_mmap_file(NULL, (size_t)size, map_prot,
+                                 MMAP_MAP_32BIT, file, 0))) {
+            set_error_buf(error_buf, error_buf_size,
+                          "WASM module load failed: mmap file failed");
+            goto fail;
+        }
+    }
+#endif
+
+    *p_size = size;
+fail:
+    os_mmap_file_close(file);
+    return buf;
+}
+
+#if WASM_ENABLE_AOT != 0
+/* Make the pages of the code of the XIP module mapped from file read-only
+   and executable, the pages not patched by the relocations are never
+   copied, and keep shared with the page cache and with the other
+   processes mapping the same file, see wamrc --shared-text */
+static bool
+protect_xip_text(AOTModule *module, char *error_buf, uint32 error_buf_size)
+{
+    uintptr_t page_size = (uintptr_t)os_getpagesize();
+    uintptr_t start = (uintptr_t)module->code & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t)module->code + module->code_size
+                     + page_size - 1)
+                    & ~(page_size - 1);
+
+    if (!module->is_indirect_mode || module->code_size == 0)
+        return true;
+
+    if (os_mprotect((void *)start, end - start,
+                    MMAP_PROT_READ | MMAP_PROT_EXEC)
+        != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: "
+                      "make the text of the XIP module executable failed");
+        return false;
+    }
+    return true;
+}
+#endif
+#endif /* end of OS_ENABLE_FILE_MMAP */
+
+WASMModuleCommon *
+wasm_runtime_load_from_file(const char *path, const LoadArgs *args,
+                            char *error_buf, uint32 error_buf_size)
+{
+#ifdef OS_ENABLE_FILE_MMAP
+    WASMModuleCommon *module_common;
+    LoadArgs load_args;
+    uint64 size = 0;
+    uint8 *buf;
+
+    if (!args) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: null load arguments");
+        return NULL;
+    }
+
+    if (!(buf = map_module_file(path, &size, error_buf, error_buf_size)))
+        return NULL;
+
+    /* Let the loader refer to the mapped file rather than copy from it */
+    load_args = *args;
+    load_args.wasm_binary_freeable = false;
+    if (!(module_common = wasm_runtime_load_ex(buf, (uint32)size, &load_args,
+                                               error_buf, error_buf_size))) {
+        os_munmap(buf, (size_t)size);
+        return NULL;
+    }
+
+    /* The mapping is owned by the module and unmapped when it is unloaded,
+       unless the module doesn't refer to it, e.g. it is loaded from the
+       LLVM JIT cache */
+#if WASM_ENABLE_INTERP != 0
+    if (module_common->module_type == Wasm_Module_Bytecode
+        && !((WASMModule *)module_common)->is_binary_freeable) {
+        ((WASMModule *)module_common)->mapped_file_buf = buf;
+        ((WASMModule *)module_common)->mapped_file_size = size;
+        buf = NULL;
+    }
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_common->module_type == Wasm_Module_AoT
+        && !((AOTModule *)module_common)->is_binary_freeable) {
+        ((AOTModule *)module_common)->mapped_file_buf = buf;
+        ((AOTModule *)module_common)->mapped_file_size = size;
+        buf = NULL;
+        if (!protect_xip_text((AOTModule *)module_common, error_buf,
+                              error_buf_size)) {
+            /* The mapping is unmapped with the module */
+            wasm_runtime_unload(module_common);
+            return NULL;
+        }
+    }
+#endif
+    if (buf)
+        os_munmap(buf, (size_t)size);
+
+    return module_common;
+#else
+    (void)path;
+    (void)args;
+    set_error_buf(error_buf, error_buf_size,
+                  "WASM module load failed: "
+                  "loading from file isn't supported by the platform");
+    return NULL;
+#endif
+}
+
 bool
 wasm_runtime_resolve_symbols(WASMModuleCommon *module)
 {
@@ -1872,8 +2071,17 @@ wasm_runtime_set_running_mode(wasm_module_inst_t module_inst,
                               RunningMode running_mode)
 {
 #if WASM_ENABLE_AOT != 0
-    if (module_inst->module_type == Wasm_Module_AoT)
+    if (module_inst->module_type == Wasm_Module_AoT) {
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+        /* The module loaded from the LLVM JIT cache runs the code compiled
+           by LLVM and can't switch to the other running modes */
+        if (((AOTModule *)((AOTModuleInstance *)module_inst)->module)
+                ->is_llvm_jit_cache)
+            return running_mode == Mode_Default
+                   || running_mode == Mode_LLVM_JIT;
+#endif
         return true;
+    }
 #endif
 
 #if WASM_ENABLE_INTERP != 0
@@ -1899,6 +2107,13 @@ wasm_runtime_get_running_mode(wasm_module_inst_t module_inst)
     }
 #endif
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    if (module_inst->module_type == Wasm_Module_AoT
+        && ((AOTModule *)((AOTModuleInstance *)module_inst)->module)
+               ->is_llvm_jit_cache)
+        return Mode_LLVM_JIT;
+#endif
+
     return Mode_Default;
 }
 
@@ -1987,12 +2202,20 @@ wasm_runtime_init_thread_env(void)
     os_end_blocking_op();
 #endif
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    wasm_runtime_memory_init_thread_cache();
+#endif
+
     return true;
 }
 
 void
 wasm_runtime_destroy_thread_env(void)
 {
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    wasm_runtime_memory_destroy_thread_cache();
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     runtime_signal_destroy();
 #endif
@@ -2480,6 +2703,138 @@ wasm_runtime_set_instruction_count_limit(WASMExecEnv *exec_env,
 {
     exec_env->instructions_to_execute = instructions_to_execute;
 }
+
+int
+wasm_runtime_get_instruction_count_limit(WASMExecEnv *exec_env)
+{
+    return exec_env->instructions_to_execute;
+}
+
+void
+wasm_runtime_set_instruction_limit_callback(
+    WASMExecEnv *exec_env, instruction_limit_callback_t callback,
+    void *user_data)
+{
+    exec_env->instruction_limit_callback = callback;
+    exec_env->instruction_limit_user_data = user_data;
+}
+
+bool
+wasm_runtime_check_instruction_limit(WASMExecEnv *exec_env, uint32 count)
+{
+    int instructions_left;
+
+    while ((instructions_left = exec_env->instructions_to_execute) >= 0) {
+        if ((uint32)instructions_left >= count) {
+            exec_env->instructions_to_execute =
+                instructions_left - (int)count;
+            return true;
+        }
+
+        /* Consume what is left and let the callback refill the count,
+           it may also yield the thread before returning */
+        count -= (uint32)instructions_left;
+        exec_env->instructions_to_execute = 0;
+        if (!exec_env->instruction_limit_callback
+            || !exec_env->instruction_limit_callback(
+                exec_env, exec_env->instruction_limit_user_data)
+            || exec_env->instructions_to_execute == 0) {
+            wasm_runtime_set_exception(exec_env->module_inst,
+                                       "instruction limit exceeded");
+            return false;
+        }
+    }
+
+    /* The limit was removed */
+    return true;
+}
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* The global epoch counter shared by all the module instances */
+static bh_atomic_64_t runtime_epoch = 0;
+
+static uint64 *
+get_epoch_deadline_addr(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return &((WASMModuleInstance *)module_inst)->e->epoch_deadline;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return &((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                     ->e)
+                    ->epoch_deadline;
+#endif
+    bh_assert(0);
+    return NULL;
+}
+
+void
+wasm_runtime_increment_epoch(void)
+{
+    BH_ATOMIC_64_FETCH_ADD(runtime_epoch, 1);
+}
+
+uint64
+wasm_runtime_get_epoch(void)
+{
+    return BH_ATOMIC_64_LOAD(runtime_epoch);
+}
+
+const uint64 *
+wasm_runtime_get_epoch_addr(void)
+{
+    return (const uint64 *)&runtime_epoch;
+}
+
+void
+wasm_runtime_set_epoch_deadline(WASMModuleInstanceCommon *module_inst,
+                                uint64 ticks_beyond_current)
+{
+    uint64 epoch = BH_ATOMIC_64_LOAD(runtime_epoch);
+
+    /* Saturate the deadline, UINT64_MAX is never reached */
+    *get_epoch_deadline_addr(module_inst) =
+        ticks_beyond_current < UINT64_MAX - epoch ? epoch + ticks_beyond_current
+                                                  : UINT64_MAX;
+}
+
+void
+wasm_runtime_set_epoch_deadline_callback(WASMModuleInstanceCommon *module_inst,
+                                         epoch_deadline_callback_t callback,
+                                         void *user_data)
+{
+    WASMModuleInstanceExtraCommon *e =
+        GetModuleInstanceExtraCommon((WASMModuleInstance *)module_inst);
+
+    e->epoch_deadline_callback = callback;
+    e->epoch_deadline_user_data = user_data;
+}
+
+bool
+wasm_runtime_check_epoch_deadline(WASMExecEnv *exec_env)
+{
+    WASMModuleInstanceCommon *module_inst = exec_env->module_inst;
+    WASMModuleInstanceExtraCommon *e =
+        GetModuleInstanceExtraCommon((WASMModuleInstance *)module_inst);
+    uint64 *p_deadline = get_epoch_deadline_addr(module_inst);
+
+    /* The fast path may have read a torn epoch on 32-bit targets */
+    if (BH_ATOMIC_64_LOAD(runtime_epoch) < *p_deadline)
+        return true;
+
+    /* Let the callback extend the deadline, it may also yield the
+       thread before returning */
+    if (e->epoch_deadline_callback
+        && e->epoch_deadline_callback(exec_env, e->epoch_deadline_user_data)
+        && BH_ATOMIC_64_LOAD(runtime_epoch) < *p_deadline)
+        return true;
+
+    wasm_runtime_set_exception(module_inst, "epoch deadline reached");
+    return false;
+}
 #endif
 
 WASMFuncType *
@@ -3363,6 +3718,229 @@ wasm_runtime_terminate(WASMModuleInstanceCommon *module_inst_comm)
     wasm_set_exception(module_inst, "terminated by user");
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/* The size of the exception values and, when GC is enabled, of their ref
+   flags following them */
+static uint32
+get_exce_values_size(uint32 cell_num)
+{
+#if WASM_ENABLE_GC == 0
+    return (uint32)sizeof(uint32) * cell_num;
+#else
+    return ((uint32)sizeof(uint32) + 1) * cell_num;
+#endif
+}
+
+#if WASM_ENABLE_GC != 0
+/* Keep the copy of the exception caught into buf until the catch clause
+   is left, so that its GC references are roots */
+static bool
+keep_caught_exception(WASMModuleInstanceExtraCommon *e, const uint32 *buf,
+                      const uint32 *values, uint32 cell_num)
+{
+    WASMCaughtException *caught, **p_caught = &e->caught_exceptions;
+    const uint8 *ref_flags = (const uint8 *)(values + cell_num);
+    uint32 i;
+
+    /* Remove the exception caught into the same buffer before, and the
+       ones of the native frames which have returned, they are below
+       the frame of this function */
+    while ((caught = *p_caught)) {
+        if (caught->buf == buf || (uint8 *)caught->buf < (uint8 *)&p_caught) {
+            *p_caught = caught->next;
+            wasm_runtime_free(caught);
+        }
+        else {
+            p_caught = &caught->next;
+        }
+    }
+
+    for (i = 0; i < cell_num; i++) {
+        if (ref_flags[i])
+            break;
+    }
+    if (i == cell_num)
+        return true;
+
+    if (!(caught = wasm_runtime_malloc(
+              (uint32)offsetof(WASMCaughtException, values)
+              + get_exce_values_size(cell_num))))
+        return false;
+    caught->buf = buf;
+    caught->cell_num = cell_num;
+    bh_memcpy_s(caught->values, get_exce_values_size(cell_num), values,
+                get_exce_values_size(cell_num));
+    caught->next = e->caught_exceptions;
+    e->caught_exceptions = caught;
+    return true;
+}
+
+static bool
+exception_values_traverse_gc_rootset(const uint32 *values, uint32 cell_num,
+                                     void *heap)
+{
+    const uint8 *ref_flags = (const uint8 *)(values + cell_num);
+    WASMObjectRef gc_obj;
+    uint32 i;
+
+    for (i = 0; i < cell_num; i++) {
+        if (ref_flags[i]) {
+            gc_obj = GET_REF_FROM_ADDR(values + i);
+            if (wasm_obj_is_created_from_heap(gc_obj)) {
+                if (mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+                    return false;
+            }
+#if UINTPTR_MAX == UINT64_MAX
+            bh_assert(ref_flags[i + 1]);
+            i++;
+#endif
+        }
+    }
+    return true;
+}
+
+bool
+wasm_runtime_exception_traverse_gc_rootset(
+    WASMModuleInstanceCommon *module_inst_comm, void *heap)
+{
+    WASMModuleInstanceExtraCommon *e =
+        GetModuleInstanceExtraCommon((WASMModuleInstance *)module_inst_comm);
+    WASMCaughtException *caught;
+
+    if (e->exce_value_cell_num > 0
+        && !exception_values_traverse_gc_rootset(
+            e->exce_values, e->exce_value_cell_num, heap))
+        return false;
+
+    for (caught = e->caught_exceptions; caught; caught = caught->next) {
+        if (!exception_values_traverse_gc_rootset(caught->values,
+                                                  caught->cell_num, heap))
+            return false;
+    }
+    return true;
+}
+#endif /* end of WASM_ENABLE_GC != 0 */
+
+void
+wasm_runtime_throw_exception(WASMModuleInstanceCommon *module_inst_comm,
+                             uint32 tag_index, const uint32 *values,
+                             uint32 cell_num, const uint8 *ref_flags)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMModuleInstanceExtraCommon *e =
+        GetModuleInstanceExtraCommon(module_inst);
+    uint32 *exce_values;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    if (cell_num > e->exce_value_cell_capacity) {
+        if (!(exce_values = wasm_runtime_realloc(
+                  e->exce_values, get_exce_values_size(cell_num)))) {
+            wasm_set_exception(module_inst, "allocate memory failed");
+            return;
+        }
+        e->exce_values = exce_values;
+        e->exce_value_cell_capacity = cell_num;
+    }
+
+    if (cell_num > 0) {
+        bh_memcpy_s(e->exce_values, (uint32)sizeof(uint32) * cell_num, values,
+                    (uint32)sizeof(uint32) * cell_num);
+#if WASM_ENABLE_GC != 0
+        bh_assert(ref_flags);
+        bh_memcpy_s(e->exce_values + cell_num, cell_num, ref_flags, cell_num);
+#endif
+    }
+#if WASM_ENABLE_GC == 0
+    (void)ref_flags;
+#endif
+    e->exce_tag_index = tag_index;
+    e->exce_value_cell_num = cell_num;
+
+    /* The exception is caught by the handlers of this instance or
+       propagated to the caller, don't spread it to the other threads */
+    wasm_set_exception_local(module_inst, "uncaught wasm exception");
+}
+
+uint32
+wasm_runtime_get_exception_tag(WASMModuleInstanceCommon *module_inst_comm)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    uint32 tag_index = INVALID_TAGINDEX;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    exception_lock(module_inst);
+    if (strstr(module_inst->cur_exception, "uncaught wasm exception")) {
+        tag_index = GetModuleInstanceExtraCommon(module_inst)->exce_tag_index;
+    }
+    else if (strstr(module_inst->cur_exception,
+                    "exception thrown by stdc++")) {
+        /* libc_builtin signaled a C++ exception, which is mapped to the
+           first tag like what the interpreter does */
+        WASMModuleInstanceExtraCommon *e =
+            GetModuleInstanceExtraCommon(module_inst);
+
+        e->exce_tag_index = tag_index = 0;
+        e->exce_value_cell_num = 0;
+    }
+    exception_unlock(module_inst);
+
+    return tag_index;
+}
+
+void
+wasm_runtime_catch_exception(WASMModuleInstanceCommon *module_inst_comm,
+                             uint32 *buf)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMModuleInstanceExtraCommon *e =
+        GetModuleInstanceExtraCommon(module_inst);
+    uint32 cell_num = e->exce_value_cell_num;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    buf[0] = e->exce_tag_index;
+    buf[1] = cell_num;
+    if (cell_num > 0)
+        bh_memcpy_s(buf + 2, get_exce_values_size(cell_num), e->exce_values,
+                    get_exce_values_size(cell_num));
+    e->exce_value_cell_num = 0;
+
+    wasm_set_exception_local(module_inst, NULL);
+
+#if WASM_ENABLE_GC != 0
+    if (!keep_caught_exception(e, buf, buf + 2, cell_num))
+        wasm_set_exception(module_inst, "allocate memory failed");
+#endif
+}
+
+void
+wasm_runtime_destroy_exception_values(
+    WASMModuleInstanceCommon *module_inst_comm)
+{
+    WASMModuleInstanceExtraCommon *e =
+        GetModuleInstanceExtraCommon((WASMModuleInstance *)module_inst_comm);
+#if WASM_ENABLE_GC != 0
+    WASMCaughtException *caught, *next;
+
+    for (caught = e->caught_exceptions; caught; caught = next) {
+        next = caught->next;
+        wasm_runtime_free(caught);
+    }
+    e->caught_exceptions = NULL;
+#endif
+
+    if (e->exce_values) {
+        wasm_runtime_free(e->exce_values);
+        e->exce_values = NULL;
+    }
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
 void
 wasm_runtime_set_custom_data_internal(
     WASMModuleInstanceCommon *module_inst_comm, void *custom_data)
@@ -4899,6 +5477,52 @@ wasm_runtime_unregister_natives(const char *module_name,
     return wasm_native_unregister_natives(module_name, native_symbols);
 }
 
+bool
+wasm_runtime_register_native_bitcode(const char *module_name,
+                                     const uint8 *bitcode, uint32 size)
+{
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+    return wasm_native_register_bitcode(module_name, bitcode, size);
+#else
+    (void)module_name;
+    (void)bitcode;
+    (void)size;
+    LOG_WARNING("native bitcode is only used by LLVM JIT and AOT compiler");
+    return false;
+#endif
+}
+
+bool
+wasm_runtime_unregister_native_bitcode(const char *module_name,
+                                       const uint8 *bitcode)
+{
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+    return wasm_native_unregister_bitcode(module_name, bitcode);
+#else
+    (void)module_name;
+    (void)bitcode;
+    return false;
+#endif
+}
+
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+bool
+wasm_runtime_invoke_quick_native(WASMExecEnv *exec_env, void *quick_entry,
+                                 void *func_ptr, void *attachment,
+                                 uint32 *argv, uint32 *argv_ret)
+{
+    WASMModuleInstanceCommon *module = wasm_runtime_get_module_inst(exec_env);
+    void (*invoke_native)(void *func_ptr, void *exec_env, uint32 *argv,
+                          uint32 *argv_ret) = quick_entry;
+
+    exec_env->attachment = attachment;
+    invoke_native(func_ptr, exec_env, argv, argv_ret);
+    exec_env->attachment = NULL;
+
+    return !wasm_runtime_copy_exception(module, NULL);
+}
+#endif
+
 bool
 wasm_runtime_invoke_native_raw(WASMExecEnv *exec_env, void *func_ptr,
                                const WASMFuncType *func_type,
@@ -621,6 +621,12 @@ struct InstantiationArgs2 {
 #if WASM_ENABLE_LIBC_WASI != 0
     WASIArguments wasi;
 #endif
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* Internal flag set by wasm_runtime_instantiate_from_snapshot: the
+       instance state is restored from the snapshot, so don't initialize
+       the memory data or call the start/initialize functions */
+    bool restore_from_snapshot;
+#endif
 };
 
 void
@@ -886,6 +892,70 @@ wasm_runtime_set_native_stack_boundary(WASMExecEnv *exec_env,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_set_instruction_count_limit(WASMExecEnv *exec_env,
                                          int instructions_to_execute);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN int
+wasm_runtime_get_instruction_count_limit(WASMExecEnv *exec_env);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_instruction_limit_callback(
+    WASMExecEnv *exec_env, instruction_limit_callback_t callback,
+    void *user_data);
+
+/**
+ * Charge count instructions from the instruction count limit of the
+ * exec_env, it is the slow path of the instruction metering of the
+ * interpreters and AOTed code, which is called when the count left
+ * isn't enough. The instruction limit callback is called to refill
+ * the count, if it isn't set or it fails, the exception "instruction
+ * limit exceeded" is thrown.
+ *
+ * @return true if the instructions can be executed, false otherwise
+ */
+bool
+wasm_runtime_check_instruction_limit(WASMExecEnv *exec_env, uint32 count);
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_increment_epoch(void);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint64
+wasm_runtime_get_epoch(void);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline(WASMModuleInstanceCommon *module_inst,
+                                uint64 ticks_beyond_current);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline_callback(WASMModuleInstanceCommon *module_inst,
+                                         epoch_deadline_callback_t callback,
+                                         void *user_data);
+
+/**
+ * Get the address of the global epoch counter, which is compared with
+ * the epoch deadline of the module instance by the interpreters and the
+ * jitted/AOTed code.
+ */
+const uint64 *
+wasm_runtime_get_epoch_addr(void);
+
+/**
+ * The slow path of the epoch check at the loop back-edges, which is
+ * called when the epoch deadline of the module instance of exec_env may
+ * have been reached. The epoch deadline callback is called to extend the
+ * deadline, if it isn't set or it fails, the exception "epoch deadline
+ * reached" is thrown.
+ *
+ * @return true if the execution can continue, false otherwise
+ */
+bool
+wasm_runtime_check_epoch_deadline(WASMExecEnv *exec_env);
 #endif
 
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
@@ -974,6 +1044,41 @@ wasm_runtime_clear_exception(WASMModuleInstanceCommon *module_inst);
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_terminate(WASMModuleInstanceCommon *module);
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/* Internal API, throw the wasm exception of tag tag_index with the
+   values of the tag parameters, called by AOT/LLVM JIT code. When GC is
+   enabled, ref_flags marks the cells of the values which are GC
+   references, or else it is NULL */
+void
+wasm_runtime_throw_exception(WASMModuleInstanceCommon *module_inst,
+                             uint32 tag_index, const uint32 *values,
+                             uint32 cell_num, const uint8 *ref_flags);
+
+/* Internal API, get the tag index of the exception in flight, or
+   INVALID_TAGINDEX if it is a trap which can't be caught */
+uint32
+wasm_runtime_get_exception_tag(WASMModuleInstanceCommon *module_inst);
+
+/* Internal API, catch the wasm exception in flight: store its tag index,
+   the cell number of its values and the values into buf, followed by
+   the ref flags of the values when GC is enabled, and clear it */
+void
+wasm_runtime_catch_exception(WASMModuleInstanceCommon *module_inst,
+                             uint32 *buf);
+
+/* Internal API, free the values of the exceptions kept */
+void
+wasm_runtime_destroy_exception_values(WASMModuleInstanceCommon *module_inst);
+
+#if WASM_ENABLE_GC != 0
+/* Internal API, add the GC references of the exception in flight and of
+   the exceptions caught for rethrow to the root set */
+bool
+wasm_runtime_exception_traverse_gc_rootset(
+    WASMModuleInstanceCommon *module_inst, void *heap);
+#endif
+#endif
+
 /* Internal API */
 void
 wasm_runtime_set_custom_data_internal(WASMModuleInstanceCommon *module_inst,
@@ -1309,6 +1414,16 @@ wasm_runtime_invoke_native(WASMExecEnv *exec_env, void *func_ptr,
                            void *attachment, uint32 *argv, uint32 argc,
                            uint32 *ret);
 
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+/* Call a native function through the signature-specialized thunk
+   returned by wasm_native_lookup_quick_native_entry, bypassing the
+   generic argument marshalling of wasm_runtime_invoke_native */
+bool
+wasm_runtime_invoke_quick_native(WASMExecEnv *exec_env, void *quick_entry,
+                                 void *func_ptr, void *attachment,
+                                 uint32 *argv, uint32 *argv_ret);
+#endif
+
 bool
 wasm_runtime_invoke_native_raw(WASMExecEnv *exec_env, void *func_ptr,
                                const WASMFuncType *func_type,
@@ -5,6 +5,7 @@
 
 #include "bh_log.h"
 #include "wasm_shared_memory.h"
+#include "wasm_memory.h"
 #if WASM_ENABLE_THREAD_MGR != 0
 #include "../libraries/thread-mgr/thread_manager.h"
 #endif
@@ -31,6 +32,9 @@ enum {
 /* clang-format on */
 
 typedef struct AtomicWaitInfo {
+    bh_list_link l;
+    /* the address waited on */
+    void *address;
     bh_list wait_list_head;
     bh_list *wait_list;
     /* WARNING: insert to the list allowed only in acquire_wait_info
@@ -43,14 +47,28 @@ typedef struct AtomicWaitNode {
     korp_cond wait_cond;
 } AtomicWaitNode;
 
-/* Atomic wait map */
-static HashMap *wait_map;
+/* The bucket count of the atomic wait map, must be a power of 2 */
+#define WAIT_MAP_BUCKET_NUM 256
 
-static uint32
-wait_address_hash(const void *address);
+/*
+ * The atomic wait map is sharded into buckets by the wait address, each
+ * bucket has its own lock, so that the threads waiting on or notifying
+ * different addresses don't contend for one lock. The addresses are the
+ * native addresses of the linear memories, so the waiters of different
+ * shared memories never share a wait info.
+ */
+typedef struct AtomicWaitBucket {
+    korp_mutex lock;
+    /* Count of the threads waiting on the addresses of this bucket, it is
+       increased by the waiter before it reads the value of the address,
+       so that notify can skip locking the bucket if it is 0 */
+    uint32 waiter_count;
+    /* List of AtomicWaitInfo */
+    bh_list wait_info_list;
+} AtomicWaitBucket;
 
-static bool
-wait_address_equal(void *h1, void *h2);
+/* Atomic wait map */
+static AtomicWaitBucket wait_map[WAIT_MAP_BUCKET_NUM];
 
 static void
 destroy_wait_info(void *wait_info);
@@ -58,14 +76,20 @@ destroy_wait_info(void *wait_info);
 bool
 wasm_shared_memory_init()
 {
+    uint32 i;
+
     if (os_mutex_init(&g_shared_memory_lock) != 0)
         return false;
-    /* wait map not exists, create new map */
-    if (!(wait_map = bh_hash_map_create(32, true, (HashFunc)wait_address_hash,
-                                        (KeyEqualFunc)wait_address_equal, NULL,
-                                        destroy_wait_info))) {
-        os_mutex_destroy(&g_shared_memory_lock);
-        return false;
+
+    for (i = 0; i < WAIT_MAP_BUCKET_NUM; i++) {
+        if (os_mutex_init(&wait_map[i].lock) != 0) {
+            while (i > 0)
+                os_mutex_destroy(&wait_map[--i].lock);
+            os_mutex_destroy(&g_shared_memory_lock);
+            return false;
+        }
+        wait_map[i].waiter_count = 0;
+        bh_list_init(&wait_map[i].wait_info_list);
     }
     return true;
 }
@@ -73,7 +97,19 @@ wasm_shared_memory_init()
 void
 wasm_shared_memory_destroy()
 {
-    bh_hash_map_destroy(wait_map);
+    AtomicWaitInfo *wait_info, *next;
+    uint32 i;
+
+    for (i = 0; i < WAIT_MAP_BUCKET_NUM; i++) {
+        wait_info = bh_list_first_elem(&wait_map[i].wait_info_list);
+        while (wait_info) {
+            next = bh_list_elem_next(wait_info);
+            destroy_wait_info(wait_info);
+            wait_info = next;
+        }
+        bh_list_init(&wait_map[i].wait_info_list);
+        os_mutex_destroy(&wait_map[i].lock);
+    }
     os_mutex_destroy(&g_shared_memory_lock);
 }
 
@@ -110,24 +146,14 @@ shared_memory_dec_reference(WASMMemoryInstance *memory)
     return old - 1;
 }
 
-static korp_mutex *
-shared_memory_get_lock_pointer(WASMMemoryInstance *memory)
-{
-    bh_assert(memory != NULL);
-    return &g_shared_memory_lock;
-}
-
 /* Atomics wait && notify APIs */
-static uint32
-wait_address_hash(const void *address)
+static AtomicWaitBucket *
+get_wait_bucket(const void *address)
 {
-    return (uint32)(uintptr_t)address;
-}
-
-static bool
-wait_address_equal(void *h1, void *h2)
-{
-    return h1 == h2 ? true : false;
+    /* Fibonacci hashing of the address, the low 2 bits are dropped
+       since the address waited on is at least 4-byte aligned */
+    uint32 hash = (uint32)((uintptr_t)address >> 2) * 2654435761U;
+    return &wait_map[hash >> 24];
 }
 
 static bool
@@ -149,39 +175,39 @@ is_wait_node_exists(bh_list *wait_list, AtomicWaitNode *node)
 static uint32
 notify_wait_list(bh_list *wait_list, uint32 count)
 {
-    AtomicWaitNode *node, *next;
-    uint32 i, notify_count = count;
-
-    if (count > wait_list->len)
-        notify_count = wait_list->len;
+    AtomicWaitNode *node;
+    uint32 notify_count = 0;
 
     node = bh_list_first_elem(wait_list);
-    if (!node)
-        return 0;
-
-    for (i = 0; i < notify_count; i++) {
-        bh_assert(node);
-        next = bh_list_elem_next(node);
-
-        node->status = S_NOTIFIED;
-        /* wakeup */
-        os_cond_signal(&node->wait_cond);
 
-        node = next;
+    while (node && notify_count < count) {
+        /* The nodes notified stay in the list until their threads wake up,
+           don't count them again */
+        if (node->status == S_WAITING) {
+            node->status = S_NOTIFIED;
+            /* wakeup */
+            os_cond_signal(&node->wait_cond);
+            notify_count++;
+        }
+        node = bh_list_elem_next(node);
     }
 
     return notify_count;
 }
 
 static AtomicWaitInfo *
-acquire_wait_info(void *address, AtomicWaitNode *wait_node)
+acquire_wait_info(AtomicWaitBucket *bucket, void *address,
+                  AtomicWaitNode *wait_node)
 {
-    AtomicWaitInfo *wait_info = NULL;
+    AtomicWaitInfo *wait_info;
     bh_list_status ret;
 
     bh_assert(address != NULL);
 
-    wait_info = (AtomicWaitInfo *)bh_hash_map_find(wait_map, address);
+    wait_info = bh_list_first_elem(&bucket->wait_info_list);
+    while (wait_info && wait_info->address != address) {
+        wait_info = bh_list_elem_next(wait_info);
+    }
 
     if (!wait_node) {
         return wait_info;
@@ -194,6 +220,7 @@ acquire_wait_info(void *address, AtomicWaitNode *wait_node)
             return NULL;
         }
         memset(wait_info, 0, sizeof(AtomicWaitInfo));
+        wait_info->address = address;
 
         /* init wait list */
         wait_info->wait_list = &wait_info->wait_list_head;
@@ -201,10 +228,9 @@ acquire_wait_info(void *address, AtomicWaitNode *wait_node)
         bh_assert(ret == BH_LIST_SUCCESS);
         (void)ret;
 
-        if (!bh_hash_map_insert(wait_map, address, (void *)wait_info)) {
-            wasm_runtime_free(wait_info);
-            return NULL;
-        }
+        ret = bh_list_insert(&bucket->wait_info_list, wait_info);
+        bh_assert(ret == BH_LIST_SUCCESS);
+        (void)ret;
     }
 
     ret = bh_list_insert(wait_info->wait_list, wait_node);
@@ -235,14 +261,13 @@ destroy_wait_info(void *wait_info)
 }
 
 static void
-map_try_release_wait_info(HashMap *wait_hash_map, AtomicWaitInfo *wait_info,
-                          void *address)
+map_try_release_wait_info(AtomicWaitBucket *bucket, AtomicWaitInfo *wait_info)
 {
     if (wait_info->wait_list->len > 0) {
         return;
     }
 
-    bh_hash_map_remove(wait_hash_map, address, NULL, NULL);
+    bh_list_remove(&bucket->wait_info_list, wait_info);
     destroy_wait_info(wait_info);
 }
 
@@ -275,11 +300,34 @@ is_native_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
 }
 #endif
 
+/* The memory data of a shared memory is never moved, and its size is read
+   atomically, so the bounds of the address can be checked without holding
+   the shared memory lock */
+static bool
+is_wait_addr_in_bounds(WASMModuleInstance *module_inst, uint8 *address,
+                       uint32 bytes)
+{
+    WASMMemoryInstance *memory = module_inst->memories[0];
+
+    return
+#if WASM_ENABLE_SHARED_HEAP != 0
+        /* in shared heap */
+        is_native_addr_in_shared_heap((WASMModuleInstanceCommon *)module_inst,
+                                      address, bytes)
+        ||
+#endif
+        /* or in linear memory */
+        (address >= memory->memory_data
+         && address + bytes
+                <= memory->memory_data + GET_LINEAR_MEMORY_SIZE(memory));
+}
+
 uint32
 wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
                          uint64 expect, int64 timeout, bool wait64)
 {
     WASMModuleInstance *module_inst = (WASMModuleInstance *)module;
+    AtomicWaitBucket *bucket;
     AtomicWaitInfo *wait_info;
     AtomicWaitNode *wait_node;
     korp_mutex *lock;
@@ -302,23 +350,10 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
         return -1;
     }
 
-    shared_memory_lock(module_inst->memories[0]);
-    if (
-#if WASM_ENABLE_SHARED_HEAP != 0
-        /* not in shared heap */
-        !is_native_addr_in_shared_heap((WASMModuleInstanceCommon *)module_inst,
-                                       address, wait64 ? 8 : 4)
-        &&
-#endif
-        /* and not in linear memory */
-        ((uint8 *)address < module_inst->memories[0]->memory_data
-         || (uint8 *)address + (wait64 ? 8 : 4)
-                > module_inst->memories[0]->memory_data_end)) {
-        shared_memory_unlock(module_inst->memories[0]);
+    if (!is_wait_addr_in_bounds(module_inst, address, wait64 ? 8 : 4)) {
         wasm_runtime_set_exception(module, "out of bounds memory access");
         return -1;
     }
-    shared_memory_unlock(module_inst->memories[0]);
 
 #if WASM_ENABLE_THREAD_MGR != 0
     exec_env =
@@ -326,21 +361,29 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     bh_assert(exec_env);
 #endif
 
-    lock = shared_memory_get_lock_pointer(module_inst->memories[0]);
+    bucket = get_wait_bucket(address);
+    lock = &bucket->lock;
 
-    /* Lock the shared_mem_lock for the whole atomic wait process,
+    /* Lock the bucket lock for the whole atomic wait process,
        and use it to os_cond_reltimedwait */
     os_mutex_lock(lock);
 
+    /* Announce the waiter before reading the value: a notifier which
+       stores the value and then reads a zero waiter count is ordered
+       before this point, so the new value is read below */
+    BH_ATOMIC_32_FETCH_ADD(bucket->waiter_count, 1);
+
     no_wait = (!wait64 && *(uint32 *)address != (uint32)expect)
               || (wait64 && *(uint64 *)address != expect);
 
     if (no_wait) {
+        BH_ATOMIC_32_FETCH_SUB(bucket->waiter_count, 1);
         os_mutex_unlock(lock);
         return 1;
     }
 
     if (!(wait_node = wasm_runtime_malloc(sizeof(AtomicWaitNode)))) {
+        BH_ATOMIC_32_FETCH_SUB(bucket->waiter_count, 1);
         os_mutex_unlock(lock);
         wasm_runtime_set_exception(module, "failed to create wait node");
         return -1;
@@ -348,6 +391,7 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     memset(wait_node, 0, sizeof(AtomicWaitNode));
 
     if (0 != os_cond_init(&wait_node->wait_cond)) {
+        BH_ATOMIC_32_FETCH_SUB(bucket->waiter_count, 1);
         os_mutex_unlock(lock);
         wasm_runtime_free(wait_node);
         wasm_runtime_set_exception(module, "failed to init wait cond");
@@ -357,9 +401,10 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     wait_node->status = S_WAITING;
 
     /* Acquire the wait info, create new one if not exists */
-    wait_info = acquire_wait_info(address, wait_node);
+    wait_info = acquire_wait_info(bucket, address, wait_node);
 
     if (!wait_info) {
+        BH_ATOMIC_32_FETCH_SUB(bucket->waiter_count, 1);
         os_mutex_unlock(lock);
         os_cond_destroy(&wait_node->wait_cond);
         wasm_runtime_free(wait_node);
@@ -415,8 +460,9 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     wasm_runtime_free(wait_node);
 
     /* Release wait info if no wait nodes are attached */
-    map_try_release_wait_info(wait_map, wait_info, address);
+    map_try_release_wait_info(bucket, wait_info);
 
+    BH_ATOMIC_32_FETCH_SUB(bucket->waiter_count, 1);
     os_mutex_unlock(lock);
 
     return is_timeout ? 2 : 0;
@@ -428,25 +474,14 @@ wasm_runtime_atomic_notify(WASMModuleInstanceCommon *module, void *address,
 {
     WASMModuleInstance *module_inst = (WASMModuleInstance *)module;
     uint32 notify_result;
+    AtomicWaitBucket *bucket;
     AtomicWaitInfo *wait_info;
     korp_mutex *lock;
-    bool out_of_bounds;
 
     bh_assert(module->module_type == Wasm_Module_Bytecode
               || module->module_type == Wasm_Module_AoT);
 
-    shared_memory_lock(module_inst->memories[0]);
-    out_of_bounds =
-#if WASM_ENABLE_SHARED_HEAP != 0
-        /* not in shared heap */
-        !is_native_addr_in_shared_heap(module, address, 4) &&
-#endif
-        /* and not in linear memory */
-        ((uint8 *)address < module_inst->memories[0]->memory_data
-         || (uint8 *)address + 4 > module_inst->memories[0]->memory_data_end);
-    shared_memory_unlock(module_inst->memories[0]);
-
-    if (out_of_bounds) {
+    if (!is_wait_addr_in_bounds(module_inst, address, 4)) {
         wasm_runtime_set_exception(module, "out of bounds memory access");
         return -1;
     }
@@ -458,13 +493,24 @@ wasm_runtime_atomic_notify(WASMModuleInstanceCommon *module, void *address,
         return 0;
     }
 
-    lock = shared_memory_get_lock_pointer(module_inst->memories[0]);
+    bucket = get_wait_bucket(address);
+
+#if BH_ATOMIC_32_IS_ATOMIC != 0
+    /* Nobody waits on the addresses of the bucket, the read-modify-write
+       is a full barrier which orders it after the store to the address
+       by the notifier, see wasm_runtime_atomic_wait */
+    if (BH_ATOMIC_32_FETCH_ADD(bucket->waiter_count, 0) == 0) {
+        return 0;
+    }
+#endif
+
+    lock = &bucket->lock;
 
-    /* Lock the shared_mem_lock for the whole atomic notify process,
+    /* Lock the bucket lock for the whole atomic notify process,
        and use it to os_cond_signal */
     os_mutex_lock(lock);
 
-    wait_info = acquire_wait_info(address, NULL);
+    wait_info = acquire_wait_info(bucket, address, NULL);
 
     /* Nobody wait on this address */
     if (!wait_info) {
@@ -196,6 +196,11 @@ typedef struct AOTImportFunc {
     const char *signature;
     /* attachment */
     void *attachment;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    /* signature-specialized thunk to call the linked native function,
+       NULL if it must go through wasm_runtime_invoke_native */
+    void *quick_native_entry;
+#endif
     bool call_conv_raw;
     bool call_conv_wasm_c_api;
     bool wasm_c_api_with_env;
@@ -667,7 +667,14 @@ aot_gen_commit_sp_ip(AOTCompFrame *frame, bool commit_sp, bool commit_ip)
         offset_sp = frame->comp_ctx->pointer_size * 5;
     }
     else {
+#if WASM_ENABLE_FAST_INTERP == 0
         offset_sp = offsetof(WASMInterpFrame, sp);
+#else
+        /* The fast interpreter frame has no sp, the llvm jit frames are
+           disabled when the fast interpreter is the first tier */
+        aot_set_last_error("llvm jit frames unsupported with fast interpreter");
+        return false;
+#endif
     }
 
     if (commit_ip && comp_ctx->call_stack_features.ip) {
@@ -995,6 +1002,50 @@ init_comp_frame(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+/* Whether the opcode ends a basic block charged by the instruction
+   metering at once: it may branch or leave the function, or the code
+   following it is a branch target */
+static bool
+is_metering_block_end(uint8 opcode, const uint8 *frame_ip,
+                      const uint8 *frame_ip_end)
+{
+    uint32 opcode1;
+
+    switch (opcode) {
+        case WASM_OP_UNREACHABLE:
+        case WASM_OP_LOOP:
+        case WASM_OP_IF:
+        case EXT_OP_LOOP:
+        case EXT_OP_IF:
+        case WASM_OP_ELSE:
+        case WASM_OP_CATCH:
+        case WASM_OP_CATCH_ALL:
+        case WASM_OP_DELEGATE:
+        case WASM_OP_THROW:
+        case WASM_OP_RETHROW:
+        case WASM_OP_END:
+        case WASM_OP_BR:
+        case WASM_OP_BR_IF:
+        case WASM_OP_BR_TABLE:
+        case EXT_OP_BR_TABLE_CACHE:
+        case WASM_OP_RETURN:
+        case WASM_OP_RETURN_CALL:
+        case WASM_OP_RETURN_CALL_INDIRECT:
+        case WASM_OP_RETURN_CALL_REF:
+        case WASM_OP_BR_ON_NULL:
+        case WASM_OP_BR_ON_NON_NULL:
+            return true;
+        case WASM_OP_GC_PREFIX:
+            read_leb_uint32(frame_ip, frame_ip_end, opcode1);
+            return opcode1 == WASM_OP_BR_ON_CAST
+                   || opcode1 == WASM_OP_BR_ON_CAST_FAIL;
+        default:
+            return false;
+    }
+}
+#endif
+
 static bool
 aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
 {
@@ -1021,6 +1072,12 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
 #if WASM_ENABLE_DEBUG_AOT != 0
     LLVMMetadataRef location;
 #endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    /* The count of instructions translated in current basic block, and
+       the LLVM block charging them at its entry */
+    uint32 metering_count = 0;
+    LLVMBasicBlockRef metering_block = NULL;
+#endif
 
     /* Start to translate the opcodes */
     LLVMPositionBuilderAtEnd(
@@ -1059,6 +1116,27 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
         }
 #endif
 
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+        if (comp_ctx->enable_instruction_metering) {
+            /* Charge the instructions of the basic block once at its
+               entry, like the interpreters, so that none of them runs
+               when the limit is exceeded. The charge is emitted when
+               the opcode ending the basic block is reached, and the
+               unreachable code skipped after branches isn't counted. */
+            if (metering_count == 0
+                && !aot_reserve_instruction_metering(comp_ctx, func_ctx,
+                                                     &metering_block))
+                return false;
+            metering_count++;
+            if (is_metering_block_end(opcode, frame_ip, frame_ip_end)) {
+                if (!aot_compile_instruction_metering(
+                        comp_ctx, func_ctx, metering_block, metering_count))
+                    return false;
+                metering_count = 0;
+            }
+        }
+#endif
+
         switch (opcode) {
             case WASM_OP_UNREACHABLE:
                 if (!aot_compile_op_unreachable(comp_ctx, func_ctx, &frame_ip))
@@ -1071,6 +1149,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
             case WASM_OP_BLOCK:
             case WASM_OP_LOOP:
             case WASM_OP_IF:
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case WASM_OP_TRY:
+#endif
             {
                 value_type = *frame_ip++;
                 if (value_type == VALUE_TYPE_I32 || value_type == VALUE_TYPE_I64
@@ -1111,7 +1192,12 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 }
                 if (!aot_compile_op_block(
                         comp_ctx, func_ctx, &frame_ip, frame_ip_end,
-                        (uint32)(LABEL_TYPE_BLOCK + opcode - WASM_OP_BLOCK),
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                        opcode == WASM_OP_TRY
+                            ? LABEL_TYPE_TRY
+                            :
+#endif
+                            (uint32)(LABEL_TYPE_BLOCK + opcode - WASM_OP_BLOCK),
                         param_count, param_types, result_count, result_types))
                     return false;
                 break;
@@ -1120,6 +1206,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
             case EXT_OP_BLOCK:
             case EXT_OP_LOOP:
             case EXT_OP_IF:
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case EXT_OP_TRY:
+#endif
             {
                 read_leb_int32(frame_ip, frame_ip_end, type_index);
                 /* type index was checked in wasm loader */
@@ -1132,7 +1221,12 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 result_types = func_type->types + param_count;
                 if (!aot_compile_op_block(
                         comp_ctx, func_ctx, &frame_ip, frame_ip_end,
-                        (uint32)(LABEL_TYPE_BLOCK + opcode - EXT_OP_BLOCK),
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                        opcode == EXT_OP_TRY
+                            ? LABEL_TYPE_TRY
+                            :
+#endif
+                            (uint32)(LABEL_TYPE_BLOCK + opcode - EXT_OP_BLOCK),
                         param_count, param_types, result_count, result_types))
                     return false;
                 break;
@@ -1148,6 +1242,45 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     return false;
                 break;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case WASM_OP_CATCH:
+            case WASM_OP_CATCH_ALL:
+                if (!aot_compile_op_catch(comp_ctx, func_ctx, &frame_ip))
+                    return false;
+                break;
+
+            case WASM_OP_DELEGATE:
+            {
+                uint32 delegate_depth;
+
+                /* The delegate's target was resolved when translating
+                   the try opcode, end the try block like end */
+                read_leb_uint32(frame_ip, frame_ip_end, delegate_depth);
+                (void)delegate_depth;
+                if (!aot_compile_op_end(comp_ctx, func_ctx, &frame_ip))
+                    return false;
+                break;
+            }
+
+            case WASM_OP_THROW:
+            {
+                uint32 tag_idx;
+
+                read_leb_uint32(frame_ip, frame_ip_end, tag_idx);
+                if (!aot_compile_op_throw(comp_ctx, func_ctx, tag_idx,
+                                          &frame_ip))
+                    return false;
+                break;
+            }
+
+            case WASM_OP_RETHROW:
+                read_leb_uint32(frame_ip, frame_ip_end, br_depth);
+                if (!aot_compile_op_rethrow(comp_ctx, func_ctx, br_depth,
+                                            &frame_ip))
+                    return false;
+                break;
+#endif
+
             case WASM_OP_BR:
             {
                 read_leb_uint32(frame_ip, frame_ip_end, br_depth);
@@ -1246,7 +1379,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 }
 
                 if (!aot_compile_op_call_indirect(comp_ctx, func_ctx, type_idx,
-                                                  tbl_idx))
+                                                  tbl_idx, false))
                     return false;
                 break;
             }
@@ -1286,7 +1419,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 }
 
                 if (!aot_compile_op_call_indirect(comp_ctx, func_ctx, type_idx,
-                                                  tbl_idx))
+                                                  tbl_idx, true))
                     return false;
                 if (!aot_compile_op_return(comp_ctx, func_ctx, &frame_ip))
                     return false;
@@ -4056,7 +4189,13 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
            JIT: one is memory leak in do_ir_transform, the other is
            possible core dump. */
         bh_print_time("Begin to run llvm optimization passes");
-        aot_apply_llvm_new_pass_manager(comp_ctx, comp_ctx->module);
+        if (comp_ctx->jobs > 0) {
+            if (!aot_apply_llvm_new_pass_manager_parallel(comp_ctx))
+                return false;
+        }
+        else {
+            aot_apply_llvm_new_pass_manager(comp_ctx, comp_ctx->module);
+        }
         bh_print_time("Finish llvm optimization passes");
     }
 
@@ -68,6 +68,8 @@ struct AOTObjectData {
     /* literal data and size */
     void *literal;
     uint32 literal_size;
+    /* zero bytes emitted after the literal to align the code */
+    uint32 literal_padding;
 
     AOTObjectDataSection *data_sections;
     uint32 data_sections_count;
@@ -811,11 +813,32 @@ get_init_data_section_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
     return size;
 }
 
+/* The max page size of the supported targets, to which the code is
+   aligned in the AOT file if shared text is enabled */
+#define AOT_SHARED_TEXT_ALIGN (64 * 1024)
+
+/* Get the padding to align the code to AOT_SHARED_TEXT_ALIGN, so that
+   the runtime can map the code pages from the AOT file and keep them
+   shared with the page cache, `offset` is the offset of the text section
+   body in the AOT file */
+static uint32
+get_literal_padding(AOTObjectData *obj_data, uint32 offset)
+{
+    uint32 code_offset;
+
+    if (!obj_data->comp_ctx->enable_shared_text)
+        return 0;
+
+    code_offset =
+        offset + (uint32)sizeof(uint32) + align_uint(obj_data->literal_size, 4);
+    return align_uint(code_offset, AOT_SHARED_TEXT_ALIGN) - code_offset;
+}
+
 static uint32
 get_text_section_size(AOTObjectData *obj_data)
 {
     return sizeof(uint32) + align_uint(obj_data->literal_size, 4)
-           + align_uint(obj_data->text_size, 4)
+           + obj_data->literal_padding + align_uint(obj_data->text_size, 4)
            + align_uint(obj_data->text_unlikely_size, 4)
            + align_uint(obj_data->text_hot_size, 4);
 }
@@ -1237,6 +1260,7 @@ aot_get_aot_file_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
     size = align_uint(size, 4);
     /* section id + section size */
     size += (uint32)sizeof(uint32) * 2;
+    obj_data->literal_padding = get_literal_padding(obj_data, size);
     size += get_text_section_size(obj_data);
 
     /* function section */
@@ -2483,7 +2507,13 @@ aot_emit_text_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
 
     EMIT_U32(AOT_SECTION_TYPE_TEXT);
     EMIT_U32(section_size);
-    EMIT_U32(obj_data->literal_size);
+    if (obj_data->literal_padding > 0)
+        /* The padding is taken as part of the literal by the loader,
+           which finds the code right after the literal */
+        EMIT_U32(align_uint(obj_data->literal_size, 4)
+                 + obj_data->literal_padding);
+    else
+        EMIT_U32(obj_data->literal_size);
 
     if (obj_data->literal_size > 0) {
         EMIT_BUF(obj_data->literal, obj_data->literal_size);
@@ -2491,6 +2521,9 @@ aot_emit_text_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
             EMIT_BUF(&placeholder, 1);
     }
 
+    for (i = 0; i < obj_data->literal_padding; i++)
+        EMIT_BUF(&placeholder, 1);
+
     text = buf + offset;
 
     if (obj_data->text_size > 0) {
@@ -4513,6 +4546,22 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     if (!comp_ctx->call_stack_features.func_idx) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_FRAME_NO_FUNC_IDX;
     }
+    if (comp_ctx->enable_trap_unwind) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_TRAP_UNWIND;
+    }
+    if (comp_ctx->enable_exce_handling) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_EXCEPTION_HANDLING;
+    }
+    if (comp_ctx->enable_instruction_metering) {
+        obj_data->target_info.feature_flags |=
+            WASM_FEATURE_INSTRUCTION_METERING;
+    }
+    if (comp_ctx->enable_epoch_interruption) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_EPOCH_INTERRUPTION;
+    }
+    if (comp_ctx->enable_gc_tlab) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_GC_TLAB;
+    }
 
     bh_print_time("Begin to resolve object file info");
 
@@ -6,19 +6,22 @@
 #include "aot_emit_control.h"
 #include "aot_compiler.h"
 #include "aot_emit_exception.h"
+#include "aot_emit_function.h"
 #include "aot_stack_frame_comp.h"
 #if WASM_ENABLE_GC != 0
 #include "aot_emit_gc.h"
 #endif
 #include "../aot/aot_runtime.h"
 #include "../interpreter/wasm_loader.h"
+#include "../interpreter/wasm_opcode.h"
 #include "../common/wasm_loader_common.h"
 
 #if WASM_ENABLE_DEBUG_AOT != 0
 #include "debug/dwarf_extractor.h"
 #endif
 
-static char *block_name_prefix[] = { "block", "loop", "if" };
+static char *block_name_prefix[] = { "block", "loop",  "if",       "func",
+                                     "try",   "catch", "catch_all" };
 static char *block_name_suffix[] = { "begin", "else", "end" };
 
 /* clang-format off */
@@ -265,6 +268,26 @@ restore_frame_sp_for_op_end(AOTBlock *block, AOTCompFrame *aot_frame)
     aot_frame->sp = block->frame_sp_begin;
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+static void
+restore_frame_sp_for_op_catch(AOTBlock *block, AOTCompFrame *aot_frame)
+{
+    uint32 all_cell_num =
+        aot_frame->max_local_cell_num + aot_frame->max_stack_cell_num;
+    AOTValueSlot *p_end = aot_frame->lp + all_cell_num, *p;
+
+    restore_frame_sp_for_op_else(block, aot_frame);
+
+    /* The exception may be thrown anywhere in the try body, after any
+       ref flags above the frame sp of the block are committed, set the
+       flags to uncommitted */
+    if (aot_frame->comp_ctx->enable_gc) {
+        for (p = block->frame_sp_begin; p < p_end; p++)
+            p->committed_ref = 0;
+    }
+}
+#endif
+
 #if WASM_ENABLE_BRANCH_HINTS != 0
 static void
 aot_emit_branch_hint(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -295,6 +318,17 @@ aot_emit_branch_hint(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 }
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+static bool
+handle_op_catch(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                uint8 **p_frame_ip);
+
+/* Whether the catch clauses of the try block haven't been translated,
+   they are translated only if any exception may be caught */
+#define HAS_CATCH_TO_TRANSLATE(block) \
+    (block->llvm_catch_blocks && block->catch_idx < block->catch_count)
+#endif
+
 static bool
 handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             uint8 **p_frame_ip)
@@ -343,6 +377,10 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     while (block && !block->is_reachable) {
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        if (HAS_CATCH_TO_TRANSLATE(block))
+            return handle_op_catch(comp_ctx, func_ctx, p_frame_ip);
+#endif
         block_prev = block->prev;
         block = aot_block_stack_pop(&func_ctx->block_stack);
 
@@ -383,6 +421,11 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         return true;
     }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (HAS_CATCH_TO_TRANSLATE(block))
+        return handle_op_catch(comp_ctx, func_ctx, p_frame_ip);
+#endif
+
     if (block->label_type == LABEL_TYPE_IF && block->llvm_else_block
         && !block->skip_wasm_code_else
         && *p_frame_ip <= block->wasm_code_else) {
@@ -592,6 +635,90 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/* Read a LEB128 encoded uint32 which has been validated by the loader */
+static uint32
+read_leb_uint32_validated(uint8 **p_buf)
+{
+    uint64 res64 = 0;
+
+    read_leb(p_buf, *p_buf + 5, 32, false, &res64, NULL, 0);
+    return (uint32)res64;
+}
+
+/* Find the address of the next catch/catch_all/delegate/end opcode of
+   the try block whose current clause starts at frame_ip */
+static bool
+find_try_handler_addr(uint8 *frame_ip, uint8 *frame_ip_end,
+                      uint8 **p_handler_addr)
+{
+    BlockAddr block_addr_cache[BLOCK_ADDR_CACHE_SIZE][BLOCK_ADDR_CONFLICT_SIZE];
+    uint8 *else_addr;
+
+    memset(block_addr_cache, 0, sizeof(block_addr_cache));
+
+    if (!(wasm_loader_find_block_addr(
+            NULL, (BlockAddr *)block_addr_cache, frame_ip, frame_ip_end,
+            LABEL_TYPE_TRY, &else_addr, p_handler_addr))) {
+        aot_set_last_error("find block end addr failed.");
+        return false;
+    }
+    return true;
+}
+
+/* Record the catch clauses of a try block and find its end */
+static bool
+init_try_block(AOTBlock *block, uint8 *frame_ip_end)
+{
+    uint8 *handler_addr = block->wasm_code_end, *p;
+    uint32 catch_count = 0, i;
+
+    /* Count the catch/catch_all clauses */
+    while (*handler_addr == WASM_OP_CATCH
+           || *handler_addr == WASM_OP_CATCH_ALL) {
+        p = handler_addr + 1;
+        if (*handler_addr == WASM_OP_CATCH)
+            read_leb_uint32_validated(&p);
+        if (!find_try_handler_addr(p, frame_ip_end, &handler_addr))
+            return false;
+        catch_count++;
+    }
+
+    if (catch_count > 0) {
+        if (!(block->wasm_code_catches =
+                  wasm_runtime_malloc(sizeof(uint8 *) * catch_count))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+
+        handler_addr = block->wasm_code_end;
+        for (i = 0; i < catch_count; i++) {
+            block->wasm_code_catches[i] = handler_addr;
+            p = handler_addr + 1;
+            if (*handler_addr == WASM_OP_CATCH)
+                read_leb_uint32_validated(&p);
+            if (!find_try_handler_addr(p, frame_ip_end, &handler_addr))
+                return false;
+        }
+    }
+    block->catch_count = catch_count;
+
+    if (*handler_addr == WASM_OP_DELEGATE) {
+        p = handler_addr + 1;
+        block->is_delegate = true;
+        block->delegate_depth = read_leb_uint32_validated(&p);
+        /* Let wasm_code_end + 1 point to the opcode following the
+           delegate's label index, like the opcode following end */
+        block->wasm_code_end = p - 1;
+    }
+    else {
+        bh_assert(*handler_addr == WASM_OP_END);
+        block->wasm_code_end = handler_addr;
+    }
+    return true;
+}
+#endif
+
 bool
 aot_compile_op_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                      uint8 **p_frame_ip, uint8 *frame_ip_end, uint32 label_type,
@@ -661,7 +788,18 @@ aot_compile_op_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
     }
 
-    if (label_type == LABEL_TYPE_BLOCK || label_type == LABEL_TYPE_LOOP) {
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* The try body is translated like a block, the catch clauses are
+       translated after it if any exception may be caught */
+    if (label_type == LABEL_TYPE_TRY && !init_try_block(block, frame_ip_end))
+        goto fail;
+#endif
+
+    if (label_type == LABEL_TYPE_BLOCK || label_type == LABEL_TYPE_LOOP
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        || label_type == LABEL_TYPE_TRY
+#endif
+    ) {
         /* Create block */
         format_block_name(name, sizeof(name), block->block_index, label_type,
                           LABEL_BEGIN);
@@ -1005,6 +1143,197 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+bool
+aot_reserve_instruction_metering(AOTCompContext *comp_ctx,
+                                 AOTFuncContext *func_ctx,
+                                 LLVMBasicBlockRef *p_metering_block)
+{
+    LLVMBasicBlockRef metering_block, metered_block;
+
+    CREATE_BLOCK(metering_block, "instruction_metering");
+    MOVE_BLOCK_AFTER_CURR(metering_block);
+    CREATE_BLOCK(metered_block, "instructions_metered");
+    MOVE_BLOCK_AFTER(metered_block, metering_block);
+
+    BUILD_BR(metering_block);
+    /* Jump to the basic block until the charge is emitted */
+    SET_BUILDER_POS(metering_block);
+    BUILD_BR(metered_block);
+
+    SET_BUILDER_POS(metered_block);
+    *p_metering_block = metering_block;
+    return true;
+fail:
+    return false;
+}
+
+bool
+aot_compile_instruction_metering(AOTCompContext *comp_ctx,
+                                 AOTFuncContext *func_ctx,
+                                 LLVMBasicBlockRef metering_block,
+                                 uint32 count)
+{
+    LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[2], func, value, offset, count_addr;
+    LLVMValueRef instructions_left, new_left, is_unlimited, res, br;
+    LLVMBasicBlockRef charge_block, check_block, exceeded_block, next_block;
+    LLVMBasicBlockRef metered_block, block_curr = CURR_BLOCK();
+
+    /* Replace the jump to the basic block with the charge */
+    br = LLVMGetBasicBlockTerminator(metering_block);
+    metered_block = LLVMGetSuccessor(br, 0);
+    LLVMInstructionEraseFromParent(br);
+    SET_BUILDER_POS(metering_block);
+
+    /* Offset of instructions_to_execute */
+    offset = I32_CONST(17);
+    CHECK_LLVM_CONST(offset);
+
+    if (!(count_addr = LLVMBuildInBoundsGEP2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                             func_ctx->exec_env, &offset, 1,
+                                             "instructions_addr"))) {
+        aot_set_last_error("llvm build in bounds gep failed");
+        return false;
+    }
+    if (!(count_addr = LLVMBuildBitCast(comp_ctx->builder, count_addr,
+                                        INT32_PTR_TYPE, "instructions_ptr"))) {
+        aot_set_last_error("llvm build bit cast failed");
+        return false;
+    }
+    if (!(instructions_left = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE,
+                                             count_addr, "instructions_left"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+
+    CREATE_BLOCK(next_block, "instructions_charged");
+    MOVE_BLOCK_AFTER_CURR(next_block);
+    CREATE_BLOCK(exceeded_block, "instruction_limit_exceeded");
+    MOVE_BLOCK_AFTER_CURR(exceeded_block);
+    CREATE_BLOCK(check_block, "check_instruction_limit");
+    MOVE_BLOCK_AFTER_CURR(check_block);
+    CREATE_BLOCK(charge_block, "charge_instructions");
+    MOVE_BLOCK_AFTER_CURR(charge_block);
+
+    /* The count left is -1 if there is no limit, which isn't less than
+       count when compared as unsigned */
+    BUILD_ICMP(LLVMIntULT, instructions_left, I32_CONST(count), res,
+               "instructions_not_enough");
+    BUILD_COND_BR(res, check_block, charge_block);
+
+    /* Charge the instructions unless there is no limit */
+    SET_BUILDER_POS(charge_block);
+    if (!(new_left = LLVMBuildSub(comp_ctx->builder, instructions_left,
+                                  I32_CONST(count), "new_left"))) {
+        aot_set_last_error("llvm build sub failed");
+        goto fail;
+    }
+    BUILD_ICMP(LLVMIntSLT, instructions_left, I32_ZERO, is_unlimited,
+               "is_unlimited");
+    if (!(new_left = LLVMBuildSelect(comp_ctx->builder, is_unlimited,
+                                     instructions_left, new_left, "new_left"))) {
+        aot_set_last_error("llvm build select failed");
+        goto fail;
+    }
+    if (!LLVMBuildStore(comp_ctx->builder, new_left, count_addr)) {
+        aot_set_last_error("llvm build store failed");
+        goto fail;
+    }
+    BUILD_BR(next_block);
+
+    /* Let the runtime call the instruction limit callback to refill the
+       count, or throw the exception */
+    SET_BUILDER_POS(check_block);
+    param_types[0] = comp_ctx->exec_env_type;
+    param_types[1] = I32_TYPE;
+    ret_type = INT8_TYPE;
+    GET_AOT_FUNCTION(wasm_runtime_check_instruction_limit, 2);
+
+    param_values[0] = func_ctx->exec_env;
+    param_values[1] = I32_CONST(count);
+    if (!(res = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                               param_values, 2, "check_instruction_limit"))) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+    BUILD_ICMP(LLVMIntNE, res, I8_ZERO, res, "instructions_charged");
+    BUILD_COND_BR(res, next_block, exceeded_block);
+
+    SET_BUILDER_POS(exceeded_block);
+    if (!aot_emit_return_on_exception(comp_ctx, func_ctx))
+        goto fail;
+
+    SET_BUILDER_POS(next_block);
+    BUILD_BR(metered_block);
+
+    SET_BUILDER_POS(block_curr);
+    return true;
+fail:
+    return false;
+}
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+bool
+aot_check_epoch_deadline(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMTypeRef param_types[1], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[1], func, value, epoch, deadline, res;
+    LLVMBasicBlockRef check_block, interrupted_block, next_block;
+
+    if (!(epoch = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                 func_ctx->epoch_ptr, "epoch"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+    /* The epoch is bumped by other threads, always load it from memory */
+    LLVMSetVolatile(epoch, true);
+
+    if (!(deadline = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                    func_ctx->epoch_deadline_ptr,
+                                    "epoch_deadline"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+
+    CREATE_BLOCK(next_block, "epoch_checked");
+    MOVE_BLOCK_AFTER_CURR(next_block);
+    CREATE_BLOCK(interrupted_block, "epoch_interrupted");
+    MOVE_BLOCK_AFTER_CURR(interrupted_block);
+    CREATE_BLOCK(check_block, "check_epoch_deadline");
+    MOVE_BLOCK_AFTER_CURR(check_block);
+
+    BUILD_ICMP(LLVMIntUGE, epoch, deadline, res, "epoch_deadline_reached");
+    BUILD_COND_BR(res, check_block, next_block);
+
+    /* Let the runtime call the epoch deadline callback to extend the
+       deadline, or throw the exception */
+    SET_BUILDER_POS(check_block);
+    param_types[0] = comp_ctx->exec_env_type;
+    ret_type = INT8_TYPE;
+    GET_AOT_FUNCTION(wasm_runtime_check_epoch_deadline, 1);
+
+    param_values[0] = func_ctx->exec_env;
+    if (!(res = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                               param_values, 1, "check_epoch_deadline"))) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+    BUILD_ICMP(LLVMIntNE, res, I8_ZERO, res, "epoch_not_interrupted");
+    BUILD_COND_BR(res, next_block, interrupted_block);
+
+    SET_BUILDER_POS(interrupted_block);
+    if (!aot_emit_return_on_exception(comp_ctx, func_ctx))
+        goto fail;
+
+    SET_BUILDER_POS(next_block);
+    return true;
+fail:
+    return false;
+}
+#endif
+
 bool
 aot_compile_op_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                   uint32 br_depth, uint8 **p_frame_ip)
@@ -1044,6 +1373,14 @@ aot_compile_op_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             return false;
     }
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    if (comp_ctx->enable_epoch_interruption
+        && block_dst->label_type == LABEL_TYPE_LOOP) {
+        if (!aot_check_epoch_deadline(comp_ctx, func_ctx))
+            return false;
+    }
+#endif
+
     if (block_dst->label_type == LABEL_TYPE_LOOP) {
         /* Dest block is Loop block */
         /* Handle Loop parameters */
@@ -1136,6 +1473,14 @@ aot_compile_conditional_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             return false;
     }
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    if (comp_ctx->enable_epoch_interruption
+        && block_dst->label_type == LABEL_TYPE_LOOP) {
+        if (!aot_check_epoch_deadline(comp_ctx, func_ctx))
+            return false;
+    }
+#endif
+
     if (LLVMIsUndef(value_cmp)
 #if LLVM_VERSION_NUMBER >= 12
         || LLVMIsPoison(value_cmp)
@@ -1364,6 +1709,21 @@ aot_compile_op_br_table(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             }
         }
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+        if (comp_ctx->enable_epoch_interruption) {
+            for (i = 0; i <= br_count; i++) {
+                target_block = get_target_block(func_ctx, br_depths[i]);
+                if (!target_block)
+                    return false;
+                if (target_block->label_type == LABEL_TYPE_LOOP) {
+                    if (!aot_check_epoch_deadline(comp_ctx, func_ctx))
+                        return false;
+                    break;
+                }
+            }
+        }
+#endif
+
         /* Compare value is not constant, create switch IR */
         for (i = 0; i <= br_count; i++) {
             target_block = get_target_block(func_ctx, br_depths[i]);
@@ -1560,6 +1920,609 @@ aot_handle_next_reachable_block(AOTCompContext *comp_ctx,
     return handle_next_reachable_block(comp_ctx, func_ctx, p_frame_ip);
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/*
+ * The wasm exception in flight is kept by the module instance: the
+ * exception string is set to "uncaught wasm exception", and the tag
+ * index and the values are stored in the extra common part of the
+ * instance by wasm_runtime_throw_exception. A callee which doesn't catch
+ * it returns to the caller, which checks it after the call returns and
+ * dispatches it to the catch clauses of the enclosing try blocks. The
+ * catch clause copies it to a buffer of the try block, which is kept
+ * for rethrow, and clears it. When GC is enabled, the ref flags of the
+ * values follow them, and the runtime adds the GC references of the
+ * exception in flight and of the exceptions kept to the root set.
+ */
+
+static WASMFuncType *
+get_tag_type(const WASMModule *module, uint32 tag_idx)
+{
+    if (tag_idx < module->import_tag_count)
+        return module->import_tags[tag_idx].u.tag.tag_type;
+    bh_assert(tag_idx - module->import_tag_count < module->tag_count);
+    return module->tags[tag_idx - module->import_tag_count]->tag_type;
+}
+
+static uint32
+get_tag_param_cell_num(const AOTCompContext *comp_ctx,
+                       const WASMFuncType *tag_type)
+{
+    uint32 cell_num = 0, i;
+
+    for (i = 0; i < tag_type->param_count; i++)
+        cell_num += wasm_value_type_cell_num_internal(tag_type->types[i],
+                                                      comp_ctx->pointer_size);
+    return cell_num;
+}
+
+static uint32
+get_max_tag_param_cell_num(const AOTCompContext *comp_ctx)
+{
+    const WASMModule *module = comp_ctx->comp_data->wasm_module;
+    uint32 i, cell_num, max_cell_num = 0;
+
+    for (i = 0; i < module->import_tag_count + module->tag_count; i++) {
+        cell_num = get_tag_param_cell_num(comp_ctx, get_tag_type(module, i));
+        if (cell_num > max_cell_num)
+            max_cell_num = cell_num;
+    }
+    return max_cell_num;
+}
+
+/* Get the cell number of the buffer of the exception values, followed
+   by their ref flags when GC is enabled */
+static uint32
+get_exce_buf_cell_num(const AOTCompContext *comp_ctx, uint32 value_cell_num)
+{
+    if (comp_ctx->enable_gc)
+        return value_cell_num + (value_cell_num + 3) / 4;
+    return value_cell_num;
+}
+
+#if WASM_ENABLE_GC != 0
+/* Store the ref flags of the exception values of the tag after the values
+   in the buffer, and return the address of the ref flags */
+static LLVMValueRef
+store_exce_ref_flags(AOTCompContext *comp_ctx, LLVMValueRef buf,
+                     const WASMFuncType *tag_type, uint32 cell_num)
+{
+    LLVMValueRef offset = I32_CONST(cell_num), ref_flags, addr;
+    uint32 cell_offset = 0, i, j, n;
+    uint8 type;
+
+    if (!offset) {
+        aot_set_last_error("llvm create const failed.");
+        return NULL;
+    }
+    if (!(ref_flags = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE, buf,
+                                            &offset, 1, "ref_flags"))
+        || !(ref_flags = LLVMBuildBitCast(comp_ctx->builder, ref_flags,
+                                          INT8_PTR_TYPE, "ref_flags"))) {
+        aot_set_last_error("llvm build in bounds gep failed.");
+        return NULL;
+    }
+
+    for (i = 0; i < tag_type->param_count; i++) {
+        type = tag_type->types[i];
+        n = wasm_value_type_cell_num_internal(type, comp_ctx->pointer_size);
+        for (j = 0; j < n; j++, cell_offset++) {
+            offset = I32_CONST(cell_offset);
+            if (!offset) {
+                aot_set_last_error("llvm create const failed.");
+                return NULL;
+            }
+            if (!(addr = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
+                                               ref_flags, &offset, 1,
+                                               "ref_flag_addr"))) {
+                aot_set_last_error("llvm build in bounds gep failed.");
+                return NULL;
+            }
+            if (!LLVMBuildStore(comp_ctx->builder,
+                                aot_is_type_gc_reftype(type)
+                                        && !wasm_is_reftype_i31ref(type)
+                                    ? I8_ONE
+                                    : I8_ZERO,
+                                addr)) {
+                aot_set_last_error("llvm build store failed.");
+                return NULL;
+            }
+        }
+    }
+    return ref_flags;
+}
+#endif
+
+/* Create a uint32 array in the entry block of the function, so that it
+   can be accessed from any basic block */
+static LLVMValueRef
+create_exce_buf(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                uint32 cell_num, const char *name)
+{
+    LLVMBasicBlockRef block_curr = CURR_BLOCK();
+    LLVMBasicBlockRef entry_block = LLVMGetEntryBasicBlock(func_ctx->func);
+    LLVMValueRef first_instr = LLVMGetFirstInstruction(entry_block), buf;
+    LLVMTypeRef buf_type;
+
+    if (!(buf_type = LLVMArrayType(I32_TYPE, cell_num))) {
+        aot_set_last_error("llvm add array type failed.");
+        return NULL;
+    }
+
+    if (first_instr)
+        LLVMPositionBuilderBefore(comp_ctx->builder, first_instr);
+    else
+        SET_BUILDER_POS(entry_block);
+
+    if (!(buf = LLVMBuildAlloca(comp_ctx->builder, buf_type, name))) {
+        aot_set_last_error("llvm build alloca failed.");
+        goto fail;
+    }
+    LLVMSetAlignment(buf, 8);
+    if (!(buf = LLVMBuildBitCast(comp_ctx->builder, buf, INT32_PTR_TYPE,
+                                 name))) {
+        aot_set_last_error("llvm build bit cast failed.");
+        goto fail;
+    }
+
+    SET_BUILDER_POS(block_curr);
+    return buf;
+fail:
+    SET_BUILDER_POS(block_curr);
+    return NULL;
+}
+
+/* Get the address of the exception value of the given type in the
+   buffer */
+static LLVMValueRef
+get_exce_value_addr(AOTCompContext *comp_ctx, LLVMValueRef buf,
+                    uint32 cell_offset, uint8 type)
+{
+    LLVMValueRef offset = I32_CONST(cell_offset), addr;
+
+    if (!offset) {
+        aot_set_last_error("llvm create const failed.");
+        return NULL;
+    }
+    if (!(addr = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE, buf,
+                                       &offset, 1, "exce_value_addr"))) {
+        aot_set_last_error("llvm build in bounds gep failed.");
+        return NULL;
+    }
+    if (!(addr = LLVMBuildBitCast(comp_ctx->builder, addr,
+                                  LLVMPointerType(TO_LLVM_TYPE(type), 0),
+                                  "exce_value_ptr"))) {
+        aot_set_last_error("llvm build bit cast failed.");
+        return NULL;
+    }
+    return addr;
+}
+
+/* Get the basic block which handles the exception thrown in the given
+   block: the catch dispatching of the nearest try block which has catch
+   clauses, or the function return block which returns the exception to
+   the caller */
+static LLVMBasicBlockRef
+get_exception_landing_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                            AOTBlock *block);
+
+/* Create the basic block which compares the tag index of the exception
+   in flight with the ones of the catch clauses of a try block, and the
+   basic blocks of the catch clauses which are translated later */
+static bool
+create_catch_dispatch_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                            AOTBlock *block)
+{
+    LLVMBasicBlockRef block_curr = CURR_BLOCK(), default_block = NULL;
+    LLVMTypeRef param_types[1], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[1], func, value, tag_idx, switch_instr;
+    uint8 *p;
+    uint32 tag_indexes_size, i, j;
+    uint32 *tag_indexes = NULL;
+    char name[32];
+
+    tag_indexes_size = (uint32)sizeof(uint32) * block->catch_count;
+    if (!(block->llvm_catch_blocks = wasm_runtime_malloc(
+              (uint32)sizeof(LLVMBasicBlockRef) * block->catch_count))
+        || !(tag_indexes = wasm_runtime_malloc(tag_indexes_size))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+
+    snprintf(name, sizeof(name), "try%d_dispatch", block->block_index);
+    CREATE_BLOCK(block->llvm_catch_dispatch_block, name);
+    for (i = 0; i < block->catch_count; i++) {
+        snprintf(name, sizeof(name), "try%d_catch%d", block->block_index, i);
+        CREATE_BLOCK(block->llvm_catch_blocks[i], name);
+    }
+
+    SET_BUILDER_POS(block->llvm_catch_dispatch_block);
+
+    /* uint32 wasm_runtime_get_exception_tag(WASMModuleInstanceCommon *) */
+    param_types[0] = INT8_PTR_TYPE;
+    ret_type = I32_TYPE;
+    GET_AOT_FUNCTION(wasm_runtime_get_exception_tag, 1);
+
+    param_values[0] = func_ctx->aot_inst;
+    if (!(tag_idx = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                                   param_values, 1, "tag_idx"))) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    /* Read the tags of the catch clauses before the catch_all clause */
+    for (i = 0; i < block->catch_count; i++) {
+        p = block->wasm_code_catches[i];
+        if (*p++ == WASM_OP_CATCH_ALL) {
+            default_block = block->llvm_catch_blocks[i];
+            break;
+        }
+        tag_indexes[i] = read_leb_uint32_validated(&p);
+    }
+
+    if (!default_block) {
+        /* No catch clause matches, search the outer handlers */
+        if (!(default_block = get_exception_landing_block(comp_ctx, func_ctx,
+                                                          block->prev)))
+            goto fail;
+        SET_BUILDER_POS(block->llvm_catch_dispatch_block);
+    }
+
+    /* The traps can't be caught, return them to the caller directly */
+    if (!aot_create_func_return_block(comp_ctx, func_ctx))
+        goto fail;
+
+    if (!(switch_instr = LLVMBuildSwitch(comp_ctx->builder, tag_idx,
+                                         default_block, i + 1))) {
+        aot_set_last_error("llvm build switch failed.");
+        goto fail;
+    }
+    LLVMAddCase(switch_instr, I32_CONST(INVALID_TAGINDEX),
+                func_ctx->func_return_block);
+    for (j = 0; j < i; j++) {
+        uint32 k;
+
+        /* Only the first catch clause of a tag may be reached */
+        for (k = 0; k < j && tag_indexes[k] != tag_indexes[j]; k++)
+            ;
+        if (k == j)
+            LLVMAddCase(switch_instr, I32_CONST(tag_indexes[j]),
+                        block->llvm_catch_blocks[j]);
+    }
+
+    wasm_runtime_free(tag_indexes);
+    SET_BUILDER_POS(block_curr);
+    return true;
+fail:
+    if (tag_indexes)
+        wasm_runtime_free(tag_indexes);
+    SET_BUILDER_POS(block_curr);
+    return false;
+}
+
+static LLVMBasicBlockRef
+get_exception_landing_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                            AOTBlock *block)
+{
+    uint32 depth;
+
+    while (block) {
+        if (block->label_type == LABEL_TYPE_TRY) {
+            if (block->is_delegate) {
+                /* Search the handlers from the delegate's target block */
+                depth = block->delegate_depth;
+                block = block->prev;
+                while (depth-- > 0 && block)
+                    block = block->prev;
+                continue;
+            }
+            if (block->catch_count > 0) {
+                if (!block->llvm_catch_dispatch_block
+                    && !create_catch_dispatch_block(comp_ctx, func_ctx, block))
+                    return NULL;
+                return block->llvm_catch_dispatch_block;
+            }
+        }
+        else if (block->label_type == LABEL_TYPE_FUNCTION) {
+            if (!aot_create_func_return_block(comp_ctx, func_ctx))
+                return NULL;
+            return func_ctx->func_return_block;
+        }
+        /* Other blocks and the catch clauses can't catch the exception */
+        block = block->prev;
+    }
+
+    aot_set_last_error("WASM block stack underflow.");
+    return NULL;
+}
+
+/* Start to translate the next catch clause of the try block on the top
+   of block stack, the previous part of the try block has been finished */
+static bool
+handle_op_catch(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                uint8 **p_frame_ip)
+{
+    AOTBlock *block = func_ctx->block_stack.block_list_end;
+    WASMFuncType *tag_type = NULL;
+    LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[2], func, value, addr;
+    uint8 *frame_ip;
+    uint32 cell_offset, i;
+
+    bh_assert(HAS_CATCH_TO_TRANSLATE(block));
+
+    /* Clear value stack and start to translate the catch clause */
+    aot_value_stack_destroy(comp_ctx, &block->value_stack);
+    if (comp_ctx->aot_frame)
+        restore_frame_sp_for_op_catch(block, comp_ctx->aot_frame);
+
+    frame_ip = block->wasm_code_catches[block->catch_idx];
+    SET_BUILDER_POS(block->llvm_catch_blocks[block->catch_idx]);
+    block->catch_idx++;
+
+    if (*frame_ip++ == WASM_OP_CATCH) {
+        tag_type = get_tag_type(comp_ctx->comp_data->wasm_module,
+                                read_leb_uint32_validated(&frame_ip));
+        block->label_type = LABEL_TYPE_CATCH;
+    }
+    else {
+        block->label_type = LABEL_TYPE_CATCH_ALL;
+    }
+    *p_frame_ip = frame_ip;
+
+    /* Keep room for the values of any exception to rethrow */
+    if (!block->exce_buf
+        && !(block->exce_buf = create_exce_buf(
+                 comp_ctx, func_ctx,
+                 2
+                     + get_exce_buf_cell_num(
+                         comp_ctx, get_max_tag_param_cell_num(comp_ctx)),
+                 "exce_buf")))
+        return false;
+
+    /* void wasm_runtime_catch_exception(WASMModuleInstanceCommon *,
+                                         uint32 *) */
+    param_types[0] = INT8_PTR_TYPE;
+    param_types[1] = INT32_PTR_TYPE;
+    ret_type = VOID_TYPE;
+    GET_AOT_FUNCTION(wasm_runtime_catch_exception, 2);
+
+    param_values[0] = func_ctx->aot_inst;
+    param_values[1] = block->exce_buf;
+    if (!LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values, 2,
+                        "")) {
+        aot_set_last_error("llvm build call failed.");
+        return false;
+    }
+
+    /* Push the exception values for the catch clause */
+    if (tag_type) {
+        cell_offset = 2;
+        for (i = 0; i < tag_type->param_count; i++) {
+            if (!(addr = get_exce_value_addr(comp_ctx, block->exce_buf,
+                                             cell_offset, tag_type->types[i])))
+                return false;
+            if (!(value = LLVMBuildLoad2(comp_ctx->builder,
+                                         TO_LLVM_TYPE(tag_type->types[i]),
+                                         addr, "exce_value"))) {
+                aot_set_last_error("llvm build load failed.");
+                return false;
+            }
+            LLVMSetAlignment(value, 4);
+            cell_offset += wasm_value_type_cell_num_internal(
+                tag_type->types[i], comp_ctx->pointer_size);
+            PUSH(value, tag_type->types[i]);
+        }
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+bool
+aot_compile_op_catch(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint8 **p_frame_ip)
+{
+    AOTBlock *block = func_ctx->block_stack.block_list_end;
+
+    if (!block
+        || (block->label_type != LABEL_TYPE_TRY
+            && block->label_type != LABEL_TYPE_CATCH
+            && block->label_type != LABEL_TYPE_CATCH_ALL)) {
+        aot_set_last_error("Invalid WASM block type.");
+        return false;
+    }
+
+    /* Leave the try body or the previous catch clause like br 0, then the
+       next catch clause is translated if any exception may be caught,
+       or else the rest of the try block is skipped */
+    return aot_compile_op_br(comp_ctx, func_ctx, 0, p_frame_ip);
+}
+
+/* Throw the exception with the tag index, the values, the cell number
+   and the ref flags of the values, and jump to its handler */
+static bool
+throw_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                LLVMValueRef tag_idx, LLVMValueRef values,
+                LLVMValueRef cell_num, LLVMValueRef ref_flags,
+                uint8 **p_frame_ip)
+{
+    LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[5], func, value;
+    LLVMBasicBlockRef landing_block;
+
+    /* void wasm_runtime_throw_exception(WASMModuleInstanceCommon *, uint32,
+                                         const uint32 *, uint32,
+                                         const uint8 *) */
+    param_types[0] = INT8_PTR_TYPE;
+    param_types[1] = I32_TYPE;
+    param_types[2] = INT32_PTR_TYPE;
+    param_types[3] = I32_TYPE;
+    param_types[4] = INT8_PTR_TYPE;
+    ret_type = VOID_TYPE;
+    GET_AOT_FUNCTION(wasm_runtime_throw_exception, 5);
+
+    param_values[0] = func_ctx->aot_inst;
+    param_values[1] = tag_idx;
+    param_values[2] = values;
+    param_values[3] = cell_num;
+    param_values[4] = ref_flags;
+    if (!LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values, 5,
+                        "")) {
+        aot_set_last_error("llvm build call failed.");
+        return false;
+    }
+
+    if (!(landing_block = get_exception_landing_block(
+              comp_ctx, func_ctx, func_ctx->block_stack.block_list_end)))
+        return false;
+    BUILD_BR(landing_block);
+
+    return handle_next_reachable_block(comp_ctx, func_ctx, p_frame_ip);
+fail:
+    return false;
+}
+
+bool
+aot_compile_op_throw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint32 tag_idx, uint8 **p_frame_ip)
+{
+    WASMFuncType *tag_type =
+        get_tag_type(comp_ctx->comp_data->wasm_module, tag_idx);
+    uint32 cell_num = get_tag_param_cell_num(comp_ctx, tag_type);
+    LLVMValueRef value, addr, values = LLVMConstNull(INT32_PTR_TYPE);
+    LLVMValueRef ref_flags = LLVMConstNull(INT8_PTR_TYPE), store;
+    uint32 cell_offset = cell_num, i;
+    uint8 type;
+
+    if (comp_ctx->aot_frame && comp_ctx->enable_gc
+        && !aot_gen_commit_values(comp_ctx->aot_frame))
+        return false;
+
+    if (cell_num > 0) {
+        if (!func_ctx->exce_throw_buf
+            && !(func_ctx->exce_throw_buf = create_exce_buf(
+                     comp_ctx, func_ctx,
+                     get_exce_buf_cell_num(
+                         comp_ctx, get_max_tag_param_cell_num(comp_ctx)),
+                     "exce_throw_buf")))
+            return false;
+        values = func_ctx->exce_throw_buf;
+
+        /* Pop the exception values and store them to the buffer */
+        for (i = tag_type->param_count; i > 0; i--) {
+            type = tag_type->types[i - 1];
+            cell_offset -=
+                wasm_value_type_cell_num_internal(type, comp_ctx->pointer_size);
+            POP(value, type);
+            if (!(addr = get_exce_value_addr(comp_ctx, values, cell_offset,
+                                             type)))
+                return false;
+            if (!(store = LLVMBuildStore(comp_ctx->builder, value, addr))) {
+                aot_set_last_error("llvm build store failed.");
+                return false;
+            }
+            LLVMSetAlignment(store, 4);
+        }
+
+#if WASM_ENABLE_GC != 0
+        if (comp_ctx->enable_gc
+            && !(ref_flags = store_exce_ref_flags(comp_ctx, values, tag_type,
+                                                  cell_num)))
+            return false;
+#endif
+    }
+
+    return throw_exception(comp_ctx, func_ctx, I32_CONST(tag_idx), values,
+                           I32_CONST(cell_num), ref_flags, p_frame_ip);
+fail:
+    return false;
+}
+
+bool
+aot_compile_op_rethrow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                       uint32 depth, uint8 **p_frame_ip)
+{
+    AOTBlock *block_dst;
+    LLVMValueRef offset, tag_idx, cell_num, values;
+    LLVMValueRef ref_flags = LLVMConstNull(INT8_PTR_TYPE);
+
+    if (!(block_dst = get_target_block(func_ctx, depth)))
+        return false;
+    bh_assert((block_dst->label_type == LABEL_TYPE_CATCH
+               || block_dst->label_type == LABEL_TYPE_CATCH_ALL)
+              && block_dst->exce_buf);
+
+    if (comp_ctx->aot_frame && comp_ctx->enable_gc
+        && !aot_gen_commit_values(comp_ctx->aot_frame))
+        return false;
+
+    /* Throw the exception caught by the target catch clause again */
+    offset = I32_ONE;
+    if (!(tag_idx = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE,
+                                   block_dst->exce_buf, "tag_idx"))
+        || !(cell_num = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE,
+                                              block_dst->exce_buf, &offset, 1,
+                                              "cell_num_addr"))
+        || !(cell_num = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE, cell_num,
+                                       "cell_num"))) {
+        aot_set_last_error("llvm build load failed.");
+        return false;
+    }
+    offset = I32_TWO;
+    if (!(values = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE,
+                                         block_dst->exce_buf, &offset, 1,
+                                         "exce_values"))) {
+        aot_set_last_error("llvm build in bounds gep failed.");
+        return false;
+    }
+
+    /* The ref flags stored by wasm_runtime_catch_exception follow the
+       values */
+    if (comp_ctx->enable_gc
+        && (!(ref_flags = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE,
+                                                values, &cell_num, 1,
+                                                "ref_flags"))
+            || !(ref_flags = LLVMBuildBitCast(comp_ctx->builder, ref_flags,
+                                              INT8_PTR_TYPE, "ref_flags")))) {
+        aot_set_last_error("llvm build in bounds gep failed.");
+        return false;
+    }
+
+    return throw_exception(comp_ctx, func_ctx, tag_idx, values, cell_num,
+                           ref_flags, p_frame_ip);
+}
+
+bool
+aot_check_callee_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMBasicBlockRef landing_block, check_exce_succ;
+    LLVMValueRef value, cmp;
+
+    if (!(landing_block = get_exception_landing_block(
+              comp_ctx, func_ctx, func_ctx->block_stack.block_list_end)))
+        return false;
+
+    /* Load the first byte of aot_module_inst->cur_exception, and check
+       whether it is '\0'. If yes, no exception was thrown. */
+    if (!(value = LLVMBuildLoad2(comp_ctx->builder, INT8_TYPE,
+                                 func_ctx->cur_exception, "exce_value"))) {
+        aot_set_last_error("llvm build load failed.");
+        return false;
+    }
+    BUILD_ICMP(LLVMIntNE, value, I8_ZERO, cmp, "cmp");
+
+    CREATE_BLOCK(check_exce_succ, "check_exce_succ");
+    MOVE_BLOCK_AFTER_CURR(check_exce_succ);
+    BUILD_COND_BR(cmp, landing_block, check_exce_succ);
+
+    SET_BUILDER_POS(check_exce_succ);
+    return true;
+fail:
+    return false;
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
 #if WASM_ENABLE_GC != 0
 static bool
 commit_gc_and_check_suspend_flags(AOTCompContext *comp_ctx,
@@ -1597,6 +2560,14 @@ commit_gc_and_check_suspend_flags(AOTCompContext *comp_ctx,
             return false;
     }
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    if (comp_ctx->enable_epoch_interruption
+        && block_dst->label_type == LABEL_TYPE_LOOP) {
+        if (!aot_check_epoch_deadline(comp_ctx, func_ctx))
+            return false;
+    }
+#endif
+
     return true;
 }
 
@@ -54,6 +54,29 @@ bool
 check_suspend_flags(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     bool check_terminate_and_suspend);
 
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+/* Reserve the LLVM block at the entry of a basic block which charges its
+   instructions, the charge is emitted once they are all translated */
+bool
+aot_reserve_instruction_metering(AOTCompContext *comp_ctx,
+                                 AOTFuncContext *func_ctx,
+                                 LLVMBasicBlockRef *p_metering_block);
+
+/* Charge count instructions from exec_env->instructions_to_execute in
+   the LLVM block reserved by aot_reserve_instruction_metering */
+bool
+aot_compile_instruction_metering(AOTCompContext *comp_ctx,
+                                 AOTFuncContext *func_ctx,
+                                 LLVMBasicBlockRef metering_block,
+                                 uint32 count);
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* Compare the global epoch with the epoch deadline of the module instance */
+bool
+aot_check_epoch_deadline(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+#endif
+
 #if WASM_ENABLE_GC != 0
 bool
 aot_compile_op_br_on_null(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -71,6 +94,25 @@ aot_compile_op_br_on_cast(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 br_depth, uint8 **p_frame_ip);
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+bool
+aot_compile_op_catch(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint8 **p_frame_ip);
+
+bool
+aot_compile_op_throw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint32 tag_idx, uint8 **p_frame_ip);
+
+bool
+aot_compile_op_rethrow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                       uint32 depth, uint8 **p_frame_ip);
+
+/* Check the wasm exception left by a returned callee, and dispatch it
+   to the catch clauses or return it to the caller */
+bool
+aot_check_callee_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+#endif
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
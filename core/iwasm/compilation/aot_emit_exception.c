@@ -186,3 +186,18 @@ aot_emit_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 fail:
     return false;
 }
+
+/* Return from the function after a runtime API called has thrown the
+   exception. If the callers don't check the exception after calls, throw
+   it again to let the runtime unwind to the entry of wasm function call */
+bool
+aot_emit_return_on_exception(AOTCompContext *comp_ctx,
+                             AOTFuncContext *func_ctx)
+{
+    if (!comp_ctx->enable_bound_check || comp_ctx->enable_trap_unwind)
+        return aot_emit_exception(comp_ctx, func_ctx, EXCE_ALREADY_THROWN,
+                                  false, NULL, NULL);
+
+    return aot_build_zero_function_ret(comp_ctx, func_ctx,
+                                       func_ctx->aot_func->func_type);
+}
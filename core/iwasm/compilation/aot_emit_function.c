@@ -36,8 +36,27 @@ is_win_platform(AOTCompContext *comp_ctx)
     return ret;
 }
 
+/* Whether to check the exception thrown by the callee after the call
+   returns. There is no need if the runtime unwinds the traps to the
+   entry of wasm function call, e.g. by the signal handler */
 static bool
-create_func_return_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+need_check_exception(AOTCompContext *comp_ctx)
+{
+    return !comp_ctx->enable_trap_unwind
+           && (comp_ctx->enable_bound_check || is_win_platform(comp_ctx));
+}
+
+/* Whether to check the exception thrown by the callee right after the
+   call returns. If exception handling is enabled, it is checked after
+   the callee's frame is freed, and dispatched to the catch clauses */
+static bool
+need_check_call_exception(AOTCompContext *comp_ctx)
+{
+    return !comp_ctx->enable_exce_handling && need_check_exception(comp_ctx);
+}
+
+bool
+aot_create_func_return_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 {
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
@@ -53,7 +72,22 @@ create_func_return_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         /* Create return IR */
         LLVMPositionBuilderAtEnd(comp_ctx->builder,
                                  func_ctx->func_return_block);
-        if (!comp_ctx->enable_bound_check) {
+        if (comp_ctx->enable_exce_handling) {
+            /* The wasm exception must be returned to the caller which
+               may catch it, rather than be unwound to the entry */
+            if (comp_ctx->aux_stack_frame_type
+                && comp_ctx->call_stack_features.frame_per_function
+                && !aot_free_frame_per_function_frame_for_aot_func(comp_ctx,
+                                                                   func_ctx)) {
+                return false;
+            }
+            if (!aot_build_zero_function_ret(comp_ctx, func_ctx,
+                                             aot_func_type)) {
+                return false;
+            }
+        }
+        else if (!comp_ctx->enable_bound_check
+                 || comp_ctx->enable_trap_unwind) {
             if (!aot_emit_exception(comp_ctx, func_ctx, EXCE_ALREADY_THROWN,
                                     false, NULL, NULL)) {
                 return false;
@@ -77,7 +111,7 @@ check_exception_thrown(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     LLVMValueRef value, cmp;
 
     /* Create function return block if it isn't created */
-    if (!create_func_return_block(comp_ctx, func_ctx))
+    if (!aot_create_func_return_block(comp_ctx, func_ctx))
         return false;
 
     /* Load the first byte of aot_module_inst->cur_exception, and check
@@ -121,7 +155,7 @@ check_call_return(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMValueRef cmp;
 
     /* Create function return block if it isn't created */
-    if (!create_func_return_block(comp_ctx, func_ctx))
+    if (!aot_create_func_return_block(comp_ctx, func_ctx))
         return false;
 
     if (!(cmp = LLVMBuildICmp(comp_ctx->builder, LLVMIntNE, res, I8_ZERO,
@@ -443,7 +477,8 @@ call_aot_invoke_c_api_native(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     /* Check whether exception was thrown when executing the function */
-    if (comp_ctx->enable_bound_check
+    if (!comp_ctx->enable_exce_handling && !comp_ctx->enable_trap_unwind
+        && comp_ctx->enable_bound_check
         && !check_call_return(comp_ctx, func_ctx, res)) {
         goto fail;
     }
@@ -506,7 +541,6 @@ call_aot_alloc_frame_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     LLVMBasicBlockRef frame_alloc_fail, frame_alloc_success;
-    AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
 
     param_types[0] = comp_ctx->exec_env_type;
     param_types[1] = I32_TYPE;
@@ -550,7 +584,7 @@ call_aot_alloc_frame_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     /* If frame alloc failed, return this function
         so the runtime can catch the exception */
     LLVMPositionBuilderAtEnd(comp_ctx->builder, frame_alloc_fail);
-    if (!aot_build_zero_function_ret(comp_ctx, func_ctx, aot_func_type)) {
+    if (!aot_emit_return_on_exception(comp_ctx, func_ctx)) {
         return false;
     }
 
@@ -738,8 +772,18 @@ alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             /* new_frame->sp = new_frame->lp + max_local_cell_num */
             if (!comp_ctx->is_jit_mode)
                 offset = I32_CONST(comp_ctx->pointer_size * 5);
-            else
+            else {
+#if WASM_ENABLE_FAST_INTERP == 0
                 offset = I32_CONST(offsetof(WASMInterpFrame, sp));
+#else
+                /* The fast interpreter frame has no sp, the llvm jit
+                   frames are disabled when the fast interpreter is the
+                   first tier */
+                aot_set_last_error(
+                    "llvm jit frames unsupported with fast interpreter");
+                return false;
+#endif
+            }
             CHECK_LLVM_CONST(offset);
             if (!(frame_sp_ptr = LLVMBuildInBoundsGEP2(
                       comp_ctx->builder, INT8_TYPE, new_frame, &offset, 1,
@@ -1248,7 +1292,7 @@ check_app_addr_and_convert(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     /* Check whether exception was thrown when executing the function */
-    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+    if (need_check_exception(comp_ctx)
         && !check_call_return(comp_ctx, func_ctx, res)) {
         return false;
     }
@@ -1416,6 +1460,7 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     uint8 wasm_ret_type;
     uint8 *ext_ret_types = NULL;
     const char *signature = NULL;
+    LLVMValueRef native_bitcode_func = NULL;
     bool ret = false;
     char buf[32];
     bool quick_invoke_c_api_import = false;
@@ -1631,7 +1676,37 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             ret_type = VOID_TYPE;
         }
 
-        if (!signature) {
+        /* Inline the host function if its LLVM bitcode was registered */
+        if (ext_ret_count == 0)
+            native_bitcode_func = aot_get_native_bitcode_func(
+                comp_ctx, import_funcs[func_idx].module_name,
+                import_funcs[func_idx].func_name, ret_type, param_types,
+                (uint32)param_count + 1);
+
+        if (native_bitcode_func) {
+            LLVMTypeRef native_func_type =
+                LLVMGlobalGetValueType(native_bitcode_func);
+
+            LLVMGetParamTypes(native_func_type, param_types);
+            for (i = 0; i < param_count + 1; i++) {
+                if (LLVMTypeOf(param_values[i]) != param_types[i]
+                    && !(param_values[i] = LLVMBuildBitCast(
+                             comp_ctx->builder, param_values[i],
+                             param_types[i], "native_arg"))) {
+                    aot_set_last_error("llvm bit cast failed.");
+                    goto fail;
+                }
+            }
+
+            if (!(value_ret = LLVMBuildCall2(
+                      comp_ctx->builder, native_func_type, native_bitcode_func,
+                      param_values, (uint32)param_count + 1,
+                      (func_type->result_count > 0 ? "call" : "")))) {
+                aot_set_last_error("LLVM build call failed.");
+                goto fail;
+            }
+        }
+        else if (!signature) {
             if (comp_ctx->quick_invoke_c_api_import) {
                 uint32 buf_size_needed =
                     sizeof(wasm_val_t) * (param_count + result_count);
@@ -1665,7 +1740,7 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     goto fail;
                 /* Check whether there was exception thrown when executing
                    the function */
-                if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+                if (need_check_call_exception(comp_ctx)
                     && !check_call_return(comp_ctx, func_ctx, res))
                     goto fail;
             }
@@ -1716,7 +1791,8 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
             /* Check whether there was exception thrown when executing
                the function */
-            if (!check_exception_thrown(comp_ctx, func_ctx)) {
+            if (!comp_ctx->enable_exce_handling
+                && !check_exception_thrown(comp_ctx, func_ctx)) {
                 goto fail;
             }
         }
@@ -1816,7 +1892,7 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         /* Check whether there was exception thrown when executing
            the function */
         if (!tail_call
-            && (comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+            && need_check_call_exception(comp_ctx)
             && !check_exception_thrown(comp_ctx, func_ctx))
             goto fail;
     }
@@ -1859,6 +1935,13 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Dispatch the wasm exception thrown by the callee */
+    if (comp_ctx->enable_exce_handling && !tail_call
+        && !aot_check_callee_exception(comp_ctx, func_ctx))
+        goto fail;
+#endif
+
     /* Insert suspend check point */
     if (comp_ctx->enable_thread_mgr) {
         if (!check_suspend_flags(comp_ctx, func_ctx, false))
@@ -2079,9 +2162,217 @@ call_aot_call_indirect_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+/* The number of the function indexes cached for each call_indirect site */
+#define CALL_INDIRECT_CACHE_SIZE 2
+/* The empty cache entry, which differs from any function index and from
+   the -1 of the uninitialized table element */
+#define CALL_INDIRECT_CACHE_EMPTY ((uint32)-2)
+
+/**
+ * Create the inline cache of a call_indirect site, which records the indexes
+ * of the functions that have passed the function type check of the site.
+ * The result of the check only depends on the module, so the cache is a
+ * global variable shared by all the instances.
+ */
+static LLVMValueRef
+create_call_indirect_cache(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMValueRef cache, values[CALL_INDIRECT_CACHE_SIZE], init_value;
+    LLVMValueRef empty_value;
+    LLVMTypeRef cache_type;
+    uint32 i;
+
+    if (!(cache_type = LLVMArrayType(I32_TYPE, CALL_INDIRECT_CACHE_SIZE))) {
+        aot_set_last_error("llvm get array type failed.");
+        return NULL;
+    }
+
+    if (!(cache = LLVMAddGlobal(func_ctx->module, cache_type,
+                                "call_indirect_cache"))) {
+        aot_set_last_error("llvm add global failed.");
+        return NULL;
+    }
+
+    if (!(empty_value = I32_CONST(CALL_INDIRECT_CACHE_EMPTY))) {
+        aot_set_last_error("llvm build const failed.");
+        return NULL;
+    }
+
+    for (i = 0; i < CALL_INDIRECT_CACHE_SIZE; i++)
+        values[i] = empty_value;
+
+    if (!(init_value =
+              LLVMConstArray(I32_TYPE, values, CALL_INDIRECT_CACHE_SIZE))) {
+        aot_set_last_error("llvm build const array failed.");
+        return NULL;
+    }
+
+    LLVMSetInitializer(cache, init_value);
+    LLVMSetLinkage(cache, LLVMInternalLinkage);
+    LLVMSetAlignment(cache, 4);
+    return cache;
+}
+
+static LLVMValueRef
+get_call_indirect_cache_entry(AOTCompContext *comp_ctx, LLVMValueRef cache,
+                              uint32 entry_idx)
+{
+    LLVMValueRef entry, indices[2];
+
+    indices[0] = I32_ZERO;
+    if (!(indices[1] = I32_CONST(entry_idx))) {
+        aot_set_last_error("llvm build const failed.");
+        return NULL;
+    }
+
+    if (!(entry = LLVMBuildInBoundsGEP2(
+              comp_ctx->builder,
+              LLVMArrayType(I32_TYPE, CALL_INDIRECT_CACHE_SIZE), cache,
+              indices, 2, "cache_entry"))) {
+        aot_set_last_error("llvm build inbounds gep failed.");
+        return NULL;
+    }
+    return entry;
+}
+
+/**
+ * Jump to block_type_checked if func_idx is in the inline cache, otherwise
+ * continue to check the function type in a new block. The entries are
+ * accessed with unordered atomic operations as they may be updated by the
+ * other threads at the same time.
+ */
+static bool
+check_call_indirect_cache(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                          LLVMValueRef cache, LLVMValueRef func_idx,
+                          LLVMValueRef *cache_values,
+                          LLVMBasicBlockRef block_type_checked)
+{
+    LLVMValueRef entry, cmp, cache_hit = NULL;
+    LLVMBasicBlockRef block_cache_miss;
+    uint32 i;
+
+    for (i = 0; i < CALL_INDIRECT_CACHE_SIZE; i++) {
+        if (!(entry = get_call_indirect_cache_entry(comp_ctx, cache, i)))
+            return false;
+
+        if (!(cache_values[i] = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE,
+                                               entry, "cached_func_idx"))) {
+            aot_set_last_error("llvm build load failed.");
+            return false;
+        }
+        LLVMSetAlignment(cache_values[i], 4);
+        LLVMSetOrdering(cache_values[i], LLVMAtomicOrderingUnordered);
+
+        if (!(cmp = LLVMBuildICmp(comp_ctx->builder, LLVMIntEQ, func_idx,
+                                  cache_values[i], "cmp_cached_func_idx"))) {
+            aot_set_last_error("llvm build icmp failed.");
+            return false;
+        }
+
+        if (!cache_hit)
+            cache_hit = cmp;
+        else if (!(cache_hit = LLVMBuildOr(comp_ctx->builder, cache_hit, cmp,
+                                           "cache_hit"))) {
+            aot_set_last_error("llvm build or failed.");
+            return false;
+        }
+    }
+
+    if (!(block_cache_miss = LLVMAppendBasicBlockInContext(
+              comp_ctx->context, func_ctx->func, "call_indirect_cache_miss"))) {
+        aot_set_last_error("llvm add basic block failed.");
+        return false;
+    }
+    LLVMMoveBasicBlockAfter(block_cache_miss,
+                            LLVMGetInsertBlock(comp_ctx->builder));
+
+    if (!LLVMBuildCondBr(comp_ctx->builder, cache_hit, block_type_checked,
+                         block_cache_miss)) {
+        aot_set_last_error("llvm build cond br failed.");
+        return false;
+    }
+
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, block_cache_miss);
+    return true;
+}
+
+/**
+ * Record func_idx, which has just passed the function type check, in the
+ * first empty entry of the inline cache and jump to block_type_checked.
+ * A full cache isn't updated any more, so that a megamorphic call site
+ * doesn't keep writing the cache.
+ */
+static bool
+update_call_indirect_cache(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           LLVMValueRef cache, LLVMValueRef func_idx,
+                           LLVMValueRef *cache_values,
+                           LLVMBasicBlockRef block_type_checked)
+{
+    LLVMValueRef entry, empty_value, cmp, store;
+    LLVMBasicBlockRef block_fill, block_next;
+    uint32 i;
+
+    if (!(empty_value = I32_CONST(CALL_INDIRECT_CACHE_EMPTY))) {
+        aot_set_last_error("llvm build const failed.");
+        return false;
+    }
+
+    for (i = 0; i < CALL_INDIRECT_CACHE_SIZE; i++) {
+        if (!(cmp = LLVMBuildICmp(comp_ctx->builder, LLVMIntEQ,
+                                  cache_values[i], empty_value,
+                                  "is_cache_entry_empty"))) {
+            aot_set_last_error("llvm build icmp failed.");
+            return false;
+        }
+
+        if (!(block_fill = LLVMAppendBasicBlockInContext(
+                  comp_ctx->context, func_ctx->func, "call_indirect_cache_fill"))
+            || !(block_next = LLVMAppendBasicBlockInContext(
+                     comp_ctx->context, func_ctx->func,
+                     "call_indirect_cache_next"))) {
+            aot_set_last_error("llvm add basic block failed.");
+            return false;
+        }
+        LLVMMoveBasicBlockAfter(block_fill,
+                                LLVMGetInsertBlock(comp_ctx->builder));
+        LLVMMoveBasicBlockAfter(block_next, block_fill);
+
+        if (!LLVMBuildCondBr(comp_ctx->builder, cmp, block_fill, block_next)) {
+            aot_set_last_error("llvm build cond br failed.");
+            return false;
+        }
+
+        LLVMPositionBuilderAtEnd(comp_ctx->builder, block_fill);
+        if (!(entry = get_call_indirect_cache_entry(comp_ctx, cache, i)))
+            return false;
+        if (!(store = LLVMBuildStore(comp_ctx->builder, func_idx, entry))) {
+            aot_set_last_error("llvm build store failed.");
+            return false;
+        }
+        LLVMSetAlignment(store, 4);
+        LLVMSetOrdering(store, LLVMAtomicOrderingUnordered);
+        if (!LLVMBuildBr(comp_ctx->builder, block_type_checked)) {
+            aot_set_last_error("llvm build br failed.");
+            return false;
+        }
+
+        LLVMPositionBuilderAtEnd(comp_ctx->builder, block_next);
+    }
+
+    if (!LLVMBuildBr(comp_ctx->builder, block_type_checked)) {
+        aot_set_last_error("llvm build br failed.");
+        return false;
+    }
+
+    LLVMMoveBasicBlockAfter(block_type_checked,
+                            LLVMGetInsertBlock(comp_ctx->builder));
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, block_type_checked);
+    return true;
+}
+
 bool
 aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                             uint32 type_idx, uint32 tbl_idx)
+                             uint32 type_idx, uint32 tbl_idx, bool tail_call)
 {
     AOTFuncType *func_type;
     LLVMValueRef tbl_idx_value, elem_idx, func_idx;
@@ -2102,7 +2393,8 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         check_ftype_idx_succ;
     LLVMBasicBlockRef check_func_idx_succ, block_return, block_curr;
     LLVMBasicBlockRef block_call_import, block_call_non_import;
-    LLVMValueRef offset;
+    LLVMBasicBlockRef block_type_checked = NULL;
+    LLVMValueRef offset, cache = NULL, cache_values[CALL_INDIRECT_CACHE_SIZE];
     uint32 total_param_count, func_param_count, func_result_count;
     uint32 ext_cell_num, param_cell_num, i, j;
     uint8 wasm_ret_type, *wasm_ret_types;
@@ -2356,7 +2648,24 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             aot_set_last_error("llvm build int cast failed.");
             goto fail;
         }
+    }
 
+    /* Skip checking the function if it has passed the checks at this
+       call site before */
+    if (comp_ctx->enable_call_indirect_cache) {
+        if (!(block_type_checked = LLVMAppendBasicBlockInContext(
+                  comp_ctx->context, func_ctx->func, "func_type_checked"))) {
+            aot_set_last_error("llvm add basic block failed.");
+            goto fail;
+        }
+
+        if (!(cache = create_call_indirect_cache(comp_ctx, func_ctx))
+            || !check_call_indirect_cache(comp_ctx, func_ctx, cache, func_idx,
+                                          cache_values, block_type_checked))
+            goto fail;
+    }
+
+    if (!comp_ctx->enable_gc) {
         /* Check if func_idx == -1 */
         if (!(cmp_func_idx =
                   LLVMBuildICmp(comp_ctx->builder, LLVMIntEQ, func_idx,
@@ -2427,6 +2736,11 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              cmp_ftype_idx, check_ftype_idx_succ)))
         goto fail;
 
+    if (comp_ctx->enable_call_indirect_cache
+        && !update_call_indirect_cache(comp_ctx, func_ctx, cache, func_idx,
+                                       cache_values, block_type_checked))
+        goto fail;
+
     /* Initialize parameter types of the LLVM function */
     total_param_count = 1 + func_param_count;
 
@@ -2624,7 +2938,7 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
 
     /* Check whether exception was thrown when executing the function */
-    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+    if (need_check_call_exception(comp_ctx)
         && !check_call_return(comp_ctx, func_ctx, res))
         goto fail;
 
@@ -2681,8 +2995,12 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
+    if (tail_call)
+        LLVMSetTailCall(value_ret, true);
+
     /* Check whether exception was thrown when executing the function */
-    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+    if (!tail_call
+        && need_check_call_exception(comp_ctx)
         && !check_exception_thrown(comp_ctx, func_ctx))
         goto fail;
 
@@ -2727,6 +3045,15 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 #endif
     }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Dispatch the wasm exception thrown by the callee, the one thrown
+       by a tail callee is returned to the caller as the try blocks of
+       this function have been left */
+    if (comp_ctx->enable_exce_handling && !tail_call
+        && !aot_check_callee_exception(comp_ctx, func_ctx))
+        goto fail;
+#endif
+
     /* Insert suspend check point */
     if (comp_ctx->enable_thread_mgr) {
         if (!check_suspend_flags(comp_ctx, func_ctx, false))
@@ -3112,7 +3439,8 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
 
     /* Check whether exception was thrown when executing the function */
-    if (comp_ctx->enable_bound_check
+    if (!comp_ctx->enable_exce_handling && !comp_ctx->enable_trap_unwind
+        && comp_ctx->enable_bound_check
         && !check_call_return(comp_ctx, func_ctx, res))
         goto fail;
 
@@ -3190,7 +3518,7 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* Check whether exception was thrown when executing the function */
     if (!tail_call
-        && (comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+        && need_check_call_exception(comp_ctx)
         && !check_exception_thrown(comp_ctx, func_ctx))
         goto fail;
 
@@ -3235,6 +3563,13 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 #endif
     }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Dispatch the wasm exception thrown by the callee */
+    if (comp_ctx->enable_exce_handling && !tail_call
+        && !aot_check_callee_exception(comp_ctx, func_ctx))
+        goto fail;
+#endif
+
     /* Insert suspend check point */
     if (comp_ctx->enable_thread_mgr) {
         if (!check_suspend_flags(comp_ctx, func_ctx, false))
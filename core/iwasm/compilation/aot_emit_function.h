@@ -18,7 +18,13 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
 bool
 aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                             uint32 type_idx, uint32 tbl_idx);
+                             uint32 type_idx, uint32 tbl_idx, bool tail_call);
+
+/* Create the basic block which returns from the function with the
+   exception thrown by the callee */
+bool
+aot_create_func_return_block(AOTCompContext *comp_ctx,
+                             AOTFuncContext *func_ctx);
 
 bool
 aot_compile_op_ref_null(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
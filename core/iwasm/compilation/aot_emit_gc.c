@@ -6,6 +6,7 @@
 #include "aot_emit_gc.h"
 #include "aot_compiler.h"
 #include "aot_emit_exception.h"
+#include "ems/ems_gc.h"
 
 #if WASM_ENABLE_GC != 0
 
@@ -87,7 +88,6 @@ aot_call_aot_create_func_obj(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 {
     LLVMValueRef gc_obj, cmp_gc_obj, param_values[5], func, value;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
-    AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     LLVMBasicBlockRef init_gc_obj_fail, init_gc_obj_succ;
 
@@ -132,7 +132,7 @@ aot_call_aot_create_func_obj(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     /* If init gc_obj failed, return this function
        so the runtime can catch the exception */
     LLVMPositionBuilderAtEnd(comp_ctx->builder, init_gc_obj_fail);
-    if (!aot_build_zero_function_ret(comp_ctx, func_ctx, aot_func_type)) {
+    if (!aot_emit_return_on_exception(comp_ctx, func_ctx)) {
         goto fail;
     }
 
@@ -527,12 +527,231 @@ fail:
     return false;
 }
 
+/* The indexes of exec_env->gc_tlab.top and exec_env->gc_tlab.limit in
+   pointer size, see the static asserts in aot_runtime.c */
+#define GC_TLAB_TOP_INDEX 13
+#define GC_TLAB_LIMIT_INDEX 14
+
+/* The size of the hmu header of a gc object */
+#define GC_HMU_HEADER_SIZE 4
+
+static bool
+gc_tlab_can_alloc_inline(AOTCompContext *comp_ctx, uint64 obj_size)
+{
+    return comp_ctx->enable_gc_tlab && obj_size <= GC_TLAB_MAX_OBJ_SIZE;
+}
+
+/**
+ * Allocate a gc object from the TLAB of exec_env inline in the same way
+ * as gc_alloc_wo_tlab, jump to block_slow if the TLAB is exhausted or
+ * isn't set. The hmu headers and the object header are written, and the
+ * rest of the object is left to the caller, with the builder positioned
+ * at the end of the fast path.
+ */
+static bool
+aot_gc_tlab_alloc(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                  uint32 obj_size, LLVMValueRef rtt_type,
+                  LLVMBasicBlockRef block_slow, LLVMValueRef *p_obj)
+{
+    LLVMValueRef offset, top_ptr, limit_ptr, top, limit, new_top, cmp;
+    LLVMValueRef rest_size, header, header_ptr, obj, obj_header_ptr, res;
+    LLVMBasicBlockRef block_fast;
+    uint32 hmu_size = align_uint(obj_size + GC_HMU_HEADER_SIZE, 8);
+
+    if (hmu_size < GC_TLAB_MIN_REST_SIZE)
+        hmu_size = GC_TLAB_MIN_REST_SIZE;
+
+    ADD_BASIC_BLOCK(block_fast, "tlab_alloc_fast");
+    MOVE_BLOCK_AFTER_CURR(block_fast);
+
+    offset = I32_CONST(GC_TLAB_TOP_INDEX);
+    if (!(top_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                          func_ctx->exec_env, &offset, 1,
+                                          "tlab_top_ptr"))
+        || !(top = LLVMBuildLoad2(comp_ctx->builder, INT8_PTR_TYPE, top_ptr,
+                                  "tlab_top"))) {
+        aot_set_last_error("load gc_tlab.top failed.");
+        goto fail;
+    }
+
+    offset = I32_CONST(GC_TLAB_LIMIT_INDEX);
+    if (!(limit_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                            func_ctx->exec_env, &offset, 1,
+                                            "tlab_limit_ptr"))
+        || !(limit = LLVMBuildLoad2(comp_ctx->builder, INT8_PTR_TYPE,
+                                    limit_ptr, "tlab_limit"))) {
+        aot_set_last_error("load gc_tlab.limit failed.");
+        goto fail;
+    }
+
+    /* top and limit are NULL if the TLAB isn't set, don't use inbounds gep */
+    offset = I32_CONST(hmu_size);
+    if (!(new_top = LLVMBuildGEP2(comp_ctx->builder, INT8_TYPE, top, &offset,
+                                  1, "tlab_new_top"))) {
+        aot_set_last_error("llvm build gep failed.");
+        goto fail;
+    }
+
+    BUILD_ICMP(LLVMIntULE, new_top, limit, cmp, "tlab_has_space");
+    BUILD_COND_BR(cmp, block_fast, block_slow);
+
+    SET_BUILDER_POS(block_fast);
+
+    /* Write the hmu header of the object */
+    if (!(header_ptr = LLVMBuildBitCast(comp_ctx->builder, top, INT32_PTR_TYPE,
+                                        "hmu_header_ptr"))
+        || !LLVMBuildStore(comp_ctx->builder,
+                           I32_CONST(GC_TLAB_WO_HEADER(hmu_size)),
+                           header_ptr)) {
+        aot_set_last_error("llvm build store failed.");
+        goto fail;
+    }
+
+    /* Write the hmu header of the rest of the TLAB, whose size is
+       limit + GC_TLAB_MIN_REST_SIZE - new_top */
+    if (!(rest_size = LLVMBuildSub(
+              comp_ctx->builder,
+              LLVMBuildPtrToInt(comp_ctx->builder, limit, INTPTR_T_TYPE,
+                                "limit_int"),
+              LLVMBuildPtrToInt(comp_ctx->builder, new_top, INTPTR_T_TYPE,
+                                "new_top_int"),
+              "rest_size"))
+        || !(rest_size = LLVMBuildTruncOrBitCast(comp_ctx->builder, rest_size,
+                                                 I32_TYPE, "rest_size_i32"))
+        || !(rest_size = LLVMBuildAdd(comp_ctx->builder, rest_size,
+                                      I32_CONST(GC_TLAB_MIN_REST_SIZE),
+                                      "rest_size"))
+        || !(rest_size = LLVMBuildLShr(comp_ctx->builder, rest_size,
+                                       I32_CONST(3), "rest_size_shr"))
+        || !(header =
+                 LLVMBuildOr(comp_ctx->builder, rest_size,
+                             I32_CONST(GC_TLAB_REST_HEADER(0)), "rest_header"))
+        || !(header_ptr = LLVMBuildBitCast(comp_ctx->builder, new_top,
+                                           INT32_PTR_TYPE, "rest_header_ptr"))
+        || !LLVMBuildStore(comp_ctx->builder, header, header_ptr)) {
+        aot_set_last_error("llvm build rest header failed.");
+        goto fail;
+    }
+
+    /* obj = top + GC_HMU_HEADER_SIZE, obj->header = rtt_type */
+    offset = I32_CONST(GC_HMU_HEADER_SIZE);
+    if (!(obj = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, top,
+                                      &offset, 1, "tlab_obj"))) {
+        aot_set_last_error("llvm build gep failed.");
+        goto fail;
+    }
+
+    if (!(obj_header_ptr = LLVMBuildBitCast(comp_ctx->builder, obj,
+                                            GC_REF_PTR_TYPE, "obj_header_ptr"))
+        || !(res = LLVMBuildStore(comp_ctx->builder, rtt_type,
+                                  obj_header_ptr))) {
+        aot_set_last_error("llvm build store failed.");
+        goto fail;
+    }
+    if (!is_target_x86(comp_ctx))
+        LLVMSetAlignment(res, 4);
+
+    if (!LLVMBuildStore(comp_ctx->builder, new_top, top_ptr)) {
+        aot_set_last_error("llvm build store failed.");
+        goto fail;
+    }
+
+    *p_obj = obj;
+    return true;
+fail:
+    return false;
+}
+
+/* Zero the object allocated from the TLAB from offset start to the end of
+   its hmu, the size of which is 4 bytes aligned */
+static bool
+aot_gc_tlab_zero_obj(AOTCompContext *comp_ctx, LLVMValueRef obj,
+                     uint32 start, uint32 obj_size)
+{
+    LLVMValueRef offset, field_ptr;
+    uint32 hmu_size = align_uint(obj_size + GC_HMU_HEADER_SIZE, 8), i;
+
+    if (hmu_size < GC_TLAB_MIN_REST_SIZE)
+        hmu_size = GC_TLAB_MIN_REST_SIZE;
+
+    for (i = start; i < hmu_size - GC_HMU_HEADER_SIZE; i += sizeof(uint32)) {
+        offset = I32_CONST(i);
+        if (!(field_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
+                                                obj, &offset, 1, "field_ptr"))
+            || !(field_ptr = LLVMBuildBitCast(comp_ctx->builder, field_ptr,
+                                              INT32_PTR_TYPE, "field_ptr"))
+            || !LLVMBuildStore(comp_ctx->builder, I32_ZERO, field_ptr)) {
+            aot_set_last_error("llvm build store failed.");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Merge the object allocated by the fast path ending with block_fast
+   and the one allocated by the slow path ending with the current block */
+static bool
+aot_gc_tlab_alloc_join(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                       LLVMBasicBlockRef block_fast, LLVMValueRef obj_fast,
+                       LLVMValueRef obj_slow, LLVMValueRef *p_obj)
+{
+    LLVMBasicBlockRef block_slow = CURR_BLOCK(), block_succ;
+    LLVMValueRef phi;
+
+    ADD_BASIC_BLOCK(block_succ, "tlab_alloc_succ");
+    MOVE_BLOCK_AFTER_CURR(block_succ);
+
+    BUILD_BR(block_succ);
+
+    SET_BUILDER_POS(block_fast);
+    if (!(obj_fast = LLVMBuildBitCast(comp_ctx->builder, obj_fast, GC_REF_TYPE,
+                                      "obj_fast"))) {
+        aot_set_last_error("llvm build bitcast failed.");
+        goto fail;
+    }
+    BUILD_BR(block_succ);
+
+    SET_BUILDER_POS(block_succ);
+    if (!(phi = LLVMBuildPhi(comp_ctx->builder, GC_REF_TYPE, "gc_obj"))) {
+        aot_set_last_error("llvm build phi failed.");
+        goto fail;
+    }
+    LLVMAddIncoming(phi, &obj_fast, &block_fast, 1);
+    LLVMAddIncoming(phi, &obj_slow, &block_slow, 1);
+
+    *p_obj = phi;
+    return true;
+fail:
+    return false;
+}
+
+/* offsetof(WASMStructObject, field_data) + the size of the fields in the
+   target, the same as the total_size of the struct type in runtime */
+static uint32
+aot_struct_obj_size(AOTCompContext *comp_ctx, WASMStructType *struct_type)
+{
+    WASMStructFieldType *last_field;
+
+    if (struct_type->field_count == 0)
+        return comp_ctx->pointer_size;
+
+    last_field = &struct_type->fields[struct_type->field_count - 1];
+    return comp_ctx->pointer_size == sizeof(uint64)
+               ? last_field->field_offset_64bit + last_field->field_size_64bit
+               : last_field->field_offset_32bit + last_field->field_size_32bit;
+}
+
 bool
 aot_compile_op_struct_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 type_index, bool init_with_default)
 {
-    LLVMValueRef rtt_type, struct_obj, cmp;
+    LLVMValueRef rtt_type, struct_obj, cmp, struct_obj_fast = NULL;
     LLVMBasicBlockRef check_rtt_type_succ, check_struct_obj_succ;
+    LLVMBasicBlockRef alloc_slow, alloc_fast_end = NULL;
+    uint32 obj_size = aot_struct_obj_size(
+        comp_ctx, (WASMStructType *)comp_ctx->comp_data->types[type_index]);
+    bool alloc_inline = gc_tlab_can_alloc_inline(comp_ctx, obj_size);
 
     if (!aot_gen_commit_values(comp_ctx->aot_frame))
         return false;
@@ -553,13 +772,33 @@ aot_compile_op_struct_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             true, cmp, check_rtt_type_succ))
         goto fail;
 
+    /* Allocate the struct object from the TLAB of exec_env inline, and
+       call wasm_struct_obj_new if the TLAB is exhausted */
+    if (alloc_inline) {
+        ADD_BASIC_BLOCK(alloc_slow, "struct_alloc_slow");
+        MOVE_BLOCK_AFTER_CURR(alloc_slow);
+
+        if (!aot_gc_tlab_alloc(comp_ctx, func_ctx, obj_size, rtt_type,
+                               alloc_slow, &struct_obj_fast))
+            goto fail;
+
+        /* The fields are all set by WASM_OP_STRUCT_NEW */
+        if (init_with_default
+            && !aot_gc_tlab_zero_obj(comp_ctx, struct_obj_fast,
+                                     comp_ctx->pointer_size, obj_size))
+            goto fail;
+
+        alloc_fast_end = CURR_BLOCK();
+        SET_BUILDER_POS(alloc_slow);
+    }
+
     /* Generate call wasm_struct_obj_new and check for exception */
     if (!aot_call_wasm_struct_obj_new(comp_ctx, func_ctx, rtt_type,
                                       &struct_obj))
         goto fail;
 
     ADD_BASIC_BLOCK(check_struct_obj_succ, "check struct obj succ");
-    MOVE_BLOCK_AFTER(check_struct_obj_succ, check_rtt_type_succ);
+    MOVE_BLOCK_AFTER_CURR(check_struct_obj_succ);
 
     BUILD_ISNULL(struct_obj, cmp, "cmp_struct_obj");
     if (!aot_emit_exception(comp_ctx, func_ctx,
@@ -569,6 +808,11 @@ aot_compile_op_struct_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     SET_BUILDER_POS(check_struct_obj_succ);
 
+    if (alloc_inline
+        && !aot_gc_tlab_alloc_join(comp_ctx, func_ctx, alloc_fast_end,
+                                   struct_obj_fast, struct_obj, &struct_obj))
+        goto fail;
+
     /* For WASM_OP_STRUCT_NEW, init field with poped value */
     if (!init_with_default
         && !struct_new_canon_init_fields(comp_ctx, func_ctx, type_index,
@@ -718,10 +962,22 @@ aot_call_wasm_array_obj_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             LLVMValueRef array_elem, LLVMValueRef *array_obj)
 {
     LLVMValueRef param_values[4], func, value, res, array_elem_ptr;
+    LLVMValueRef entry_first_inst;
     LLVMTypeRef param_types[4], ret_type, func_type, func_ptr_type;
+    LLVMBasicBlockRef block_curr = CURR_BLOCK(), block_entry;
 
-    if (!(array_elem_ptr = LLVMBuildAlloca(
-              comp_ctx->builder, LLVMTypeOf(array_elem), "array_elem_ptr"))) {
+    /* Create the alloca in the entry block, or the native stack grows
+       each time when array.new is executed in a loop */
+    block_entry = LLVMGetEntryBasicBlock(func_ctx->func);
+    if ((entry_first_inst = LLVMGetFirstInstruction(block_entry)))
+        LLVMPositionBuilderBefore(comp_ctx->builder, entry_first_inst);
+    else
+        SET_BUILDER_POS(block_entry);
+
+    array_elem_ptr = LLVMBuildAlloca(comp_ctx->builder, LLVMTypeOf(array_elem),
+                                     "array_elem_ptr");
+    SET_BUILDER_POS(block_curr);
+    if (!array_elem_ptr) {
         aot_set_last_error("llvm build alloca failed.");
         goto fail;
     }
@@ -1117,12 +1373,22 @@ aot_compile_op_array_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                          bool fixed_size, uint32 array_len)
 {
     LLVMValueRef array_length, array_elem = NULL, array_obj;
-    LLVMValueRef rtt_type, cmp, elem_idx;
+    LLVMValueRef rtt_type, cmp, elem_idx, array_obj_fast = NULL;
+    LLVMValueRef offset, length_ptr;
     LLVMBasicBlockRef check_rtt_type_succ, check_array_obj_succ;
+    LLVMBasicBlockRef alloc_slow, alloc_fast_end = NULL;
     /* Use for distinguish what type of AOTValue POP */
     WASMArrayType *compile_time_array_type =
         (WASMArrayType *)comp_ctx->comp_data->types[type_index];
     uint8 array_elem_type = compile_time_array_type->elem_type;
+    uint32 elem_size_log =
+        aot_array_obj_elem_size_log(comp_ctx, array_elem_type);
+    uint64 obj_size = (uint64)comp_ctx->pointer_size + sizeof(uint32)
+                      + ((uint64)array_len << elem_size_log);
+    /* Only the array whose length is known at compile time is allocated
+       inline, all of its elements are set by WASM_OP_ARRAY_NEW_FIXED */
+    bool alloc_inline =
+        fixed_size && gc_tlab_can_alloc_inline(comp_ctx, obj_size);
     uint32 i;
 
     if (!aot_gen_commit_values(comp_ctx->aot_frame))
@@ -1178,19 +1444,52 @@ aot_compile_op_array_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         array_elem = I64_ZERO;
     }
 
+    if (alloc_inline) {
+        ADD_BASIC_BLOCK(alloc_slow, "array_alloc_slow");
+        MOVE_BLOCK_AFTER_CURR(alloc_slow);
+
+        if (!aot_gc_tlab_alloc(comp_ctx, func_ctx, (uint32)obj_size, rtt_type,
+                               alloc_slow, &array_obj_fast))
+            goto fail;
+
+        /* array_obj->length = (array_len << 2) | elem_size_log */
+        offset = I32_CONST(comp_ctx->pointer_size);
+        if (!(length_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
+                                                 array_obj_fast, &offset, 1,
+                                                 "length_ptr"))
+            || !(length_ptr = LLVMBuildBitCast(comp_ctx->builder, length_ptr,
+                                               INT32_PTR_TYPE, "length_ptr"))
+            || !LLVMBuildStore(
+                comp_ctx->builder,
+                I32_CONST((array_len << WASM_ARRAY_LENGTH_SHIFT)
+                          | elem_size_log),
+                length_ptr)) {
+            aot_set_last_error("llvm build store failed.");
+            goto fail;
+        }
+
+        alloc_fast_end = CURR_BLOCK();
+        SET_BUILDER_POS(alloc_slow);
+    }
+
     /* Generate call wasm_array_obj_new and check for exception */
     if (!aot_call_wasm_array_obj_new(comp_ctx, func_ctx, rtt_type, array_length,
                                      array_elem, &array_obj))
         goto fail;
 
     ADD_BASIC_BLOCK(check_array_obj_succ, "check array obj succ");
-    MOVE_BLOCK_AFTER(check_array_obj_succ, check_rtt_type_succ);
+    MOVE_BLOCK_AFTER_CURR(check_array_obj_succ);
 
     BUILD_ISNULL(array_obj, cmp, "cmp_array_obj");
     if (!aot_emit_exception(comp_ctx, func_ctx, EXCE_FAILED_TO_CREATE_ARRAY_OBJ,
                             true, cmp, check_array_obj_succ))
         goto fail;
 
+    if (alloc_inline
+        && !aot_gc_tlab_alloc_join(comp_ctx, func_ctx, alloc_fast_end,
+                                   array_obj_fast, array_obj, &array_obj))
+        goto fail;
+
     if (fixed_size) {
         for (i = 0; i < array_len; i++) {
             if (wasm_is_type_reftype(array_elem_type)) {
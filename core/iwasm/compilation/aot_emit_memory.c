@@ -1681,7 +1681,6 @@ aot_compile_op_memory_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 {
     LLVMValueRef seg, offset, dst, len, param_values[5], ret_value, func, value;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
-    AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     LLVMBasicBlockRef mem_init_fail, init_success;
 
@@ -1736,7 +1735,7 @@ aot_compile_op_memory_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     /* If memory.init failed, return this function
        so the runtime can catch the exception */
     LLVMPositionBuilderAtEnd(comp_ctx->builder, mem_init_fail);
-    if (!aot_build_zero_function_ret(comp_ctx, func_ctx, aot_func_type)) {
+    if (!aot_emit_return_on_exception(comp_ctx, func_ctx)) {
         goto fail;
     }
 
@@ -2148,7 +2147,6 @@ aot_compile_op_atomic_wait(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
     LLVMBasicBlockRef wait_fail, wait_success;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
-    AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
 
     POP_I64(timeout);
     if (op_type == VALUE_TYPE_I32) {
@@ -2210,7 +2208,7 @@ aot_compile_op_atomic_wait(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     /* If atomic wait failed, return this function
        so the runtime can catch the exception */
     LLVMPositionBuilderAtEnd(comp_ctx->builder, wait_fail);
-    if (!aot_build_zero_function_ret(comp_ctx, func_ctx, aot_func_type)) {
+    if (!aot_emit_return_on_exception(comp_ctx, func_ctx)) {
         goto fail;
     }
 
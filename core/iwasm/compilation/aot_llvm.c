@@ -1667,6 +1667,62 @@ fail:
 #endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
 }
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+static bool
+create_epoch_info(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMValueRef offset, epoch_ptr_p;
+    LLVMTypeRef epoch_ptr_p_type;
+    uint32 offset_u32;
+
+    if (!(epoch_ptr_p_type = LLVMPointerType(INT64_PTR_TYPE, 0))) {
+        aot_set_last_error("llvm add pointer type failed");
+        return false;
+    }
+
+    /* The address of the global epoch never changes, load it once */
+    get_module_extra_field_offset(epoch_ptr);
+    offset = I32_CONST(offset_u32);
+    CHECK_LLVM_CONST(offset);
+    if (!(epoch_ptr_p = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
+                                              func_ctx->aot_inst, &offset, 1,
+                                              "epoch_ptr_p"))) {
+        aot_set_last_error("llvm build inbounds gep failed");
+        goto fail;
+    }
+    if (!(epoch_ptr_p = LLVMBuildBitCast(comp_ctx->builder, epoch_ptr_p,
+                                         epoch_ptr_p_type, "epoch_ptr_p"))) {
+        aot_set_last_error("llvm build bit cast failed");
+        goto fail;
+    }
+    if (!(func_ctx->epoch_ptr = LLVMBuildLoad2(
+              comp_ctx->builder, INT64_PTR_TYPE, epoch_ptr_p, "epoch_ptr"))) {
+        aot_set_last_error("llvm build load failed");
+        goto fail;
+    }
+
+    /* The deadline may be changed by the runtime, only keep its address */
+    get_module_extra_field_offset(epoch_deadline);
+    offset = I32_CONST(offset_u32);
+    CHECK_LLVM_CONST(offset);
+    if (!(func_ctx->epoch_deadline_ptr = LLVMBuildInBoundsGEP2(
+              comp_ctx->builder, INT8_TYPE, func_ctx->aot_inst, &offset, 1,
+              "epoch_deadline_p"))) {
+        aot_set_last_error("llvm build inbounds gep failed");
+        goto fail;
+    }
+    if (!(func_ctx->epoch_deadline_ptr = LLVMBuildBitCast(
+              comp_ctx->builder, func_ctx->epoch_deadline_ptr, INT64_PTR_TYPE,
+              "epoch_deadline_p"))) {
+        aot_set_last_error("llvm build bit cast failed");
+        goto fail;
+    }
+    return true;
+fail:
+    return false;
+}
+#endif
+
 static bool
 create_cur_exception(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 {
@@ -1957,6 +2013,14 @@ aot_create_func_context(const AOTCompData *comp_data, AOTCompContext *comp_ctx,
         goto fail;
     }
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* Load the address of the global epoch and the epoch deadline */
+    if (comp_ctx->enable_epoch_interruption
+        && !create_epoch_info(comp_ctx, func_ctx)) {
+        goto fail;
+    }
+#endif
+
 #if WASM_ENABLE_BRANCH_HINTS != 0
     func_ctx->function_hints =
         comp_ctx->comp_data->function_hints
@@ -2625,6 +2689,220 @@ aot_compiler_destroy(void)
     LLVMShutdown();
 }
 
+#define NATIVE_BITCODE_FUNC_PREFIX "native_bitcode#"
+
+static bool
+is_native_bitcode_self_contained(LLVMModuleRef module)
+{
+    LLVMValueRef func, global;
+    const char *name;
+    size_t name_len;
+
+    for (func = LLVMGetFirstFunction(module); func;
+         func = LLVMGetNextFunction(func)) {
+        name = LLVMGetValueName2(func, &name_len);
+        if (LLVMIsDeclaration(func) && strncmp(name, "llvm.", 5)) {
+            LOG_WARNING("native bitcode calls external function %s", name);
+            return false;
+        }
+    }
+
+    for (global = LLVMGetFirstGlobal(module); global;
+         global = LLVMGetNextGlobal(global)) {
+        if (LLVMIsDeclaration(global)) {
+            name = LLVMGetValueName2(global, &name_len);
+            LOG_WARNING("native bitcode accesses external global %s", name);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Rename the external functions of the bitcode with the module name,
+   and let them be inlined into the AOT code */
+static bool
+prepare_native_bitcode_funcs(AOTCompContext *comp_ctx, LLVMModuleRef module,
+                             const char *module_name)
+{
+    LLVMValueRef func;
+    const char *name;
+    char *new_name;
+    size_t name_len;
+    uint32 kind_alwaysinline, kind_noinline, kind_optnone;
+    uint64 total_size;
+
+    kind_alwaysinline = LLVMGetEnumAttributeKindForName(
+        "alwaysinline", strlen("alwaysinline"));
+    kind_noinline =
+        LLVMGetEnumAttributeKindForName("noinline", strlen("noinline"));
+    kind_optnone =
+        LLVMGetEnumAttributeKindForName("optnone", strlen("optnone"));
+
+    for (func = LLVMGetFirstFunction(module); func;
+         func = LLVMGetNextFunction(func)) {
+        if (LLVMIsDeclaration(func))
+            continue;
+
+        /* Drop the attributes which prevent inlining into AOT code,
+           e.g. the bitcode was built with -O0 or another target cpu */
+        LLVMRemoveEnumAttributeAtIndex(func, LLVMAttributeFunctionIndex,
+                                       kind_noinline);
+        LLVMRemoveEnumAttributeAtIndex(func, LLVMAttributeFunctionIndex,
+                                       kind_optnone);
+        LLVMRemoveStringAttributeAtIndex(func, LLVMAttributeFunctionIndex,
+                                         "target-cpu", strlen("target-cpu"));
+        LLVMRemoveStringAttributeAtIndex(func, LLVMAttributeFunctionIndex,
+                                         "target-features",
+                                         strlen("target-features"));
+        LLVMAddAttributeAtIndex(
+            func, LLVMAttributeFunctionIndex,
+            LLVMCreateEnumAttribute(comp_ctx->context, kind_alwaysinline, 0));
+
+        if (LLVMGetLinkage(func) == LLVMInternalLinkage
+            || LLVMGetLinkage(func) == LLVMPrivateLinkage)
+            continue;
+
+        name = LLVMGetValueName2(func, &name_len);
+        total_size = strlen(NATIVE_BITCODE_FUNC_PREFIX) + strlen(module_name)
+                     + 1 + name_len + 1;
+        if (total_size >= UINT32_MAX
+            || !(new_name = wasm_runtime_malloc((uint32)total_size))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+        snprintf(new_name, (uint32)total_size, "%s%s#%s",
+                 NATIVE_BITCODE_FUNC_PREFIX, module_name, name);
+        LLVMSetValueName2(func, new_name, strlen(new_name));
+        wasm_runtime_free(new_name);
+    }
+    return true;
+}
+
+static bool
+aot_link_native_bitcode(AOTCompContext *comp_ctx)
+{
+    NativeBitcodeNode *node = wasm_native_get_bitcode_list();
+    LLVMMemoryBufferRef mem_buf;
+    LLVMModuleRef module;
+    LLVMValueRef func;
+    const char *name;
+    size_t name_len;
+    char *err_msg = NULL;
+
+    if (node && comp_ctx->is_indirect_mode) {
+        LOG_WARNING("native bitcode is ignored in indirect mode");
+        return true;
+    }
+
+    for (; node; node = node->next) {
+        if (!(mem_buf = LLVMCreateMemoryBufferWithMemoryRange(
+                  (const char *)node->buf, node->size, node->module_name,
+                  false))) {
+            aot_set_last_error("create LLVM memory buffer failed.");
+            return false;
+        }
+
+        /* Don't use LLVMParseBitcodeInContext2, which reports the error
+           to the diagnostic handler of the context and exits */
+        if (LLVMParseBitcodeInContext(comp_ctx->context, mem_buf, &module,
+                                      &err_msg)) {
+            LOG_WARNING("failed to parse native bitcode of module %s: %s",
+                        node->module_name, err_msg ? err_msg : "");
+            if (err_msg)
+                LLVMDisposeMessage(err_msg);
+            LLVMDisposeMemoryBuffer(mem_buf);
+            continue;
+        }
+        LLVMDisposeMemoryBuffer(mem_buf);
+
+        if (!is_native_bitcode_self_contained(module)) {
+            LOG_WARNING("native bitcode of module %s is ignored",
+                        node->module_name);
+            LLVMDisposeModule(module);
+            continue;
+        }
+
+        if (!prepare_native_bitcode_funcs(comp_ctx, module,
+                                          node->module_name)) {
+            LLVMDisposeModule(module);
+            return false;
+        }
+
+        LLVMSetTarget(module, LLVMGetTarget(comp_ctx->module));
+        LLVMSetDataLayout(module, LLVMGetDataLayoutStr(comp_ctx->module));
+
+        /* The source module is destroyed by the linker */
+        if (LLVMLinkModules2(comp_ctx->module, module)) {
+            aot_set_last_error("link native bitcode failed.");
+            return false;
+        }
+    }
+
+    /* Make them internal after linking, or the linker drops them as
+       they aren't referenced yet, and they are removed after inlining */
+    for (func = LLVMGetFirstFunction(comp_ctx->module); func;
+         func = LLVMGetNextFunction(func)) {
+        name = LLVMGetValueName2(func, &name_len);
+        if (!strncmp(name, NATIVE_BITCODE_FUNC_PREFIX,
+                     strlen(NATIVE_BITCODE_FUNC_PREFIX)))
+            LLVMSetLinkage(func, LLVMInternalLinkage);
+    }
+    return true;
+}
+
+LLVMValueRef
+aot_get_native_bitcode_func(AOTCompContext *comp_ctx, const char *module_name,
+                            const char *func_name, LLVMTypeRef ret_type,
+                            LLVMTypeRef *param_types, uint32 param_count)
+{
+    LLVMValueRef func;
+    LLVMTypeRef func_type, *func_param_types = NULL;
+    char buf[128];
+    uint32 i;
+    bool matched = false;
+
+    if (!wasm_native_get_bitcode_list())
+        return NULL;
+
+    snprintf(buf, sizeof(buf), "%s%s#%s", NATIVE_BITCODE_FUNC_PREFIX,
+             module_name, func_name);
+    if (!(func = LLVMGetNamedFunction(comp_ctx->module, buf))
+        || LLVMIsDeclaration(func))
+        return NULL;
+
+    /* Pointer types may differ in the typed pointer mode, the caller
+       casts the pointer arguments to the param types of func */
+    func_type = LLVMGlobalGetValueType(func);
+    if (LLVMGetReturnType(func_type) == ret_type
+        && LLVMCountParamTypes(func_type) == param_count
+        && !LLVMIsFunctionVarArg(func_type)) {
+        if (!(func_param_types =
+                  wasm_runtime_malloc(sizeof(LLVMTypeRef) * param_count))) {
+            aot_set_last_error("allocate memory failed.");
+            return NULL;
+        }
+        LLVMGetParamTypes(func_type, func_param_types);
+        for (i = 0; i < param_count; i++) {
+            if (func_param_types[i] != param_types[i]
+                && !(LLVMGetTypeKind(func_param_types[i])
+                         == LLVMPointerTypeKind
+                     && LLVMGetTypeKind(param_types[i])
+                            == LLVMPointerTypeKind))
+                break;
+        }
+        matched = (i == param_count);
+        wasm_runtime_free(func_param_types);
+    }
+
+    if (!matched) {
+        LOG_WARNING("native bitcode function (%s, %s) doesn't match the type "
+                    "of the import function",
+                    module_name, func_name);
+        return NULL;
+    }
+    return func;
+}
+
 AOTCompContext *
 aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
 {
@@ -2776,6 +3054,9 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
         comp_ctx->is_indirect_mode = true;
         /* avoid LUT relocations ("switch-table") */
         comp_ctx->disable_llvm_jump_tables = true;
+
+        if (option->enable_shared_text)
+            comp_ctx->enable_shared_text = true;
     }
 
     if (option->disable_llvm_intrinsics)
@@ -2787,6 +3068,11 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->disable_llvm_lto)
         comp_ctx->disable_llvm_lto = true;
 
+    /* The cache is a writable global variable, which isn't allowed in
+       the indirect mode */
+    if (!option->disable_call_indirect_cache && !option->is_indirect_mode)
+        comp_ctx->enable_call_indirect_cache = true;
+
     if (option->enable_llvm_pgo)
         comp_ctx->enable_llvm_pgo = true;
 
@@ -2808,6 +3094,27 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_gc)
         comp_ctx->enable_gc = true;
 
+    if (option->enable_gc && option->enable_gc_tlab)
+        comp_ctx->enable_gc_tlab = true;
+
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    if (option->enable_instruction_metering)
+        comp_ctx->enable_instruction_metering = true;
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    if (option->enable_epoch_interruption)
+        comp_ctx->enable_epoch_interruption = true;
+#endif
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Only the modules which have tags may throw wasm exceptions */
+    if (comp_data->wasm_module->import_tag_count
+            + comp_data->wasm_module->tag_count
+        > 0)
+        comp_ctx->enable_exce_handling = true;
+#endif
+
     if (option->enable_shared_heap)
         comp_ctx->enable_shared_heap = true;
 
@@ -2820,6 +3127,14 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     comp_ctx->opt_level = option->opt_level;
     comp_ctx->size_level = option->size_level;
 
+    /* Running the optimization passes in parallel isn't supported for
+       JIT, PGO and debug info yet */
+#if WASM_ENABLE_DEBUG_AOT == 0
+    if (!option->is_jit_mode && !option->enable_llvm_pgo
+        && !option->use_prof_file)
+        comp_ctx->jobs = option->jobs;
+#endif
+
     comp_ctx->custom_sections_wp = option->custom_sections;
     comp_ctx->custom_sections_count = option->custom_sections_count;
 
@@ -3231,6 +3546,19 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
             }
         }
 
+        if (option->enable_trap_unwind) {
+            /* The traps are unwound through the exception check guard
+               page of the runtime, which is only available for the
+               64-bit targets other than SGX and Windows */
+            if (!strstr(comp_ctx->target_arch, "64") || option->is_sgx_platform
+                || strstr(triple_norm, "win")) {
+                aot_set_last_error("trap unwinding is only supported for the "
+                                   "64-bit targets other than SGX and Windows");
+                goto fail;
+            }
+            comp_ctx->enable_trap_unwind = true;
+        }
+
         if (option->stack_bounds_checks == 1
             || option->stack_bounds_checks == 0) {
             /* Set by the user */
@@ -3451,6 +3779,9 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     comp_ctx->pointer_size = LLVMPointerSize(target_data_ref);
     LLVMDisposeTargetData(target_data_ref);
 
+    if (!aot_link_native_bitcode(comp_ctx))
+        goto fail;
+
     comp_ctx->optimize = true;
     if (option->output_format == AOT_LLVMIR_UNOPT_FILE)
         comp_ctx->optimize = false;
@@ -3833,6 +4164,12 @@ aot_block_destroy(AOTCompContext *comp_ctx, AOTBlock *block)
         wasm_runtime_free(block->result_types);
     if (block->result_phis)
         wasm_runtime_free(block->result_phis);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (block->wasm_code_catches)
+        wasm_runtime_free(block->wasm_code_catches);
+    if (block->llvm_catch_blocks)
+        wasm_runtime_free(block->llvm_catch_blocks);
+#endif
     wasm_runtime_free(block);
 }
 
@@ -3886,9 +4223,14 @@ aot_checked_addr_list_find(AOTFuncContext *func_ctx, uint32 local_idx,
 {
     AOTCheckedAddr *node = func_ctx->checked_addr_list;
 
+    /* A checked access [local + node->offset, local + node->offset +
+       node->bytes) proves that its end is inside the linear memory, and
+       the memory never shrinks, so any access through the same local
+       ending no later than that is also in bounds */
     while (node) {
-        if (node->local_idx == local_idx && node->offset == offset
-            && node->bytes >= bytes) {
+        if (node->local_idx == local_idx && offset <= UINT64_MAX - bytes
+            && node->offset <= UINT64_MAX - node->bytes
+            && offset + bytes <= node->offset + node->bytes) {
             return true;
         }
         node = node->next;
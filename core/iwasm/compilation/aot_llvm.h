@@ -15,7 +15,9 @@
 #include "llvm-c/OrcEE.h"
 #include "llvm-c/ExecutionEngine.h"
 #include "llvm-c/Analysis.h"
+#include "llvm-c/BitReader.h"
 #include "llvm-c/BitWriter.h"
+#include "llvm-c/Linker.h"
 #if LLVM_VERSION_MAJOR < 17
 #include "llvm-c/Transforms/Utils.h"
 #include "llvm-c/Transforms/Scalar.h"
@@ -194,6 +196,25 @@ typedef struct AOTBlock {
     /* The max frame stack pointer that br/br_if/br_table/br_on_xxx
        opcodes ever reached when they jumped to the end this block */
     AOTValueSlot *frame_sp_max_reached;
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Code of the catch/catch_all opcodes, if it is a TRY block */
+    uint8 **wasm_code_catches;
+    uint32 catch_count;
+    /* Index of the next catch clause to translate */
+    uint32 catch_idx;
+    /* Whether the try block ends with a delegate opcode */
+    bool is_delegate;
+    uint32 delegate_depth;
+    /* LLVM label which compares the tag of the exception in flight with
+       the ones of the catch clauses, created when it is first needed */
+    LLVMBasicBlockRef llvm_catch_dispatch_block;
+    /* LLVM labels point to code of the catch clauses */
+    LLVMBasicBlockRef *llvm_catch_blocks;
+    /* Buffer of the exception caught: the tag index, the cell number
+       of the values and the values, kept for rethrow */
+    LLVMValueRef exce_buf;
+#endif
 } AOTBlock;
 
 /**
@@ -203,7 +224,11 @@ typedef struct AOTBlockStack {
     AOTBlock *block_list_head;
     AOTBlock *block_list_end;
     /* Current block index of each block type */
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    uint32 block_index[LABEL_TYPE_TRY + 1];
+#else
     uint32 block_index[3];
+#endif
 } AOTBlockStack;
 
 typedef struct AOTCheckedAddr {
@@ -261,12 +286,22 @@ typedef struct AOTFuncContext {
     /* The start offset of the head of shared heap chain */
     LLVMValueRef shared_heap_head_start_off;
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* The address of the global epoch and of the epoch deadline */
+    LLVMValueRef epoch_ptr;
+    LLVMValueRef epoch_deadline_ptr;
+#endif
+
     LLVMBasicBlockRef got_exception_block;
     LLVMBasicBlockRef func_return_block;
     LLVMValueRef exception_id_phi;
     /* current ip when exception is thrown */
     LLVMValueRef exception_ip_phi;
     LLVMValueRef func_type_indexes;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Buffer of the values of the exception to throw */
+    LLVMValueRef exce_throw_buf;
+#endif
 #if WASM_ENABLE_DEBUG_AOT != 0
     LLVMMetadataRef debug_func;
 #endif
@@ -413,6 +448,9 @@ typedef struct AOTCompContext {
     bool is_indirect_mode;
     bh_list native_symbols;
 
+    /* Whether to align the code to the page size in the AOT file */
+    bool enable_shared_text;
+
     /* Bulk memory feature */
     bool enable_bulk_memory;
 
@@ -468,6 +506,10 @@ typedef struct AOTCompContext {
     /* Disable LLVM link time optimization */
     bool disable_llvm_lto;
 
+    /* Cache the functions which have passed the checks at each
+       call_indirect site to skip the checks next time */
+    bool enable_call_indirect_cache;
+
     /* Enable LLVM PGO (Profile-Guided Optimization) */
     bool enable_llvm_pgo;
 
@@ -502,12 +544,35 @@ typedef struct AOTCompContext {
     /* Enable GC */
     bool enable_gc;
 
+    /* Allocate the small gc objects from the TLAB of exec_env inline */
+    bool enable_gc_tlab;
+
+    /* The traps unwind to the entry of wasm function call, so the
+       exception isn't checked after calls */
+    bool enable_trap_unwind;
+
+    /* Charge the instructions of each basic block from
+       exec_env->instructions_to_execute */
+    bool enable_instruction_metering;
+
+    /* Compare the global epoch with the epoch deadline of the module
+       instance at the loop back-edges */
+    bool enable_epoch_interruption;
+
+    /* The module has tags: wasm exceptions are returned to the caller
+       and checked after calls, and dispatched to the catch clauses */
+    bool enable_exce_handling;
+
     bool enable_shared_heap;
     bool enable_shared_chain;
 
     uint32 opt_level;
     uint32 size_level;
 
+    /* The number of threads to run the LLVM optimization passes in
+       parallel, 0 means running them on the whole module in one thread */
+    uint32 jobs;
+
     /* LLVM floating-point rounding mode metadata */
     LLVMValueRef fp_rounding_mode;
 
@@ -578,6 +643,13 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx);
 int32
 aot_get_native_symbol_index(AOTCompContext *comp_ctx, const char *symbol);
 
+/* Get the function of the native bitcode linked for an import function,
+   return NULL if not found or its type doesn't match */
+LLVMValueRef
+aot_get_native_bitcode_func(AOTCompContext *comp_ctx, const char *module_name,
+                            const char *func_name, LLVMTypeRef ret_type,
+                            LLVMTypeRef *param_types, uint32 param_count);
+
 bool
 aot_compile_wasm(AOTCompContext *comp_ctx);
 
@@ -657,6 +729,9 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str);
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module);
 
+bool
+aot_apply_llvm_new_pass_manager_parallel(AOTCompContext *comp_ctx);
+
 void
 aot_handle_llvm_errmsg(const char *string, LLVMErrorRef err);
 
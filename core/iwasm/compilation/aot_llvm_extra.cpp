@@ -17,6 +17,11 @@
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/Support/TargetSelect.h>
+#if LLVM_VERSION_MAJOR >= 14
+#include <llvm/MC/TargetRegistry.h>
+#else
+#include <llvm/Support/TargetRegistry.h>
+#endif
 #include <llvm/Target/TargetMachine.h>
 #include <llvm-c/Core.h>
 #include <llvm-c/ExecutionEngine.h>
@@ -59,8 +64,27 @@
 #include <llvm/Analysis/AliasAnalysis.h>
 #endif
 #include <llvm/ProfileData/InstrProf.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Analysis/AssumptionCache.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/PatternMatch.h>
+#include <llvm/Transforms/InstCombine/InstCombine.h>
+#include <llvm/Transforms/Scalar/SimplifyCFG.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/LoopSimplify.h>
+#include <llvm/Transforms/Utils/LoopUtils.h>
+#include <llvm/Transforms/Utils/ScalarEvolutionExpander.h>
 
+#include <atomic>
 #include <cstring>
+#include <thread>
 #include "../aot/aot_runtime.h"
 #include "aot_llvm.h"
 
@@ -82,6 +106,9 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str);
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module);
 
+bool
+aot_apply_llvm_new_pass_manager_parallel(AOTCompContext *comp_ctx);
+
 LLVM_C_EXTERN_C_END
 
 ExitOnError ExitOnErr;
@@ -145,6 +172,465 @@ ExpandMemoryOpPass::run(Function &F, FunctionAnalysisManager &AM)
     return PA;
 }
 
+#if LLVM_VERSION_MAJOR >= 14
+/* Versions the innermost loops whose memory bounds checks are driven by an
+   affine induction variable: a test emitted in the preheader proves that
+   none of these checks can fail in any iteration the loop may run, and if
+   it holds, a copy of the loop with the checks removed is executed. If it
+   doesn't hold the original loop runs, so an out of bounds access still
+   traps in the same iteration and after the same side effects. */
+class BoundsCheckVersioningPass
+  : public PassInfoMixin<BoundsCheckVersioningPass>
+{
+  public:
+    PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+};
+
+namespace {
+
+/* Don't duplicate the loops larger than this */
+const unsigned MaxVersionedLoopInsts = 512;
+
+/* The step is limited so that the whole range of an index can be computed
+   in 64-bit without overflow */
+const int64_t MaxVersionedLoopStep = (int64_t)1 << 30;
+
+/* A loop-variant index of the form Offset + zext({Start,+,Step}), in which
+   the add recurrence is at most 32-bit wide */
+struct AffineIndex {
+    const SCEVAddRecExpr *AddRec;
+    uint64_t Offset;
+    int64_t Step;
+    unsigned Bits;
+};
+
+/* An unsigned compare deciding whether a loop exit which can't be computed
+   statically, e.g. the one to throw an out of bounds exception, is taken */
+struct RangeCheck {
+    ICmpInst *Cmp;
+    /* The value of the compare when the loop isn't exited */
+    bool StayValue;
+    /* The compare in the form of "Index Pred Bound" which holds when the
+       loop isn't exited */
+    AffineIndex Index;
+    ICmpInst::Predicate Pred;
+    Value *Bound;
+    /* The last iteration in which the compare may be executed */
+    const SCEV *LastIter;
+};
+
+/* Match the zero extension of an expression, including the form
+   "C * zext(trunc(X /u C))" which the induction variable widening creates
+   for an "and" with a low bits mask */
+const SCEV *
+match_zext_operand(const SCEV *S, ScalarEvolution &SE)
+{
+    const SCEVConstant *Mul;
+    const SCEVZeroExtendExpr *ZExt;
+    const SCEVTruncateExpr *Trunc;
+    const SCEVUDivExpr *UDiv;
+    unsigned Shift;
+
+    if (auto *Ext = dyn_cast<SCEVZeroExtendExpr>(S))
+        return Ext->getOperand();
+
+    auto *MulExpr = dyn_cast<SCEVMulExpr>(S);
+    if (!MulExpr || MulExpr->getNumOperands() != 2
+        || !(Mul = dyn_cast<SCEVConstant>(MulExpr->getOperand(0)))
+        || !Mul->getAPInt().isPowerOf2()
+        || !(ZExt = dyn_cast<SCEVZeroExtendExpr>(MulExpr->getOperand(1)))
+        || !(Trunc = dyn_cast<SCEVTruncateExpr>(ZExt->getOperand()))
+        || !(UDiv = dyn_cast<SCEVUDivExpr>(Trunc->getOperand()))
+        || UDiv->getRHS() != Mul)
+        return nullptr;
+
+    /* The low bits cleared by the division must be zero already */
+    Shift = Mul->getAPInt().logBase2();
+#if LLVM_VERSION_MAJOR >= 17
+    if (SE.getMinTrailingZeros(UDiv->getLHS()) < Shift
+#else
+    if (SE.GetMinTrailingZeros(UDiv->getLHS()) < Shift
+#endif
+        || Trunc->getType()->getIntegerBitWidth() + Shift
+               > S->getType()->getIntegerBitWidth())
+        return nullptr;
+
+    return SE.getTruncateExpr(
+        UDiv->getLHS(),
+        IntegerType::get(S->getType()->getContext(),
+                         Trunc->getType()->getIntegerBitWidth() + Shift));
+}
+
+bool
+match_affine_index(const SCEV *S, const Loop *L, ScalarEvolution &SE,
+                   AffineIndex &Index)
+{
+    const SCEVAddRecExpr *AddRec;
+    const SCEVConstant *Step;
+    const SCEV *Operand;
+
+    Index.Bits = S->getType()->getIntegerBitWidth();
+    Index.Offset = 0;
+    if (auto *Add = dyn_cast<SCEVAddExpr>(S)) {
+        auto *Offset = dyn_cast<SCEVConstant>(Add->getOperand(0));
+        if (Add->getNumOperands() != 2 || !Offset
+            || Offset->getAPInt().getActiveBits() > 32
+            || !match_zext_operand(Add->getOperand(1), SE))
+            return false;
+        Index.Offset = Offset->getAPInt().getZExtValue();
+        S = Add->getOperand(1);
+    }
+    if ((Operand = match_zext_operand(S, SE)))
+        S = Operand;
+
+    if (!(AddRec = dyn_cast<SCEVAddRecExpr>(S)) || AddRec->getLoop() != L
+        || !AddRec->isAffine() || AddRec->getType()->getIntegerBitWidth() > 32
+        || !(Step = dyn_cast<SCEVConstant>(AddRec->getOperand(1))))
+        return false;
+
+    Index.AddRec = AddRec;
+    Index.Step = Step->getAPInt().getSExtValue();
+    return Index.Step != 0 && Index.Step <= MaxVersionedLoopStep
+           && Index.Step >= -MaxVersionedLoopStep;
+}
+
+void
+collect_range_checks(Value *Cond, bool StayValue, const SCEV *LastIter,
+                     const Loop *L, ScalarEvolution &SE,
+                     SmallVectorImpl<RangeCheck> &Checks, unsigned Depth)
+{
+    using namespace PatternMatch;
+    RangeCheck Check;
+    Value *A, *B, *Index;
+    ICmpInst *Cmp;
+
+    if (Depth > 16)
+        return;
+
+    /* The loop is exited if any operand of an "or" is true, or if any
+       operand of an "and" is false */
+    if (StayValue ? match(Cond, m_LogicalAnd(m_Value(A), m_Value(B)))
+                  : match(Cond, m_LogicalOr(m_Value(A), m_Value(B)))) {
+        collect_range_checks(A, StayValue, LastIter, L, SE, Checks,
+                             Depth + 1);
+        collect_range_checks(B, StayValue, LastIter, L, SE, Checks,
+                             Depth + 1);
+        return;
+    }
+
+    if (!(Cmp = dyn_cast<ICmpInst>(Cond)) || !L->contains(Cmp)
+        || !Cmp->isRelational() || !Cmp->isUnsigned()
+        || !Cmp->getOperand(0)->getType()->isIntegerTy()
+        || Cmp->getOperand(0)->getType()->getIntegerBitWidth() > 64)
+        return;
+
+    for (RangeCheck &Existing : Checks) {
+        if (Existing.Cmp == Cmp)
+            return;
+    }
+
+    Check.Cmp = Cmp;
+    Check.StayValue = StayValue;
+    Check.LastIter = LastIter;
+    Check.Pred = StayValue ? Cmp->getPredicate() : Cmp->getInversePredicate();
+    Index = Cmp->getOperand(0);
+    Check.Bound = Cmp->getOperand(1);
+    if (L->isLoopInvariant(Index)) {
+        std::swap(Index, Check.Bound);
+        Check.Pred = ICmpInst::getSwappedPredicate(Check.Pred);
+    }
+
+    if (!L->isLoopInvariant(Check.Bound)
+        || !match_affine_index(SE.getSCEV(Index), L, SE, Check.Index))
+        return;
+
+    Checks.push_back(Check);
+}
+
+void
+collect_loop_range_checks(const Loop *L, DominatorTree &DT,
+                          ScalarEvolution &SE,
+                          SmallVectorImpl<RangeCheck> &Checks)
+{
+    SmallVector<BasicBlock *, 8> ExitingBlocks;
+    const SCEV *MaxBTC = SE.getSymbolicMaxBackedgeTakenCount(L);
+
+    if (isa<SCEVCouldNotCompute>(MaxBTC)
+        || MaxBTC->getType()->getIntegerBitWidth() > 64)
+        return;
+
+    L->getExitingBlocks(ExitingBlocks);
+    for (BasicBlock *Exiting : ExitingBlocks) {
+        auto *Br = dyn_cast<BranchInst>(Exiting->getTerminator());
+        const SCEV *LastIter = MaxBTC;
+
+        if (!Br || !Br->isConditional()
+            || !isa<SCEVCouldNotCompute>(SE.getExitCount(L, Exiting)))
+            continue;
+
+        /* If a countable exit is always tested before the block, e.g. in
+           the loop header, the block isn't executed in the iteration where
+           that exit is taken. The count minus one wraps around if it is
+           zero, which just makes the test fail. */
+        for (BasicBlock *Other : ExitingBlocks) {
+            const SCEV *ExitCount = SE.getExitCount(L, Other);
+
+            if (Other != Exiting && !isa<SCEVCouldNotCompute>(ExitCount)
+                && ExitCount->getType()->getIntegerBitWidth() <= 64
+                && DT.dominates(Other, Exiting)) {
+                LastIter = SE.getMinusSCEV(
+                    ExitCount, SE.getOne(ExitCount->getType()));
+                break;
+            }
+        }
+
+        /* The loop stays if the condition is false when the true
+           successor leaves the loop, and vice versa */
+        collect_range_checks(Br->getCondition(),
+                             L->contains(Br->getSuccessor(0)), LastIter, L,
+                             SE, Checks, 0);
+    }
+}
+
+/* Emit the test that none of the checks fails in the iterations they may
+   run, the checks which can't be tested are removed from the list */
+Value *
+emit_range_checks_test(SmallVectorImpl<RangeCheck> &Checks,
+                       ScalarEvolution &SE, SCEVExpander &Expander,
+                       Instruction *InsertPt)
+{
+    IRBuilder<> Builder(InsertPt);
+    Type *I64Ty = Builder.getInt64Ty();
+    Value *Result = nullptr;
+    unsigned i = 0;
+
+    while (i < Checks.size()) {
+        RangeCheck &Check = Checks[i];
+        AffineIndex &Index = Check.Index;
+        const SCEV *Start = Index.AddRec->getStart();
+        Value *Count, *First, *Dist, *Min, *Max, *Bound, *Cond;
+        uint64_t Step =
+            Index.Step > 0 ? (uint64_t)Index.Step : (uint64_t)-Index.Step;
+
+#if LLVM_VERSION_MAJOR >= 16
+        if (!Expander.isSafeToExpandAt(Start, InsertPt)
+            || !Expander.isSafeToExpandAt(Check.LastIter, InsertPt)) {
+#else
+        if (!isSafeToExpandAt(Start, InsertPt, SE)
+            || !isSafeToExpandAt(Check.LastIter, InsertPt, SE)) {
+#endif
+            Checks.erase(Checks.begin() + i);
+            continue;
+        }
+
+        /* The iteration count is limited to 32-bit so that the range of
+           the index can't overflow */
+        Count = Expander.expandCodeFor(Check.LastIter,
+                                       Check.LastIter->getType(), InsertPt);
+        Cond = Builder.getTrue();
+        if (Count->getType()->getIntegerBitWidth() > 32)
+            Cond = Builder.CreateICmpULE(
+                Count, ConstantInt::get(Count->getType(), UINT32_MAX));
+        Count = Builder.CreateZExt(Count, I64Ty);
+
+        First = Builder.CreateZExt(
+            Expander.expandCodeFor(Start, Start->getType(), InsertPt), I64Ty);
+        Dist = Builder.CreateMul(Count, ConstantInt::get(I64Ty, Step));
+
+        /* The add recurrence mustn't wrap around during the iterations, so
+           that the index changes monotonically */
+        if (Index.Step > 0) {
+            Min = First;
+            Max = Builder.CreateAdd(First, Dist);
+            Cond = Builder.CreateAnd(
+                Cond,
+                Builder.CreateICmpULE(
+                    Max, ConstantInt::get(
+                             I64Ty, APInt::getMaxValue(
+                                        Index.AddRec->getType()
+                                            ->getIntegerBitWidth())
+                                        .getZExtValue())));
+        }
+        else {
+            Min = Builder.CreateSub(First, Dist);
+            Max = First;
+            Cond = Builder.CreateAnd(Cond, Builder.CreateICmpUGE(First, Dist));
+        }
+
+        if (Index.Offset) {
+            Min = Builder.CreateAdd(Min, ConstantInt::get(I64Ty, Index.Offset));
+            Max = Builder.CreateAdd(Max, ConstantInt::get(I64Ty, Index.Offset));
+            if (Index.Bits < 64)
+                Cond = Builder.CreateAnd(
+                    Cond,
+                    Builder.CreateICmpULE(
+                        Max, ConstantInt::get(
+                                 I64Ty, APInt::getMaxValue(Index.Bits)
+                                            .getZExtValue())));
+        }
+
+        Bound = Builder.CreateZExt(Check.Bound, I64Ty);
+        switch (Check.Pred) {
+            case ICmpInst::ICMP_ULT:
+                Cond = Builder.CreateAnd(Cond, Builder.CreateICmpULT(Max, Bound));
+                break;
+            case ICmpInst::ICMP_ULE:
+                Cond = Builder.CreateAnd(Cond, Builder.CreateICmpULE(Max, Bound));
+                break;
+            case ICmpInst::ICMP_UGT:
+                Cond = Builder.CreateAnd(Cond, Builder.CreateICmpUGT(Min, Bound));
+                break;
+            default:
+                Cond = Builder.CreateAnd(Cond, Builder.CreateICmpUGE(Min, Bound));
+                break;
+        }
+
+        Result = Result ? Builder.CreateAnd(Result, Cond) : Cond;
+        i++;
+    }
+
+    return Result;
+}
+
+/* Returns true if the function is changed */
+bool
+version_loop(Loop *L, LoopInfo &LI, DominatorTree &DT, ScalarEvolution &SE,
+             AssumptionCache &AC, SmallPtrSetImpl<BasicBlock *> &Visited)
+{
+    SmallVector<RangeCheck, 8> Checks;
+    SmallVector<BasicBlock *, 8> ExitBlocks, ClonedBlocks;
+    ValueToValueMapTy VMap;
+    BasicBlock *CheckBB, *Preheader;
+    Instruction *InsertPt;
+    Value *Safe;
+    Loop *SlowLoop;
+    unsigned InstCount = 0;
+
+    if (!L->isInnermost() || !L->isSafeToClone())
+        return false;
+
+    for (BasicBlock *BB : L->blocks()) {
+        InstCount += BB->size();
+    }
+    if (InstCount > MaxVersionedLoopInsts)
+        return false;
+
+    collect_loop_range_checks(L, DT, SE, Checks);
+    if (Checks.empty())
+        return false;
+
+    /* Make sure that the loop has a preheader and dedicated exits, and that
+       the values defined in it are only used out of it by the PHIs of its
+       exit blocks, then collect the checks again as the loop may have been
+       changed */
+    simplifyLoop(L, &DT, &LI, &SE, &AC, nullptr, false);
+    formLCSSARecursively(*L, DT, &LI, &SE);
+    if (!L->isLoopSimplifyForm())
+        return true;
+
+    Checks.clear();
+    collect_loop_range_checks(L, DT, SE, Checks);
+    if (Checks.empty())
+        return true;
+
+    CheckBB = L->getLoopPreheader();
+    InsertPt = CheckBB->getTerminator();
+    SCEVExpander Expander(SE, CheckBB->getModule()->getDataLayout(),
+                          "bound_check");
+    if (!(Safe = emit_range_checks_test(Checks, SE, Expander, InsertPt)))
+        return true;
+
+    /* Clone the loop as the slow path, and run the original loop without
+       the checks if the test passes */
+    L->getUniqueExitBlocks(ExitBlocks);
+    Preheader = SplitBlock(CheckBB, InsertPt, &DT, &LI, nullptr,
+                           L->getHeader()->getName() + ".ph");
+    SlowLoop = cloneLoopWithPreheader(Preheader, CheckBB, L, VMap, ".slow",
+                                      &LI, &DT, ClonedBlocks);
+    remapInstructionsInBlocks(ClonedBlocks, VMap);
+    Visited.insert(SlowLoop->getHeader());
+
+    InsertPt = CheckBB->getTerminator();
+    BranchInst::Create(Preheader, SlowLoop->getLoopPreheader(), Safe,
+                       InsertPt);
+    InsertPt->eraseFromParent();
+
+    /* The two loops are merged in the exit blocks */
+    for (BasicBlock *Exit : ExitBlocks) {
+        for (PHINode &Phi : Exit->phis()) {
+            unsigned Count = Phi.getNumIncomingValues();
+
+            for (unsigned i = 0; i < Count; i++) {
+                BasicBlock *Pred = Phi.getIncomingBlock(i);
+                Value *Incoming = Phi.getIncomingValue(i);
+                Value *Mapped;
+
+                if (!L->contains(Pred))
+                    continue;
+                Mapped = VMap.lookup(Incoming);
+                Phi.addIncoming(Mapped ? Mapped : Incoming,
+                                cast<BasicBlock>(VMap[Pred]));
+            }
+        }
+    }
+
+    for (RangeCheck &Check : Checks) {
+        Check.Cmp->replaceAllUsesWith(
+            ConstantInt::getBool(Check.Cmp->getContext(), Check.StayValue));
+    }
+
+    return true;
+}
+
+} /* end of anonymous namespace */
+
+PreservedAnalyses
+BoundsCheckVersioningPass::run(Function &F, FunctionAnalysisManager &AM)
+{
+    SmallPtrSet<BasicBlock *, 16> Visited;
+    bool Changed = false, Restart;
+
+    if (F.isDeclaration())
+        return PreservedAnalyses::all();
+
+    /* The analyses are rebuilt after each loop is processed as the
+       versioning doesn't keep them up to date */
+    do {
+        DominatorTree DT(F);
+        LoopInfo LI(DT);
+        AssumptionCache AC(F);
+        ScalarEvolution SE(F, AM.getResult<TargetLibraryAnalysis>(F), AC, DT,
+                           LI);
+
+        Restart = false;
+        for (Loop *L : LI.getLoopsInPreorder()) {
+            if (Visited.insert(L->getHeader()).second
+                && version_loop(L, LI, DT, SE, AC, Visited)) {
+                Changed = Restart = true;
+                break;
+            }
+        }
+    } while (Restart);
+
+    if (!Changed)
+        return PreservedAnalyses::all();
+
+    /* Fold the removed checks and give the loops without checks another
+       chance to be vectorized */
+    AM.invalidate(F, PreservedAnalyses::none());
+    FunctionPassManager FPM;
+    FPM.addPass(InstCombinePass());
+    FPM.addPass(SimplifyCFGPass());
+    FPM.addPass(createFunctionToLoopPassAdaptor(LoopRotatePass()));
+    FPM.addPass(LoopVectorizePass());
+    FPM.addPass(InstCombinePass());
+    FPM.addPass(SimplifyCFGPass());
+    FPM.run(F, AM);
+
+    return PreservedAnalyses::none();
+}
+#endif /* end of LLVM_VERSION_MAJOR >= 14 */
+
 bool
 aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str)
 {
@@ -189,11 +675,9 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str)
 #endif /* WASM_ENABLE_SIMD */
 }
 
-void
-aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
+static void
+apply_llvm_passes(AOTCompContext *comp_ctx, TargetMachine *TM, Module *M)
 {
-    TargetMachine *TM =
-        reinterpret_cast<TargetMachine *>(comp_ctx->target_machine);
     PipelineTuningOptions PTO;
     PTO.LoopVectorization = true;
     PTO.SLPVectorization = true;
@@ -313,7 +797,6 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
     disable_llvm_lto = true;
 #endif
 
-    Module *M = reinterpret_cast<Module *>(module);
     if (disable_llvm_lto) {
         for (Function &F : *M) {
             F.addFnAttr("disable-tail-calls", "true");
@@ -392,6 +875,16 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
             }
         }
 
+#if LLVM_VERSION_MAJOR >= 14
+        if (comp_ctx->enable_bound_check && OptimizationLevel::O0 != OL) {
+            /* Hoist the bounds checks of the memory accesses indexed by
+               induction variables out of the loops */
+            FunctionPassManager FPM2;
+            FPM2.addPass(BoundsCheckVersioningPass());
+            MPM.addPass(createModuleToFunctionPassAdaptor(std::move(FPM2)));
+        }
+#endif
+
         /* Run specific passes for AOT indirect mode in last since general
             optimization may create some intrinsic function calls like
             llvm.memset, so let's remove these function calls here. */
@@ -405,6 +898,272 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
     MPM.run(*M, MAM);
 }
 
+void
+aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
+{
+    apply_llvm_passes(
+        comp_ctx, reinterpret_cast<TargetMachine *>(comp_ctx->target_machine),
+        reinterpret_cast<Module *>(module));
+}
+
+/* The max number of the shards which the module is split into to run the
+   optimization passes in parallel. The shards only depend on the module
+   but not on the number of jobs, so that the same code is generated with
+   any number of jobs. */
+#define AOT_OPT_SHARD_MAX_NUM 64
+/* The min number of the functions in a shard */
+#define AOT_OPT_SHARD_MIN_FUNC_NUM 16
+
+typedef struct AOTLocalSymbol {
+    std::string Name;
+    GlobalValue::LinkageTypes Linkage;
+    bool Unnamed;
+    /* Whether all the uses are in the shard which defines it, if yes,
+       it is kept local in that shard while running the passes */
+    bool UsedInOwnerShardOnly;
+} AOTLocalSymbol;
+
+static uint32
+get_shard_of_global(const DenseMap<const GlobalValue *, uint32> &Owners,
+                    const GlobalValue *GV)
+{
+    auto It = Owners.find(GV);
+    /* The other global values are all put into the first shard */
+    return It != Owners.end() ? It->second : 0;
+}
+
+static bool
+is_used_in_shard_only(const DenseMap<const GlobalValue *, uint32> &Owners,
+                      const Value *V, uint32 Shard)
+{
+    for (const User *U : V->users()) {
+        if (const Instruction *I = dyn_cast<Instruction>(U)) {
+            if (get_shard_of_global(Owners, I->getFunction()) != Shard)
+                return false;
+        }
+        else if (const GlobalValue *GV = dyn_cast<GlobalValue>(U)) {
+            if (get_shard_of_global(Owners, GV) != Shard)
+                return false;
+        }
+        else if (!is_used_in_shard_only(Owners, U, Shard)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static TargetMachine *
+create_target_machine(const TargetMachine *TM)
+{
+    return TM->getTarget().createTargetMachine(
+#if LLVM_VERSION_MAJOR >= 21
+        TM->getTargetTriple(),
+#else
+        TM->getTargetTriple().str(),
+#endif
+        TM->getTargetCPU(), TM->getTargetFeatureString(), TM->Options,
+        TM->getRelocationModel(), TM->getCodeModel(), TM->getOptLevel());
+}
+
+/* Run the passes for a shard in its own context and target machine, which
+   can be done in any thread */
+static bool
+optimize_shard(AOTCompContext *comp_ctx, const std::string &Input,
+               std::string &Output)
+{
+    LLVMContext Context;
+    auto MOrErr =
+        parseBitcodeFile(MemoryBufferRef(Input, "WASM Module"), Context);
+    if (!MOrErr) {
+        consumeError(MOrErr.takeError());
+        return false;
+    }
+
+    std::unique_ptr<TargetMachine> TM(create_target_machine(
+        reinterpret_cast<TargetMachine *>(comp_ctx->target_machine)));
+    if (!TM)
+        return false;
+
+    std::unique_ptr<Module> M = std::move(*MOrErr);
+    apply_llvm_passes(comp_ctx, TM.get(), M.get());
+
+    raw_string_ostream OS(Output);
+    WriteBitcodeToFile(*M, OS);
+    OS.flush();
+    return true;
+}
+
+bool
+aot_apply_llvm_new_pass_manager_parallel(AOTCompContext *comp_ctx)
+{
+    Module *M = reinterpret_cast<Module *>(comp_ctx->module);
+    DenseMap<const GlobalValue *, uint32> Owners;
+    std::vector<AOTLocalSymbol> Locals;
+    std::vector<std::string> Inputs, Outputs, FuncNames, PrecheckFuncNames;
+    std::vector<std::thread> Threads;
+    std::atomic<uint32> NextShard(0);
+    std::atomic<bool> Failed(false);
+    std::unique_ptr<Module> Merged;
+    uint64 total_code_size = 0, code_size = 0;
+    uint32 shard_num, thread_num, i;
+
+    shard_num = comp_ctx->func_ctx_count / AOT_OPT_SHARD_MIN_FUNC_NUM;
+    if (shard_num > AOT_OPT_SHARD_MAX_NUM)
+        shard_num = AOT_OPT_SHARD_MAX_NUM;
+    if (shard_num <= 1) {
+        aot_apply_llvm_new_pass_manager(comp_ctx, comp_ctx->module);
+        return true;
+    }
+
+    /* Split the wasm functions into the shards by the ranges of their
+       indexes, with roughly the same wasm code size in each shard, the
+       precheck function is put into the same shard as its function */
+    for (i = 0; i < comp_ctx->func_ctx_count; i++)
+        total_code_size += comp_ctx->func_ctxes[i]->aot_func->code_size;
+    for (i = 0; i < comp_ctx->func_ctx_count; i++) {
+        AOTFuncContext *func_ctx = comp_ctx->func_ctxes[i];
+        uint32 shard =
+            total_code_size > 0
+                ? (uint32)(code_size * shard_num / total_code_size)
+                : (uint32)((uint64)i * shard_num / comp_ctx->func_ctx_count);
+
+        Owners[reinterpret_cast<Function *>(func_ctx->func)] = shard;
+        Owners[reinterpret_cast<Function *>(func_ctx->precheck_func)] = shard;
+        code_size += func_ctx->aot_func->code_size;
+
+        /* Record the names to resolve the functions again in the module
+           linked, the values of the module split are freed with it */
+        FuncNames.push_back(
+            reinterpret_cast<Function *>(func_ctx->func)->getName().str());
+        PrecheckFuncNames.push_back(
+            reinterpret_cast<Function *>(func_ctx->precheck_func)
+                ->getName()
+                .str());
+    }
+
+    /* Make the local symbols external so that they can be referred to by
+       the other shards, and restore them after the shards are linked */
+    for (GlobalValue &GV : M->global_values()) {
+        if (!GV.hasLocalLinkage())
+            continue;
+        AOTLocalSymbol Local;
+        Local.Unnamed = !GV.hasName();
+        if (Local.Unnamed)
+            GV.setName("aot_local");
+        Local.Name = GV.getName().str();
+        Local.Linkage = GV.getLinkage();
+        Local.UsedInOwnerShardOnly = is_used_in_shard_only(
+            Owners, &GV, get_shard_of_global(Owners, &GV));
+        GV.setLinkage(GlobalValue::ExternalLinkage);
+        Locals.push_back(Local);
+    }
+
+    for (i = 0; i < shard_num; i++) {
+        ValueToValueMapTy VMap;
+        std::unique_ptr<Module> Shard =
+            CloneModule(*M, VMap, [&](const GlobalValue *GV) {
+                return get_shard_of_global(Owners, GV) == i;
+            });
+
+        for (const AOTLocalSymbol &Local : Locals) {
+            GlobalValue *GV;
+            if (Local.UsedInOwnerShardOnly
+                && (GV = Shard->getNamedValue(Local.Name))
+                && !GV->isDeclaration())
+                GV->setLinkage(Local.Linkage);
+        }
+
+        /* Remove the unused declarations, so that a local symbol of the
+           other shard isn't declared as an external symbol in this shard */
+        for (Function &F : make_early_inc_range(Shard->functions())) {
+            if (F.isDeclaration() && F.use_empty())
+                F.eraseFromParent();
+        }
+        for (GlobalVariable &G : make_early_inc_range(Shard->globals())) {
+            if (G.isDeclaration() && G.use_empty())
+                G.eraseFromParent();
+        }
+
+        std::string Input;
+        raw_string_ostream OS(Input);
+        WriteBitcodeToFile(*Shard, OS);
+        OS.flush();
+        Inputs.push_back(std::move(Input));
+    }
+
+    /* Run the passes for the shards in parallel, each shard has its own
+       output so that the result doesn't depend on the thread scheduling */
+    Outputs.resize(shard_num);
+    thread_num = comp_ctx->jobs < shard_num ? comp_ctx->jobs : shard_num;
+    auto Worker = [&]() {
+        uint32 shard;
+        while ((shard = NextShard++) < shard_num) {
+            if (!optimize_shard(comp_ctx, Inputs[shard], Outputs[shard]))
+                Failed = true;
+        }
+    };
+    for (i = 1; i < thread_num; i++)
+        Threads.emplace_back(Worker);
+    Worker();
+    for (std::thread &Thread : Threads)
+        Thread.join();
+
+    if (Failed) {
+        aot_set_last_error("run llvm optimization passes for shard failed.");
+        return false;
+    }
+
+    /* Link the shards back in order */
+    for (i = 0; i < shard_num; i++) {
+        auto MOrErr = parseBitcodeFile(
+            MemoryBufferRef(Outputs[i], "WASM Module"), M->getContext());
+        if (!MOrErr) {
+            consumeError(MOrErr.takeError());
+            aot_set_last_error("parse optimized llvm shard failed.");
+            return false;
+        }
+        if (!Merged) {
+            Merged = std::move(*MOrErr);
+        }
+        else if (Linker::linkModules(*Merged, std::move(*MOrErr))) {
+            aot_set_last_error("link optimized llvm shards failed.");
+            return false;
+        }
+    }
+
+    for (const AOTLocalSymbol &Local : Locals) {
+        GlobalValue *GV = Merged->getNamedValue(Local.Name);
+        if (GV && !GV->isDeclaration()) {
+            GV->setLinkage(Local.Linkage);
+            if (Local.Unnamed)
+                GV->setName("");
+        }
+    }
+
+    /* Resolve the values which the compiler context refers to in the
+       module linked, the other values of the function contexts are only
+       used while translating the functions */
+    for (i = 0; i < comp_ctx->func_ctx_count; i++) {
+        AOTFuncContext *func_ctx = comp_ctx->func_ctxes[i];
+        func_ctx->func =
+            reinterpret_cast<LLVMValueRef>(Merged->getFunction(FuncNames[i]));
+        func_ctx->precheck_func = reinterpret_cast<LLVMValueRef>(
+            Merged->getFunction(PrecheckFuncNames[i]));
+    }
+    if (comp_ctx->stack_sizes) {
+        comp_ctx->stack_sizes = reinterpret_cast<LLVMValueRef>(
+            Merged->getNamedGlobal(aot_stack_sizes_name));
+        if (!comp_ctx->stack_sizes) {
+            aot_set_last_error("resolve stack_sizes in llvm shards failed.");
+            return false;
+        }
+    }
+
+    LLVMDisposeModule(comp_ctx->module);
+    comp_ctx->module = reinterpret_cast<LLVMModuleRef>(Merged.release());
+    return true;
+}
+
 char *
 aot_compress_aot_func_names(AOTCompContext *comp_ctx, uint32 *p_size)
 {
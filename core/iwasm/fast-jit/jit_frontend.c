@@ -880,6 +880,7 @@ gen_commit_values(JitFrame *frame, JitValueSlot *begin, JitValueSlot *end)
                          NEW_CONST(I32, offset_of_local(n)));
                 (++p)->dirty = 0;
                 break;
+
         }
     }
 }
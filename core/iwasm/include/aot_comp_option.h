@@ -69,6 +69,21 @@ typedef struct AOTCompOption {
     bool enable_ref_types;
     bool enable_call_indirect_overlong;
     bool enable_gc;
+    /* Allocate the small gc objects inline from the TLAB of exec_env,
+       requires the runtime to support it */
+    bool enable_gc_tlab;
+    /* Let the runtime unwind the traps to the entry of wasm function call
+       rather than checking the exception after each call, requires a
+       runtime with the hardware bounds checks */
+    bool enable_trap_unwind;
+    /* Charge the instructions of each basic block from the instruction
+       count limit of exec_env, requires WASM_ENABLE_INSTRUCTION_METERING
+       in the runtime */
+    bool enable_instruction_metering;
+    /* Compare the global epoch with the epoch deadline of the module
+       instance at the loop back-edges, requires
+       WASM_ENABLE_EPOCH_INTERRUPTION in the runtime */
+    bool enable_epoch_interruption;
     bool enable_aux_stack_check;
     bool enable_extended_const;
     bool enable_lime1;
@@ -79,6 +94,9 @@ typedef struct AOTCompOption {
     bool disable_llvm_intrinsics;
     bool disable_llvm_jump_tables;
     bool disable_llvm_lto;
+    /* Don't cache the functions which have passed the checks at each
+       call_indirect site */
+    bool disable_call_indirect_cache;
     bool enable_llvm_pgo;
     bool enable_stack_estimation;
     bool quick_invoke_c_api_import;
@@ -96,6 +114,12 @@ typedef struct AOTCompOption {
     const char *stack_usage_file;
     const char *llvm_passes;
     const char *builtin_intrinsics;
+    /* The number of threads to run the LLVM optimization passes of the
+       module shards, 0 to optimize the whole module in one thread */
+    uint32_t jobs;
+    /* Align the code to the page size in the AOT file of indirect mode,
+       so that its pages can be mapped from the file and shared */
+    bool enable_shared_text;
 } AOTCompOption, *aot_comp_option_t;
 
 #ifdef __cplusplus
@@ -157,6 +157,9 @@ typedef struct WASMExecEnv *wasm_exec_env_t;
 struct WASMSharedHeap;
 typedef struct WASMSharedHeap *wasm_shared_heap_t;
 
+struct WASMInstanceSnapshot;
+typedef struct WASMInstanceSnapshot *wasm_instance_snapshot_t;
+
 /* Package Type */
 typedef enum {
     Wasm_Module_Bytecode = 0,
@@ -207,6 +210,13 @@ typedef struct mem_alloc_info_t {
     uint32_t highmark_size;
 } mem_alloc_info_t;
 
+/* Linear memory or instance slot pool info */
+typedef struct memory_slot_info_t {
+    uint32_t slot_count;
+    uint32_t free_slot_count;
+    uint32_t highmark_slot_count;
+} memory_slot_info_t;
+
 /* Running mode of runtime and module instance*/
 typedef enum RunningMode {
     Mode_Interp = 1,
@@ -257,6 +267,22 @@ typedef struct RuntimeInitArgs {
      * - interpreter. TBD
      */
     bool enable_linux_perf;
+
+    /* Number of linear memory slots reserved at initialization, only
+       used when WASM_ENABLE_LINEAR_MEMORY_POOL is defined */
+    uint32_t linear_memory_slot_count;
+    /* Number and size of the instance slots reserved at initialization,
+       a module instance structure (including its tables and global data)
+       which fits in a slot is allocated from it, only used when
+       WASM_ENABLE_LINEAR_MEMORY_POOL is defined */
+    uint32_t instance_slot_count;
+    uint32_t instance_slot_size;
+
+    /* Directory of the persistent LLVM JIT code cache, only used when
+       WASM_ENABLE_LLVM_JIT_CACHE is defined, NULL to disable the cache.
+       The modules run with LLVM JIT are AOT compiled into the directory
+       and loaded from the AOT files instead */
+    const char *llvm_jit_cache_dir;
 } RuntimeInitArgs;
 
 #ifndef LOAD_ARGS_OPTION_DEFINED
@@ -275,6 +301,12 @@ typedef struct LoadArgs {
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
     bool no_resolve;
+
+    /* false by default, used by wasm loader only when the lazy function
+       validation is enabled. If true, the start function and the exported
+       functions are validated and prepared in a background thread after
+       loading, instead of on their first calls */
+    bool prepare_exports_in_background;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -461,6 +493,20 @@ wasm_runtime_free(void *ptr);
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_get_mem_alloc_info(mem_alloc_info_t *mem_alloc_info);
 
+/*
+ * Get the info of the linear memory slot pool, only supported when
+ * the slots are reserved with RuntimeInitArgs.linear_memory_slot_count.
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_memory_slot_info(memory_slot_info_t *memory_slot_info);
+
+/*
+ * Get the info of the instance slot pool, only supported when the slots
+ * are reserved with RuntimeInitArgs.instance_slot_count.
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_instance_slot_info(memory_slot_info_t *instance_slot_info);
+
 /**
  * Get the package type of a buffer.
  *
@@ -615,6 +661,29 @@ WASM_RUNTIME_API_EXTERN wasm_module_t
 wasm_runtime_load_ex(uint8_t *buf, uint32_t size, const LoadArgs *args,
                      char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Load a WASM module or an AOT module from a file. The file is mapped
+ * into memory with private copy-on-write pages rather than read into a
+ * buffer: the bytecode, the data segments and the text of the XIP AOT
+ * file are referred to in place, and the pages which the runtime doesn't
+ * modify are shared with the page cache and with the other processes
+ * loading the same file. The mapping is released when the module is
+ * unloaded.
+ *
+ * Note: only supported on the platforms which define OS_ENABLE_FILE_MMAP,
+ * e.g. Linux, and the file must not be truncated while it is mapped.
+ *
+ * @param path the path of the WASM/AOT file
+ * @param args the load arguments, wasm_binary_freeable is ignored
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return WASM module loaded, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_t
+wasm_runtime_load_from_file(const char *path, const LoadArgs *args,
+                            char *error_buf, uint32_t error_buf_size);
+
 /**
  * Resolve symbols for a previously loaded WASM module. Only useful when the
  * module was loaded with LoadArgs::no_resolve set to true
@@ -831,7 +900,9 @@ wasm_runtime_instantiate_ex2(const wasm_module_t module,
  * Set the running mode of a WASM module instance, override the
  * default running mode of the runtime. Note that it only makes sense when
  * the input is a wasm bytecode file: for the AOT file, runtime always runs
- * it with AOT engine, and this function always returns true.
+ * it with AOT engine, and this function always returns true, except for
+ * the module loaded from the LLVM JIT cache, which only accepts the
+ * default mode and Mode_LLVM_JIT.
  *
  * @param module_inst the WASM module instance to set running mode
  * @param running_mode the running mode to set
@@ -846,7 +917,9 @@ wasm_runtime_set_running_mode(wasm_module_inst_t module_inst,
  * Get the running mode of a WASM module instance, if no running mode
  * is explicitly set the default running mode of runtime will
  * be used and returned. Note that it only makes sense when the input is a
- * wasm bytecode file: for the AOT file, this function always returns 0.
+ * wasm bytecode file: for the AOT file, this function always returns 0,
+ * except for the module loaded from the LLVM JIT cache, for which it
+ * returns Mode_LLVM_JIT.
  *
  * @param module_inst the WASM module instance to query for running mode
  *
@@ -1057,6 +1130,10 @@ wasm_runtime_start_debug_instance(wasm_exec_env_t exec_env);
  *   wasm_runtime_destroy_thread_env() after calling the wasm
  *   function. If the thread is created from the runtime API,
  *   it is unnecessary to call these two APIs.
+ *   With WAMR_BUILD_ALLOC_THREAD_CACHE and the Alloc_With_Pool global
+ *   heap, the thread caches the small objects it frees to the global
+ *   heap until wasm_runtime_destroy_thread_env() is called, which must
+ *   be called before the thread exits.
  *
  * @return true if success, false otherwise
  */
@@ -1842,6 +1919,46 @@ WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_unregister_natives(const char *module_name,
                                 NativeSymbol *native_symbols);
 
+/**
+ * Register host functions of a module name as LLVM bitcode, so that the
+ * LLVM JIT and the AOT compiler can inline them into the calls to the
+ * matched imports instead of calling the native functions.
+ *
+ * Each external function defined in the bitcode is matched by name with
+ * the import functions of the module name. Like a native function, it
+ * takes the exec_env followed by the wasm params, and a param whose
+ * signature char is '*' or '$' in the registered native symbol is passed
+ * as a native pointer. The bitcode must be self-contained: it may only
+ * call the functions defined in it and LLVM intrinsics, and may not access
+ * external globals. A native symbol should still be registered for the
+ * interpreter and for modules compiled without the bitcode.
+ *
+ * The bitcode must be registered before the wasm module is loaded by the
+ * LLVM JIT or compiled by wamrc, and the buffer must be kept valid until
+ * it is unregistered.
+ *
+ * @param module_name the module name of the import functions
+ * @param bitcode the buffer of the LLVM bitcode
+ * @param size the size of the buffer
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_register_native_bitcode(const char *module_name,
+                                     const uint8_t *bitcode, uint32_t size);
+
+/**
+ * Undo wasm_runtime_register_native_bitcode
+ *
+ * @param module_name the same module name as registered
+ * @param bitcode the same bitcode buffer as registered
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_unregister_native_bitcode(const char *module_name,
+                                       const uint8_t *bitcode);
+
 /**
  * Get an export global instance
  *
@@ -1948,6 +2065,113 @@ WASM_RUNTIME_API_EXTERN void
 wasm_runtime_set_instruction_count_limit(wasm_exec_env_t exec_env,
                                          int instruction_count);
 
+/**
+ * Get the count of instructions which the execution environment can
+ * still execute before reaching the instruction count limit.
+ *
+ * @param exec_env the execution environment
+ *
+ * @return the instruction count left, -1 means no limit
+ */
+WASM_RUNTIME_API_EXTERN int
+wasm_runtime_get_instruction_count_limit(wasm_exec_env_t exec_env);
+
+/**
+ * Callback called when the instruction count limit of an execution
+ * environment is exhausted. It runs in the thread which executes the
+ * wasm code, and may yield the thread, e.g. to let other instances run,
+ * and then refill the limit with wasm_runtime_set_instruction_count_limit
+ * to resume the execution.
+ *
+ * @param exec_env the execution environment
+ * @param user_data the user data passed to
+ *        wasm_runtime_set_instruction_limit_callback
+ *
+ * @return true to continue the execution if the limit was refilled,
+ *         false to terminate it with the "instruction limit exceeded"
+ *         exception
+ */
+typedef bool (*instruction_limit_callback_t)(wasm_exec_env_t exec_env,
+                                             void *user_data);
+
+/**
+ * Set the callback called when the instruction count limit of the
+ * execution environment is exhausted. Without it, the execution is
+ * terminated once the limit is reached.
+ *
+ * The instructions are charged per basic block by the fast interpreter,
+ * Fast JIT, LLVM JIT and AOT code, when the count left isn't enough for a
+ * block, it is consumed and the callback is called before the block
+ * runs.
+ *
+ * @param exec_env the execution environment
+ * @param callback the callback to be set, NULL to clear it
+ * @param user_data the user data passed to the callback
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_instruction_limit_callback(
+    wasm_exec_env_t exec_env, instruction_limit_callback_t callback,
+    void *user_data);
+
+/**
+ * Increment the global epoch counter by one. It may be called from any
+ * thread, e.g. a timer thread, and the wasm code of the module instances
+ * whose epoch deadline is reached will be interrupted at its next loop
+ * back-edge.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_increment_epoch(void);
+
+/**
+ * Get the current value of the global epoch counter.
+ *
+ * @return the current epoch
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_get_epoch(void);
+
+/**
+ * Set the epoch deadline of the module instance to the given count of
+ * epoch ticks beyond the current epoch. By default there is no deadline.
+ *
+ * @param module_inst the module instance
+ * @param ticks_beyond_current the count of epoch increments after which
+ *        the wasm code is interrupted, UINT64_MAX means no deadline
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline(wasm_module_inst_t module_inst,
+                                uint64_t ticks_beyond_current);
+
+/**
+ * Callback called when the epoch deadline of a module instance is
+ * reached. It runs in the thread which executes the wasm code, and may
+ * yield the thread, e.g. to let other instances run, and then extend the
+ * deadline with wasm_runtime_set_epoch_deadline to resume the execution.
+ *
+ * @param exec_env the execution environment
+ * @param user_data the user data passed to
+ *        wasm_runtime_set_epoch_deadline_callback
+ *
+ * @return true to continue the execution if the deadline was extended,
+ *         false to terminate it with the "epoch deadline reached" exception
+ */
+typedef bool (*epoch_deadline_callback_t)(wasm_exec_env_t exec_env,
+                                          void *user_data);
+
+/**
+ * Set the callback called when the epoch deadline of the module instance
+ * is reached. Without it, the execution is terminated once the deadline
+ * is reached.
+ *
+ * @param module_inst the module instance
+ * @param callback the callback to be set, NULL to clear it
+ * @param user_data the user data passed to the callback
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline_callback(wasm_module_inst_t module_inst,
+                                         epoch_deadline_callback_t callback,
+                                         void *user_data);
+
 /**
  * Dump runtime memory consumption, including:
  *     Exec env memory consumption
@@ -2516,6 +2740,57 @@ wasm_runtime_shared_heap_malloc(wasm_module_inst_t module_inst, uint64_t size,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_shared_heap_free(wasm_module_inst_t module_inst, uint64_t ptr);
 
+/**
+ * Capture the state of an initialized module instance, including the
+ * linear memories, globals and tables, as a snapshot, from which new
+ * instances can be created without re-running the data segment
+ * initialization and the start/_initialize functions.
+ *
+ * The instance must be idle, must not use shared memory and must be
+ * instantiated without host managed heap. Host side state such as the
+ * WASI context isn't captured. The module must outlive the snapshot.
+ *
+ * @param module_inst the module instance to capture
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the snapshot created, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_instance_snapshot_t
+wasm_runtime_create_instance_snapshot(wasm_module_inst_t module_inst,
+                                      char *error_buf,
+                                      uint32_t error_buf_size);
+
+/**
+ * Instantiate the module of the snapshot and restore the captured state
+ * into the new instance. When supported by the platform, the linear
+ * memory is mapped copy-on-write from the snapshot, so the cost is
+ * proportional to the pages written by the new instance rather than
+ * to the memory size.
+ *
+ * @param snapshot the snapshot created by
+ *        wasm_runtime_create_instance_snapshot
+ * @param args the instantiation arguments, can be NULL to use the
+ *        default ones, the host managed heap size is ignored
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the instantiated module instance, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_instantiate_from_snapshot(wasm_instance_snapshot_t snapshot,
+                                       const struct InstantiationArgs2 *args,
+                                       char *error_buf,
+                                       uint32_t error_buf_size);
+
+/**
+ * Destroy a snapshot, the instances created from it are not affected.
+ *
+ * @param snapshot the snapshot to destroy
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_instance_snapshot(wasm_instance_snapshot_t snapshot);
+
 #ifdef __cplusplus
 }
 #endif
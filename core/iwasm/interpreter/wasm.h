@@ -9,6 +9,7 @@
 #include "bh_platform.h"
 #include "bh_hashmap.h"
 #include "bh_assert.h"
+#include "bh_atomic.h"
 #if WASM_ENABLE_GC != 0
 #include "gc_export.h"
 #endif
@@ -610,6 +611,11 @@ typedef struct WASMFunctionImport {
 #if WASM_ENABLE_GC != 0
     /* the type index of this function's func_type */
     uint32 type_idx;
+#endif
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    /* signature-specialized thunk to call the linked native function,
+       NULL if it must go through wasm_runtime_invoke_native */
+    void *quick_native_entry;
 #endif
     bool call_conv_raw;
     bool call_conv_wasm_c_api;
@@ -681,6 +687,37 @@ typedef struct WASMImport {
     } u;
 } WASMImport;
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+/* The function hasn't been validated and prepared */
+#define WASM_FUNC_PREPARE_STATE_NONE 0
+/* The function has been validated and its bytecode has been prepared */
+#define WASM_FUNC_PREPARE_STATE_DONE 1
+/* The function failed to be validated */
+#define WASM_FUNC_PREPARE_STATE_FAILED 2
+#endif
+
+#if WASM_ENABLE_EXCE_HANDLING != 0 && WASM_ENABLE_FAST_INTERP != 0
+typedef struct WASMCatchHandler {
+    /* the tag index to catch, or INVALID_TAGINDEX for catch_all */
+    uint32 tag_index;
+    /* the compiled code of the catch or catch_all clause */
+    uint8 *addr;
+} WASMCatchHandler;
+
+typedef struct WASMTryBlock {
+    /* the exceptions thrown by the instructions ending in
+       (start_addr, end_addr] of the compiled code are handled */
+    uint8 *start_addr;
+    uint8 *end_addr;
+    /* index of the try block to search next if no handler matches,
+       either the enclosing one or the one delegated to, -1 means
+       the exception is propagated to the caller */
+    int32 outer_try_idx;
+    uint32 handler_count;
+    WASMCatchHandler *handlers;
+} WASMTryBlock;
+#endif
+
 struct WASMFunction {
 #if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
     char *field_name;
@@ -722,6 +759,14 @@ struct WASMFunction {
 
 #if WASM_ENABLE_EXCE_HANDLING != 0
     uint32 exception_handler_count;
+#if WASM_ENABLE_FAST_INTERP != 0
+    /* try blocks in the order of their try opcodes */
+    uint32 try_block_count;
+    WASMTryBlock *try_blocks;
+    /* catch handlers of all the try blocks */
+    uint32 catch_handler_count;
+    WASMCatchHandler *catch_handlers;
+#endif
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0 \
@@ -752,9 +797,23 @@ struct WASMFunction {
 #endif
 #endif
 
+#if WASM_ENABLE_TIERED_JIT != 0
+    /* The count of calls and loop back-edges executed by the fast
+       interpreter, it stops at WASM_TIERED_JIT_LLVM_JIT_THRESHOLD and is
+       updated without synchronization since losing some counts between
+       threads is harmless */
+    uint32 hotness;
+#endif
+
 #if WASM_ENABLE_BRANCH_HINTS != 0
     uint8 *code_body_begin;
 #endif
+
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* One of WASM_FUNC_PREPARE_STATE_XXX, it is set under the lazy
+       prepare lock of the module and read atomically without the lock */
+    bh_atomic_32_t prepare_state;
+#endif
 };
 
 #if WASM_ENABLE_TAGS != 0
@@ -1118,6 +1177,11 @@ struct WASMModule {
     void **func_ptrs;
     /* whether the func pointers are compiled */
     bool *func_ptrs_compiled;
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    /* whether the module is loaded only to be compiled into an AOT file
+       for the LLVM JIT cache, and not to be compiled with JIT */
+    bool skip_jit_compilation;
+#endif
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
@@ -1129,13 +1193,18 @@ struct WASMModule {
     bool orcjit_stop_compiling;
 #endif
 
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
-    && WASM_ENABLE_LAZY_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+     && WASM_ENABLE_LAZY_JIT != 0)                         \
+    || WASM_ENABLE_TIERED_JIT != 0
     /* wait lock/cond for the synchronization of
-       the llvm jit initialization */
+       the llvm jit initialization and tier-up */
     korp_mutex tierup_wait_lock;
     korp_cond tierup_wait_cond;
     bool tierup_wait_lock_inited;
+#endif
+
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
     korp_tid llvm_jit_init_thread;
     /* whether the llvm jit is initialized */
     bool llvm_jit_inited;
@@ -1150,17 +1219,43 @@ struct WASMModule {
     uint32 fast_jit_ready_groups;
 #endif
 
+#if WASM_ENABLE_TIERED_JIT != 0
+    /* The count of functions which got hot enough for llvm jit, the
+       backend threads wait on tierup_wait_cond until it changes */
+    uint32 hot_func_count;
+#endif
+
 #if WASM_ENABLE_WAMR_COMPILER != 0
     bool is_simd_used;
     bool is_ref_types_used;
     bool is_bulk_memory_used;
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* Whether the functions are validated and prepared on their first
+       calls rather than at load time */
+    bool is_lazy_prepare;
+    /* lock to validate and prepare the functions one at a time */
+    korp_mutex lazy_prepare_lock;
+    bool lazy_prepare_lock_inited;
+    /* thread to prepare the exported functions in background */
+    korp_tid lazy_prepare_thread;
+    /* whether to stop the preparation of the background thread */
+    bh_atomic_32_t lazy_prepare_stop;
+#endif
+
     /* user defined name */
     char *name;
 
     /* Whether the underlying wasm binary buffer can be freed */
     bool is_binary_freeable;
+
+#ifdef OS_ENABLE_FILE_MMAP
+    /* The file mapped by wasm_runtime_load_from_file, which the module
+       refers to and which is unmapped when the module is unloaded */
+    uint8 *mapped_file_buf;
+    uint64 mapped_file_size;
+#endif
 };
 
 typedef struct BlockType {
@@ -1272,6 +1272,13 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
             argv_ret[1] = frame->lp[1];
         }
     }
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    else if (func_import->quick_native_entry) {
+        ret = wasm_runtime_invoke_quick_native(
+            exec_env, func_import->quick_native_entry, native_func_pointer,
+            func_import->attachment, frame->lp, argv_ret);
+    }
+#endif
     else if (!func_import->call_conv_raw) {
         ret = wasm_runtime_invoke_native(
             exec_env, native_func_pointer, func_import->func_type,
@@ -1547,17 +1554,34 @@ get_global_addr(uint8 *global_data, WASMGlobalInstance *global)
 }
 
 #if WASM_ENABLE_INSTRUCTION_METERING != 0
-#define CHECK_INSTRUCTION_LIMIT()                                 \
-    if (instructions_left == 0) {                                 \
-        wasm_set_exception(module, "instruction limit exceeded"); \
-        goto got_exception;                                       \
-    }                                                             \
-    else if (instructions_left > 0)                               \
-        instructions_left--;
+/* The count is kept in exec_env so that the instruction limit callback
+   and the callee functions see and refill the same count */
+#define CHECK_INSTRUCTION_LIMIT()                                          \
+    if (exec_env->instructions_to_execute == 0) {                          \
+        SYNC_ALL_TO_FRAME();                                               \
+        if (!wasm_runtime_check_instruction_limit(exec_env, 1))            \
+            goto got_exception;                                            \
+    }                                                                      \
+    else if (exec_env->instructions_to_execute > 0)                        \
+        exec_env->instructions_to_execute--;
 #else
 #define CHECK_INSTRUCTION_LIMIT() (void)0
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* The epoch is bumped by other threads, read it from memory each time,
+   the runtime checks the deadline again and calls the callback */
+#define CHECK_EPOCH_DEADLINE()                                        \
+    do {                                                              \
+        if (*(volatile const uint64 *)module->e->epoch_ptr            \
+            >= module->e->epoch_deadline) {                           \
+            SYNC_ALL_TO_FRAME();                                      \
+            if (!wasm_runtime_check_epoch_deadline(exec_env))         \
+                goto got_exception;                                   \
+        }                                                             \
+    } while (0)
+#endif
+
 static void
 wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                WASMExecEnv *exec_env,
@@ -1602,13 +1626,6 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
     uint8 local_type, *global_addr;
     uint32 cache_index, type_index, param_cell_num, cell_num;
 
-#if WASM_ENABLE_INSTRUCTION_METERING != 0
-    int instructions_left = -1;
-    if (exec_env) {
-        instructions_left = exec_env->instructions_to_execute;
-    }
-#endif
-
 #if WASM_ENABLE_EXCE_HANDLING != 0
     int32_t exception_tag_index;
 #endif
@@ -1735,10 +1752,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 }
 
                 /* move exception parameters (if there are any) onto top
-                 * of stack */
+                 * of stack, they are saved right after the tag index */
                 if (cell_num_to_copy > 0) {
-                    word_copy(frame_sp, tgtframe_sp - cell_num_to_copy,
-                              cell_num_to_copy);
+                    word_copy(frame_sp, tgtframe_sp, cell_num_to_copy);
                 }
 
                 frame_sp += cell_num_to_copy;
@@ -2240,6 +2256,11 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 read_leb_uint32(frame_ip, frame_ip_end, depth);
             label_pop_csp_n:
                 POP_CSP_N(depth);
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+                /* Check the epoch deadline at the loop back-edges */
+                if (frame_ip == (frame_csp - 1)->begin_addr)
+                    CHECK_EPOCH_DEADLINE();
+#endif
                 if (!frame_ip) { /* must be label pushed by WASM_OP_BLOCK */
                     if (!wasm_loader_find_block_addr(
                             exec_env, (BlockAddr *)exec_env->block_addr_cache,
@@ -6774,12 +6795,21 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         else {
             WASMFunction *cur_wasm_func = cur_func->u.func;
             WASMFuncType *func_type = cur_wasm_func->func_type;
-            uint32 max_stack_cell_num = cur_wasm_func->max_stack_cell_num;
+            uint32 max_stack_cell_num;
             uint32 cell_num_of_local_stack;
 #if WASM_ENABLE_REF_TYPES != 0 && WASM_ENABLE_GC == 0
             uint32 local_cell_idx;
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+            if (!cur_func->is_prepared
+                && !wasm_prepare_function(module, cur_func)) {
+                frame = prev_frame;
+                goto got_exception;
+            }
+#endif
+            max_stack_cell_num = cur_wasm_func->max_stack_cell_num;
+
 #if WASM_ENABLE_EXCE_HANDLING != 0
             /* account for exception handlers, bundle them here */
             uint32 eh_size =
@@ -89,19 +89,6 @@ typedef float64 CellType_F64;
             goto unaligned_atomic;                 \
     } while (0)
 
-#if WASM_ENABLE_INSTRUCTION_METERING != 0
-#define CHECK_INSTRUCTION_LIMIT()                                 \
-    if (instructions_left == 0) {                                 \
-        wasm_set_exception(module, "instruction limit exceeded"); \
-        goto got_exception;                                       \
-    }                                                             \
-    else if (instructions_left > 0)                               \
-        instructions_left--;
-
-#else
-#define CHECK_INSTRUCTION_LIMIT() (void)0
-#endif
-
 static inline uint32
 rotl32(uint32 n, uint32 c)
 {
@@ -580,6 +567,34 @@ wasm_interp_get_frame_ref(WASMInterpFrame *frame)
         frame_ip += 6;                                               \
     } while (0)
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#if WASM_ENABLE_THREAD_MGR != 0
+#define BR_IF_CHECK_SUSPEND_FLAGS() CHECK_SUSPEND_FLAGS()
+#else
+#define BR_IF_CHECK_SUSPEND_FLAGS() (void)0
+#endif
+
+/* br_if fused with the i32 comparison which computes its condition, the
+   operands of the comparison are followed by the br info */
+#define DEF_OP_BR_IF(cond_expr, operands_size) \
+    do {                                       \
+        BR_IF_CHECK_SUSPEND_FLAGS();           \
+        cond = (uint32)(cond_expr);            \
+        frame_ip += operands_size;             \
+        if (cond)                              \
+            goto recover_br_info;              \
+        else                                   \
+            SKIP_BR_INFO();                    \
+    } while (0)
+
+/* The operands are laid out as the ones of DEF_OP_CMP, except that
+   there is no result offset */
+#define DEF_OP_BR_IF_CMP(src_type, cond)                 \
+    DEF_OP_BR_IF(GET_OPERAND(src_type, I32, 2)           \
+                     cond GET_OPERAND(src_type, I32, 0), \
+                 4)
+#endif
+
 #define DEF_OP_BIT_COUNT(src_type, src_op_type, operation)               \
     do {                                                                 \
         SET_OPERAND(                                                     \
@@ -1151,6 +1166,37 @@ word_copy(uint32 *dest, uint32 *src, unsigned num)
     }
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/* Find the handler of the exception with tag_index thrown by the
+   instruction ending at ip, return NULL if it isn't caught by func */
+static uint8 *
+find_catch_handler(const WASMFunction *func, const uint8 *ip,
+                   uint32 tag_index)
+{
+    const WASMTryBlock *try_block;
+    int32 try_idx = (int32)func->try_block_count - 1;
+    uint32 i;
+
+    /* The try blocks are in the order of their try opcodes, so the last
+       one covering ip is the innermost one */
+    while (try_idx >= 0
+           && !(ip > func->try_blocks[try_idx].start_addr
+                && ip <= func->try_blocks[try_idx].end_addr))
+        try_idx--;
+
+    while (try_idx >= 0) {
+        try_block = func->try_blocks + try_idx;
+        for (i = 0; i < try_block->handler_count; i++) {
+            if (try_block->handlers[i].tag_index == tag_index
+                || try_block->handlers[i].tag_index == INVALID_TAGINDEX)
+                return try_block->handlers[i].addr;
+        }
+        try_idx = try_block->outer_try_idx;
+    }
+    return NULL;
+}
+#endif
+
 static inline WASMInterpFrame *
 ALLOC_FRAME(WASMExecEnv *exec_env, uint32 size, WASMInterpFrame *prev_frame)
 {
@@ -1262,6 +1308,13 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
             argv_ret[1] = frame->lp[1];
         }
     }
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    else if (func_import->quick_native_entry) {
+        ret = wasm_runtime_invoke_quick_native(
+            exec_env, func_import->quick_native_entry, native_func_pointer,
+            func_import->attachment, frame->lp, argv_ret);
+    }
+#endif
     else if (!func_import->call_conv_raw) {
         ret = wasm_runtime_invoke_native(
             exec_env, native_func_pointer, func_import->func_type,
@@ -1378,6 +1431,203 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
 }
 #endif
 
+#if WASM_ENABLE_JIT != 0
+/* The fast interpreter is only built together with LLVM JIT for the
+   tier-up, where it runs the functions until they get hot */
+static bool
+llvm_jit_call_func_bytecode(WASMModuleInstance *module_inst,
+                            WASMExecEnv *exec_env,
+                            WASMFunctionInstance *function, uint32 argc,
+                            uint32 argv[])
+{
+    WASMFuncType *func_type = function->u.func->func_type;
+    uint32 result_count = func_type->result_count;
+    uint32 ext_ret_count = result_count > 1 ? result_count - 1 : 0;
+    uint32 func_idx = (uint32)(function - module_inst->e->functions);
+    bool ret = false;
+
+    if (ext_ret_count > 0) {
+        uint32 cell_num = 0, i;
+        uint8 *ext_ret_types = func_type->types + func_type->param_count + 1;
+        uint32 argv1_buf[32], *argv1 = argv1_buf, *ext_rets = NULL;
+        uint32 *argv_ret = argv;
+        uint32 ext_ret_cell = wasm_get_cell_num(ext_ret_types, ext_ret_count);
+        uint64 size;
+
+        /* Allocate memory all arguments */
+        size =
+            sizeof(uint32) * (uint64)argc /* original arguments */
+            + sizeof(void *)
+                  * (uint64)ext_ret_count /* extra result values' addr */
+            + sizeof(uint32) * (uint64)ext_ret_cell; /* extra result values */
+        if (size > sizeof(argv1_buf)) {
+            if (size > UINT32_MAX
+                || !(argv1 = wasm_runtime_malloc((uint32)size))) {
+                wasm_set_exception(module_inst, "allocate memory failed");
+                return false;
+            }
+        }
+
+        /* Copy original arguments */
+        bh_memcpy_s(argv1, (uint32)size, argv, sizeof(uint32) * argc);
+
+        /* Get the extra result value's address */
+        ext_rets =
+            argv1 + argc + sizeof(void *) / sizeof(uint32) * ext_ret_count;
+
+        /* Append each extra result value's address to original arguments */
+        for (i = 0; i < ext_ret_count; i++) {
+            *(uintptr_t *)(argv1 + argc + sizeof(void *) / sizeof(uint32) * i) =
+                (uintptr_t)(ext_rets + cell_num);
+            cell_num += wasm_value_type_cell_num(ext_ret_types[i]);
+        }
+
+        ret = wasm_runtime_invoke_native(
+            exec_env, module_inst->func_ptrs[func_idx], func_type, NULL, NULL,
+            argv1, argc, argv);
+        if (!ret) {
+            if (argv1 != argv1_buf)
+                wasm_runtime_free(argv1);
+            return false;
+        }
+
+        /* Get extra result values */
+        switch (func_type->types[func_type->param_count]) {
+            case VALUE_TYPE_I32:
+            case VALUE_TYPE_F32:
+#if WASM_ENABLE_REF_TYPES != 0
+            case VALUE_TYPE_FUNCREF:
+            case VALUE_TYPE_EXTERNREF:
+#endif
+                argv_ret++;
+                break;
+            case VALUE_TYPE_I64:
+            case VALUE_TYPE_F64:
+                argv_ret += 2;
+                break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                argv_ret += 4;
+                break;
+#endif
+            default:
+                bh_assert(0);
+                break;
+        }
+
+        ext_rets =
+            argv1 + argc + sizeof(void *) / sizeof(uint32) * ext_ret_count;
+        bh_memcpy_s(argv_ret, sizeof(uint32) * cell_num, ext_rets,
+                    sizeof(uint32) * cell_num);
+
+        if (argv1 != argv1_buf)
+            wasm_runtime_free(argv1);
+        ret = true;
+    }
+    else {
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+        /* Quick call if the quick jit entry is registered */
+        if (func_type->quick_aot_entry) {
+            void (*invoke_native)(void *func_ptr, void *exec_env, uint32 *argv,
+                                  uint32 *argv_ret) =
+                func_type->quick_aot_entry;
+            invoke_native(module_inst->func_ptrs[func_idx], exec_env, argv,
+                          argv);
+            ret = !wasm_copy_exception(module_inst, NULL);
+        }
+        else
+#endif
+        {
+            ret = wasm_runtime_invoke_native(
+                exec_env, module_inst->func_ptrs[func_idx], func_type, NULL,
+                NULL, argv, argc, argv);
+
+            if (ret)
+                ret = !wasm_copy_exception(module_inst, NULL);
+        }
+    }
+
+    return ret;
+}
+
+/* Whether to call the llvm jit function rather than interpreting the
+   function: always in Mode_LLVM_JIT, and after the backend threads
+   compile it in Mode_Multi_Tier_JIT */
+static inline bool
+llvm_jit_is_func_callable(WASMModuleInstance *module_inst,
+                          WASMFunctionInstance *function)
+{
+    uint32 func_idx;
+
+    if (module_inst->e->running_mode == Mode_LLVM_JIT)
+        return true;
+    if (module_inst->e->running_mode != Mode_Multi_Tier_JIT)
+        return false;
+
+    func_idx = (uint32)(function - module_inst->e->functions);
+    return module_inst->module->func_ptrs_compiled
+        [func_idx - module_inst->module->import_function_count];
+}
+
+/* Call the llvm jit function with the arguments pushed at the top of the
+   wasm stack, and return the results to prev_frame like the interpreted
+   function does */
+static void
+wasm_interp_call_func_llvm_jit(WASMModuleInstance *module_inst,
+                               WASMExecEnv *exec_env,
+                               WASMFunctionInstance *cur_func,
+                               WASMInterpFrame *prev_frame)
+{
+    unsigned local_cell_num =
+        cur_func->param_cell_num > cur_func->ret_cell_num
+            ? cur_func->param_cell_num
+            : cur_func->ret_cell_num;
+    WASMInterpFrame *frame;
+
+    if (local_cell_num < 2)
+        local_cell_num = 2;
+
+    /* Keep the arguments where the caller pushed them */
+    if (!(frame = ALLOC_FRAME(exec_env,
+                              wasm_interp_interp_frame_size(
+                                  cur_func->const_cell_num + local_cell_num),
+                              prev_frame)))
+        return;
+
+    frame->function = cur_func;
+    frame->ip = NULL;
+    frame->lp = frame->operand + cur_func->const_cell_num;
+
+    wasm_exec_env_set_cur_frame(exec_env, frame);
+
+    if (llvm_jit_call_func_bytecode(module_inst, exec_env, cur_func,
+                                    cur_func->param_cell_num, frame->lp)
+        && cur_func->ret_cell_num > 0) {
+        word_copy(prev_frame->lp + prev_frame->ret_offset, frame->lp,
+                  cur_func->ret_cell_num);
+    }
+
+    FREE_FRAME(exec_env, frame);
+    wasm_exec_env_set_cur_frame(exec_env, prev_frame);
+}
+#endif /* end of WASM_ENABLE_JIT != 0 */
+
+#if WASM_ENABLE_TIERED_JIT != 0
+/* Count the calls and loop back-edges of the function in Multi-Tier JIT
+   mode, and wake up the backend threads to compile it with LLVM JIT once
+   it gets hot. There is no on-stack replacement, the function switches
+   to the llvm jit code from its next call. */
+#define COUNT_HOTNESS(func)                                              \
+    do {                                                                 \
+        if (module->e->running_mode == Mode_Multi_Tier_JIT               \
+            && (func)->hotness < WASM_TIERED_JIT_LLVM_JIT_THRESHOLD      \
+            && ++(func)->hotness == WASM_TIERED_JIT_LLVM_JIT_THRESHOLD)  \
+            wasm_tiered_jit_notify_hot_function(module->module);         \
+    } while (0)
+#else
+#define COUNT_HOTNESS(func) (void)0
+#endif
+
 #if WASM_ENABLE_THREAD_MGR != 0
 #define CHECK_SUSPEND_FLAGS()                               \
     do {                                                    \
@@ -1393,6 +1643,20 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
     } while (0)
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* The epoch is bumped by other threads, read it from memory each time,
+   the runtime checks the deadline again and calls the callback */
+#define CHECK_EPOCH_DEADLINE()                                        \
+    do {                                                              \
+        if (*(volatile const uint64 *)module->e->epoch_ptr            \
+            >= module->e->epoch_deadline) {                           \
+            SYNC_ALL_TO_FRAME();                                      \
+            if (!wasm_runtime_check_epoch_deadline(exec_env))         \
+                goto got_exception;                                   \
+        }                                                             \
+    } while (0)
+#endif
+
 #if WASM_ENABLE_OPCODE_COUNTER != 0
 typedef struct OpcodeInfo {
     char *name;
@@ -1408,17 +1672,30 @@ DEFINE_GOTO_TABLE(OpcodeInfo, opcode_table);
 #undef HANDLE_OPCODE
 /* clang-format on */
 
+static bool
+is_op_count_dumped(uint32 opcode)
+{
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* Dump the superinstructions too, so that the counts of the fused
+       comparisons can be compared with the unfused ones */
+    if (opcode >= EXT_OP_BR_IF_I32_EQZ && opcode <= EXT_OP_BR_IF_I32_GE_U)
+        return true;
+#endif
+    return opcode < WASM_OP_IMPDEP;
+}
+
 static void
 wasm_interp_dump_op_count()
 {
     uint32 i;
     uint64 total_count = 0;
-    for (i = 0; i < WASM_OP_IMPDEP; i++)
-        total_count += opcode_table[i].count;
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
+        if (is_op_count_dumped(i))
+            total_count += opcode_table[i].count;
 
     os_printf("total opcode count: %ld\n", total_count);
-    for (i = 0; i < WASM_OP_IMPDEP; i++)
-        if (opcode_table[i].count > 0)
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
+        if (is_op_count_dumped(i) && opcode_table[i].count > 0)
             os_printf("\t\t%s count:\t\t%ld,\t\t%.2f%%\n", opcode_table[i].name,
                       opcode_table[i].count,
                       opcode_table[i].count * 100.0f / total_count);
@@ -1438,7 +1715,6 @@ wasm_interp_dump_op_count()
     do {                                               \
         const void *p_label_addr = *(void **)frame_ip; \
         frame_ip += sizeof(void *);                    \
-        CHECK_INSTRUCTION_LIMIT();                     \
         goto *p_label_addr;                            \
     } while (0)
 #else
@@ -1450,7 +1726,6 @@ wasm_interp_dump_op_count()
         /* int32 relative offset was emitted in 64-bit target */          \
         p_label_addr = label_base + (int32)LOAD_U32_WITH_2U16S(frame_ip); \
         frame_ip += sizeof(int32);                                        \
-        CHECK_INSTRUCTION_LIMIT();                                        \
         goto *p_label_addr;                                               \
     } while (0)
 #else
@@ -1461,7 +1736,6 @@ wasm_interp_dump_op_count()
         /* uint32 label address was emitted in 32-bit target */          \
         p_label_addr = (void *)(uintptr_t)LOAD_U32_WITH_2U16S(frame_ip); \
         frame_ip += sizeof(int32);                                       \
-        CHECK_INSTRUCTION_LIMIT();                                       \
         goto *p_label_addr;                                              \
     } while (0)
 #endif
@@ -1538,13 +1812,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
     uint8 *maddr = NULL;
     uint32 local_idx, local_offset, global_idx;
     uint8 opcode = 0, local_type, *global_addr;
-
-#if WASM_ENABLE_INSTRUCTION_METERING != 0
-    int instructions_left = -1;
-    if (exec_env) {
-        instructions_left = exec_env->instructions_to_execute;
-    }
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0 || WASM_ENABLE_TIERED_JIT != 0
+    uint8 *br_ip;
 #endif
+
 #if !defined(OS_ENABLE_HW_BOUND_CHECK) \
     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
@@ -1643,7 +1914,19 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 CHECK_SUSPEND_FLAGS();
 #endif
             recover_br_info:
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0 || WASM_ENABLE_TIERED_JIT != 0
+                br_ip = frame_ip;
                 RECOVER_BR_INFO();
+                /* A backward branch is a loop back-edge */
+                if (frame_ip < br_ip) {
+                    COUNT_HOTNESS(cur_func->u.func);
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+                    CHECK_EPOCH_DEADLINE();
+#endif
+                }
+#else
+                RECOVER_BR_INFO();
+#endif
                 HANDLE_OP_END();
             }
 
@@ -1662,6 +1945,97 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+            HANDLE_OP(EXT_OP_BR_IF_I32_EQZ)
+            {
+                DEF_OP_BR_IF(GET_OPERAND(int32, I32, 0) == 0, 2);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_EQ)
+            {
+                DEF_OP_BR_IF_CMP(uint32, ==);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_NE)
+            {
+                DEF_OP_BR_IF_CMP(uint32, !=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_LT_S)
+            {
+                DEF_OP_BR_IF_CMP(int32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_LT_U)
+            {
+                DEF_OP_BR_IF_CMP(uint32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_GT_S)
+            {
+                DEF_OP_BR_IF_CMP(int32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_GT_U)
+            {
+                DEF_OP_BR_IF_CMP(uint32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_LE_S)
+            {
+                DEF_OP_BR_IF_CMP(int32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_LE_U)
+            {
+                DEF_OP_BR_IF_CMP(uint32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_GE_S)
+            {
+                DEF_OP_BR_IF_CMP(int32, >=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_BR_IF_I32_GE_U)
+            {
+                DEF_OP_BR_IF_CMP(uint32, >=);
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS != 0 */
+
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+            HANDLE_OP(EXT_OP_INSTRUCTION_METERING)
+            {
+                /* charge all the instructions of the basic block at once,
+                   the count was calculated by the loader */
+                uint32 instr_count = read_uint32(frame_ip);
+                int instructions_left = exec_env->instructions_to_execute;
+
+                if (instructions_left >= 0) {
+                    if ((uint32)instructions_left >= instr_count)
+                        exec_env->instructions_to_execute =
+                            instructions_left - (int)instr_count;
+                    else {
+                        SYNC_ALL_TO_FRAME();
+                        if (!wasm_runtime_check_instruction_limit(
+                                exec_env, instr_count))
+                            goto got_exception;
+                    }
+                }
+                HANDLE_OP_END();
+            }
+#endif
+
             HANDLE_OP(WASM_OP_BR_TABLE)
             {
                 uint32 arity, br_item_size;
@@ -1836,16 +2210,104 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             }
 
 #if WASM_ENABLE_EXCE_HANDLING != 0
-            HANDLE_OP(WASM_OP_TRY)
-            HANDLE_OP(WASM_OP_CATCH)
             HANDLE_OP(WASM_OP_THROW)
+            {
+                WASMTagInstance *tag;
+                WASMFuncType *tag_type;
+                uint32 tag_index, *exce_values, cell_idx, cell_num;
+                int32 n;
+
+                tag_index = read_uint32(frame_ip);
+                exce_values = frame_lp + GET_OFFSET();
+
+                tag = module->e->tags + tag_index;
+                tag_type = tag->is_import_tag ? tag->u.tag_import->tag_type
+                                              : tag->u.tag->tag_type;
+
+                /* gather the values, their offsets are from the last one */
+                cell_idx = tag_type->param_cell_num;
+                for (n = (int32)tag_type->param_count - 1; n >= 0; n--) {
+                    cell_num = wasm_value_type_cell_num(tag_type->types[n]);
+                    cell_idx -= cell_num;
+                    word_copy(exce_values + cell_idx, frame_lp + GET_OFFSET(),
+                              cell_num);
+                }
+
+                wasm_runtime_throw_exception((WASMModuleInstanceCommon *)module,
+                                             tag_index, exce_values,
+                                             tag_type->param_cell_num, NULL);
+                goto find_a_catch_handler;
+            }
+
             HANDLE_OP(WASM_OP_RETHROW)
-            HANDLE_OP(WASM_OP_DELEGATE)
+            {
+                /* the exception kept by the catching block */
+                uint32 *exce = frame_lp + GET_OFFSET();
+
+                wasm_runtime_throw_exception((WASMModuleInstanceCommon *)module,
+                                             exce[0], exce + 2, exce[1], NULL);
+                goto find_a_catch_handler;
+            }
+
+            HANDLE_OP(WASM_OP_CATCH)
+            {
+                uint32 *exce = frame_lp + GET_OFFSET();
+                uint32 cell_num = read_uint32(frame_ip);
+
+                /* keep the exception for rethrow and copy its values
+                   as the operands of the catch body */
+                wasm_runtime_catch_exception((WASMModuleInstanceCommon *)module,
+                                             exce);
+                if (cell_num > 0)
+                    word_copy(exce + 2 + cell_num, exce + 2, cell_num);
+                HANDLE_OP_END();
+            }
+
             HANDLE_OP(WASM_OP_CATCH_ALL)
-            HANDLE_OP(EXT_OP_TRY)
             {
-                wasm_set_exception(module, "unsupported opcode");
-                goto got_exception;
+                wasm_runtime_catch_exception((WASMModuleInstanceCommon *)module,
+                                             frame_lp + GET_OFFSET());
+                HANDLE_OP_END();
+            }
+
+            find_a_catch_handler:
+            {
+                WASMInterpFrame *catch_frame = frame, *prev;
+                uint8 *catch_ip = frame_ip, *handler;
+                uint32 tag_index = wasm_runtime_get_exception_tag(
+                    (WASMModuleInstanceCommon *)module);
+
+                /* traps can't be caught */
+                if (tag_index == INVALID_TAGINDEX)
+                    goto got_exception;
+
+                /* search the frames called from the interpreter */
+                while (!(handler = find_catch_handler(
+                             catch_frame->function->u.func, catch_ip,
+                             tag_index))) {
+                    catch_frame = catch_frame->prev_frame;
+                    if (!(catch_ip = catch_frame->ip))
+                        /* the exception is propagated to native */
+                        goto got_exception;
+                }
+
+                if (catch_frame != frame) {
+                    /* unwind the frames of the callees */
+                    while (frame != catch_frame) {
+                        prev = frame->prev_frame;
+                        FREE_FRAME(exec_env, frame);
+                        frame = prev;
+                    }
+                    wasm_exec_env_set_cur_frame(exec_env,
+                                                (WASMRuntimeFrame *)frame);
+                    RECOVER_CONTEXT(frame);
+#if WASM_ENABLE_GC != 0
+                    local_cell_num =
+                        cur_func->param_cell_num + cur_func->local_cell_num;
+#endif
+                }
+                frame_ip = handler;
+                HANDLE_OP_END();
             }
 #endif
 
@@ -7506,13 +7968,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #endif
 #if WASM_ENABLE_EXCE_HANDLING == 0
         /* if exception handling is disabled, these opcodes issue a trap */
-        HANDLE_OP(WASM_OP_TRY)
         HANDLE_OP(WASM_OP_CATCH)
         HANDLE_OP(WASM_OP_THROW)
         HANDLE_OP(WASM_OP_RETHROW)
-        HANDLE_OP(WASM_OP_DELEGATE)
         HANDLE_OP(WASM_OP_CATCH_ALL)
-        HANDLE_OP(EXT_OP_TRY)
 #endif
         HANDLE_OP(WASM_OP_UNUSED_0x16)
         HANDLE_OP(WASM_OP_UNUSED_0x17)
@@ -7534,6 +7993,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         HANDLE_OP(EXT_OP_LOOP)
         HANDLE_OP(EXT_OP_IF)
         HANDLE_OP(EXT_OP_BR_TABLE_CACHE)
+        HANDLE_OP(WASM_OP_TRY)
+        HANDLE_OP(WASM_OP_DELEGATE)
+        HANDLE_OP(EXT_OP_TRY)
 #if WASM_ENABLE_SIMDE == 0
         HANDLE_OP(WASM_OP_SIMD_PREFIX)
 #endif
@@ -7555,6 +8017,11 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         uint32 *lp_base = NULL, *lp = NULL;
         int i;
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+        if (!cur_func->is_prepared && !wasm_prepare_function(module, cur_func))
+            goto got_exception;
+#endif
+
         if (cur_func->param_cell_num > 0
             && !(lp_base = lp = wasm_runtime_malloc(cur_func->param_cell_num
                                                     * sizeof(uint32)))) {
@@ -7602,6 +8069,12 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         WASMInterpFrame *outs_area = wasm_exec_env_wasm_stack_top(exec_env);
         int i;
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+        /* The const cell num of the callee is known after it is prepared */
+        if (!cur_func->is_prepared && !wasm_prepare_function(module, cur_func))
+            goto got_exception;
+#endif
+
 #if WASM_ENABLE_MULTI_MODULE != 0
         if (cur_func->is_import_func) {
             outs_area->lp = outs_area->operand
@@ -7677,7 +8150,18 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
     call_func_from_entry:
     {
-        if (cur_func->is_import_func) {
+        if (cur_func->is_import_func
+#if WASM_ENABLE_JIT != 0
+            || llvm_jit_is_func_callable(module, cur_func)
+#endif
+        ) {
+#if WASM_ENABLE_JIT != 0
+            if (!cur_func->is_import_func) {
+                wasm_interp_call_func_llvm_jit(module, exec_env, cur_func,
+                                               prev_frame);
+            }
+            else
+#endif
 #if WASM_ENABLE_MULTI_MODULE != 0
             if (cur_func->import_func_inst) {
                 wasm_interp_call_func_import(module, exec_env, cur_func,
@@ -7713,8 +8197,20 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             if (memory)
                 linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
 #endif
-            if (wasm_copy_exception(module, NULL))
+            if (wasm_copy_exception(module, NULL)) {
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                /* the wasm exception thrown by the callee may be caught
+                   by the caller */
+                if (frame_ip)
+                    goto find_a_catch_handler;
+#endif
                 goto got_exception;
+            }
+#if WASM_ENABLE_JIT != 0
+            /* The llvm jit function was called from native */
+            if (!frame_ip)
+                return;
+#endif
         }
         else {
             WASMFunction *cur_wasm_func = cur_func->u.func;
@@ -7740,6 +8236,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                in loader), all_cell_num must be smaller than 1MB */
             bh_assert(all_cell_num < 1 * BH_MB);
 
+            COUNT_HOTNESS(cur_wasm_func);
+
             frame_size = wasm_interp_interp_frame_size(all_cell_num);
             if (!(frame = ALLOC_FRAME(exec_env, frame_size, prev_frame))) {
                 frame = prev_frame;
@@ -7923,6 +8421,11 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
     argc = function->param_cell_num;
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    if (!function->is_prepared && !wasm_prepare_function(module_inst, function))
+        return;
+#endif
+
 #if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_DISABLE_STACK_HW_BOUND_CHECK == 0
     /*
      * wasm_runtime_detect_native_stack_overflow is done by
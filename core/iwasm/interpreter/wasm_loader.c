@@ -5899,7 +5899,8 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     if (module->function_count == 0)
         return true;
 
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0) \
+    || WASM_ENABLE_TIERED_JIT != 0
     if (os_mutex_init(&module->tierup_wait_lock) != 0) {
         set_error_buf(error_buf, error_buf_size, "init jit tierup lock failed");
         return false;
@@ -5956,9 +5957,16 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.enable_ref_types = true;
 #elif WASM_ENABLE_GC != 0
     option.enable_gc = true;
+    option.enable_gc_tlab = true;
 #endif
 #if WASM_ENABLE_CALL_INDIRECT_OVERLONG != 0
     option.enable_call_indirect_overlong = true;
+#endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    option.enable_instruction_metering = true;
+#endif
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    option.enable_epoch_interruption = true;
 #endif
     option.enable_aux_stack_check = true;
 #if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
@@ -6074,6 +6082,153 @@ init_llvm_jit_functions_stage2_callback(void *arg)
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
+#if WASM_ENABLE_JIT != 0
+/* Compile the llvm jit functions of the group whose first function is
+   the i-th non-import function, the group contains the functions
+   i + j * WASM_ORC_JIT_BACKEND_THREAD_NUM, which are compiled together
+   by the jit wrapper function */
+static bool
+orcjit_compile_llvm_jit_group(WASMModule *module, AOTCompContext *comp_ctx,
+                              uint32 i)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    LLVMOrcJITTargetAddress func_addr = 0;
+    LLVMErrorRef error;
+    char func_name[48];
+    typedef void (*F)(void);
+    union {
+        F f;
+        void *v;
+    } u;
+    uint32 j;
+
+    snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
+             "_wrapper");
+    LOG_DEBUG("compile llvm jit func %s", func_name);
+    error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
+    if (error != LLVMErrorSuccess) {
+        char *err_msg = LLVMGetErrorMessage(error);
+        LOG_ERROR("failed to compile llvm jit function %u: %s", i, err_msg);
+        LLVMDisposeErrorMessage(err_msg);
+        return false;
+    }
+
+    /* Call the jit wrapper function to trigger its compilation, so as
+       to compile the actual jit functions, since we add the latter to
+       function list in the PartitionFunction callback */
+    u.v = (void *)func_addr;
+    u.f();
+
+    for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
+        if (i + j * group_stride < func_count) {
+            module->func_ptrs_compiled[i + j * group_stride] = true;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+            snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
+                     i + j * group_stride);
+            error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
+                                           func_name);
+            if (error != LLVMErrorSuccess) {
+                char *err_msg = LLVMGetErrorMessage(error);
+                LOG_ERROR("failed to compile llvm jit function %u: %s", i,
+                          err_msg);
+                LLVMDisposeErrorMessage(err_msg);
+                /* Ignore current llvm jit func, as its func ptr is
+                   previous set to call_to_fast_jit, which also works */
+                continue;
+            }
+
+            jit_compiler_set_llvm_jit_func_ptr(
+                module, i + j * group_stride + module->import_function_count,
+                (void *)func_addr);
+
+            /* Try to switch to call this llvm jit function instead of
+               fast jit function from fast jit jitted code */
+            jit_compiler_set_call_to_llvm_jit(
+                module, i + j * group_stride + module->import_function_count);
+#endif
+        }
+    }
+
+    return true;
+}
+#endif /* end of WASM_ENABLE_JIT != 0 */
+
+#if WASM_ENABLE_TIERED_JIT != 0
+/* Get the hottest function's hotness of the llvm jit function group
+   whose first function is the i-th non-import function */
+static uint32
+orcjit_get_group_hotness(WASMModule *module, uint32 i)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 hotness = 0, j;
+
+    for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM
+                && i + j * group_stride < module->function_count;
+         j++) {
+        if (module->functions[i + j * group_stride]->hotness > hotness)
+            hotness = module->functions[i + j * group_stride]->hotness;
+    }
+
+    return hotness;
+}
+
+/* Compile the llvm jit function groups of this thread when they get hot,
+   the hottest one first, until all of them are compiled */
+static void
+orcjit_tier_up_llvm_jit_groups(WASMModule *module, AOTCompContext *comp_ctx,
+                               uint32 group_idx)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    uint32 i, hotness, max_hotness, hottest_group, hot_func_count;
+    bool all_compiled;
+
+    while (!module->orcjit_stop_compiling) {
+        os_mutex_lock(&module->tierup_wait_lock);
+        hot_func_count = module->hot_func_count;
+        os_mutex_unlock(&module->tierup_wait_lock);
+
+        all_compiled = true;
+        max_hotness = 0;
+        hottest_group = func_count;
+
+        for (i = group_idx; i < func_count;
+             i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
+            if (module->func_ptrs_compiled[i])
+                continue;
+            all_compiled = false;
+            hotness = orcjit_get_group_hotness(module, i);
+            if (hotness >= WASM_TIERED_JIT_LLVM_JIT_THRESHOLD
+                && hotness > max_hotness) {
+                max_hotness = hotness;
+                hottest_group = i;
+            }
+        }
+
+        if (all_compiled)
+            break;
+
+        if (hottest_group < func_count) {
+            if (!orcjit_compile_llvm_jit_group(module, comp_ctx,
+                                               hottest_group))
+                break;
+            continue;
+        }
+
+        /* Nothing is hot enough yet, wait until another function gets
+           hot since the scan above */
+        os_mutex_lock(&module->tierup_wait_lock);
+        while (module->hot_func_count == hot_func_count
+               && !module->orcjit_stop_compiling) {
+            os_cond_wait(&module->tierup_wait_cond,
+                         &module->tierup_wait_lock);
+        }
+        os_mutex_unlock(&module->tierup_wait_lock);
+    }
+}
+#endif /* end of WASM_ENABLE_TIERED_JIT != 0 */
+
 /* The callback function to compile jit functions */
 static void *
 orcjit_thread_callback(void *arg)
@@ -6148,70 +6303,17 @@ orcjit_thread_callback(void *arg)
     os_mutex_unlock(&module->tierup_wait_lock);
 #endif
 
-#if WASM_ENABLE_JIT != 0
+#if WASM_ENABLE_TIERED_JIT != 0
+    /* Compile llvm jit functions of this group when they get hot */
+    orcjit_tier_up_llvm_jit_groups(module, comp_ctx, group_idx);
+#elif WASM_ENABLE_JIT != 0
     /* Compile llvm jit functions of this group */
     for (i = group_idx; i < func_count;
          i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
-        LLVMOrcJITTargetAddress func_addr = 0;
-        LLVMErrorRef error;
-        char func_name[48];
-        typedef void (*F)(void);
-        union {
-            F f;
-            void *v;
-        } u;
-        uint32 j;
-
-        snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
-                 "_wrapper");
-        LOG_DEBUG("compile llvm jit func %s", func_name);
-        error =
-            LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
-        if (error != LLVMErrorSuccess) {
-            char *err_msg = LLVMGetErrorMessage(error);
-            LOG_ERROR("failed to compile llvm jit function %u: %s", i, err_msg);
-            LLVMDisposeErrorMessage(err_msg);
+        if (!orcjit_compile_llvm_jit_group(module, comp_ctx, i)) {
             break;
         }
 
-        /* Call the jit wrapper function to trigger its compilation, so as
-           to compile the actual jit functions, since we add the latter to
-           function list in the PartitionFunction callback */
-        u.v = (void *)func_addr;
-        u.f();
-
-        for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
-            if (i + j * group_stride < func_count) {
-                module->func_ptrs_compiled[i + j * group_stride] = true;
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
-                snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
-                         i + j * group_stride);
-                error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
-                                               func_name);
-                if (error != LLVMErrorSuccess) {
-                    char *err_msg = LLVMGetErrorMessage(error);
-                    LOG_ERROR("failed to compile llvm jit function %u: %s", i,
-                              err_msg);
-                    LLVMDisposeErrorMessage(err_msg);
-                    /* Ignore current llvm jit func, as its func ptr is
-                       previous set to call_to_fast_jit, which also works */
-                    continue;
-                }
-
-                jit_compiler_set_llvm_jit_func_ptr(
-                    module,
-                    i + j * group_stride + module->import_function_count,
-                    (void *)func_addr);
-
-                /* Try to switch to call this llvm jit function instead of
-                   fast jit function from fast jit jitted code */
-                jit_compiler_set_call_to_llvm_jit(
-                    module,
-                    i + j * group_stride + module->import_function_count);
-#endif
-            }
-        }
-
         if (module->orcjit_stop_compiling) {
             break;
         }
@@ -6229,6 +6331,14 @@ orcjit_stop_compile_threads(WASMModule *module)
                                     / sizeof(OrcJitThreadArg));
 
     module->orcjit_stop_compiling = true;
+#if WASM_ENABLE_TIERED_JIT != 0
+    /* Wake up the threads waiting for hot functions */
+    if (module->tierup_wait_lock_inited) {
+        os_mutex_lock(&module->tierup_wait_lock);
+        os_cond_broadcast(&module->tierup_wait_cond);
+        os_mutex_unlock(&module->tierup_wait_lock);
+    }
+#endif
     for (i = 0; i < thread_num; i++) {
         if (module->orcjit_threads[i])
             os_thread_join(module->orcjit_threads[i], NULL);
@@ -6304,6 +6414,48 @@ compile_jit_functions(WASMModule *module, char *error_buf,
 
     return true;
 }
+
+static bool
+init_jit_functions(WASMModule *module, char *error_buf,
+                   uint32 error_buf_size)
+{
+#if WASM_ENABLE_FAST_JIT != 0
+    if (!init_fast_jit_functions(module, error_buf, error_buf_size)) {
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_JIT != 0
+    if (!init_llvm_jit_functions_stage1(module, error_buf, error_buf_size)) {
+        return false;
+    }
+#if !(WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0)
+    if (!init_llvm_jit_functions_stage2(module, error_buf, error_buf_size)) {
+        return false;
+    }
+#else
+    /* Run aot_compile_wasm in a backend thread, so as not to block the main
+       thread fast jit execution, since applying llvm optimizations in
+       aot_compile_wasm may cost a lot of time.
+       Create thread with enough native stack to apply llvm optimizations */
+    if (os_thread_create(&module->llvm_jit_init_thread,
+                         init_llvm_jit_functions_stage2_callback,
+                         (void *)module, APP_THREAD_STACK_SIZE_DEFAULT * 8)
+        != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "create orcjit compile thread failed");
+        return false;
+    }
+#endif
+#endif
+
+    /* Create threads to compile the jit functions */
+    if (!compile_jit_functions(module, error_buf, error_buf_size)) {
+        return false;
+    }
+
+    return true;
+}
 #endif /* end of WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0 */
 
 static bool
@@ -6694,12 +6846,39 @@ load_from_sections(WASMModule *module, WASMSection *sections,
     handle_table = wasm_interp_get_handle_table();
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* Validate and prepare the functions on their first calls, unless the
+       wasm binary may be freed after loading, in which case the function
+       bodies are no longer available */
+    if (!wasm_binary_freeable) {
+        if (os_mutex_init(&module->lazy_prepare_lock) != 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "init lazy prepare lock failed");
+            return false;
+        }
+        module->lazy_prepare_lock_inited = true;
+        module->is_lazy_prepare = true;
+        /* memory.grow can't be found without decoding the function bodies */
+        module->possible_memory_grow = true;
+    }
+#endif
+
     for (i = 0; i < module->function_count; i++) {
         WASMFunction *func = module->functions[i];
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+        if (!module->is_lazy_prepare) {
+            if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
+                                              error_buf_size)) {
+                return false;
+            }
+            func->prepare_state = WASM_FUNC_PREPARE_STATE_DONE;
+        }
+#else
         if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
                                           error_buf_size)) {
             return false;
         }
+#endif
 
         if (i == module->function_count - 1
             && func->code + func->code_size != buf_code_end) {
@@ -6792,41 +6971,15 @@ load_from_sections(WASMModule *module, WASMSection *sections,
 
     calculate_global_data_offset(module);
 
-#if WASM_ENABLE_FAST_JIT != 0
-    if (!init_fast_jit_functions(module, error_buf, error_buf_size)) {
-        return false;
-    }
-#endif
-
-#if WASM_ENABLE_JIT != 0
-    if (!init_llvm_jit_functions_stage1(module, error_buf, error_buf_size)) {
-        return false;
-    }
-#if !(WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0)
-    if (!init_llvm_jit_functions_stage2(module, error_buf, error_buf_size)) {
-        return false;
-    }
-#else
-    /* Run aot_compile_wasm in a backend thread, so as not to block the main
-       thread fast jit execution, since applying llvm optimizations in
-       aot_compile_wasm may cost a lot of time.
-       Create thread with enough native stack to apply llvm optimizations */
-    if (os_thread_create(&module->llvm_jit_init_thread,
-                         init_llvm_jit_functions_stage2_callback,
-                         (void *)module, APP_THREAD_STACK_SIZE_DEFAULT * 8)
-        != 0) {
-        set_error_buf(error_buf, error_buf_size,
-                      "create orcjit compile thread failed");
-        return false;
-    }
-#endif
-#endif
-
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
-    /* Create threads to compile the jit functions */
-    if (!compile_jit_functions(module, error_buf, error_buf_size)) {
-        return false;
-    }
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    /* The module is only compiled into an AOT file for the
+       LLVM JIT cache, see wasm_loader_load_for_jit_cache */
+    if (!module->skip_jit_compilation)
+#endif
+        if (!init_jit_functions(module, error_buf, error_buf_size)) {
+            return false;
+        }
 #endif
 
 #if WASM_ENABLE_MEMORY_TRACING != 0
@@ -7275,6 +7428,73 @@ check_wasi_abi_compatibility(const WASMModule *module,
 }
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+bool
+wasm_loader_prepare_function(WASMModule *module, uint32 func_idx,
+                             char *error_buf, uint32 error_buf_size)
+{
+    WASMFunction *func = module->functions[func_idx];
+    uint32 prepare_state;
+
+    if (BH_ATOMIC_32_LOAD(func->prepare_state)
+        == WASM_FUNC_PREPARE_STATE_DONE)
+        return true;
+
+    os_mutex_lock(&module->lazy_prepare_lock);
+    prepare_state = func->prepare_state;
+    if (prepare_state == WASM_FUNC_PREPARE_STATE_NONE) {
+        if (wasm_loader_prepare_bytecode(module, func, func_idx, error_buf,
+                                         error_buf_size))
+            prepare_state = WASM_FUNC_PREPARE_STATE_DONE;
+        else
+            /* Don't validate it again, the bytecode may have been
+               partially rewritten */
+            prepare_state = WASM_FUNC_PREPARE_STATE_FAILED;
+        BH_ATOMIC_32_STORE(func->prepare_state, prepare_state);
+    }
+    else if (prepare_state == WASM_FUNC_PREPARE_STATE_FAILED) {
+        set_error_buf_v(error_buf, error_buf_size,
+                        "function %" PRIu32 " failed to validate", func_idx);
+    }
+    os_mutex_unlock(&module->lazy_prepare_lock);
+
+    return prepare_state == WASM_FUNC_PREPARE_STATE_DONE;
+}
+
+/* Prepare the start function and the exported functions, which are the
+   entries of the module and are likely to be called soon */
+static void *
+lazy_prepare_thread_callback(void *arg)
+{
+    WASMModule *module = (WASMModule *)arg;
+    char error_buf[128];
+    uint32 i;
+
+    if (module->start_function != (uint32)-1
+        && module->start_function >= module->import_function_count) {
+        /* The errors are reported again when the function is called */
+        wasm_loader_prepare_function(
+            module, module->start_function - module->import_function_count,
+            error_buf, sizeof(error_buf));
+    }
+
+    for (i = 0; i < module->export_count; i++) {
+        WASMExport *export = &module->exports[i];
+
+        if (BH_ATOMIC_32_LOAD(module->lazy_prepare_stop))
+            break;
+        if (export->kind == EXPORT_KIND_FUNC
+            && export->index >= module->import_function_count) {
+            wasm_loader_prepare_function(
+                module, export->index - module->import_function_count,
+                error_buf, sizeof(error_buf));
+        }
+    }
+
+    return NULL;
+}
+#endif /* end of WASM_ENABLE_LAZY_FUNC_VALIDATION != 0 */
+
 WASMModule *
 wasm_loader_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -7309,6 +7529,19 @@ wasm_loader_load(uint8 *buf, uint32 size,
     }
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    if (module->is_lazy_prepare && args->prepare_exports_in_background
+        && os_thread_create(&module->lazy_prepare_thread,
+                            lazy_prepare_thread_callback, (void *)module,
+                            APP_THREAD_STACK_SIZE_DEFAULT)
+               != 0) {
+        /* Not fatal, the functions are still prepared on their first
+           calls */
+        LOG_WARNING("warning: create lazy prepare thread failed");
+        module->lazy_prepare_thread = 0;
+    }
+#endif
+
     LOG_VERBOSE("Load module success.\n");
     return module;
 
@@ -7317,6 +7550,28 @@ fail:
     return NULL;
 }
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+WASMModule *
+wasm_loader_load_for_jit_cache(uint8 *buf, uint32 size, char *error_buf,
+                               uint32 error_buf_size)
+{
+    WASMModule *module = create_module("", error_buf, error_buf_size);
+    if (!module) {
+        return NULL;
+    }
+
+    module->load_addr = (uint8 *)buf;
+    module->load_size = size;
+    module->skip_jit_compilation = true;
+
+    if (!load(buf, size, module, false, true, error_buf, error_buf_size)) {
+        wasm_loader_unload(module);
+        return NULL;
+    }
+    return module;
+}
+#endif
+
 void
 wasm_loader_unload(WASMModule *module)
 {
@@ -7325,6 +7580,16 @@ wasm_loader_unload(WASMModule *module)
     if (!module)
         return;
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* Stop the background preparation firstly to avoid accessing module
+       internal data after they were freed */
+    BH_ATOMIC_32_STORE(module->lazy_prepare_stop, 1);
+    if (module->lazy_prepare_thread)
+        os_thread_join(module->lazy_prepare_thread, NULL);
+    if (module->lazy_prepare_lock_inited)
+        os_mutex_destroy(&module->lazy_prepare_lock);
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     module->orcjit_stop_compiling = true;
@@ -7347,8 +7612,9 @@ wasm_loader_unload(WASMModule *module)
         aot_destroy_comp_data(module->comp_data);
 #endif
 
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
-    && WASM_ENABLE_LAZY_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+     && WASM_ENABLE_LAZY_JIT != 0)                         \
+    || WASM_ENABLE_TIERED_JIT != 0
     if (module->tierup_wait_lock_inited) {
         os_mutex_destroy(&module->tierup_wait_lock);
         os_cond_destroy(&module->tierup_wait_cond);
@@ -7368,6 +7634,12 @@ wasm_loader_unload(WASMModule *module)
                     wasm_runtime_free(module->functions[i]->code_compiled);
                 if (module->functions[i]->consts)
                     wasm_runtime_free(module->functions[i]->consts);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                if (module->functions[i]->try_blocks)
+                    wasm_runtime_free(module->functions[i]->try_blocks);
+                if (module->functions[i]->catch_handlers)
+                    wasm_runtime_free(module->functions[i]->catch_handlers);
+#endif
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
                 if (module->functions[i]->fast_jit_jitted_code) {
@@ -7582,6 +7854,11 @@ wasm_loader_unload(WASMModule *module)
     if (module->function_hints != NULL)
         wasm_runtime_free(module->function_hints);
 #endif
+
+#ifdef OS_ENABLE_FILE_MMAP
+    if (module->mapped_file_buf)
+        os_munmap(module->mapped_file_buf, (size_t)module->mapped_file_size);
+#endif
     wasm_runtime_free(module);
 }
 
@@ -7649,6 +7926,8 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                     /* stop search and return the address of the catch block */
                     return true;
                 }
+                /* skip tag_index */
+                skip_leb(p);
                 break;
             case WASM_OP_CATCH_ALL:
                 if (block_nested_depth == 1) {
@@ -8478,6 +8757,16 @@ typedef struct BranchBlock {
      * to copy the stack operands to the loop block's arguments in
      * wasm_loader_emit_br_info for opcode br. */
     uint16 start_dynamic_offset;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Index of the try block in the function's try blocks */
+    uint32 try_block_idx;
+    /* Where the handlers of the try block start in the catch
+     * handler stack of loader context */
+    uint32 catch_handler_base;
+    /* Offset of the exception caught by the catch or catch_all
+     * block, kept for rethrow */
+    int16 exce_offset;
+#endif
 #endif
 
     /* Indicate the operand stack is in polymorphic state.
@@ -8559,6 +8848,16 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* try blocks and catch handlers, counted in the first traverse and
+     * filled into the function in the second traverse */
+    uint32 try_block_num;
+    uint32 catch_handler_num;
+    /* catch handlers of the try blocks not ended yet */
+    WASMCatchHandler *catch_handler_stack;
+    uint32 catch_handler_stack_num;
+#endif
 #endif
 } WASMLoaderContext;
 
@@ -8793,6 +9092,10 @@ wasm_loader_ctx_destroy(WASMLoaderContext *ctx)
             wasm_runtime_free(ctx->i32_consts);
         if (ctx->v128_consts)
             wasm_runtime_free(ctx->v128_consts);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        if (ctx->catch_handler_stack)
+            wasm_runtime_free(ctx->catch_handler_stack);
+#endif
 #endif
         wasm_runtime_free(ctx);
     }
@@ -9480,6 +9783,49 @@ fail:
         || (last_op == WASM_OP_F64_REINTERPRET_I64)                            \
         || (last_op == EXT_OP_COPY_STACK_TOP_I64)
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+/* Whether last op is an i32 comparison which can be fused with br_if */
+#define LAST_OP_FUSIBLE_WITH_BR_IF()                              \
+    (last_op >= WASM_OP_I32_EQZ && last_op <= WASM_OP_I32_GE_U \
+     && (WASM_SUPERINSTRUCTION_SET & (1 << (last_op - WASM_OP_I32_EQZ))))
+#endif
+
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+/* Whether the opcode ends the basic block charged by one
+   EXT_OP_INSTRUCTION_METERING: it may branch or leave the function, or
+   the code following it is a branch target */
+static bool
+is_metering_block_end(uint8 opcode)
+{
+    switch (opcode) {
+        case WASM_OP_UNREACHABLE:
+        case WASM_OP_LOOP:
+        case WASM_OP_IF:
+        case WASM_OP_ELSE:
+        case WASM_OP_END:
+        case WASM_OP_BR:
+        case WASM_OP_BR_IF:
+        case WASM_OP_BR_TABLE:
+        case WASM_OP_RETURN:
+        case WASM_OP_RETURN_CALL:
+        case WASM_OP_RETURN_CALL_INDIRECT:
+        case WASM_OP_RETURN_CALL_REF:
+        case WASM_OP_BR_ON_NULL:
+        case WASM_OP_BR_ON_NON_NULL:
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        case WASM_OP_THROW:
+        case WASM_OP_RETHROW:
+        case WASM_OP_CATCH:
+        case WASM_OP_CATCH_ALL:
+        case WASM_OP_DELEGATE:
+#endif
+            return true;
+        default:
+            return false;
+    }
+}
+#endif
+
 #define GET_CONST_OFFSET(type, val)                                    \
     do {                                                               \
         if (!(wasm_loader_get_const_offset(loader_ctx, type, &val,     \
@@ -11281,9 +11627,6 @@ check_branch_block_for_delegate(WASMLoaderContext *loader_ctx, uint8 **p_buf,
         goto fail;
     }
     frame_csp_tmp = loader_ctx->frame_csp - depth - 2;
-#if WASM_ENABLE_FAST_INTERP != 0
-    emit_br_info(frame_csp_tmp, false);
-#endif
 
     *p_buf = p;
     return frame_csp_tmp;
@@ -11553,7 +11896,163 @@ fail:
 
     return ret;
 }
-#endif
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/* Get the index of the innermost try block whose try body contains
+ * the given block (the given block included), or -1 if there is none */
+static int32
+get_enclosing_try_block_idx(WASMLoaderContext *loader_ctx, BranchBlock *block)
+{
+    for (; block >= loader_ctx->frame_csp_bottom; block--) {
+        if (block->label_type == LABEL_TYPE_TRY)
+            return (int32)block->try_block_idx;
+    }
+    return -1;
+}
+
+static uint32
+get_max_tag_param_cell_num(const WASMModule *module)
+{
+    uint32 max_cell_num = 0, cell_num, i;
+
+    for (i = 0; i < module->import_tag_count; i++) {
+        cell_num = module->import_tags[i].u.tag.tag_type->param_cell_num;
+        if (cell_num > max_cell_num)
+            max_cell_num = cell_num;
+    }
+    for (i = 0; i < module->tag_count; i++) {
+        cell_num = module->tags[i]->tag_type->param_cell_num;
+        if (cell_num > max_cell_num)
+            max_cell_num = cell_num;
+    }
+    return max_cell_num;
+}
+
+/* Start the try block on the top of the block stack, its try body
+ * starts from the current compiled code */
+static void
+wasm_loader_begin_try_block(WASMLoaderContext *loader_ctx,
+                            WASMFunction *func)
+{
+    BranchBlock *block = loader_ctx->frame_csp - 1;
+    WASMTryBlock *try_block;
+
+    block->try_block_idx = loader_ctx->try_block_num++;
+    block->catch_handler_base = loader_ctx->catch_handler_stack_num;
+
+    /* The try blocks are only filled in the second traverse */
+    if (!loader_ctx->p_code_compiled)
+        return;
+
+    bh_assert(block->try_block_idx < func->try_block_count);
+    try_block = func->try_blocks + block->try_block_idx;
+    try_block->start_addr = loader_ctx->p_code_compiled;
+    try_block->end_addr = NULL;
+    try_block->outer_try_idx =
+        get_enclosing_try_block_idx(loader_ctx, block - 1);
+    try_block->handler_count = 0;
+    try_block->handlers = NULL;
+}
+
+/* End the try body or the previous catch body of the block on the top
+ * of the block stack and emit the entry of a catch or catch_all handler.
+ * The caught exception is stored in the dynamic space of the block for
+ * rethrow: the tag index, the cell num and the values, see
+ * wasm_runtime_catch_exception, the catch handler then copies the values
+ * once more as the operands of the catch body. */
+static bool
+wasm_loader_emit_catch(WASMLoaderContext *loader_ctx, WASMFunction *func,
+                       uint8 opcode, uint32 tag_index, uint32 exce_cell_num,
+                       char *error_buf, uint32 error_buf_size)
+{
+    BranchBlock *block = loader_ctx->frame_csp - 1;
+    WASMCatchHandler *handler;
+    int32 dynamic_offset;
+
+    /* The catch or catch_all opcode was emitted, remove it */
+    skip_label();
+
+    if (block->label_type == LABEL_TYPE_TRY && loader_ctx->p_code_compiled)
+        func->try_blocks[block->try_block_idx].end_addr =
+            loader_ctx->p_code_compiled;
+
+    /* Copy the results to the block return address and jump to the end
+     * of the block like what the else opcode of if block does */
+    emit_label(WASM_OP_ELSE);
+    if (!reserve_block_ret(loader_ctx, WASM_OP_ELSE, false, error_buf,
+                           error_buf_size))
+        return false;
+    emit_empty_label_addr_and_frame_ip(PATCH_END);
+
+    /* Reserve the dynamic space of the caught exception */
+    dynamic_offset = (int32)block->dynamic_offset + 2 + (int32)exce_cell_num;
+    if (dynamic_offset >= INT16_MAX) {
+        set_error_buf(error_buf, error_buf_size,
+                      "fast interpreter offset overflow");
+        return false;
+    }
+    block->exce_offset = (int16)block->dynamic_offset;
+    loader_ctx->dynamic_offset = (int16)dynamic_offset;
+    if (loader_ctx->dynamic_offset > loader_ctx->max_dynamic_offset)
+        loader_ctx->max_dynamic_offset = loader_ctx->dynamic_offset;
+
+    if (!loader_ctx->p_code_compiled) {
+        /* Only count the handlers in the first traverse */
+        loader_ctx->catch_handler_num++;
+    }
+    else {
+        bh_assert(loader_ctx->catch_handler_stack_num
+                  < func->catch_handler_count);
+        handler = loader_ctx->catch_handler_stack
+                  + loader_ctx->catch_handler_stack_num++;
+        handler->tag_index = tag_index;
+        handler->addr = loader_ctx->p_code_compiled;
+    }
+
+    emit_label(opcode);
+    emit_operand(loader_ctx, block->exce_offset);
+    if (opcode == WASM_OP_CATCH)
+        emit_uint32(loader_ctx, exce_cell_num);
+
+    return true;
+fail:
+    return false;
+}
+
+/* End the try block, catch block or catch_all block which was just
+ * popped from the block stack, and move its handlers to the function */
+static void
+wasm_loader_end_try_block(WASMLoaderContext *loader_ctx, WASMFunction *func,
+                          BranchBlock *block)
+{
+    WASMTryBlock *try_block;
+    uint32 handler_count;
+
+    if (!loader_ctx->p_code_compiled)
+        return;
+
+    try_block = func->try_blocks + block->try_block_idx;
+    if (block->label_type == LABEL_TYPE_TRY)
+        try_block->end_addr = loader_ctx->p_code_compiled;
+
+    handler_count =
+        loader_ctx->catch_handler_stack_num - block->catch_handler_base;
+    if (handler_count > 0) {
+        bh_assert(loader_ctx->catch_handler_num + handler_count
+                  <= func->catch_handler_count);
+        try_block->handlers =
+            func->catch_handlers + loader_ctx->catch_handler_num;
+        try_block->handler_count = handler_count;
+        bh_memcpy_s(try_block->handlers,
+                    (uint32)sizeof(WASMCatchHandler) * handler_count,
+                    loader_ctx->catch_handler_stack + block->catch_handler_base,
+                    (uint32)sizeof(WASMCatchHandler) * handler_count);
+        loader_ctx->catch_handler_num += handler_count;
+        loader_ctx->catch_handler_stack_num = block->catch_handler_base;
+    }
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+#endif /* end of WASM_ENABLE_FAST_INTERP != 0 */
 
 #if WASM_ENABLE_GC == 0
 #define RESET_REFTYPE_MAP_STACK() (void)0
@@ -11813,6 +12312,14 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
      * the end opcode and then raising the exception.
      */
     bool pending_exception = false;
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    /* The instruction count of current basic block, and the address of
+       the count operand of the EXT_OP_INSTRUCTION_METERING emitted at
+       the start of the block, which is patched when the block ends */
+    uint32 metering_count = 0;
+    uint8 *metering_count_addr = NULL;
+    bool metering_block_end;
+#endif
 
     LOG_OP("\nProcessing func | [%d] params | [%d] locals | [%d] return\n",
            func->param_cell_num, func->local_cell_num, func->ret_cell_num);
@@ -11875,6 +12382,29 @@ re_scan:
         func->code_compiled = loader_ctx->p_code_compiled;
         func->code_compiled_size = loader_ctx->code_compiled_size;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        if (loader_ctx->try_block_num > 0) {
+            if (!(func->try_blocks = loader_malloc(
+                      sizeof(WASMTryBlock) * (uint64)loader_ctx->try_block_num,
+                      error_buf, error_buf_size)))
+                goto fail;
+            func->try_block_count = loader_ctx->try_block_num;
+            loader_ctx->try_block_num = 0;
+        }
+        if (loader_ctx->catch_handler_num > 0) {
+            uint64 size = sizeof(WASMCatchHandler)
+                          * (uint64)loader_ctx->catch_handler_num;
+
+            if (!(func->catch_handlers =
+                      loader_malloc(size, error_buf, error_buf_size))
+                || !(loader_ctx->catch_handler_stack =
+                         loader_malloc(size, error_buf, error_buf_size)))
+                goto fail;
+            func->catch_handler_count = loader_ctx->catch_handler_num;
+            loader_ctx->catch_handler_num = 0;
+        }
+#endif
+
         if (loader_ctx->i64_const_num > 0) {
             int64 *i64_consts_old = loader_ctx->i64_consts;
 
@@ -11974,11 +12504,27 @@ re_scan:
 
     PUSH_CSP(LABEL_TYPE_FUNCTION, func_block_type, p);
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_INSTRUCTION_METERING != 0
+    metering_block_end = true;
+#endif
+
     while (p < p_end) {
         opcode = *p++;
 #if WASM_ENABLE_FAST_INTERP != 0
         p_org = p;
         disable_emit = false;
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+        if (metering_block_end) {
+            /* Start a new basic block, its instruction count is unknown
+               until it ends */
+            emit_label(EXT_OP_INSTRUCTION_METERING);
+            metering_count_addr = loader_ctx->p_code_compiled;
+            emit_uint32(loader_ctx, 0);
+            metering_count = 0;
+            metering_block_end = false;
+        }
+        metering_count++;
+#endif
         emit_label(opcode);
 #endif
         switch (opcode) {
@@ -12267,7 +12813,11 @@ re_scan:
                 }
 
 #if WASM_ENABLE_FAST_INTERP != 0
-                if (opcode == WASM_OP_BLOCK || opcode == WASM_OP_LOOP) {
+                if (opcode == WASM_OP_BLOCK || opcode == WASM_OP_LOOP
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                    || opcode == WASM_OP_TRY
+#endif
+                ) {
                     skip_label();
 
                     if (BLOCK_HAS_PARAM(block_type)) {
@@ -12281,12 +12831,12 @@ re_scan:
                         (loader_ctx->frame_csp - 1)->code_compiled =
                             loader_ctx->p_code_compiled;
                     }
-                }
 #if WASM_ENABLE_EXCE_HANDLING != 0
-                else if (opcode == WASM_OP_TRY) {
-                    skip_label();
-                }
+                    else if (opcode == WASM_OP_TRY) {
+                        wasm_loader_begin_try_block(loader_ctx, func);
+                    }
 #endif
+                }
                 else if (opcode == WASM_OP_IF) {
                     BranchBlock *block = loader_ctx->frame_csp - 1;
                     /* If block has parameters, we should make sure they are in
@@ -12450,6 +13000,27 @@ re_scan:
                 param_count = func->func_type->param_count;
 #endif
 
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* The values are gathered to the top of dynamic space and
+                 * then thrown, emit the tag index, the dynamic offset and
+                 * the offsets of the values from the last one */
+                if ((int32)loader_ctx->dynamic_offset
+                        + (int32)tag_type->param_cell_num
+                    >= INT16_MAX) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "fast interpreter offset overflow");
+                    goto fail;
+                }
+                emit_uint32(loader_ctx, tag_index);
+                emit_operand(loader_ctx, loader_ctx->dynamic_offset);
+                if (loader_ctx->dynamic_offset + tag_type->param_cell_num
+                    > loader_ctx->max_dynamic_offset)
+                    loader_ctx->max_dynamic_offset =
+                        loader_ctx->dynamic_offset + tag_type->param_cell_num;
+                for (tti = (int32)tag_type->param_count - 1; tti >= 0; tti--)
+                    POP_OFFSET_TYPE(tag_type->types[tti]);
+#endif
+
                 /* throw is stack polymorphic */
                 (void)label_type;
                 RESET_STACK();
@@ -12458,14 +13029,20 @@ re_scan:
             }
             case WASM_OP_RETHROW:
             {
-                /* must be done before checking branch block */
+                uint32 depth;
+
                 SET_CUR_BLOCK_STACK_POLYMORPHIC_STATE(true);
 
-                /* check the target catching block:  LABEL_TYPE_CATCH */
-                if (!(frame_csp_tmp =
-                          check_branch_block(loader_ctx, &p, p_end, opcode,
-                                             error_buf, error_buf_size)))
+                /* check the target catching block:  LABEL_TYPE_CATCH, it
+                 * isn't a branch and no values are passed to it */
+                pb_read_leb_uint32(p, p_end, depth);
+                if (loader_ctx->csp_num - 1 < depth) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "unknown label, "
+                                  "unexpected end of section or function");
                     goto fail;
+                }
+                frame_csp_tmp = loader_ctx->frame_csp - depth - 1;
 
                 if (frame_csp_tmp->label_type != LABEL_TYPE_CATCH
                     && frame_csp_tmp->label_type != LABEL_TYPE_CATCH_ALL) {
@@ -12475,6 +13052,11 @@ re_scan:
                     goto fail;
                 }
 
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* rethrow the exception kept by the catching block */
+                emit_operand(loader_ctx, frame_csp_tmp->exce_offset);
+#endif
+
                 BranchBlock *cur_block = loader_ctx->frame_csp - 1;
                 uint8 label_type = cur_block->label_type;
                 (void)label_type;
@@ -12490,11 +13072,45 @@ re_scan:
                     goto fail;
 
                 BranchBlock *cur_block = loader_ctx->frame_csp - 1;
-                uint8 label_type = cur_block->label_type;
 
-                (void)label_type;
+                /* expecting a TRY, anything else will be considered an
+                 * error */
+                if (LABEL_TYPE_TRY != cur_block->label_type) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "Unexpected block sequence encountered.");
+                    goto fail;
+                }
+
+                /* check whether block stack matches its result type */
+                if (!check_block_stack(loader_ctx, cur_block, error_buf,
+                                       error_buf_size))
+                    goto fail;
+
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* the exceptions not caught by the try block are
+                 * searched from the target block */
+                if (loader_ctx->p_code_compiled)
+                    func->try_blocks[cur_block->try_block_idx].outer_try_idx =
+                        get_enclosing_try_block_idx(loader_ctx,
+                                                    frame_csp_tmp);
+#endif
                 /* DELEGATE ends the block */
                 POP_CSP();
+
+#if WASM_ENABLE_FAST_INTERP != 0
+                skip_label();
+                wasm_loader_end_try_block(loader_ctx, func,
+                                          loader_ctx->frame_csp);
+                /* copy the result to the block return address */
+                if (!reserve_block_ret(loader_ctx, WASM_OP_END, disable_emit,
+                                       error_buf, error_buf_size)) {
+                    free_label_patch_list(loader_ctx->frame_csp);
+                    goto fail;
+                }
+
+                apply_label_patch(loader_ctx, 0, PATCH_END);
+                free_label_patch_list(loader_ctx->frame_csp);
+#endif
                 break;
             }
             case WASM_OP_CATCH:
@@ -12541,6 +13157,19 @@ re_scan:
                     goto fail;
                 }
 
+                /* check whether the try body or the previous catch body
+                 * matches the result type */
+                if (!check_block_stack(loader_ctx, cur_block, error_buf,
+                                       error_buf_size))
+                    goto fail;
+
+#if WASM_ENABLE_FAST_INTERP != 0
+                if (!wasm_loader_emit_catch(loader_ctx, func, opcode,
+                                            tag_index, func_type->param_cell_num,
+                                            error_buf, error_buf_size))
+                    goto fail;
+#endif
+
                 /*
                  * replace frame_csp by LABEL_TYPE_CATCH
                  */
@@ -12549,6 +13178,7 @@ re_scan:
                 /* RESET_STACK removes the values pushed in TRY or previous
                  * CATCH Blocks */
                 RESET_STACK();
+                SET_CUR_BLOCK_STACK_POLYMORPHIC_STATE(false);
 
 #if WASM_ENABLE_GC != 0
                 WASMRefType *ref_type;
@@ -12566,6 +13196,12 @@ re_scan:
                                     wasm_reftype_struct_size(ref_type));
                         j++;
                     }
+#endif
+#if WASM_ENABLE_FAST_INTERP != 0
+                    /* the values were copied to the dynamic space by
+                     * the catch handler, erase the emitted offset */
+                    PUSH_OFFSET_TYPE(func_type->types[i]);
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
 #endif
                     PUSH_TYPE(func_type->types[i]);
                 }
@@ -12584,6 +13220,22 @@ re_scan:
                     goto fail;
                 }
 
+                /* check whether the try body or the previous catch body
+                 * matches the result type */
+                if (!check_block_stack(loader_ctx, cur_block, error_buf,
+                                       error_buf_size))
+                    goto fail;
+
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* any exception may be caught, reserve the space for
+                 * the one with the most values */
+                if (!wasm_loader_emit_catch(
+                        loader_ctx, func, opcode, INVALID_TAGINDEX,
+                        get_max_tag_param_cell_num(module), error_buf,
+                        error_buf_size))
+                    goto fail;
+#endif
+
                 /* no immediates */
                 /* replace frame_csp by LABEL_TYPE_CATCH_ALL */
                 cur_block->label_type = LABEL_TYPE_CATCH_ALL;
@@ -12591,6 +13243,7 @@ re_scan:
                 /* RESET_STACK removes the values pushed in TRY or previous
                  * CATCH Blocks */
                 RESET_STACK();
+                SET_CUR_BLOCK_STACK_POLYMORPHIC_STATE(false);
 
                 /* catch_all has no tagtype and therefore no parameters */
                 break;
@@ -12694,6 +13347,19 @@ re_scan:
 
 #if WASM_ENABLE_FAST_INTERP != 0
                 skip_label();
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                if (loader_ctx->frame_csp->label_type == LABEL_TYPE_TRY
+                    || loader_ctx->frame_csp->label_type == LABEL_TYPE_CATCH
+                    || loader_ctx->frame_csp->label_type
+                           == LABEL_TYPE_CATCH_ALL) {
+                    wasm_loader_end_try_block(loader_ctx, func,
+                                              loader_ctx->frame_csp);
+                    /* release the dynamic space of the caught exception */
+                    if (loader_ctx->frame_csp->label_type != LABEL_TYPE_TRY)
+                        loader_ctx->dynamic_offset =
+                            loader_ctx->frame_csp->dynamic_offset;
+                }
+#endif
                 /* copy the result to the block return address */
                 if (!reserve_block_ret(loader_ctx, opcode, disable_emit,
                                        error_buf, error_buf_size)) {
@@ -12758,7 +13424,43 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
-                POP_I32();
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                if (LAST_OP_FUSIBLE_WITH_BR_IF()
+                    && !(loader_ctx->frame_csp - 1)->is_stack_polymorphic) {
+                    /* Replace the comparison and br_if with the fused op,
+                       the result of the comparison is no longer written
+                       to the stack and its operands are used directly as
+                       the condition of br_if */
+                    uint32 operand_num = last_op == WASM_OP_I32_EQZ ? 1 : 2;
+                    int16 rhs = 0, lhs = 0;
+
+                    skip_label();
+                    if (loader_ctx->p_code_compiled) {
+                        /* the comparison emitted its operands and then
+                           the result offset */
+                        uint8 *p_operands = loader_ctx->p_code_compiled
+                                            - sizeof(int16) * (operand_num + 1);
+                        rhs = LOAD_I16(p_operands);
+                        if (operand_num == 2)
+                            lhs = LOAD_I16(p_operands + sizeof(int16));
+                    }
+                    wasm_loader_emit_backspace(
+                        loader_ctx, sizeof(int16) * (operand_num + 1));
+                    skip_label();
+
+                    emit_label(EXT_OP_BR_IF_I32_EQZ
+                               + (last_op - WASM_OP_I32_EQZ));
+                    emit_operand(loader_ctx, rhs);
+                    if (operand_num == 2)
+                        emit_operand(loader_ctx, lhs);
+
+                    POP_I32();
+                    /* remove the result offset emitted by POP_I32 */
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+                }
+                else
+#endif
+                    POP_I32();
 
                 if (!(frame_csp_tmp =
                           check_branch_block(loader_ctx, &p, p_end, opcode,
@@ -15483,6 +16185,9 @@ re_scan:
 #if WASM_ENABLE_FAST_INTERP != 0
                         /* Erase the opnd offset emitted by PUSH_REF() */
                         wasm_loader_emit_backspace(loader_ctx, sizeof(uint16));
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+                        metering_block_end = true;
+#endif
 #endif
                         break;
                     }
@@ -17037,6 +17742,14 @@ re_scan:
         }
 
 #if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+        if (metering_block_end || is_metering_block_end(opcode)) {
+            metering_block_end = true;
+            /* The code is only emitted in the second traverse */
+            if (metering_count_addr)
+                STORE_U32(metering_count_addr, metering_count);
+        }
+#endif
         last_op = opcode;
 #endif
     }
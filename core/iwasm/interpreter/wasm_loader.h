@@ -43,6 +43,24 @@ WASMModule *
 wasm_loader_load_from_sections(WASMSection *section_list, char *error_buf,
                                uint32 error_buf_size);
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+/**
+ * Load a WASM module from a specified byte buffer without compiling its
+ * functions with JIT and without resolving its imports, the module is
+ * only used to compile the AOT file of the LLVM JIT cache.
+ *
+ * @param buf the byte buffer which contains the WASM binary data
+ * @param size the size of the buffer
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return module loaded, NULL if failed
+ */
+WASMModule *
+wasm_loader_load_for_jit_cache(uint8 *buf, uint32 size, char *error_buf,
+                               uint32 error_buf_size);
+#endif
+
 /**
  * Unload a WASM module.
  *
@@ -51,6 +69,23 @@ wasm_loader_load_from_sections(WASMSection *section_list, char *error_buf,
 void
 wasm_loader_unload(WASMModule *module);
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+/**
+ * Validate a function and prepare its bytecode if it hasn't been done,
+ * it is thread-safe and the function is only prepared once.
+ *
+ * @param module the module of the function
+ * @param func_idx the index of the function, excluding the imported ones
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return true if success, false if the function is invalid
+ */
+bool
+wasm_loader_prepare_function(WASMModule *module, uint32 func_idx,
+                             char *error_buf, uint32 error_buf_size);
+#endif
+
 /**
  * Find address of related else opcode and end opcode of opcode block/loop/if
  * according to the start address of opcode.
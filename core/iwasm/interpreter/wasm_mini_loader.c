@@ -832,6 +832,11 @@ load_function_import(const uint8 **p_buf, const uint8 *buf_end,
     function->signature = linked_signature;
     function->attachment = linked_attachment;
     function->call_conv_raw = linked_call_conv_raw;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    if (linked_func && !linked_call_conv_raw)
+        function->quick_native_entry = wasm_native_lookup_quick_native_entry(
+            declare_func_type, linked_signature);
+#endif
     return true;
 }
 
@@ -2355,7 +2360,8 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     if (module->function_count == 0)
         return true;
 
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0) \
+    || WASM_ENABLE_TIERED_JIT != 0
     if (os_mutex_init(&module->tierup_wait_lock) != 0) {
         set_error_buf(error_buf, error_buf_size, "init jit tierup lock failed");
         return false;
@@ -2412,6 +2418,12 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
 #endif
 #if WASM_ENABLE_CALL_INDIRECT_OVERLONG != 0
     option.enable_call_indirect_overlong = true;
+#endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    option.enable_instruction_metering = true;
+#endif
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    option.enable_epoch_interruption = true;
 #endif
     option.enable_aux_stack_check = true;
 #if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
@@ -2529,6 +2541,153 @@ init_llvm_jit_functions_stage2_callback(void *arg)
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
+#if WASM_ENABLE_JIT != 0
+/* Compile the llvm jit functions of the group whose first function is
+   the i-th non-import function, the group contains the functions
+   i + j * WASM_ORC_JIT_BACKEND_THREAD_NUM, which are compiled together
+   by the jit wrapper function */
+static bool
+orcjit_compile_llvm_jit_group(WASMModule *module, AOTCompContext *comp_ctx,
+                              uint32 i)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    LLVMOrcJITTargetAddress func_addr = 0;
+    LLVMErrorRef error;
+    char func_name[48];
+    typedef void (*F)(void);
+    union {
+        F f;
+        void *v;
+    } u;
+    uint32 j;
+
+    snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
+             "_wrapper");
+    LOG_DEBUG("compile llvm jit func %s", func_name);
+    error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
+    if (error != LLVMErrorSuccess) {
+        char *err_msg = LLVMGetErrorMessage(error);
+        LOG_ERROR("failed to compile llvm jit function %u: %s", i, err_msg);
+        LLVMDisposeErrorMessage(err_msg);
+        return false;
+    }
+
+    /* Call the jit wrapper function to trigger its compilation, so as
+       to compile the actual jit functions, since we add the latter to
+       function list in the PartitionFunction callback */
+    u.v = (void *)func_addr;
+    u.f();
+
+    for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
+        if (i + j * group_stride < func_count) {
+            module->func_ptrs_compiled[i + j * group_stride] = true;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+            snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
+                     i + j * group_stride);
+            error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
+                                           func_name);
+            if (error != LLVMErrorSuccess) {
+                char *err_msg = LLVMGetErrorMessage(error);
+                LOG_ERROR("failed to compile llvm jit function %u: %s", i,
+                          err_msg);
+                LLVMDisposeErrorMessage(err_msg);
+                /* Ignore current llvm jit func, as its func ptr is
+                   previous set to call_to_fast_jit, which also works */
+                continue;
+            }
+
+            jit_compiler_set_llvm_jit_func_ptr(
+                module, i + j * group_stride + module->import_function_count,
+                (void *)func_addr);
+
+            /* Try to switch to call this llvm jit function instead of
+               fast jit function from fast jit jitted code */
+            jit_compiler_set_call_to_llvm_jit(
+                module, i + j * group_stride + module->import_function_count);
+#endif
+        }
+    }
+
+    return true;
+}
+#endif /* end of WASM_ENABLE_JIT != 0 */
+
+#if WASM_ENABLE_TIERED_JIT != 0
+/* Get the hottest function's hotness of the llvm jit function group
+   whose first function is the i-th non-import function */
+static uint32
+orcjit_get_group_hotness(WASMModule *module, uint32 i)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 hotness = 0, j;
+
+    for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM
+                && i + j * group_stride < module->function_count;
+         j++) {
+        if (module->functions[i + j * group_stride]->hotness > hotness)
+            hotness = module->functions[i + j * group_stride]->hotness;
+    }
+
+    return hotness;
+}
+
+/* Compile the llvm jit function groups of this thread when they get hot,
+   the hottest one first, until all of them are compiled */
+static void
+orcjit_tier_up_llvm_jit_groups(WASMModule *module, AOTCompContext *comp_ctx,
+                               uint32 group_idx)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    uint32 i, hotness, max_hotness, hottest_group, hot_func_count;
+    bool all_compiled;
+
+    while (!module->orcjit_stop_compiling) {
+        os_mutex_lock(&module->tierup_wait_lock);
+        hot_func_count = module->hot_func_count;
+        os_mutex_unlock(&module->tierup_wait_lock);
+
+        all_compiled = true;
+        max_hotness = 0;
+        hottest_group = func_count;
+
+        for (i = group_idx; i < func_count;
+             i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
+            if (module->func_ptrs_compiled[i])
+                continue;
+            all_compiled = false;
+            hotness = orcjit_get_group_hotness(module, i);
+            if (hotness >= WASM_TIERED_JIT_LLVM_JIT_THRESHOLD
+                && hotness > max_hotness) {
+                max_hotness = hotness;
+                hottest_group = i;
+            }
+        }
+
+        if (all_compiled)
+            break;
+
+        if (hottest_group < func_count) {
+            if (!orcjit_compile_llvm_jit_group(module, comp_ctx,
+                                               hottest_group))
+                break;
+            continue;
+        }
+
+        /* Nothing is hot enough yet, wait until another function gets
+           hot since the scan above */
+        os_mutex_lock(&module->tierup_wait_lock);
+        while (module->hot_func_count == hot_func_count
+               && !module->orcjit_stop_compiling) {
+            os_cond_wait(&module->tierup_wait_cond,
+                         &module->tierup_wait_lock);
+        }
+        os_mutex_unlock(&module->tierup_wait_lock);
+    }
+}
+#endif /* end of WASM_ENABLE_TIERED_JIT != 0 */
+
 /* The callback function to compile jit functions */
 static void *
 orcjit_thread_callback(void *arg)
@@ -2603,70 +2762,17 @@ orcjit_thread_callback(void *arg)
     os_mutex_unlock(&module->tierup_wait_lock);
 #endif
 
-#if WASM_ENABLE_JIT != 0
+#if WASM_ENABLE_TIERED_JIT != 0
+    /* Compile llvm jit functions of this group when they get hot */
+    orcjit_tier_up_llvm_jit_groups(module, comp_ctx, group_idx);
+#elif WASM_ENABLE_JIT != 0
     /* Compile llvm jit functions of this group */
     for (i = group_idx; i < func_count;
          i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
-        LLVMOrcJITTargetAddress func_addr = 0;
-        LLVMErrorRef error;
-        char func_name[48];
-        typedef void (*F)(void);
-        union {
-            F f;
-            void *v;
-        } u;
-        uint32 j;
-
-        snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
-                 "_wrapper");
-        LOG_DEBUG("compile llvm jit func %s", func_name);
-        error =
-            LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
-        if (error != LLVMErrorSuccess) {
-            char *err_msg = LLVMGetErrorMessage(error);
-            LOG_ERROR("failed to compile llvm jit function %u: %s", i, err_msg);
-            LLVMDisposeErrorMessage(err_msg);
+        if (!orcjit_compile_llvm_jit_group(module, comp_ctx, i)) {
             break;
         }
 
-        /* Call the jit wrapper function to trigger its compilation, so as
-           to compile the actual jit functions, since we add the latter to
-           function list in the PartitionFunction callback */
-        u.v = (void *)func_addr;
-        u.f();
-
-        for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
-            if (i + j * group_stride < func_count) {
-                module->func_ptrs_compiled[i + j * group_stride] = true;
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
-                snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
-                         i + j * group_stride);
-                error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
-                                               func_name);
-                if (error != LLVMErrorSuccess) {
-                    char *err_msg = LLVMGetErrorMessage(error);
-                    LOG_ERROR("failed to compile llvm jit function %u: %s", i,
-                              err_msg);
-                    LLVMDisposeErrorMessage(err_msg);
-                    /* Ignore current llvm jit func, as its func ptr is
-                       previous set to call_to_fast_jit, which also works */
-                    continue;
-                }
-
-                jit_compiler_set_llvm_jit_func_ptr(
-                    module,
-                    i + j * group_stride + module->import_function_count,
-                    (void *)func_addr);
-
-                /* Try to switch to call this llvm jit function instead of
-                   fast jit function from fast jit jitted code */
-                jit_compiler_set_call_to_llvm_jit(
-                    module,
-                    i + j * group_stride + module->import_function_count);
-#endif
-            }
-        }
-
         if (module->orcjit_stop_compiling) {
             break;
         }
@@ -2684,6 +2790,14 @@ orcjit_stop_compile_threads(WASMModule *module)
                                     / sizeof(OrcJitThreadArg));
 
     module->orcjit_stop_compiling = true;
+#if WASM_ENABLE_TIERED_JIT != 0
+    /* Wake up the threads waiting for hot functions */
+    if (module->tierup_wait_lock_inited) {
+        os_mutex_lock(&module->tierup_wait_lock);
+        os_cond_broadcast(&module->tierup_wait_cond);
+        os_mutex_unlock(&module->tierup_wait_lock);
+    }
+#endif
     for (i = 0; i < thread_num; i++) {
         if (module->orcjit_threads[i])
             os_thread_join(module->orcjit_threads[i], NULL);
@@ -2759,6 +2873,48 @@ compile_jit_functions(WASMModule *module, char *error_buf,
 
     return true;
 }
+
+static bool
+init_jit_functions(WASMModule *module, char *error_buf,
+                   uint32 error_buf_size)
+{
+#if WASM_ENABLE_FAST_JIT != 0
+    if (!init_fast_jit_functions(module, error_buf, error_buf_size)) {
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_JIT != 0
+    if (!init_llvm_jit_functions_stage1(module, error_buf, error_buf_size)) {
+        return false;
+    }
+#if !(WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0)
+    if (!init_llvm_jit_functions_stage2(module, error_buf, error_buf_size)) {
+        return false;
+    }
+#else
+    /* Run aot_compile_wasm in a backend thread, so as not to block the main
+       thread fast jit execution, since applying llvm optimizations in
+       aot_compile_wasm may cost a lot of time.
+       Create thread with enough native stack to apply llvm optimizations */
+    if (os_thread_create(&module->llvm_jit_init_thread,
+                         init_llvm_jit_functions_stage2_callback,
+                         (void *)module, APP_THREAD_STACK_SIZE_DEFAULT * 8)
+        != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "create orcjit compile thread failed");
+        return false;
+    }
+#endif
+#endif
+
+    /* Create threads to compile the jit functions */
+    if (!compile_jit_functions(module, error_buf, error_buf_size)) {
+        return false;
+    }
+
+    return true;
+}
 #endif /* end of WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0 */
 
 #if WASM_ENABLE_REF_TYPES != 0
@@ -3161,12 +3317,39 @@ load_from_sections(WASMModule *module, WASMSection *sections,
     handle_table = wasm_interp_get_handle_table();
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* Validate and prepare the functions on their first calls, unless the
+       wasm binary may be freed after loading, in which case the function
+       bodies are no longer available */
+    if (!wasm_binary_freeable) {
+        if (os_mutex_init(&module->lazy_prepare_lock) != 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "init lazy prepare lock failed");
+            return false;
+        }
+        module->lazy_prepare_lock_inited = true;
+        module->is_lazy_prepare = true;
+        /* memory.grow can't be found without decoding the function bodies */
+        module->possible_memory_grow = true;
+    }
+#endif
+
     for (i = 0; i < module->function_count; i++) {
         WASMFunction *func = module->functions[i];
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+        if (!module->is_lazy_prepare) {
+            if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
+                                              error_buf_size)) {
+                return false;
+            }
+            func->prepare_state = WASM_FUNC_PREPARE_STATE_DONE;
+        }
+#else
         if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
                                           error_buf_size)) {
             return false;
         }
+#endif
 
         if (i == module->function_count - 1) {
             bh_assert(func->code + func->code_size == buf_code_end);
@@ -3250,41 +3433,15 @@ load_from_sections(WASMModule *module, WASMSection *sections,
 
     calculate_global_data_offset(module);
 
-#if WASM_ENABLE_FAST_JIT != 0
-    if (!init_fast_jit_functions(module, error_buf, error_buf_size)) {
-        return false;
-    }
-#endif
-
-#if WASM_ENABLE_JIT != 0
-    if (!init_llvm_jit_functions_stage1(module, error_buf, error_buf_size)) {
-        return false;
-    }
-#if !(WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0)
-    if (!init_llvm_jit_functions_stage2(module, error_buf, error_buf_size)) {
-        return false;
-    }
-#else
-    /* Run aot_compile_wasm in a backend thread, so as not to block the main
-       thread fast jit execution, since applying llvm optimizations in
-       aot_compile_wasm may cost a lot of time.
-       Create thread with enough native stack to apply llvm optimizations */
-    if (os_thread_create(&module->llvm_jit_init_thread,
-                         init_llvm_jit_functions_stage2_callback,
-                         (void *)module, APP_THREAD_STACK_SIZE_DEFAULT * 8)
-        != 0) {
-        set_error_buf(error_buf, error_buf_size,
-                      "create orcjit compile thread failed");
-        return false;
-    }
-#endif
-#endif
-
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
-    /* Create threads to compile the jit functions */
-    if (!compile_jit_functions(module, error_buf, error_buf_size)) {
-        return false;
-    }
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    /* The module is only compiled into an AOT file for the
+       LLVM JIT cache, see wasm_loader_load_for_jit_cache */
+    if (!module->skip_jit_compilation)
+#endif
+        if (!init_jit_functions(module, error_buf, error_buf_size)) {
+            return false;
+        }
 #endif
 
 #if WASM_ENABLE_MEMORY_TRACING != 0
@@ -3510,6 +3667,72 @@ load(const uint8 *buf, uint32 size, WASMModule *module,
     return true;
 }
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+bool
+wasm_loader_prepare_function(WASMModule *module, uint32 func_idx,
+                             char *error_buf, uint32 error_buf_size)
+{
+    WASMFunction *func = module->functions[func_idx];
+    uint32 prepare_state;
+
+    if (BH_ATOMIC_32_LOAD(func->prepare_state)
+        == WASM_FUNC_PREPARE_STATE_DONE)
+        return true;
+
+    os_mutex_lock(&module->lazy_prepare_lock);
+    prepare_state = func->prepare_state;
+    if (prepare_state == WASM_FUNC_PREPARE_STATE_NONE) {
+        if (wasm_loader_prepare_bytecode(module, func, func_idx, error_buf,
+                                         error_buf_size))
+            prepare_state = WASM_FUNC_PREPARE_STATE_DONE;
+        else
+            /* Don't validate it again, the bytecode may have been
+               partially rewritten */
+            prepare_state = WASM_FUNC_PREPARE_STATE_FAILED;
+        BH_ATOMIC_32_STORE(func->prepare_state, prepare_state);
+    }
+    else if (prepare_state == WASM_FUNC_PREPARE_STATE_FAILED) {
+        set_error_buf(error_buf, error_buf_size, "function failed to validate");
+    }
+    os_mutex_unlock(&module->lazy_prepare_lock);
+
+    return prepare_state == WASM_FUNC_PREPARE_STATE_DONE;
+}
+
+/* Prepare the start function and the exported functions, which are the
+   entries of the module and are likely to be called soon */
+static void *
+lazy_prepare_thread_callback(void *arg)
+{
+    WASMModule *module = (WASMModule *)arg;
+    char error_buf[128];
+    uint32 i;
+
+    if (module->start_function != (uint32)-1
+        && module->start_function >= module->import_function_count) {
+        /* The errors are reported again when the function is called */
+        wasm_loader_prepare_function(
+            module, module->start_function - module->import_function_count,
+            error_buf, sizeof(error_buf));
+    }
+
+    for (i = 0; i < module->export_count; i++) {
+        WASMExport *export = &module->exports[i];
+
+        if (BH_ATOMIC_32_LOAD(module->lazy_prepare_stop))
+            break;
+        if (export->kind == EXPORT_KIND_FUNC
+            && export->index >= module->import_function_count) {
+            wasm_loader_prepare_function(
+                module, export->index - module->import_function_count,
+                error_buf, sizeof(error_buf));
+        }
+    }
+
+    return NULL;
+}
+#endif /* end of WASM_ENABLE_LAZY_FUNC_VALIDATION != 0 */
+
 WASMModule *
 wasm_loader_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -3537,6 +3760,19 @@ wasm_loader_load(uint8 *buf, uint32 size,
     (void)main_module;
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    if (module->is_lazy_prepare && args->prepare_exports_in_background
+        && os_thread_create(&module->lazy_prepare_thread,
+                            lazy_prepare_thread_callback, (void *)module,
+                            APP_THREAD_STACK_SIZE_DEFAULT)
+               != 0) {
+        /* Not fatal, the functions are still prepared on their first
+           calls */
+        LOG_WARNING("warning: create lazy prepare thread failed");
+        module->lazy_prepare_thread = 0;
+    }
+#endif
+
     LOG_VERBOSE("Load module success.\n");
     return module;
 
@@ -3545,6 +3781,28 @@ fail:
     return NULL;
 }
 
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+WASMModule *
+wasm_loader_load_for_jit_cache(uint8 *buf, uint32 size, char *error_buf,
+                               uint32 error_buf_size)
+{
+    WASMModule *module = create_module("", error_buf, error_buf_size);
+    if (!module) {
+        return NULL;
+    }
+
+    module->load_addr = (uint8 *)buf;
+    module->load_size = size;
+    module->skip_jit_compilation = true;
+
+    if (!load(buf, size, module, false, error_buf, error_buf_size)) {
+        wasm_loader_unload(module);
+        return NULL;
+    }
+    return module;
+}
+#endif
+
 void
 wasm_loader_unload(WASMModule *module)
 {
@@ -3553,6 +3811,16 @@ wasm_loader_unload(WASMModule *module)
     if (!module)
         return;
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* Stop the background preparation firstly to avoid accessing module
+       internal data after they were freed */
+    BH_ATOMIC_32_STORE(module->lazy_prepare_stop, 1);
+    if (module->lazy_prepare_thread)
+        os_thread_join(module->lazy_prepare_thread, NULL);
+    if (module->lazy_prepare_lock_inited)
+        os_mutex_destroy(&module->lazy_prepare_lock);
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     module->orcjit_stop_compiling = true;
@@ -3575,8 +3843,9 @@ wasm_loader_unload(WASMModule *module)
         aot_destroy_comp_data(module->comp_data);
 #endif
 
-#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
-    && WASM_ENABLE_LAZY_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+     && WASM_ENABLE_LAZY_JIT != 0)                         \
+    || WASM_ENABLE_TIERED_JIT != 0
     if (module->tierup_wait_lock_inited) {
         os_mutex_destroy(&module->tierup_wait_lock);
         os_cond_destroy(&module->tierup_wait_cond);
@@ -3704,6 +3973,11 @@ wasm_loader_unload(WASMModule *module)
     }
 #endif
 
+#ifdef OS_ENABLE_FILE_MMAP
+    if (module->mapped_file_buf)
+        os_munmap(module->mapped_file_buf, (size_t)module->mapped_file_size);
+#endif
+
     wasm_runtime_free(module);
 }
 
@@ -4741,6 +5015,39 @@ wasm_loader_pop_frame_csp(WASMLoaderContext *ctx, char *error_buf,
         || (last_op == WASM_OP_F64_REINTERPRET_I64)                            \
         || (last_op == EXT_OP_COPY_STACK_TOP_I64)
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+/* Whether last op is an i32 comparison which can be fused with br_if */
+#define LAST_OP_FUSIBLE_WITH_BR_IF()                              \
+    (last_op >= WASM_OP_I32_EQZ && last_op <= WASM_OP_I32_GE_U \
+     && (WASM_SUPERINSTRUCTION_SET & (1 << (last_op - WASM_OP_I32_EQZ))))
+#endif
+
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+/* Whether the opcode ends the basic block charged by one
+   EXT_OP_INSTRUCTION_METERING: it may branch or leave the function, or
+   the code following it is a branch target */
+static bool
+is_metering_block_end(uint8 opcode)
+{
+    switch (opcode) {
+        case WASM_OP_UNREACHABLE:
+        case WASM_OP_LOOP:
+        case WASM_OP_IF:
+        case WASM_OP_ELSE:
+        case WASM_OP_END:
+        case WASM_OP_BR:
+        case WASM_OP_BR_IF:
+        case WASM_OP_BR_TABLE:
+        case WASM_OP_RETURN:
+        case WASM_OP_RETURN_CALL:
+        case WASM_OP_RETURN_CALL_INDIRECT:
+            return true;
+        default:
+            return false;
+    }
+}
+#endif
+
 #define GET_CONST_OFFSET(type, val)                                    \
     do {                                                               \
         if (!(wasm_loader_get_const_offset(loader_ctx, type, &val,     \
@@ -6419,6 +6726,14 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     bool disable_emit, preserve_local = false, if_condition_available = true;
     float32 f32_const;
     float64 f64_const;
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    /* The instruction count of current basic block, and the address of
+       the count operand of the EXT_OP_INSTRUCTION_METERING emitted at
+       the start of the block, which is patched when the block ends */
+    uint32 metering_count = 0;
+    uint8 *metering_count_addr = NULL;
+    bool metering_block_end;
+#endif
 
     LOG_OP("\nProcessing func | [%d] params | [%d] locals | [%d] return\n",
            func->param_cell_num, func->local_cell_num, func->ret_cell_num);
@@ -6534,11 +6849,27 @@ re_scan:
 
     PUSH_CSP(LABEL_TYPE_FUNCTION, func_block_type, p);
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_INSTRUCTION_METERING != 0
+    metering_block_end = true;
+#endif
+
     while (p < p_end) {
         opcode = *p++;
 #if WASM_ENABLE_FAST_INTERP != 0
         p_org = p;
         disable_emit = false;
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+        if (metering_block_end) {
+            /* Start a new basic block, its instruction count is unknown
+               until it ends */
+            emit_label(EXT_OP_INSTRUCTION_METERING);
+            metering_count_addr = loader_ctx->p_code_compiled;
+            emit_uint32(loader_ctx, 0);
+            metering_count = 0;
+            metering_block_end = false;
+        }
+        metering_count++;
+#endif
         emit_label(opcode);
 #endif
 
@@ -6891,7 +7222,43 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
-                POP_I32();
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                if (LAST_OP_FUSIBLE_WITH_BR_IF()
+                    && !(loader_ctx->frame_csp - 1)->is_stack_polymorphic) {
+                    /* Replace the comparison and br_if with the fused op,
+                       the result of the comparison is no longer written
+                       to the stack and its operands are used directly as
+                       the condition of br_if */
+                    uint32 operand_num = last_op == WASM_OP_I32_EQZ ? 1 : 2;
+                    int16 rhs = 0, lhs = 0;
+
+                    skip_label();
+                    if (loader_ctx->p_code_compiled) {
+                        /* the comparison emitted its operands and then
+                           the result offset */
+                        uint8 *p_operands = loader_ctx->p_code_compiled
+                                            - sizeof(int16) * (operand_num + 1);
+                        rhs = LOAD_I16(p_operands);
+                        if (operand_num == 2)
+                            lhs = LOAD_I16(p_operands + sizeof(int16));
+                    }
+                    wasm_loader_emit_backspace(
+                        loader_ctx, sizeof(int16) * (operand_num + 1));
+                    skip_label();
+
+                    emit_label(EXT_OP_BR_IF_I32_EQZ
+                               + (last_op - WASM_OP_I32_EQZ));
+                    emit_operand(loader_ctx, rhs);
+                    if (operand_num == 2)
+                        emit_operand(loader_ctx, lhs);
+
+                    POP_I32();
+                    /* remove the result offset emitted by POP_I32 */
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+                }
+                else
+#endif
+                    POP_I32();
 
                 if (!(frame_csp_tmp =
                           check_branch_block(loader_ctx, &p, p_end, opcode,
@@ -8665,6 +9032,14 @@ re_scan:
         }
 
 #if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+        if (is_metering_block_end(opcode)) {
+            metering_block_end = true;
+            /* The code is only emitted in the second traverse */
+            if (metering_count_addr)
+                STORE_U32(metering_count_addr, metering_count);
+        }
+#endif
         last_op = opcode;
 #endif
     }
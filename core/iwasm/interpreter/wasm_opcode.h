@@ -287,6 +287,28 @@ typedef enum WASMOpcode {
     WASM_OP_SELECT_128 = 0xe2,
 #endif
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* superinstructions of fast interpreter: an i32 comparison fused
+       with the br_if which uses its result as the condition */
+    EXT_OP_BR_IF_I32_EQZ = 0xe3,
+    EXT_OP_BR_IF_I32_EQ = 0xe4,
+    EXT_OP_BR_IF_I32_NE = 0xe5,
+    EXT_OP_BR_IF_I32_LT_S = 0xe6,
+    EXT_OP_BR_IF_I32_LT_U = 0xe7,
+    EXT_OP_BR_IF_I32_GT_S = 0xe8,
+    EXT_OP_BR_IF_I32_GT_U = 0xe9,
+    EXT_OP_BR_IF_I32_LE_S = 0xea,
+    EXT_OP_BR_IF_I32_LE_U = 0xeb,
+    EXT_OP_BR_IF_I32_GE_S = 0xec,
+    EXT_OP_BR_IF_I32_GE_U = 0xed,
+#endif
+
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_INSTRUCTION_METERING != 0
+    /* charge the instruction count of the basic block which follows it,
+       emitted by the fast interpreter loader at the start of each block */
+    EXT_OP_INSTRUCTION_METERING = 0xee,
+#endif
+
     /* Post-MVP extend op prefix */
     WASM_OP_GC_PREFIX = 0xfb,
     WASM_OP_MISC_PREFIX = 0xfc,
@@ -802,6 +824,31 @@ typedef enum WASMAtomicEXTOpcode {
 #else
 #define DEF_EXT_V128_HANDLE()
 #endif
+
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#define DEF_EXT_SUPERINSTRUCTION_HANDLE()                   \
+    SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_EQZ),      /* 0xe3 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_EQ),   /* 0xe4 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_NE),   /* 0xe5 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_LT_S), /* 0xe6 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_LT_U), /* 0xe7 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_GT_S), /* 0xe8 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_GT_U), /* 0xe9 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_LE_S), /* 0xea */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_LE_U), /* 0xeb */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_GE_S), /* 0xec */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_BR_IF_I32_GE_U), /* 0xed */
+
+#else
+#define DEF_EXT_SUPERINSTRUCTION_HANDLE()
+#endif
+
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_INSTRUCTION_METERING != 0
+#define DEF_EXT_INSTRUCTION_METERING_HANDLE() \
+    SET_GOTO_TABLE_ELEM(EXT_OP_INSTRUCTION_METERING), /* 0xee */
+#else
+#define DEF_EXT_INSTRUCTION_METERING_HANDLE()
+#endif
 /*
  * Macro used to generate computed goto tables for the C interpreter.
  */
@@ -1034,6 +1081,8 @@ typedef enum WASMAtomicEXTOpcode {
         SET_GOTO_TABLE_ELEM(WASM_OP_SIMD_PREFIX),    /* 0xfd */ \
         SET_GOTO_TABLE_ELEM(WASM_OP_ATOMIC_PREFIX),  /* 0xfe */ \
         DEF_DEBUG_BREAK_HANDLE() DEF_EXT_V128_HANDLE()          \
+            DEF_EXT_SUPERINSTRUCTION_HANDLE()                   \
+                DEF_EXT_INSTRUCTION_METERING_HANDLE()           \
     };
 
 #ifdef __cplusplus
@@ -171,6 +171,12 @@ wasm_resolve_import_func(const WASMModule *module, WASMFunctionImport *function)
         &function->signature, &function->attachment, &function->call_conv_raw);
 
     if (function->func_ptr_linked) {
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+        if (!function->call_conv_raw)
+            function->quick_native_entry =
+                wasm_native_lookup_quick_native_entry(function->func_type,
+                                                      function->signature);
+#endif
         return true;
     }
 
@@ -215,6 +221,30 @@ runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
     return mem;
 }
 
+/* Allocate the module instance structure, from an instance slot if the
+   instance slot pool is enabled and has a free slot large enough */
+static void *
+instance_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    void *mem;
+
+    if ((mem = wasm_runtime_instance_slot_malloc(size)))
+        return mem;
+#endif
+    return runtime_malloc(size, error_buf, error_buf_size);
+}
+
+static void
+instance_free(void *module_inst)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    if (wasm_runtime_instance_slot_free(module_inst))
+        return;
+#endif
+    wasm_runtime_free(module_inst);
+}
+
 #if WASM_ENABLE_MULTI_MODULE != 0
 static WASMModuleInstance *
 get_sub_module_inst(const WASMModuleInstance *parent_module_inst,
@@ -2244,6 +2274,14 @@ wasm_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
     if (!ret)
         return ret;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* The exceptions thrown and caught by LLVM JIT code */
+    ret = wasm_runtime_exception_traverse_gc_rootset(
+        (WASMModuleInstanceCommon *)module_inst, heap);
+    if (!ret)
+        return ret;
+#endif
+
     return wasm_interp_traverse_gc_rootset(exec_env, heap);
 }
 #endif /* end of WASM_ENABLE_GC != 0 */
@@ -2260,7 +2298,11 @@ set_running_mode(WASMModuleInstance *module_inst, RunningMode running_mode,
 #elif WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT == 0
         running_mode = Mode_Fast_JIT;
 #elif WASM_ENABLE_FAST_JIT == 0 && WASM_ENABLE_JIT != 0
+#if WASM_ENABLE_TIERED_JIT != 0
+        running_mode = Mode_Multi_Tier_JIT;
+#else
         running_mode = Mode_LLVM_JIT;
+#endif
 #else /* WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 */
 #if WASM_ENABLE_LAZY_JIT == 0
         running_mode = Mode_LLVM_JIT;
@@ -2287,7 +2329,13 @@ set_running_mode(WASMModuleInstance *module_inst, RunningMode running_mode,
            module->fast_jit_func_ptrs */
     }
 #if WASM_ENABLE_JIT != 0
-    else if (running_mode == Mode_LLVM_JIT) {
+    else if (running_mode == Mode_LLVM_JIT
+#if WASM_ENABLE_TIERED_JIT != 0
+             /* Start in the fast interpreter, and call the llvm jit
+                functions once the backend threads compile them */
+             || running_mode == Mode_Multi_Tier_JIT
+#endif
+    ) {
         /* Set defined function pointers */
         bh_memcpy_s(module_inst->func_ptrs + module->import_function_count,
                     sizeof(void *) * module->function_count, module->func_ptrs,
@@ -2416,6 +2464,17 @@ wasm_set_running_mode(WASMModuleInstance *module_inst, RunningMode running_mode)
     return set_running_mode(module_inst, running_mode, false);
 }
 
+#if WASM_ENABLE_TIERED_JIT != 0
+void
+wasm_tiered_jit_notify_hot_function(WASMModule *module)
+{
+    os_mutex_lock(&module->tierup_wait_lock);
+    module->hot_func_count++;
+    os_cond_broadcast(&module->tierup_wait_cond);
+    os_mutex_unlock(&module->tierup_wait_lock);
+}
+#endif
+
 /**
  * Instantiate module
  */
@@ -2504,7 +2563,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
     /* Allocate the memory for module instance with memory instances,
        global data, table data appended at the end */
     if (!(module_inst =
-              runtime_malloc(total_size, error_buf, error_buf_size))) {
+              instance_malloc(total_size, error_buf, error_buf_size))) {
         return NULL;
     }
 
@@ -2516,7 +2575,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
         (WASMModuleInstanceCommon *)module_inst, args->custom_data);
 #if WASM_ENABLE_THREAD_MGR != 0
     if (os_mutex_init(&module_inst->e->common.exception_lock) != 0) {
-        wasm_runtime_free(module_inst);
+        instance_free(module_inst);
         return NULL;
     }
 #endif
@@ -2802,6 +2861,11 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             /* Ignore setting memory init data if the memory has been
                initialized */
             continue;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        if (args->restore_from_snapshot)
+            /* The memory data will be restored from the snapshot */
+            continue;
+#endif
 
         /* has check it in loader */
         memory = module_inst->memories[data_seg->memory_index];
@@ -2899,6 +2963,12 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
     module_inst->e->shared_heap = NULL;
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* No epoch deadline by default */
+    module_inst->e->epoch_ptr = wasm_runtime_get_epoch_addr();
+    module_inst->e->epoch_deadline = UINT64_MAX;
+#endif
+
 #if WASM_ENABLE_GC != 0
     /* Initialize the table data with init expr */
     for (i = 0; i < module->table_count; i++) {
@@ -3338,7 +3408,13 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                 &module_inst->e->functions[module->start_function];
     }
 
-    if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
+    if (
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        /* The snapshot already contains the state after the start and
+           initialize functions were executed */
+        !args->restore_from_snapshot &&
+#endif
+        !execute_post_instantiate_functions(module_inst, is_sub_inst,
                                             exec_env_main)) {
         set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
         goto fail;
@@ -3508,11 +3584,15 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
 #if WASM_ENABLE_REF_TYPES != 0
     bh_bitmap_delete(module_inst->e->common.elem_dropped);
 #endif
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    wasm_runtime_destroy_exception_values(
+        (WASMModuleInstanceCommon *)module_inst);
+#endif
 
 #if WASM_ENABLE_THREAD_MGR != 0
     os_mutex_destroy(&module_inst->e->common.exception_lock);
 #endif
-    wasm_runtime_free(module_inst);
+    instance_free(module_inst);
 }
 
 WASMFunctionInstance *
@@ -3691,6 +3771,55 @@ call_wasm_with_hw_bound_check(WASMModuleInstance *module_inst,
 #define interp_call_wasm wasm_interp_call_wasm
 #endif
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+static bool
+prepare_function(WASMModuleInstance *module_inst,
+                 WASMFunctionInstance *function, char *error_buf,
+                 uint32 error_buf_size)
+{
+    WASMModule *module = module_inst->module;
+
+    if (!function->is_import_func) {
+        uint32 func_idx = (uint32)(function - module_inst->e->functions)
+                          - module->import_function_count;
+
+        if (!wasm_loader_prepare_function(module, func_idx, error_buf,
+                                          error_buf_size))
+            return false;
+#if WASM_ENABLE_FAST_INTERP != 0
+        /* The consts are known only after the bytecode is prepared */
+        function->const_cell_num = (uint16)function->u.func->const_cell_num;
+#endif
+    }
+#if WASM_ENABLE_MULTI_MODULE != 0
+    else if (function->import_func_inst
+             && !function->import_func_inst->is_prepared) {
+        if (!prepare_function(function->import_module_inst,
+                              function->import_func_inst, error_buf,
+                              error_buf_size))
+            return false;
+    }
+#endif
+
+    function->is_prepared = true;
+    return true;
+}
+
+bool
+wasm_prepare_function(WASMModuleInstance *module_inst,
+                      WASMFunctionInstance *function)
+{
+    char error_buf[128];
+
+    if (!prepare_function(module_inst, function, error_buf,
+                          sizeof(error_buf))) {
+        wasm_set_exception(module_inst, error_buf);
+        return false;
+    }
+    return true;
+}
+#endif /* end of WASM_ENABLE_LAZY_FUNC_VALIDATION != 0 */
+
 bool
 wasm_call_function(WASMExecEnv *exec_env, WASMFunctionInstance *function,
                    unsigned argc, uint32 argv[])
@@ -3829,7 +3958,17 @@ wasm_module_malloc_internal(WASMModuleInstance *module_inst,
     }
 
     if (memory->heap_handle) {
-        addr = mem_allocator_malloc(memory->heap_handle, (uint32)size);
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+        void *alloc_cache;
+
+        /* Only the threads sharing the memory contend for the heap */
+        if (exec_env && memory->is_shared_memory
+            && (alloc_cache = wasm_exec_env_get_alloc_cache(
+                    exec_env, memory->heap_handle)))
+            addr = mem_allocator_cache_malloc(alloc_cache, (uint32)size);
+        else
+#endif
+            addr = mem_allocator_malloc(memory->heap_handle, (uint32)size);
     }
     else if (module_inst->e->malloc_function && module_inst->e->free_function) {
         if (!execute_malloc_function(
@@ -3928,7 +4067,16 @@ wasm_module_free_internal(WASMModuleInstance *module_inst,
 
         if (memory->heap_handle && memory->heap_data <= addr
             && addr < memory->heap_data_end) {
-            mem_allocator_free(memory->heap_handle, addr);
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+            void *alloc_cache;
+
+            if (exec_env && memory->is_shared_memory
+                && (alloc_cache = wasm_exec_env_get_alloc_cache(
+                        exec_env, memory->heap_handle)))
+                mem_allocator_cache_free(alloc_cache, addr);
+            else
+#endif
+                mem_allocator_free(memory->heap_handle, addr);
         }
         else if (module_inst->e->malloc_function
                  && module_inst->e->free_function && memory->memory_data <= addr
@@ -4075,7 +4223,12 @@ call_indirect(WASMExecEnv *exec_env, uint32 tbl_idx, uint32 tbl_elem_idx,
         else
             cur_func_type = (WASMType *)func_inst->u.func->func_type;
 
+#if WASM_ENABLE_GC == 0
         if (cur_type != cur_func_type) {
+#else
+        if (!wasm_func_type_is_super_of((WASMFuncType *)cur_type,
+                                        (WASMFuncType *)cur_func_type)) {
+#endif
             wasm_set_exception(module_inst, "indirect call type mismatch");
             goto got_exception;
         }
@@ -4675,6 +4828,13 @@ llvm_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx, uint32 argc,
             (WASMModuleInstanceCommon *)module_inst, func_ptr, func_type, argc,
             argv, c_api_func_import->with_env_arg, c_api_func_import->env_arg);
     }
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    else if (import_func->quick_native_entry) {
+        ret = wasm_runtime_invoke_quick_native(
+            exec_env, import_func->quick_native_entry, func_ptr, attachment,
+            argv, argv);
+    }
+#endif
     else if (!import_func->call_conv_raw) {
         signature = import_func->signature;
         ret =
@@ -214,6 +214,11 @@ struct WASMGlobalInstance {
 struct WASMFunctionInstance {
     /* whether it is import function or WASM function */
     bool is_import_func;
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+    /* whether the function, or the sub module function it imports, has
+       been prepared for this instance, see wasm_prepare_function */
+    bool is_prepared;
+#endif
     /* parameter count */
     uint16 param_count;
     /* local variable count, 0 for import function */
@@ -312,6 +317,20 @@ typedef struct CApiFuncImport {
     void *env_arg;
 } CApiFuncImport;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0 && WASM_ENABLE_GC != 0
+/* The copy of the values of an exception caught by AOT/LLVM JIT code,
+   which are kept in the native frame for rethrow and invisible to GC, so
+   that their GC references are added to the root set */
+typedef struct WASMCaughtException {
+    struct WASMCaughtException *next;
+    /* The buffer of the catch clause in the native frame */
+    const uint32 *buf;
+    uint32 cell_num;
+    /* The values followed by their ref flags */
+    uint32 values[1];
+} WASMCaughtException;
+#endif
+
 /* The common part of WASMModuleInstanceExtra and AOTModuleInstanceExtra */
 typedef struct WASMModuleInstanceExtraCommon {
 #if WASM_ENABLE_MODULE_INST_CONTEXT != 0
@@ -337,6 +356,25 @@ typedef struct WASMModuleInstanceExtraCommon {
 #if WASM_ENABLE_THREAD_MGR != 0
     korp_mutex exception_lock;
 #endif
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* The wasm exception in flight thrown by AOT/LLVM JIT code: the tag
+       index and the values of the tag parameters */
+    uint32 exce_tag_index;
+    uint32 exce_value_cell_num;
+    uint32 exce_value_cell_capacity;
+    /* The values, followed by their ref flags when GC is enabled */
+    uint32 *exce_values;
+#if WASM_ENABLE_GC != 0
+    /* The exceptions caught and kept for rethrow, see
+       WASMCaughtException */
+    struct WASMCaughtException *caught_exceptions;
+#endif
+#endif
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* Called when the epoch deadline is reached */
+    epoch_deadline_callback_t epoch_deadline_callback;
+    void *epoch_deadline_user_data;
+#endif
 } WASMModuleInstanceExtraCommon;
 
 /* Extra info of WASM module instance for interpreter/jit mode */
@@ -387,6 +425,13 @@ typedef struct WASMModuleInstanceExtra {
     WASMSharedHeap *shared_heap;
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* The global epoch counter and the epoch deadline of the instance,
+       they are compared at the loop back-edges */
+    const uint64 *epoch_ptr;
+    uint64 epoch_deadline;
+#endif
+
 #if WASM_ENABLE_DEBUG_INTERP != 0                         \
     || (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
         && WASM_ENABLE_LAZY_JIT != 0)
@@ -577,6 +622,17 @@ bool
 wasm_set_running_mode(WASMModuleInstance *module_inst,
                       RunningMode running_mode);
 
+#if WASM_ENABLE_TIERED_JIT != 0
+/**
+ * Wake up the LLVM JIT backend threads when the hotness of a function
+ * reaches WASM_TIERED_JIT_LLVM_JIT_THRESHOLD.
+ *
+ * @param module the module of the function
+ */
+void
+wasm_tiered_jit_notify_hot_function(WASMModule *module);
+#endif
+
 WASMFunctionInstance *
 wasm_lookup_function(const WASMModuleInstance *module_inst, const char *name);
 
@@ -602,6 +658,16 @@ bool
 wasm_call_function(WASMExecEnv *exec_env, WASMFunctionInstance *function,
                    unsigned argc, uint32 argv[]);
 
+#if WASM_ENABLE_LAZY_FUNC_VALIDATION != 0
+/**
+ * Validate and prepare the function on its first call in the module
+ * instance, the exception is set if the function is invalid.
+ */
+bool
+wasm_prepare_function(WASMModuleInstance *module_inst,
+                      WASMFunctionInstance *function);
+#endif
+
 void
 wasm_set_exception(WASMModuleInstance *module, const char *exception);
 
@@ -20,6 +20,17 @@ uint64
 wasm_runtime_module_realloc(wasm_module_inst_t module, uint64 ptr, uint64 size,
                             void **p_native_addr);
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+uint64
+wasm_runtime_module_malloc_internal(wasm_module_inst_t module,
+                                    wasm_exec_env_t exec_env, uint64 size,
+                                    void **p_native_addr);
+
+void
+wasm_runtime_module_free_internal(wasm_module_inst_t module,
+                                  wasm_exec_env_t exec_env, uint64 ptr);
+#endif
+
 /* clang-format off */
 #define get_module_inst(exec_env) \
     wasm_runtime_get_module_inst(exec_env)
@@ -39,11 +50,23 @@ wasm_runtime_module_realloc(wasm_module_inst_t module, uint64 ptr, uint64 size,
 #define addr_native_to_app(ptr) \
     wasm_runtime_addr_native_to_app(module_inst, ptr)
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/* Allocate with the allocation cache of the calling thread */
+#undef module_malloc
+#undef module_free
+#define module_malloc(size, p_native_addr) \
+    wasm_runtime_module_malloc_internal(module_inst, exec_env, size, \
+                                        p_native_addr)
+
+#define module_free(offset) \
+    wasm_runtime_module_free_internal(module_inst, exec_env, offset)
+#else
 #define module_malloc(size, p_native_addr) \
     wasm_runtime_module_malloc(module_inst, size, p_native_addr)
 
 #define module_free(offset) \
     wasm_runtime_module_free(module_inst, offset)
+#endif
 /* clang-format on */
 
 typedef int (*out_func_t)(int c, void *ctx);
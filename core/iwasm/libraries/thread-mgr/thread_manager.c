@@ -5,6 +5,9 @@
 
 #include "thread_manager.h"
 #include "../common/wasm_c_api_internal.h"
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+#include "../common/wasm_memory.h"
+#endif
 
 #if WASM_ENABLE_INTERP != 0
 #include "../interpreter/wasm_runtime.h"
@@ -33,6 +36,327 @@ typedef void (*list_visitor)(void *, void *);
 
 static uint32 cluster_max_thread_num = CLUSTER_MAX_THREAD_NUM;
 
+#if WASM_ENABLE_THREAD_POOL != 0
+/* A pooled native thread, which runs the spawned threads one after
+   another, and waits in the idle list for the next one in between */
+typedef struct ThreadPoolWorker {
+    bh_list_link l;
+    /* signaled when a thread is assigned or the pool is destroyed */
+    korp_cond cond;
+    /* the exec_env of the thread assigned to run */
+    WASMExecEnv *exec_env;
+} ThreadPoolWorker;
+
+/* The exit state of a thread run by a pooled native thread, it outlives
+   the exec_env of the thread until all the threads joining it get the
+   return value, like the native thread joined by os_thread_join */
+typedef struct ThreadPoolJoinState {
+    bool exited;
+    /* the count of threads joining the thread when it exits */
+    uint32 wait_count;
+    void *ret_val;
+} ThreadPoolJoinState;
+
+/* The buffer of the exec_env of an exited thread, kept to create the
+   exec_env of the next thread spawned with the same wasm stack size */
+typedef struct ThreadPoolExecEnvBuf {
+    bh_list_link l;
+    uint32 stack_size;
+} ThreadPoolExecEnvBuf;
+
+/* How long destroying the pool waits for the terminated threads */
+#define THREAD_POOL_DESTROY_TIMEOUT_US (1000 * 1000)
+
+static korp_mutex thread_pool_lock;
+/* signaled when a joined thread or an idle worker exits */
+static korp_cond thread_pool_cond;
+static bh_list thread_pool_idle_list_head;
+static bh_list *const thread_pool_idle_list = &thread_pool_idle_list_head;
+static bh_list thread_pool_exec_env_list_head;
+static bh_list *const thread_pool_exec_env_list =
+    &thread_pool_exec_env_list_head;
+static uint32 thread_pool_worker_count;
+static bool thread_pool_destroyed;
+
+static void
+set_thread_cancel_flags(WASMExecEnv *exec_env);
+
+static bool
+thread_pool_init(void)
+{
+    if (bh_list_init(thread_pool_idle_list) != 0
+        || bh_list_init(thread_pool_exec_env_list) != 0)
+        return false;
+    if (os_mutex_init(&thread_pool_lock) != 0)
+        return false;
+    if (os_cond_init(&thread_pool_cond) != 0) {
+        os_mutex_destroy(&thread_pool_lock);
+        return false;
+    }
+    thread_pool_worker_count = 0;
+    thread_pool_destroyed = false;
+    return true;
+}
+
+/* Terminate the threads run by the busy workers, the clusters must
+   not be destroyed yet */
+static void
+thread_pool_terminate_threads(void)
+{
+    WASMCluster *cluster;
+    WASMExecEnv *exec_env;
+
+    os_mutex_lock(&cluster_list_lock);
+    cluster = bh_list_first_elem(cluster_list);
+    while (cluster) {
+        os_mutex_lock(&cluster->lock);
+        exec_env = bh_list_first_elem(&cluster->exec_env_list);
+        while (exec_env) {
+            if (exec_env->pool_worker)
+                set_thread_cancel_flags(exec_env);
+            exec_env = bh_list_elem_next(exec_env);
+        }
+        os_mutex_unlock(&cluster->lock);
+        cluster = bh_list_elem_next(cluster);
+    }
+    os_mutex_unlock(&cluster_list_lock);
+}
+
+static void
+thread_pool_destroy(void)
+{
+    ThreadPoolWorker *worker;
+    ThreadPoolExecEnvBuf *buf, *next;
+    uint64 now, deadline;
+    uint32 worker_count;
+
+    os_mutex_lock(&thread_pool_lock);
+    thread_pool_destroyed = true;
+    worker = bh_list_first_elem(thread_pool_idle_list);
+    while (worker) {
+        os_cond_signal(&worker->cond);
+        worker = bh_list_elem_next(worker);
+    }
+    os_mutex_unlock(&thread_pool_lock);
+
+    thread_pool_terminate_threads();
+
+    /* Wait until all the workers exit: the idle ones exit right now, and
+       the busy ones after their terminated threads finish, they still
+       lock the pool and free their data when exiting. A thread blocked
+       in a native function may never check the terminate flag, so don't
+       wait for it forever. */
+    os_mutex_lock(&thread_pool_lock);
+    deadline = os_time_get_boot_us() + THREAD_POOL_DESTROY_TIMEOUT_US;
+    while (thread_pool_worker_count > 0
+           && (now = os_time_get_boot_us()) < deadline)
+        os_cond_reltimedwait(&thread_pool_cond, &thread_pool_lock,
+                             deadline - now);
+    worker_count = thread_pool_worker_count;
+
+    buf = bh_list_first_elem(thread_pool_exec_env_list);
+    while (buf) {
+        next = bh_list_elem_next(buf);
+        wasm_runtime_free(buf);
+        buf = next;
+    }
+    bh_list_init(thread_pool_exec_env_list);
+    os_mutex_unlock(&thread_pool_lock);
+
+    if (worker_count > 0) {
+        /* The remaining workers still lock the pool when they exit, leave
+           the lock and the condition variable alive */
+        LOG_WARNING("warning: %" PRIu32 " pooled threads are still running "
+                    "when the thread manager is destroyed",
+                    worker_count);
+        return;
+    }
+
+    os_cond_destroy(&thread_pool_cond);
+    os_mutex_destroy(&thread_pool_lock);
+}
+
+/* Create the exec_env of a spawned thread in the buffer of an exited
+   one if there is any with the same wasm stack size */
+static WASMExecEnv *
+thread_pool_create_exec_env(WASMModuleInstanceCommon *module_inst,
+                            uint32 stack_size)
+{
+    ThreadPoolExecEnvBuf *buf;
+    WASMExecEnv *exec_env;
+
+    os_mutex_lock(&thread_pool_lock);
+    buf = bh_list_first_elem(thread_pool_exec_env_list);
+    while (buf && buf->stack_size != stack_size)
+        buf = bh_list_elem_next(buf);
+    if (buf)
+        bh_list_remove(thread_pool_exec_env_list, buf);
+    os_mutex_unlock(&thread_pool_lock);
+
+    if (!buf)
+        return wasm_exec_env_create_internal(module_inst, stack_size);
+
+    if (!(exec_env = wasm_exec_env_create_in_buf_internal(buf, module_inst,
+                                                          stack_size)))
+        wasm_runtime_free(buf);
+    return exec_env;
+}
+
+/* Destroy the exec_env of a spawned thread, and keep its buffer for the
+   next thread, at most cluster_max_thread_num buffers are kept */
+static void
+thread_pool_destroy_exec_env(WASMExecEnv *exec_env)
+{
+    ThreadPoolExecEnvBuf *buf = (ThreadPoolExecEnvBuf *)exec_env;
+    uint32 stack_size = exec_env->wasm_stack_size;
+
+    wasm_exec_env_deinit_internal(exec_env);
+
+    os_mutex_lock(&thread_pool_lock);
+    if (!thread_pool_destroyed
+        && bh_list_length(thread_pool_exec_env_list) < cluster_max_thread_num) {
+        memset(buf, 0, sizeof(ThreadPoolExecEnvBuf));
+        buf->stack_size = stack_size;
+        bh_list_insert(thread_pool_exec_env_list, buf);
+        buf = NULL;
+    }
+    os_mutex_unlock(&thread_pool_lock);
+
+    if (buf)
+        wasm_runtime_free(buf);
+}
+
+/* Release the worker when its native thread is going to exit, the
+   caller should lock thread_pool_lock */
+static void
+thread_pool_release_worker(ThreadPoolWorker *worker)
+{
+    thread_pool_worker_count--;
+    os_cond_broadcast(&thread_pool_cond);
+
+    os_cond_destroy(&worker->cond);
+    wasm_runtime_free(worker);
+}
+
+static void *
+thread_manager_start_routine(void *arg);
+
+static void *
+thread_pool_worker_routine(void *arg)
+{
+    ThreadPoolWorker *worker = (ThreadPoolWorker *)arg;
+    WASMExecEnv *exec_env;
+
+    /* The worker is never joined */
+    os_thread_detach(os_self_thread());
+
+    os_mutex_lock(&thread_pool_lock);
+    while (true) {
+        while (!worker->exec_env && !thread_pool_destroyed)
+            os_cond_wait(&worker->cond, &thread_pool_lock);
+
+        if (!(exec_env = worker->exec_env)) {
+            /* The pool is destroyed when the worker is idle */
+            bh_list_remove(thread_pool_idle_list, worker);
+            break;
+        }
+        worker->exec_env = NULL;
+        os_mutex_unlock(&thread_pool_lock);
+
+        thread_manager_start_routine(exec_env);
+
+        os_mutex_lock(&thread_pool_lock);
+        /* Keep at most cluster_max_thread_num idle workers */
+        if (thread_pool_destroyed
+            || bh_list_length(thread_pool_idle_list)
+                   >= cluster_max_thread_num)
+            break;
+        bh_list_insert(thread_pool_idle_list, worker);
+    }
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    /* Before the pool can see the worker exit and destroy the runtime */
+    wasm_runtime_memory_destroy_thread_cache();
+#endif
+    thread_pool_release_worker(worker);
+    os_mutex_unlock(&thread_pool_lock);
+    return NULL;
+}
+
+/* Run the thread of exec_env in an idle pooled native thread, or in a
+   new one if there is no idle one. Unlike a task queue, a thread never
+   waits for another one to finish since it may block on the others,
+   e.g. with memory.atomic.wait. */
+static bool
+thread_pool_run(WASMExecEnv *exec_env)
+{
+    ThreadPoolWorker *worker;
+    ThreadPoolJoinState *join_state;
+    korp_tid tid;
+
+    if (!(join_state = wasm_runtime_malloc(sizeof(ThreadPoolJoinState))))
+        return false;
+    memset(join_state, 0, sizeof(ThreadPoolJoinState));
+    exec_env->pool_join_state = join_state;
+
+    os_mutex_lock(&thread_pool_lock);
+    if ((worker = bh_list_first_elem(thread_pool_idle_list))) {
+        bh_list_remove(thread_pool_idle_list, worker);
+        exec_env->pool_worker = worker;
+        worker->exec_env = exec_env;
+        os_cond_signal(&worker->cond);
+        os_mutex_unlock(&thread_pool_lock);
+        return true;
+    }
+    os_mutex_unlock(&thread_pool_lock);
+
+    if (!(worker = wasm_runtime_malloc(sizeof(ThreadPoolWorker))))
+        goto fail1;
+    memset(worker, 0, sizeof(ThreadPoolWorker));
+    if (os_cond_init(&worker->cond) != 0)
+        goto fail2;
+    exec_env->pool_worker = worker;
+    worker->exec_env = exec_env;
+
+    os_mutex_lock(&thread_pool_lock);
+    thread_pool_worker_count++;
+    os_mutex_unlock(&thread_pool_lock);
+
+    if (0
+        != os_thread_create(&tid, thread_pool_worker_routine, worker,
+                            APP_THREAD_STACK_SIZE_DEFAULT)) {
+        os_mutex_lock(&thread_pool_lock);
+        thread_pool_worker_count--;
+        os_mutex_unlock(&thread_pool_lock);
+        goto fail3;
+    }
+    return true;
+
+fail3:
+    os_cond_destroy(&worker->cond);
+fail2:
+    wasm_runtime_free(worker);
+fail1:
+    wasm_runtime_free(join_state);
+    exec_env->pool_join_state = NULL;
+    exec_env->pool_worker = NULL;
+    return false;
+}
+
+static int32
+thread_pool_join(ThreadPoolJoinState *join_state, void **ret_val)
+{
+    os_mutex_lock(&thread_pool_lock);
+    while (!join_state->exited)
+        os_cond_wait(&thread_pool_cond, &thread_pool_lock);
+    if (ret_val)
+        *ret_val = join_state->ret_val;
+    if (--join_state->wait_count == 0)
+        wasm_runtime_free(join_state);
+    os_mutex_unlock(&thread_pool_lock);
+    return 0;
+}
+#endif /* end of WASM_ENABLE_THREAD_POOL != 0 */
+
 /* Set the maximum thread number, if this function is not called,
     the max thread num is defined by CLUSTER_MAX_THREAD_NUM */
 void
@@ -49,14 +373,27 @@ thread_manager_init()
         return false;
     if (os_mutex_init(&cluster_list_lock) != 0)
         return false;
+#if WASM_ENABLE_THREAD_POOL != 0
+    if (!thread_pool_init()) {
+        os_mutex_destroy(&cluster_list_lock);
+        return false;
+    }
+#endif
     return true;
 }
 
 void
 thread_manager_destroy()
 {
-    WASMCluster *cluster = bh_list_first_elem(cluster_list);
+    WASMCluster *cluster;
     WASMCluster *next;
+
+#if WASM_ENABLE_THREAD_POOL != 0
+    /* Terminate the pooled threads while their clusters are alive */
+    thread_pool_destroy();
+#endif
+
+    cluster = bh_list_first_elem(cluster_list);
     while (cluster) {
         next = bh_list_elem_next(cluster);
         wasm_cluster_destroy(cluster);
@@ -617,6 +954,46 @@ wasm_cluster_destroy_spawned_exec_env(WASMExecEnv *exec_env)
     os_mutex_unlock(&cluster->lock);
 }
 
+/* Release the native thread of the exiting thread if there is no other
+   thread joining it, otherwise keep the return value for the threads
+   joining it, the caller should lock cluster_list_lock */
+static void
+release_exited_thread(WASMExecEnv *exec_env, void *ret_val)
+{
+#if WASM_ENABLE_THREAD_POOL != 0
+    ThreadPoolJoinState *join_state = exec_env->pool_join_state;
+
+    if (join_state) {
+        os_mutex_lock(&thread_pool_lock);
+        if (exec_env->wait_count == 0) {
+            /* The thread is detached or isn't joined */
+            wasm_runtime_free(join_state);
+        }
+        else {
+            join_state->exited = true;
+            join_state->wait_count = exec_env->wait_count;
+            join_state->ret_val = ret_val;
+            os_cond_broadcast(&thread_pool_cond);
+        }
+        os_mutex_unlock(&thread_pool_lock);
+        exec_env->pool_join_state = NULL;
+        return;
+    }
+#else
+    (void)ret_val;
+#endif
+
+    /* Detach the native thread here to ensure the resources are freed */
+    if (exec_env->wait_count == 0 && !exec_env->thread_is_detached) {
+        /* Only detach current thread when there is no other thread
+           joining it, otherwise let the system resources for the
+           thread be released after joining */
+        os_thread_detach(exec_env->handle);
+        /* No need to set exec_env->thread_is_detached to true here
+           since we will exit soon */
+    }
+}
+
 /* start routine of thread manager */
 static void *
 thread_manager_start_routine(void *arg)
@@ -626,6 +1003,9 @@ thread_manager_start_routine(void *arg)
     WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
     WASMModuleInstanceCommon *module_inst =
         wasm_exec_env_get_module_inst(exec_env);
+#if WASM_ENABLE_THREAD_POOL != 0
+    bool is_pooled;
+#endif
 
     bh_assert(cluster != NULL);
     bh_assert(module_inst != NULL);
@@ -636,6 +1016,11 @@ thread_manager_start_routine(void *arg)
     os_cond_signal(&exec_env->wait_cond);
     os_mutex_unlock(&exec_env->wait_lock);
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    /* Kept by a pooled native thread for the next threads */
+    wasm_runtime_memory_init_thread_cache();
+#endif
+
     ret = exec_env->thread_start_routine(exec_env);
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
@@ -661,15 +1046,10 @@ thread_manager_start_routine(void *arg)
 
     os_mutex_lock(&cluster->lock);
 
-    /* Detach the native thread here to ensure the resources are freed */
-    if (exec_env->wait_count == 0 && !exec_env->thread_is_detached) {
-        /* Only detach current thread when there is no other thread
-           joining it, otherwise let the system resources for the
-           thread be released after joining */
-        os_thread_detach(exec_env->handle);
-        /* No need to set exec_env->thread_is_detached to true here
-           since we will exit soon */
-    }
+#if WASM_ENABLE_THREAD_POOL != 0
+    is_pooled = exec_env->pool_worker ? true : false;
+#endif
+    release_exited_thread(exec_env, ret);
 
 #if WASM_ENABLE_PERF_PROFILING != 0
     os_printf("============= Spawned thread ===========\n");
@@ -680,7 +1060,12 @@ thread_manager_start_routine(void *arg)
     /* Remove exec_env */
     wasm_cluster_del_exec_env_internal(cluster, exec_env, false);
     /* Destroy exec_env */
-    wasm_exec_env_destroy_internal(exec_env);
+#if WASM_ENABLE_THREAD_POOL != 0
+    if (is_pooled)
+        thread_pool_destroy_exec_env(exec_env);
+    else
+#endif
+        wasm_exec_env_destroy_internal(exec_env);
     /* Routine exit, destroy instance */
     wasm_runtime_deinstantiate_internal(module_inst, true);
 
@@ -688,6 +1073,14 @@ thread_manager_start_routine(void *arg)
 
     os_mutex_unlock(&cluster_list_lock);
 
+#if WASM_ENABLE_THREAD_POOL != 0
+    if (is_pooled)
+        /* Return to the pooled native thread to run the next thread */
+        return ret;
+#endif
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    wasm_runtime_memory_destroy_thread_cache();
+#endif
     os_thread_exit(ret);
     return ret;
 }
@@ -712,8 +1105,13 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
         goto fail1;
     }
 
+#if WASM_ENABLE_THREAD_POOL != 0
+    new_exec_env =
+        thread_pool_create_exec_env(module_inst, exec_env->wasm_stack_size);
+#else
     new_exec_env =
         wasm_exec_env_create_internal(module_inst, exec_env->wasm_stack_size);
+#endif
     if (!new_exec_env)
         goto fail1;
 
@@ -744,6 +1142,13 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
 
     os_mutex_lock(&new_exec_env->wait_lock);
 
+#if WASM_ENABLE_THREAD_POOL != 0
+    (void)tid;
+    if (!thread_pool_run(new_exec_env)) {
+        os_mutex_unlock(&new_exec_env->wait_lock);
+        goto fail3;
+    }
+#else
     if (0
         != os_thread_create(&tid, thread_manager_start_routine,
                             (void *)new_exec_env,
@@ -751,6 +1156,7 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
         os_mutex_unlock(&new_exec_env->wait_lock);
         goto fail3;
     }
+#endif
 
     /* Wait until the new_exec_env->handle is set to avoid it is
        illegally accessed after unlocking cluster->lock */
@@ -764,7 +1170,11 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
 fail3:
     wasm_cluster_del_exec_env_internal(cluster, new_exec_env, false);
 fail2:
+#if WASM_ENABLE_THREAD_POOL != 0
+    thread_pool_destroy_exec_env(new_exec_env);
+#else
     wasm_exec_env_destroy_internal(new_exec_env);
+#endif
 fail1:
     os_mutex_unlock(&cluster->lock);
 
@@ -975,6 +1385,9 @@ int32
 wasm_cluster_join_thread(WASMExecEnv *exec_env, void **ret_val)
 {
     korp_tid handle;
+#if WASM_ENABLE_THREAD_POOL != 0
+    ThreadPoolJoinState *join_state;
+#endif
 
     os_mutex_lock(&cluster_list_lock);
 
@@ -989,10 +1402,17 @@ wasm_cluster_join_thread(WASMExecEnv *exec_env, void **ret_val)
     os_mutex_lock(&exec_env->wait_lock);
     exec_env->wait_count++;
     handle = exec_env->handle;
+#if WASM_ENABLE_THREAD_POOL != 0
+    join_state = exec_env->pool_join_state;
+#endif
     os_mutex_unlock(&exec_env->wait_lock);
 
     os_mutex_unlock(&cluster_list_lock);
 
+#if WASM_ENABLE_THREAD_POOL != 0
+    if (join_state)
+        return thread_pool_join(join_state, ret_val);
+#endif
     return os_thread_join(handle, ret_val);
 }
 
@@ -1011,7 +1431,11 @@ wasm_cluster_detach_thread(WASMExecEnv *exec_env)
         /* Only detach current thread when there is no other thread
            joining it, otherwise let the system resources for the
            thread be released after joining */
-        ret = os_thread_detach(exec_env->handle);
+#if WASM_ENABLE_THREAD_POOL != 0
+        /* The pooled native thread is detached already */
+        if (!exec_env->pool_join_state)
+#endif
+            ret = os_thread_detach(exec_env->handle);
         exec_env->thread_is_detached = true;
     }
     os_mutex_unlock(&cluster_list_lock);
@@ -1023,6 +1447,9 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 {
     WASMCluster *cluster;
     WASMModuleInstanceCommon *module_inst;
+#if WASM_ENABLE_THREAD_POOL != 0
+    ThreadPoolWorker *worker;
+#endif
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     if (exec_env->jmpbuf_stack_top) {
@@ -1061,22 +1488,22 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 
     os_mutex_lock(&cluster->lock);
 
-    /* Detach the native thread here to ensure the resources are freed */
-    if (exec_env->wait_count == 0 && !exec_env->thread_is_detached) {
-        /* Only detach current thread when there is no other thread
-           joining it, otherwise let the system resources for the
-           thread be released after joining */
-        os_thread_detach(exec_env->handle);
-        /* No need to set exec_env->thread_is_detached to true here
-           since we will exit soon */
-    }
+#if WASM_ENABLE_THREAD_POOL != 0
+    worker = exec_env->pool_worker;
+#endif
+    release_exited_thread(exec_env, retval);
 
     module_inst = exec_env->module_inst;
 
     /* Remove exec_env */
     wasm_cluster_del_exec_env_internal(cluster, exec_env, false);
     /* Destroy exec_env */
-    wasm_exec_env_destroy_internal(exec_env);
+#if WASM_ENABLE_THREAD_POOL != 0
+    if (worker)
+        thread_pool_destroy_exec_env(exec_env);
+    else
+#endif
+        wasm_exec_env_destroy_internal(exec_env);
     /* Routine exit, destroy instance */
     wasm_runtime_deinstantiate_internal(module_inst, true);
 
@@ -1084,6 +1511,17 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 
     os_mutex_unlock(&cluster_list_lock);
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    wasm_runtime_memory_destroy_thread_cache();
+#endif
+#if WASM_ENABLE_THREAD_POOL != 0
+    /* The pooled native thread exits with the thread */
+    if (worker) {
+        os_mutex_lock(&thread_pool_lock);
+        thread_pool_release_worker(worker);
+        os_mutex_unlock(&thread_pool_lock);
+    }
+#endif
     os_thread_exit(retval);
 }
 
@@ -328,6 +328,18 @@ gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
     return true;
 }
 
+static inline void
+update_highmark_size(gc_heap_t *heap)
+{
+#if WASM_ENABLE_GC != 0 && WASM_ENABLE_GC_LAZY_SWEEP != 0
+    /* The free chunks not swept yet aren't counted in total_free_size */
+    if (gc_is_sweeping(heap))
+        return;
+#endif
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
+}
+
 /**
  * Find a proper hmu for required memory size
  *
@@ -412,10 +424,7 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
             }
 
             heap->total_free_size -= size;
-            if ((heap->current_size - heap->total_free_size)
-                > heap->highmark_size)
-                heap->highmark_size =
-                    heap->current_size - heap->total_free_size;
+            update_highmark_size(heap);
 
             hmu_set_size((hmu_t *)p, size);
             return (hmu_t *)p;
@@ -469,8 +478,7 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
         }
 
         heap->total_free_size -= size;
-        if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
-            heap->highmark_size = heap->current_size - heap->total_free_size;
+        update_highmark_size(heap);
 
         hmu_set_size((hmu_t *)last_tp, size);
         tp_ret = (uintptr_t)last_tp;
@@ -488,7 +496,7 @@ do_gc_heap(gc_heap_t *heap)
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
     uint64 start = 0, end = 0, time = 0;
 
-    start = os_time_get_boot_microsecond();
+    start = os_time_get_boot_us();
 #endif
     if (heap->is_reclaim_enabled) {
         UNLOCK_HEAP(heap);
@@ -496,16 +504,52 @@ do_gc_heap(gc_heap_t *heap)
         LOCK_HEAP(heap);
     }
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
-    end = os_time_get_boot_microsecond();
+    end = os_time_get_boot_us();
     time = end - start;
     heap->total_gc_time += time;
     if (time > heap->max_gc_time) {
         heap->max_gc_time = time;
     }
     heap->total_gc_count += 1;
+    gc_record_pause(heap->gc_pause_histogram, time);
 #endif
     return ret;
 }
+
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+/**
+ * Find a proper hmu for required memory size, sweep the heap step by
+ * step until it is found if the heap is sweeping
+ */
+static hmu_t *
+alloc_hmu_with_sweep(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *hmu;
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    uint64 start, time;
+#endif
+
+    while (!(hmu = alloc_hmu(heap, size)) && gc_is_sweeping(heap)) {
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+        start = os_time_get_boot_us();
+#endif
+        gci_sweep_heap_step(heap, GC_LAZY_SWEEP_STEP_SIZE);
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+        time = os_time_get_boot_us() - start;
+        heap->total_gc_time += time;
+        if (time > heap->max_gc_time) {
+            heap->max_gc_time = time;
+        }
+        gc_record_pause(heap->sweep_pause_histogram, time);
+#endif
+    }
+    return hmu;
+}
+#endif
+#endif
+
+#if WASM_ENABLE_GC == 0 || WASM_ENABLE_GC_LAZY_SWEEP == 0
+#define alloc_hmu_with_sweep alloc_hmu
 #endif
 
 /**
@@ -534,6 +578,16 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
     if (GC_SUCCESS != do_gc_heap(heap))
         return NULL;
 #else
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+    /* Reuse the memory reclaimed by the last GC before collecting again,
+       total_free_size and gc_threshold are updated after the sweeping */
+    if (gc_is_sweeping(heap)) {
+        hmu_t *ret = NULL;
+        if ((ret = alloc_hmu_with_sweep(heap, size))) {
+            return ret;
+        }
+    }
+#endif
     if (heap->total_free_size < heap->gc_threshold) {
         if (GC_SUCCESS != do_gc_heap(heap))
             return NULL;
@@ -549,7 +603,7 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 #endif
 #endif
 
-    return alloc_hmu(heap, size);
+    return alloc_hmu_with_sweep(heap, size);
 }
 
 /* Convert object pointer to HMU pointer - handles aligned allocations */
@@ -799,7 +853,12 @@ gc_realloc_vo_internal(void *vheap, void *ptr, gc_size_t size, const char *file,
 
     if (hmu_old) {
         hmu_next = (hmu_t *)((char *)hmu_old + tot_size_old);
-        if (hmu_is_in_heap(hmu_next, base_addr, end_addr)) {
+        if (hmu_is_in_heap(hmu_next, base_addr, end_addr)
+#if WASM_ENABLE_GC != 0 && WASM_ENABLE_GC_LAZY_SWEEP != 0
+            /* the free chunks not swept yet aren't in KFC */
+            && !gc_is_hmu_unswept(heap, hmu_next)
+#endif
+        ) {
             ut = hmu_get_ut(hmu_next);
             tot_size_next = hmu_get_size(hmu_next);
             if (ut == HMU_FC && tot_size <= tot_size_old + tot_size_next) {
@@ -958,6 +1017,183 @@ finish:
     return ret;
 }
 
+#if WASM_ENABLE_GC != 0
+/* Remove the TLAB from the TLAB list of the heap and retire it, the
+   caller should lock the heap */
+static void
+unlink_tlab(gc_heap_t *heap, gc_tlab_t *tlab)
+{
+    gc_tlab_t **p_tlab = &heap->tlab_list;
+
+    while (*p_tlab && *p_tlab != tlab)
+        p_tlab = &(*p_tlab)->next;
+    if (*p_tlab)
+        *p_tlab = tlab->next;
+
+    tlab->top = tlab->limit = NULL;
+    tlab->heap = NULL;
+    tlab->next = NULL;
+}
+
+void
+gci_retire_tlabs(gc_heap_t *heap)
+{
+    gc_tlab_t *tlab = heap->tlab_list, *next;
+
+    /* The rest of each TLAB is a freed VO which is reclaimed by the
+       sweeping, just stop allocating objects from it */
+    while (tlab) {
+        next = tlab->next;
+        tlab->top = tlab->limit = NULL;
+        tlab->heap = NULL;
+        tlab->next = NULL;
+        tlab = next;
+    }
+    heap->tlab_list = NULL;
+    heap->tlab_size = 0;
+}
+
+void
+gc_retire_tlab(gc_tlab_t *tlab)
+{
+    gc_heap_t *heap = (gc_heap_t *)tlab->heap;
+
+    if (!heap)
+        return;
+
+    LOCK_HEAP(heap);
+    unlink_tlab(heap, tlab);
+    UNLOCK_HEAP(heap);
+}
+
+#if BH_ENABLE_GC_VERIFY == 0 && GC_IN_EVERY_ALLOCATION == 0 \
+    && GC_MANUALLY == 0
+/* Allocate an hmu from the TLAB, the caller should make sure that the
+   TLAB has enough space */
+static inline hmu_t *
+tlab_alloc_hmu(gc_tlab_t *tlab, gc_size_t tot_size)
+{
+    hmu_t *hmu = (hmu_t *)tlab->top, *rest;
+    gc_uint8 *end = tlab->limit + GC_TLAB_MIN_REST_SIZE;
+
+    bh_assert((gc_size_t)(tlab->limit - tlab->top) >= tot_size);
+
+    tlab->top += tot_size;
+    rest = (hmu_t *)tlab->top;
+    rest->header = GC_TLAB_REST_HEADER(end - tlab->top);
+    hmu->header = GC_TLAB_WO_HEADER(tot_size);
+    return hmu;
+}
+
+/**
+ * Allocate a new buffer for the TLAB from the heap. GC isn't performed
+ * here, the caller allocates the object from the heap directly if it
+ * fails, which triggers GC in the same way as without TLAB.
+ */
+static bool
+refill_tlab(gc_heap_t *heap, gc_tlab_t *tlab, gc_size_t tot_size)
+{
+    gc_size_t tlab_size = heap->tlab_size ? heap->tlab_size : GC_TLAB_SIZE;
+    hmu_t *hmu;
+
+    if (tlab_size > heap->current_size / 32)
+        tlab_size = (heap->current_size / 32) & ~(gc_size_t)7;
+    if (tlab_size < tot_size + GC_TLAB_MIN_REST_SIZE)
+        return false;
+
+    if (heap->total_free_size < heap->gc_threshold
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+        /* total_free_size only counts the hmus swept */
+        && !gc_is_sweeping(heap)
+#endif
+    )
+        return false;
+
+    /* Halve the TLAB size until a free chunk is found if the heap is
+       fragmented, it is restored after the next GC */
+    while (!(hmu = alloc_hmu_with_sweep(heap, tlab_size))) {
+        tlab_size = (tlab_size / 2) & ~(gc_size_t)7;
+        if (tlab_size < GC_TLAB_MIN_SIZE
+            || tlab_size < tot_size + GC_TLAB_MIN_REST_SIZE)
+            return false;
+        heap->tlab_size = tlab_size;
+    }
+
+    /* the total size allocated may be larger than the required size */
+    tlab_size = hmu_get_size(hmu);
+
+#if GC_STAT_DATA != 0
+    heap->total_size_allocated += tlab_size;
+#endif
+
+    hmu_set_ut(hmu, HMU_VO);
+    hmu_free_vo(hmu);
+
+    tlab->top = (gc_uint8 *)hmu;
+    tlab->limit = (gc_uint8 *)hmu + tlab_size - GC_TLAB_MIN_REST_SIZE;
+    tlab->heap = heap;
+    tlab->next = heap->tlab_list;
+    heap->tlab_list = tlab;
+    return true;
+}
+#endif
+
+gc_object_t
+gc_alloc_wo_tlab(void *vheap, gc_tlab_t *tlab, gc_size_t size)
+{
+#if BH_ENABLE_GC_VERIFY == 0 && GC_IN_EVERY_ALLOCATION == 0 \
+    && GC_MANUALLY == 0
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    hmu_t *hmu = NULL;
+    gc_size_t tot_size;
+
+    if (size > GC_TLAB_MAX_OBJ_SIZE)
+        return gc_alloc_wo(vheap, size);
+
+    tot_size = GC_ALIGN_8(HMU_SIZE + size);
+    if (tot_size < GC_SMALLEST_SIZE)
+        tot_size = GC_SMALLEST_SIZE;
+
+    if (tlab->heap == heap
+        && (gc_size_t)(tlab->limit - tlab->top) >= tot_size)
+        return hmu_to_obj(tlab_alloc_hmu(tlab, tot_size));
+
+    if (tlab->heap != heap)
+        gc_retire_tlab(tlab);
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        os_printf("[GC_ERROR]Heap is corrupted, allocate memory failed.\n");
+        return NULL;
+    }
+#endif
+
+    LOCK_HEAP(heap);
+
+    /* The rest of the TLAB is too small, leave it to the sweeping */
+    if (tlab->heap)
+        unlink_tlab(heap, tlab);
+
+    if (refill_tlab(heap, tlab, tot_size)) {
+        hmu = tlab_alloc_hmu(tlab, tot_size);
+    }
+    else if ((hmu = alloc_hmu_ex(heap, tot_size))) {
+#if GC_STAT_DATA != 0
+        heap->total_size_allocated += hmu_get_size(hmu);
+#endif
+        hmu_set_ut(hmu, HMU_WO);
+        hmu_unmark_wo(hmu);
+    }
+
+    UNLOCK_HEAP(heap);
+    return hmu ? hmu_to_obj(hmu) : NULL;
+#else
+    (void)tlab;
+    return gc_alloc_wo(vheap, size);
+#endif
+}
+#endif /* end of WASM_ENABLE_GC != 0 */
+
 /**
  * Do some checking to see if given pointer is a possible valid heap
  * @return GC_TRUE if all checking passed, GC_FALSE otherwise
@@ -973,6 +1209,88 @@ gci_is_heap_valid(gc_heap_t *heap)
     return GC_TRUE;
 }
 
+/**
+ * Free the VO hmu and merge it with the free chunks around
+ *
+ * @param heap should not be NULL and should be a valid heap, the caller
+ *        should lock the heap
+ * @param hmu should not be NULL and should be inside @heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+free_vo_hmu(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_uint8 *base_addr = heap->base_addr;
+    gc_uint8 *end_addr = base_addr + heap->current_size;
+    hmu_t *prev = NULL;
+    hmu_t *next = NULL;
+    gc_size_t size = 0;
+
+    if (hmu_get_ut(hmu) != HMU_VO)
+        return GC_ERROR;
+
+    if (hmu_is_vo_freed(hmu)) {
+        bh_assert(0);
+        return GC_ERROR;
+    }
+
+    size = hmu_get_size(hmu);
+
+#if WASM_ENABLE_GC != 0 && WASM_ENABLE_GC_LAZY_SWEEP != 0
+    if (gc_is_hmu_unswept(heap, hmu)) {
+        /* The free chunks around it aren't in KFC, leave it to the
+           sweeper, which also counts it into total_free_size */
+#if GC_STAT_DATA != 0
+        heap->total_size_freed += size;
+#endif
+        hmu_free_vo(hmu);
+        return GC_SUCCESS;
+    }
+#endif
+
+    heap->total_free_size += size;
+
+#if GC_STAT_DATA != 0
+    heap->total_size_freed += size;
+#endif
+
+    if (!hmu_get_pinuse(hmu)) {
+        prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+
+        if (hmu_is_in_heap(prev, base_addr, end_addr)
+            && hmu_get_ut(prev) == HMU_FC) {
+            size += hmu_get_size(prev);
+            hmu = prev;
+            if (!unlink_hmu(heap, prev))
+                return GC_ERROR;
+        }
+    }
+
+    next = (hmu_t *)((char *)hmu + size);
+    if (hmu_is_in_heap(next, base_addr, end_addr)
+#if WASM_ENABLE_GC != 0 && WASM_ENABLE_GC_LAZY_SWEEP != 0
+        && !gc_is_hmu_unswept(heap, next)
+#endif
+    ) {
+        if (hmu_get_ut(next) == HMU_FC) {
+            size += hmu_get_size(next);
+            if (!unlink_hmu(heap, next))
+                return GC_ERROR;
+            next = (hmu_t *)((char *)hmu + size);
+        }
+    }
+
+    if (!gci_add_fc(heap, hmu, size))
+        return GC_ERROR;
+
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        hmu_unmark_pinuse(next);
+    }
+
+    return GC_SUCCESS;
+}
+
 #if BH_ENABLE_GC_VERIFY == 0
 int
 gc_free_vo(void *vheap, gc_object_t obj)
@@ -984,10 +1302,6 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
     gc_heap_t *heap = (gc_heap_t *)vheap;
     gc_uint8 *base_addr, *end_addr;
     hmu_t *hmu = NULL;
-    hmu_t *prev = NULL;
-    hmu_t *next = NULL;
-    gc_size_t size = 0;
-    hmu_type_t ut;
     int ret = GC_SUCCESS;
 
     if (!obj) {
@@ -1012,70 +1326,332 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
 #if BH_ENABLE_GC_VERIFY != 0
         hmu_verify(heap, hmu);
 #endif
-        ut = hmu_get_ut(hmu);
-        if (ut == HMU_VO) {
-            if (hmu_is_vo_freed(hmu)) {
-                bh_assert(0);
-                ret = GC_ERROR;
-                goto out;
-            }
+        ret = free_vo_hmu(heap, hmu);
+    }
 
-            size = hmu_get_size(hmu);
+    UNLOCK_HEAP(heap);
+    return ret;
+}
+
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+gc_size_t
+gc_get_thread_cache_struct_size(void)
+{
+    return sizeof(gc_thread_cache_t);
+}
+
+void *
+gc_thread_cache_init(gc_handle_t handle, char *buf, gc_size_t buf_size)
+{
+    gc_thread_cache_t *cache = (gc_thread_cache_t *)buf;
+
+    if (!buf || buf_size < sizeof(gc_thread_cache_t))
+        return NULL;
+
+    memset(cache, 0, sizeof(gc_thread_cache_t));
+    cache->heap = (gc_heap_t *)handle;
+    cache->max_cached_size = cache->heap->current_size >> 6;
+    if (cache->max_cached_size > GC_THREAD_CACHE_MAX_CACHED_SIZE)
+        cache->max_cached_size = GC_THREAD_CACHE_MAX_CACHED_SIZE;
+
+    LOCK_HEAP(cache->heap);
+    cache->next = cache->heap->thread_cache_list;
+    cache->heap->thread_cache_list = cache;
+    UNLOCK_HEAP(cache->heap);
+    return cache;
+}
+
+void
+gc_thread_cache_destroy(void *vcache)
+{
+    gc_thread_cache_t *cache = (gc_thread_cache_t *)vcache;
+    gc_heap_t *heap = cache->heap;
+    gc_thread_cache_t **p_cache;
+
+    if (!heap)
+        /* The heap is destroyed already */
+        return;
+
+    gc_thread_cache_flush(cache);
+
+    LOCK_HEAP(heap);
+    p_cache = &heap->thread_cache_list;
+    while (*p_cache && *p_cache != cache)
+        p_cache = &(*p_cache)->next;
+    if (*p_cache)
+        *p_cache = cache->next;
+    UNLOCK_HEAP(heap);
+
+    cache->heap = NULL;
+    cache->next = NULL;
+}
+
+void
+gci_detach_thread_caches(gc_heap_t *heap)
+{
+    gc_thread_cache_t *cache = heap->thread_cache_list, *next;
+
+    while (cache) {
+        next = cache->next;
+        memset(cache, 0, sizeof(gc_thread_cache_t));
+        cache = next;
+    }
+    heap->thread_cache_list = NULL;
+}
+
+gc_handle_t
+gc_thread_cache_get_heap(void *vcache)
+{
+    return (gc_handle_t)((gc_thread_cache_t *)vcache)->heap;
+}
+
+#if BH_ENABLE_GC_VERIFY == 0
+static void
+thread_cache_push(gc_thread_cache_t *cache, uint32 bin_idx, gc_object_t obj)
+{
+    gc_uint32 *p = (gc_uint32 *)obj;
+
+    p[0] = cache->bin_heads[bin_idx];
+    p[1] = GC_THREAD_CACHE_MAGIC;
+    cache->bin_heads[bin_idx] =
+        (gc_uint32)((gc_uint8 *)obj - cache->heap->base_addr);
+    cache->bin_counts[bin_idx]++;
+    cache->cached_size += bin_idx << 3;
+}
 
-            heap->total_free_size += size;
+static gc_object_t
+thread_cache_pop(gc_thread_cache_t *cache, uint32 bin_idx)
+{
+    gc_heap_t *heap = cache->heap;
+    gc_uint32 offset = cache->bin_heads[bin_idx];
+    gc_uint32 *p;
+    hmu_t *hmu;
+
+    if (!offset)
+        return NULL;
 
+    /* The link may be modified by the user after the object is freed */
+    p = (gc_uint32 *)(heap->base_addr + offset);
+    hmu = obj_to_hmu(p);
+    if (offset < HMU_SIZE || offset >= heap->current_size
+        || ((uintptr_t)p & 7) != 0 || hmu_get_ut(hmu) != HMU_VO
+        || hmu_get_size(hmu) != bin_idx << 3
+        || p[1] != GC_THREAD_CACHE_MAGIC) {
+        LOG_ERROR("[GC_ERROR]Thread cache is corrupted.\n");
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+        heap->is_heap_corrupted = true;
+#endif
+        /* Drop the hmus of the bin, which are leaked */
+        cache->cached_size -= cache->bin_counts[bin_idx] * (bin_idx << 3);
+        cache->bin_heads[bin_idx] = 0;
+        cache->bin_counts[bin_idx] = 0;
+        return NULL;
+    }
+
+    cache->bin_heads[bin_idx] = p[0];
+    cache->bin_counts[bin_idx]--;
+    cache->cached_size -= bin_idx << 3;
+    p[0] = p[1] = 0;
+    return (gc_object_t)p;
+}
+
+static bool
+thread_cache_contains(gc_thread_cache_t *cache, uint32 bin_idx,
+                      gc_object_t obj)
+{
+    gc_uint32 offset = (gc_uint32)((gc_uint8 *)obj - cache->heap->base_addr);
+    gc_uint32 cur = cache->bin_heads[bin_idx];
+    uint32 i;
+
+    for (i = 0; cur && cur < cache->heap->current_size
+                && i < cache->bin_counts[bin_idx];
+         i++) {
+        if (cur == offset)
+            return true;
+        cur = *(gc_uint32 *)(cache->heap->base_addr + cur);
+    }
+    return false;
+}
+
+/* Free at most count hmus cached of the size to the heap */
+static void
+thread_cache_flush_bin(gc_thread_cache_t *cache, uint32 bin_idx, uint32 count)
+{
+    gc_heap_t *heap = cache->heap;
+    gc_object_t obj;
+
+    LOCK_HEAP(heap);
+    while (count-- > 0 && (obj = thread_cache_pop(cache, bin_idx))) {
+        if (free_vo_hmu(heap, obj_to_hmu(obj)) != GC_SUCCESS)
+            break;
+    }
+    UNLOCK_HEAP(heap);
+}
+
+/* Allocate a hmu for the object from the heap, and cache more hmus of
+   the same size for the following allocations with the heap locked once */
+static hmu_t *
+thread_cache_refill(gc_thread_cache_t *cache, gc_size_t tot_size)
+{
+    gc_heap_t *heap = cache->heap;
+    uint32 bin_idx = tot_size >> 3, i;
+    hmu_t *hmu, *ret;
+
+    LOCK_HEAP(heap);
+
+    if (!(ret = alloc_hmu_ex(heap, tot_size)))
+        goto finish;
+
+    hmu_set_ut(ret, HMU_VO);
+    hmu_unfree_vo(ret);
 #if GC_STAT_DATA != 0
-            heap->total_size_freed += size;
+    heap->total_size_allocated += hmu_get_size(ret);
 #endif
 
-            if (!hmu_get_pinuse(hmu)) {
-                prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+    for (i = 1; i < GC_THREAD_CACHE_BATCH
+                && cache->bin_counts[bin_idx] < GC_THREAD_CACHE_BIN_MAX
+                && cache->cached_size + tot_size <= cache->max_cached_size;
+         i++) {
+        if (!(hmu = alloc_hmu(heap, tot_size)))
+            break;
+
+        hmu_set_ut(hmu, HMU_VO);
+        hmu_unfree_vo(hmu);
+        if (hmu_get_size(hmu) != tot_size) {
+            /* The rest of the free chunk is too small to split */
+            free_vo_hmu(heap, hmu);
+            break;
+        }
+#if GC_STAT_DATA != 0
+        heap->total_size_allocated += tot_size;
+#endif
+        thread_cache_push(cache, bin_idx, hmu_to_obj(hmu));
+    }
 
-                if (hmu_is_in_heap(prev, base_addr, end_addr)
-                    && hmu_get_ut(prev) == HMU_FC) {
-                    size += hmu_get_size(prev);
-                    hmu = prev;
-                    if (!unlink_hmu(heap, prev)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                }
-            }
+finish:
+    UNLOCK_HEAP(heap);
+    return ret;
+}
+#endif /* end of BH_ENABLE_GC_VERIFY == 0 */
 
-            next = (hmu_t *)((char *)hmu + size);
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                if (hmu_get_ut(next) == HMU_FC) {
-                    size += hmu_get_size(next);
-                    if (!unlink_hmu(heap, next)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                    next = (hmu_t *)((char *)hmu + size);
-                }
-            }
+gc_object_t
+gc_thread_cache_alloc_vo(void *vcache, gc_size_t size)
+{
+    gc_thread_cache_t *cache = (gc_thread_cache_t *)vcache;
+#if BH_ENABLE_GC_VERIFY == 0
+    gc_object_t ret;
+    hmu_t *hmu;
+    gc_size_t tot_size, tot_size_unaligned;
 
-            if (!gci_add_fc(heap, hmu, size)) {
-                ret = GC_ERROR;
-                goto out;
-            }
+    tot_size_unaligned = size + OBJ_EXTRA_SIZE;
+    tot_size = GC_ALIGN_8(tot_size_unaligned);
+    if (tot_size < size)
+        /* integer overflow */
+        return NULL;
+    if (tot_size < GC_SMALLEST_SIZE)
+        tot_size = GC_SMALLEST_SIZE;
 
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                hmu_unmark_pinuse(next);
-            }
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (cache->heap->is_heap_corrupted) {
+        LOG_ERROR("[GC_ERROR]Heap is corrupted, allocate memory failed.\n");
+        return NULL;
+    }
+#endif
+
+    if (tot_size <= GC_THREAD_CACHE_MAX_SIZE) {
+        if ((ret = thread_cache_pop(cache, tot_size >> 3))) {
+            hmu = obj_to_hmu(ret);
+        }
+        else if ((hmu = thread_cache_refill(cache, tot_size))) {
+            ret = hmu_to_obj(hmu);
         }
         else {
-            ret = GC_ERROR;
-            goto out;
+            /* Return the objects cached to the heap and try again */
+            gc_thread_cache_flush(cache);
+            return gc_alloc_vo(cache->heap, size);
         }
-        ret = GC_SUCCESS;
-        goto out;
+
+        tot_size = hmu_get_size(hmu);
+        if (tot_size > tot_size_unaligned)
+            /* clear buffer appended by GC_ALIGN_8() */
+            memset((uint8 *)ret + size, 0, tot_size - tot_size_unaligned);
+        return ret;
     }
+#endif
 
-out:
-    UNLOCK_HEAP(heap);
-    return ret;
+    return gc_alloc_vo(cache->heap, size);
+}
+
+int
+gc_thread_cache_free_vo(void *vcache, gc_object_t obj)
+{
+    gc_thread_cache_t *cache = (gc_thread_cache_t *)vcache;
+#if BH_ENABLE_GC_VERIFY == 0
+    gc_heap_t *heap = cache->heap;
+    hmu_t *hmu;
+    gc_size_t size;
+    uint32 bin_idx;
+
+    if (!obj) {
+        return GC_SUCCESS;
+    }
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        LOG_ERROR("[GC_ERROR]Heap is corrupted, free memory failed.\n");
+        return GC_ERROR;
+    }
+#endif
+
+    hmu = obj_to_hmu(obj);
+    /* The aligned objects aren't cached since their hmus are not at the
+       fixed offset to the objects */
+    if ((gc_uint8 *)hmu >= heap->base_addr
+        && (gc_uint8 *)obj < heap->base_addr + heap->current_size
+        && !gc_is_aligned_allocation(obj) && hmu_get_ut(hmu) == HMU_VO
+        && (size = hmu_get_size(hmu)) <= GC_THREAD_CACHE_MAX_SIZE) {
+        bin_idx = size >> 3;
+        if (((gc_uint32 *)obj)[1] == GC_THREAD_CACHE_MAGIC
+            && thread_cache_contains(cache, bin_idx, obj)) {
+            bh_assert(0);
+            return GC_ERROR;
+        }
+
+        if (cache->bin_counts[bin_idx] >= GC_THREAD_CACHE_BIN_MAX
+            || cache->cached_size + size > cache->max_cached_size)
+            thread_cache_flush_bin(cache, bin_idx,
+                                   (cache->bin_counts[bin_idx] + 1) / 2);
+
+        if (cache->cached_size + size <= cache->max_cached_size) {
+            thread_cache_push(cache, bin_idx, obj);
+            return GC_SUCCESS;
+        }
+    }
+#endif
+
+    return gc_free_vo(cache->heap, obj);
 }
 
+void
+gc_thread_cache_flush(void *vcache)
+{
+#if BH_ENABLE_GC_VERIFY == 0
+    gc_thread_cache_t *cache = (gc_thread_cache_t *)vcache;
+    uint32 i;
+
+    if (!cache->heap)
+        return;
+
+    for (i = 0; i < GC_THREAD_CACHE_BIN_CNT; i++) {
+        if (cache->bin_counts[i] > 0)
+            thread_cache_flush_bin(cache, i, cache->bin_counts[i]);
+    }
+#else
+    (void)vcache;
+#endif
+}
+#endif /* end of WASM_ENABLE_ALLOC_THREAD_CACHE != 0 */
+
 void
 gc_dump_heap_stats(gc_heap_t *heap)
 {
@@ -1281,17 +1857,14 @@ gc_set_finalizer(gc_handle_t handle, gc_object_t obj, gc_finalizer_t cb,
 }
 
 void
-gc_unset_finalizer(gc_handle_t handle, gc_object_t obj)
+gci_unset_finalizer(gc_heap_t *vheap, gc_object_t obj)
 {
     gc_size_t index;
-    gc_heap_t *vheap = (gc_heap_t *)handle;
     extra_info_node_t *node;
 
-    LOCK_HEAP(vheap);
-    node = gc_search_extra_info_node(vheap, obj, &index);
+    node = gc_search_extra_info_node((gc_handle_t)vheap, obj, &index);
 
     if (!node) {
-        UNLOCK_HEAP(vheap);
         return;
     }
 
@@ -1302,8 +1875,16 @@ gc_unset_finalizer(gc_handle_t handle, gc_object_t obj)
         vheap->extra_info_nodes + index + 1,
         (vheap->extra_info_node_cnt - index - 1) * sizeof(extra_info_node_t *));
     vheap->extra_info_node_cnt -= 1;
-    UNLOCK_HEAP(vheap);
-
     gct_vm_set_extra_info_flag(obj, false);
 }
+
+void
+gc_unset_finalizer(gc_handle_t handle, gc_object_t obj)
+{
+    gc_heap_t *vheap = (gc_heap_t *)handle;
+
+    LOCK_HEAP(vheap);
+    gci_unset_finalizer(vheap, obj);
+    UNLOCK_HEAP(vheap);
+}
 #endif
@@ -61,34 +61,24 @@ free_mark_node(mark_node_t *node)
 }
 
 /**
- * Sweep phase of mark_sweep algorithm
+ * Sweep the hmus from *p_cur to @end of the marked heap: add the free areas
+ * into KFC, invoke the finalizers of the dead wos and unmark the live wos
+ *
  * @param heap the heap to sweep, should be a valid instance heap
- *        which has already been marked
+ * @param p_cur the first hmu to sweep, return the first hmu not swept
+ * @param end the end of the hmus to sweep
+ * @param stop the sweeping stops at the first live hmu after it
+ *
+ * @return the total size of the free areas added into KFC
  */
-static void
-sweep_instance_heap(gc_heap_t *heap)
+static gc_size_t
+sweep_hmus(gc_heap_t *heap, hmu_t **p_cur, hmu_t *end, hmu_t *stop)
 {
-    hmu_t *cur = NULL, *end = NULL, *last = NULL;
+    hmu_t *cur = *p_cur, *last = NULL;
     hmu_type_t ut;
     gc_size_t size;
-    int i, lsize;
     gc_size_t tot_free = 0;
 
-    bh_assert(gci_is_heap_valid(heap));
-
-    cur = (hmu_t *)heap->base_addr;
-    last = NULL;
-    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
-
-    /* reset KFC */
-    lsize =
-        (int)(sizeof(heap->kfc_normal_list) / sizeof(heap->kfc_normal_list[0]));
-    for (i = 0; i < lsize; i++) {
-        heap->kfc_normal_list[i].next = NULL;
-    }
-    heap->kfc_tree_root->right = NULL;
-    heap->root_set = NULL;
-
     while (cur < end) {
         ut = hmu_get_ut(cur);
         size = hmu_get_size(cur);
@@ -109,7 +99,7 @@ sweep_instance_heap(gc_heap_t *heap)
                         (gc_handle_t)heap, cur_obj, NULL);
                     bh_assert(node);
                     node->finalizer(node->obj, node->data);
-                    gc_unset_finalizer((gc_handle_t)heap, cur_obj);
+                    gci_unset_finalizer(heap, cur_obj);
                 }
             }
         }
@@ -122,6 +112,11 @@ sweep_instance_heap(gc_heap_t *heap)
                 last = NULL;
             }
 
+            if (cur >= stop)
+                /* stop at a live block so that the free areas before and
+                   after it needn't be merged */
+                break;
+
             if (ut == HMU_WO) {
                 /* unmark it */
                 hmu_unmark_wo(cur);
@@ -131,7 +126,7 @@ sweep_instance_heap(gc_heap_t *heap)
         cur = (hmu_t *)((char *)cur + size);
     }
 
-    bh_assert(cur == end);
+    bh_assert(cur <= end);
 
     if (last) {
         tot_free += (gc_size_t)((char *)cur - (char *)last);
@@ -139,17 +134,86 @@ sweep_instance_heap(gc_heap_t *heap)
         hmu_mark_pinuse(last);
     }
 
-    heap->total_free_size = tot_free;
+    *p_cur = cur;
+    return tot_free;
+}
 
+static void
+finish_sweep(gc_heap_t *heap)
+{
 #if GC_STAT_DATA != 0
     heap->total_gc_count++;
-    if ((heap->current_size - tot_free) > heap->highmark_size)
-        heap->highmark_size = heap->current_size - tot_free;
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
 
 #endif
     gc_update_threshold(heap);
 }
 
+/**
+ * Sweep phase of mark_sweep algorithm
+ * @param heap the heap to sweep, should be a valid instance heap
+ *        which has already been marked
+ */
+static void
+sweep_instance_heap(gc_heap_t *heap)
+{
+#if WASM_ENABLE_GC_LAZY_SWEEP == 0
+    hmu_t *cur = NULL, *end = NULL;
+#endif
+    int i, lsize;
+
+    bh_assert(gci_is_heap_valid(heap));
+
+    /* reset KFC */
+    lsize =
+        (int)(sizeof(heap->kfc_normal_list) / sizeof(heap->kfc_normal_list[0]));
+    for (i = 0; i < lsize; i++) {
+        heap->kfc_normal_list[i].next = NULL;
+    }
+    heap->kfc_tree_root->right = NULL;
+    heap->root_set = NULL;
+
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+    /* The heap is swept step by step when allocating memory from it,
+       see gci_sweep_heap_step */
+    heap->sweep_offset = 0;
+    heap->total_free_size = 0;
+#else
+    cur = (hmu_t *)heap->base_addr;
+    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+    heap->total_free_size = sweep_hmus(heap, &cur, end, end);
+    bh_assert(cur == end);
+
+    finish_sweep(heap);
+#endif
+}
+
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+/* Check ems_gc_internal.h for description */
+void
+gci_sweep_heap_step(gc_heap_t *heap, gc_size_t budget)
+{
+    hmu_t *cur, *end, *stop;
+
+    bh_assert(gci_is_heap_valid(heap));
+    bh_assert(gc_is_sweeping(heap));
+
+    cur = (hmu_t *)(heap->base_addr + heap->sweep_offset);
+    end = (hmu_t *)(heap->base_addr + heap->current_size);
+    stop = end;
+    if (budget > 0 && budget < heap->current_size - heap->sweep_offset)
+        stop = (hmu_t *)((gc_uint8 *)cur + budget);
+
+    heap->total_free_size += sweep_hmus(heap, &cur, end, stop);
+    heap->sweep_offset = (gc_size_t)((gc_uint8 *)cur - heap->base_addr);
+
+    if (!gc_is_sweeping(heap))
+        finish_sweep(heap);
+}
+#endif
+
 /**
  * Add a to-expand node to the to-expand list
  *
@@ -297,6 +361,17 @@ reclaim_instance_heap(gc_heap_t *heap)
 
     bh_assert(gci_is_heap_valid(heap));
 
+    /* The rest of a TLAB is a freed VO and is reclaimed by the sweeping,
+       so no object can be allocated from the TLABs any more */
+    gci_retire_tlabs(heap);
+
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+    /* The mark bits of the hmus not swept yet must be cleared before
+       marking again */
+    if (gc_is_sweeping(heap))
+        gci_sweep_heap_step(heap, 0);
+#endif
+
     heap->root_set = NULL;
 
 #if WASM_ENABLE_THREAD_MGR == 0
@@ -255,6 +255,64 @@ gc_free_wo_internal(void *vheap, void *ptr, const char *file, int line);
 
 #endif /* end of BH_ENABLE_GC_VERIFY */
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/**
+ * Get the size of the thread cache structure
+ */
+gc_size_t
+gc_get_thread_cache_struct_size(void);
+
+/**
+ * Initialize a thread cache of the heap in a buffer, which caches the
+ * small objects freed by a thread and allocates them to the thread again
+ * without locking the heap. The thread cache must only be used by one
+ * thread at a time.
+ *
+ * @param handle the heap whose objects are cached
+ * @param buf the buffer to create the thread cache
+ * @param buf_size the size of the buffer
+ *
+ * @return the thread cache if success, NULL otherwise
+ */
+void *
+gc_thread_cache_init(gc_handle_t handle, char *buf, gc_size_t buf_size);
+
+/**
+ * Get the heap whose objects are cached in the thread cache
+ */
+gc_handle_t
+gc_thread_cache_get_heap(void *cache);
+
+/**
+ * Allocate an object from the thread cache, or from the heap if there is
+ * no object of the size cached
+ */
+gc_object_t
+gc_thread_cache_alloc_vo(void *cache, gc_size_t size);
+
+/**
+ * Free an object of the heap into the thread cache, or into the heap if
+ * the object is too large to be cached
+ */
+int
+gc_thread_cache_free_vo(void *cache, gc_object_t obj);
+
+/**
+ * Free all the objects cached into the heap, it does nothing if the heap
+ * has been destroyed
+ */
+void
+gc_thread_cache_flush(void *cache);
+
+/**
+ * Flush the thread cache and detach it from the heap, which must be called
+ * before the buffer of the thread cache is freed. The heap may have been
+ * destroyed already, the thread caches are detached by the heap then.
+ */
+void
+gc_thread_cache_destroy(void *cache);
+#endif
+
 #if WASM_ENABLE_GC != 0
 /**
  * Add gc object ref to the rootset of a gc heap.
@@ -298,6 +356,62 @@ gc_set_finalizer(gc_handle_t handle, gc_object_t obj, gc_finalizer_t cb,
 void
 gc_unset_finalizer(gc_handle_t handle, gc_object_t obj);
 
+/**
+ * The thread-local allocation buffer (TLAB) of a thread, in which the
+ * thread allocates the small WO objects by bumping the top pointer without
+ * locking the heap, e.g. in the code generated by AOT compiler. The rest
+ * of the buffer, [top, limit + GC_TLAB_MIN_REST_SIZE), is always a freed
+ * VO, so that the heap can be walked, and the rest is reclaimed by the
+ * sweeping after the buffer is retired.
+ */
+typedef struct gc_tlab {
+    /* the hmu of the next object to allocate */
+    gc_uint8 *top;
+    /* the max value of top after allocating an object */
+    gc_uint8 *limit;
+    /* the heap which the buffer is allocated from, NULL if retired */
+    gc_handle_t heap;
+    /* the next TLAB of the heap */
+    struct gc_tlab *next;
+} gc_tlab_t;
+
+/* The min size of the freed VO left in a TLAB */
+#define GC_TLAB_MIN_REST_SIZE 16
+
+/* The max object size allocated from a TLAB */
+#define GC_TLAB_MAX_OBJ_SIZE 256
+
+/* The hmu header of a WO object allocated from a TLAB, and the hmu header
+   of the freed VO left, with the size of the hmu including the header,
+   the previous hmu of both is in use */
+#define GC_TLAB_WO_HEADER(hmu_size) (0xE0000000 | ((gc_uint32)(hmu_size) >> 3))
+#define GC_TLAB_REST_HEADER(hmu_size) \
+    (0xB0000000 | ((gc_uint32)(hmu_size) >> 3))
+
+/**
+ * Allocate a WO object from the TLAB, the TLAB is refilled from the heap
+ * if it is exhausted, and the object is allocated from the heap directly
+ * if it is too large or the TLAB can't be refilled. The memory allocated
+ * isn't cleared, same as gc_alloc_wo.
+ *
+ * @param heap the heap to allocate the object from
+ * @param tlab the TLAB of current thread, which is retired first if it
+ *        was allocated from another heap
+ * @param size the size of the object
+ *
+ * @return the object allocated if success, NULL otherwise
+ */
+gc_object_t
+gc_alloc_wo_tlab(void *heap, gc_tlab_t *tlab, gc_size_t size);
+
+/**
+ * Retire the TLAB so that no object is allocated from it any more, which
+ * must be called before the memory of the TLAB is freed. The heap retires
+ * all its TLABs before marking and when it is destroyed.
+ */
+void
+gc_retire_tlab(gc_tlab_t *tlab);
+
 #if WASM_ENABLE_THREAD_MGR == 0
 bool
 wasm_runtime_traverse_gc_rootset(void *exec_env, void *heap);
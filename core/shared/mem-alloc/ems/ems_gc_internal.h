@@ -345,6 +345,7 @@ obj_to_hmu(gc_object_t obj);
 #define HMU_VO_FB_OFFSET 28
 
 #define hmu_is_vo_freed(hmu) GETBIT((hmu)->header, HMU_VO_FB_OFFSET)
+#define hmu_free_vo(hmu) SETBIT((hmu)->header, HMU_VO_FB_OFFSET)
 #define hmu_unfree_vo(hmu) CLRBIT((hmu)->header, HMU_VO_FB_OFFSET)
 
 #define hmu_get_size(hmu) \
@@ -439,6 +440,21 @@ bh_static_assert(offsetof(hmu_tree_node_t, left) == 4);
                   == 0);                                                    \
     } while (0)
 
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+/* The size of the hmus swept each time the allocation can't be satisfied
+   by the hmus swept, which bounds the pause of the allocation */
+#ifndef GC_LAZY_SWEEP_STEP_SIZE
+#define GC_LAZY_SWEEP_STEP_SIZE (32 * 1024)
+#endif
+#endif
+
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+/* Bucket i of the pause time histograms counts the pauses which take
+   [2^(i-1), 2^i) us, bucket 0 counts the pauses less than 1 us and the
+   last bucket counts all the longer pauses */
+#define GC_PAUSE_HISTOGRAM_SIZE 24
+#endif
+
 typedef struct gc_heap_struct {
     /* for double checking*/
     gc_handle_t heap_id;
@@ -486,6 +502,19 @@ typedef struct gc_heap_struct {
 
     /* Whether the heap can do reclaim */
     unsigned is_reclaim_enabled : 1;
+
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+    /* Offset of the first hmu not swept yet after the last marking, the
+       hmus before it are swept and the free chunks among them are in
+       KFC, it is equal to current_size if the whole heap is swept */
+    gc_size_t sweep_offset;
+#endif
+
+    /* the TLABs allocated from the heap and not retired yet */
+    gc_tlab_t *tlab_list;
+    /* the size of the TLAB to allocate, which is halved when the heap
+       is too fragmented and restored after GC, 0 means GC_TLAB_SIZE */
+    gc_size_t tlab_size;
 #endif
 
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
@@ -498,12 +527,23 @@ typedef struct gc_heap_struct {
     gc_size_t highmark_size;
     gc_size_t total_free_size;
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    /* the thread caches of the heap not destroyed yet */
+    struct gc_thread_cache *thread_cache_list;
+#endif
+
 #if WASM_ENABLE_GC != 0
     gc_size_t gc_threshold;
     gc_size_t gc_threshold_factor;
     gc_size_t total_gc_count;
     gc_size_t total_gc_time;
     gc_size_t max_gc_time;
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    gc_size_t gc_pause_histogram[GC_PAUSE_HISTOGRAM_SIZE];
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+    gc_size_t sweep_pause_histogram[GC_PAUSE_HISTOGRAM_SIZE];
+#endif
+#endif
     /* Usually there won't be too many extra info node, so we try to use a fixed
      * array to store them, if the fixed array don't have enough space to store
      * the nodes, a new space will be allocated from heap */
@@ -521,10 +561,80 @@ typedef struct gc_heap_struct {
 #endif
 } gc_heap_t;
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/* The max size of the hmus cached, including the hmu header */
+#ifndef GC_THREAD_CACHE_MAX_SIZE
+#define GC_THREAD_CACHE_MAX_SIZE 256
+#endif
+
+#define GC_THREAD_CACHE_BIN_CNT ((GC_THREAD_CACHE_MAX_SIZE >> 3) + 1)
+
+/* The max count of the hmus cached for each size */
+#ifndef GC_THREAD_CACHE_BIN_MAX
+#define GC_THREAD_CACHE_BIN_MAX 32
+#endif
+
+/* The max total size of the hmus cached, which is also limited to 1/64
+   of the heap size so that the threads don't hold too much free memory */
+#ifndef GC_THREAD_CACHE_MAX_CACHED_SIZE
+#define GC_THREAD_CACHE_MAX_CACHED_SIZE (16 * 1024)
+#endif
+
+/* The count of hmus allocated from the heap at once when the cache of
+   the size is empty */
+#ifndef GC_THREAD_CACHE_BATCH
+#define GC_THREAD_CACHE_BATCH 8
+#endif
+
+/* Stored in the second word of the cached objects to check double free */
+#define GC_THREAD_CACHE_MAGIC 0x7ca4e5a1
+
+/**
+ * The small VO hmus freed by a thread are cached here rather than added
+ * back to the KFC of the heap, and are allocated to the thread again
+ * without locking the heap. The cached hmus are still in use in the view
+ * of the heap, each bin links the hmus of a size with the offsets of
+ * their objects to the heap base, so that they are kept valid after the
+ * heap is migrated.
+ */
+typedef struct gc_thread_cache {
+    /* NULL if the heap is destroyed before the thread cache */
+    gc_heap_t *heap;
+    struct gc_thread_cache *next;
+    gc_size_t cached_size;
+    gc_size_t max_cached_size;
+    /* offset of the first object cached of each size, 0 if empty */
+    gc_uint32 bin_heads[GC_THREAD_CACHE_BIN_CNT];
+    gc_uint16 bin_counts[GC_THREAD_CACHE_BIN_CNT];
+} gc_thread_cache_t;
+#endif
+
 #if WASM_ENABLE_GC != 0
 
 #define GC_DEFAULT_THRESHOLD_FACTOR 300
 
+/* The size of the TLAB allocated each time, which is also limited to 1/32
+   of the heap size so that the threads don't hold too much free memory */
+#ifndef GC_TLAB_SIZE
+#define GC_TLAB_SIZE (4 * 1024)
+#endif
+
+/* The min size of the TLAB allocated when the heap is fragmented */
+#ifndef GC_TLAB_MIN_SIZE
+#define GC_TLAB_MIN_SIZE 128
+#endif
+
+/* The headers written into the TLABs must match the layout of hmu */
+bh_static_assert(GC_TLAB_WO_HEADER(0)
+                 == (((gc_uint32)HMU_WO << HMU_UT_OFFSET)
+                     | (1U << HMU_P_OFFSET)));
+bh_static_assert(GC_TLAB_REST_HEADER(0)
+                 == (((gc_uint32)HMU_VO << HMU_UT_OFFSET)
+                     | (1U << HMU_P_OFFSET) | (1U << HMU_VO_FB_OFFSET)));
+#if BH_ENABLE_GC_VERIFY == 0
+bh_static_assert(GC_TLAB_MIN_REST_SIZE >= GC_SMALLEST_SIZE);
+#endif
+
 static inline void
 gc_update_threshold(gc_heap_t *heap)
 {
@@ -537,6 +647,36 @@ gc_update_threshold(gc_heap_t *heap)
     heap->gc_threshold = (uint32_t)result;
 }
 
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+static inline bool
+gc_is_sweeping(gc_heap_t *heap)
+{
+    return heap->sweep_offset < heap->current_size;
+}
+
+/* Whether the hmu is after the sweep cursor, the free chunks there are
+   not in KFC and the hmus must not be merged with the swept ones */
+static inline bool
+gc_is_hmu_unswept(gc_heap_t *heap, hmu_t *hmu)
+{
+    return (gc_uint8 *)hmu >= heap->base_addr + heap->sweep_offset;
+}
+#endif
+
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+static inline void
+gc_record_pause(gc_size_t *histogram, uint64 time)
+{
+    uint32 idx = 0;
+
+    while (time > 0 && idx < GC_PAUSE_HISTOGRAM_SIZE - 1) {
+        time >>= 1;
+        idx++;
+    }
+    histogram[idx]++;
+}
+#endif
+
 #define gct_vm_mutex_init os_mutex_init
 #define gct_vm_mutex_destroy os_mutex_destroy
 #define gct_vm_mutex_lock os_mutex_lock
@@ -572,6 +712,41 @@ gci_verify_heap(gc_heap_t *heap);
 void
 gci_dump(gc_heap_t *heap);
 
+#if WASM_ENABLE_GC != 0
+/**
+ * Remove the finalizer of the object, the caller should lock the heap
+ */
+void
+gci_unset_finalizer(gc_heap_t *heap, gc_object_t obj);
+
+/**
+ * Retire all the TLABs of the heap, the caller should lock the heap
+ */
+void
+gci_retire_tlabs(gc_heap_t *heap);
+#endif
+
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/**
+ * Detach all the thread caches from the heap which is being destroyed,
+ * the objects cached are dropped with the heap
+ */
+void
+gci_detach_thread_caches(gc_heap_t *heap);
+#endif
+
+#if WASM_ENABLE_GC != 0 && WASM_ENABLE_GC_LAZY_SWEEP != 0
+/**
+ * Sweep the next part of the heap after the last marking
+ *
+ * @param heap the heap to sweep, should be locked and be sweeping
+ * @param budget the size of the hmus to sweep, the sweeping stops at the
+ *        first live hmu after it, 0 means sweeping the rest of the heap
+ */
+void
+gci_sweep_heap_step(gc_heap_t *heap, gc_size_t budget);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
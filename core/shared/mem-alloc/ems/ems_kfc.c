@@ -30,6 +30,10 @@ gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
 #if WASM_ENABLE_GC != 0
     heap->gc_threshold_factor = GC_DEFAULT_THRESHOLD_FACTOR;
     gc_update_threshold(heap);
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+    /* nothing to sweep */
+    heap->sweep_offset = heap->current_size;
+#endif
 #endif
 
     root = heap->kfc_tree_root = (hmu_tree_node_t *)heap->kfc_tree_root_buf;
@@ -134,9 +138,19 @@ gc_destroy_with_pool(gc_handle_t handle)
     gc_heap_t *heap = (gc_heap_t *)handle;
     int ret = GC_SUCCESS;
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+    /* The exec_envs may still be alive, e.g. when the module instance is
+       deinstantiated before them, don't let them flush into the heap */
+    gci_detach_thread_caches(heap);
+#endif
+
 #if WASM_ENABLE_GC != 0
     gc_size_t i = 0;
 
+    /* The exec_envs may still be alive, don't let them allocate objects
+       from the TLABs or retire the TLABs again */
+    gci_retire_tlabs(heap);
+
     if (heap->extra_info_node_cnt > 0) {
         for (i = 0; i < heap->extra_info_node_cnt; i++) {
             extra_info_node_t *node = heap->extra_info_nodes[i];
@@ -259,6 +273,11 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     if (offset == 0)
         return 0;
 
+#if WASM_ENABLE_GC != 0
+    /* The TLABs point to the old pool */
+    gci_retire_tlabs(heap);
+#endif
+
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
     if (heap->is_heap_corrupted) {
         LOG_ERROR("[GC_ERROR]Heap is corrupted, heap migrate failed.\n");
@@ -527,15 +546,40 @@ gc_show_fragment(void *heap_arg)
 }
 
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
+static void
+dump_pause_histogram(const char *name, gc_size_t *histogram)
+{
+    uint32 i;
+
+    os_printf("    %s pause time histogram (us):\n", name);
+    for (i = 0; i < GC_PAUSE_HISTOGRAM_SIZE; i++) {
+        if (!histogram[i])
+            continue;
+        if (i == 0)
+            os_printf("        [0, 1): %" PRIu32 "\n", histogram[i]);
+        else if (i < GC_PAUSE_HISTOGRAM_SIZE - 1)
+            os_printf("        [%" PRIu32 ", %" PRIu32 "): %" PRIu32 "\n",
+                      (uint32)1 << (i - 1), (uint32)1 << i, histogram[i]);
+        else
+            os_printf("        [%" PRIu32 ", ...): %" PRIu32 "\n",
+                      (uint32)1 << (i - 1), histogram[i]);
+    }
+}
+
 void
 gc_dump_perf_profiling(gc_handle_t *handle)
 {
     gc_heap_t *gc_heap_handle = (void *)handle;
     if (gc_heap_handle) {
         os_printf("\nGC performance summary\n");
-        os_printf("    Total GC time (ms): %u\n",
+        os_printf("    Total GC time (us): %u\n",
                   gc_heap_handle->total_gc_time);
-        os_printf("    Max GC time (ms): %u\n", gc_heap_handle->max_gc_time);
+        os_printf("    Max GC time (us): %u\n", gc_heap_handle->max_gc_time);
+        dump_pause_histogram("GC", gc_heap_handle->gc_pause_histogram);
+#if WASM_ENABLE_GC_LAZY_SWEEP != 0
+        dump_pause_histogram("Lazy sweep",
+                             gc_heap_handle->sweep_pause_histogram);
+#endif
     }
     else {
         os_printf("Failed to dump GC performance\n");
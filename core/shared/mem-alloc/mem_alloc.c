@@ -82,6 +82,19 @@ mem_allocator_malloc_with_gc(mem_allocator_t allocator, uint32_t size)
     return gc_alloc_wo((gc_handle_t)allocator, size);
 }
 
+void *
+mem_allocator_malloc_with_gc_tlab(mem_allocator_t allocator, void *tlab,
+                                  uint32_t size)
+{
+    return gc_alloc_wo_tlab((gc_handle_t)allocator, (gc_tlab_t *)tlab, size);
+}
+
+void
+mem_allocator_retire_gc_tlab(void *tlab)
+{
+    gc_retire_tlab((gc_tlab_t *)tlab);
+}
+
 #if WASM_GC_MANUALLY != 0
 void
 mem_allocator_free_with_gc(mem_allocator_t allocator, void *ptr)
@@ -132,6 +145,53 @@ mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info)
     return true;
 }
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+uint32
+mem_allocator_get_cache_struct_size()
+{
+    return gc_get_thread_cache_struct_size();
+}
+
+mem_allocator_cache_t
+mem_allocator_cache_init(mem_allocator_t allocator, void *cache_buf,
+                         uint32_t cache_buf_size)
+{
+    return gc_thread_cache_init((gc_handle_t)allocator, (char *)cache_buf,
+                                cache_buf_size);
+}
+
+mem_allocator_t
+mem_allocator_cache_get_allocator(mem_allocator_cache_t cache)
+{
+    return gc_thread_cache_get_heap(cache);
+}
+
+void *
+mem_allocator_cache_malloc(mem_allocator_cache_t cache, uint32_t size)
+{
+    return gc_thread_cache_alloc_vo(cache, size);
+}
+
+void
+mem_allocator_cache_free(mem_allocator_cache_t cache, void *ptr)
+{
+    if (ptr)
+        gc_thread_cache_free_vo(cache, ptr);
+}
+
+void
+mem_allocator_cache_flush(mem_allocator_cache_t cache)
+{
+    gc_thread_cache_flush(cache);
+}
+
+void
+mem_allocator_cache_destroy(mem_allocator_cache_t cache)
+{
+    gc_thread_cache_destroy(cache);
+}
+#endif
+
 #if WASM_ENABLE_GC != 0
 bool
 mem_allocator_set_gc_finalizer(mem_allocator_t allocator, void *obj,
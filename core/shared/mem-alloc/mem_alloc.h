@@ -81,10 +81,47 @@ mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
 bool
 mem_allocator_is_heap_corrupted(mem_allocator_t allocator);
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/* The cache of the small objects freed by a thread, see
+   gc_thread_cache_init */
+typedef void *mem_allocator_cache_t;
+
+uint32
+mem_allocator_get_cache_struct_size(void);
+
+mem_allocator_cache_t
+mem_allocator_cache_init(mem_allocator_t allocator, void *cache_buf,
+                         uint32_t cache_buf_size);
+
+mem_allocator_t
+mem_allocator_cache_get_allocator(mem_allocator_cache_t cache);
+
+void *
+mem_allocator_cache_malloc(mem_allocator_cache_t cache, uint32_t size);
+
+void
+mem_allocator_cache_free(mem_allocator_cache_t cache, void *ptr);
+
+void
+mem_allocator_cache_flush(mem_allocator_cache_t cache);
+
+void
+mem_allocator_cache_destroy(mem_allocator_cache_t cache);
+#endif
+
 #if WASM_ENABLE_GC != 0
 void *
 mem_allocator_malloc_with_gc(mem_allocator_t allocator, uint32_t size);
 
+/* Allocate a gc object from the thread-local allocation buffer, which has
+   the same layout as gc_tlab_t, see gc_alloc_wo_tlab */
+void *
+mem_allocator_malloc_with_gc_tlab(mem_allocator_t allocator, void *tlab,
+                                  uint32_t size);
+
+void
+mem_allocator_retire_gc_tlab(void *tlab);
+
 #if WASM_GC_MANUALLY != 0
 void
 mem_allocator_free_with_gc(mem_allocator_t allocator, void *ptr);
@@ -264,6 +264,133 @@ os_mremap(void *old_addr, size_t old_size, size_t new_size)
 }
 #endif
 
+#ifdef OS_ENABLE_FILE_MMAP
+void *
+os_mmap_file(void *hint, size_t size, int prot, int flags,
+             os_file_handle file, uint64 offset)
+{
+    int map_prot = PROT_NONE;
+    int map_flags = (flags & MMAP_MAP_SHARED) ? MAP_SHARED : MAP_PRIVATE;
+    uint64 page_size = (uint64)getpagesize();
+    uint64 request_size = (size + page_size - 1) & ~(page_size - 1);
+    void *addr;
+
+    if ((size_t)request_size < size || (offset & (page_size - 1)) != 0) {
+        return NULL;
+    }
+
+    if (prot & MMAP_PROT_READ)
+        map_prot |= PROT_READ;
+
+    if (prot & MMAP_PROT_WRITE)
+        map_prot |= PROT_WRITE;
+
+    if (prot & MMAP_PROT_EXEC)
+        map_prot |= PROT_EXEC;
+
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+#ifndef __APPLE__
+    if (flags & MMAP_MAP_32BIT)
+        map_flags |= MAP_32BIT;
+#endif
+#endif
+
+    if (flags & MMAP_MAP_FIXED)
+        map_flags |= MAP_FIXED;
+
+    addr = mmap(hint, request_size, map_prot, map_flags, file, (off_t)offset);
+    if (addr == MAP_FAILED) {
+        os_printf("mmap file failed with errno: %d, hint: %p, size: %" PRIu64
+                  ", prot: %d, flags: %d\n",
+                  errno, hint, request_size, map_prot, map_flags);
+        return NULL;
+    }
+
+#if BH_ENABLE_TRACE_MMAP != 0
+    total_size_mmapped += request_size;
+    os_printf("mmap file return: %p with size: %zu, total_size_mmapped: %zu, "
+              "total_size_munmapped: %zu\n",
+              addr, request_size, total_size_mmapped, total_size_munmapped);
+#endif
+
+    return addr;
+}
+
+os_file_handle
+os_mem_file_create(const char *name, uint64 size)
+{
+#if defined(MFD_CLOEXEC)
+    int fd = memfd_create(name, MFD_CLOEXEC);
+
+    if (fd < 0) {
+        return os_get_invalid_handle();
+    }
+
+    /* The file is sparse, untouched pages read as zero and don't
+       consume memory */
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return os_get_invalid_handle();
+    }
+
+    return fd;
+#else
+    (void)name;
+    (void)size;
+    return os_get_invalid_handle();
+#endif
+}
+
+void
+os_mem_file_destroy(os_file_handle file)
+{
+    if (file >= 0)
+        close(file);
+}
+
+os_file_handle
+os_mmap_file_open(const char *path, uint64 *p_size)
+{
+    struct stat stat_buf;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return os_get_invalid_handle();
+    }
+
+    if (fstat(fd, &stat_buf) != 0 || !S_ISREG(stat_buf.st_mode)) {
+        close(fd);
+        return os_get_invalid_handle();
+    }
+
+    *p_size = (uint64)stat_buf.st_size;
+    return fd;
+}
+
+void
+os_mmap_file_close(os_file_handle file)
+{
+    if (file >= 0)
+        close(file);
+}
+#endif /* end of OS_ENABLE_FILE_MMAP */
+
+#ifdef OS_ENABLE_MEM_DISCARD
+int
+os_mem_discard(void *addr, size_t size)
+{
+    uint64 page_size = (uint64)getpagesize();
+    uint64 request_size = (size + page_size - 1) & ~(page_size - 1);
+
+    if (!addr || request_size == 0)
+        return 0;
+
+    /* MADV_DONTNEED only takes the mmap lock for reading and, unlike
+       on some other systems, zeroes private anonymous pages on Linux */
+    return madvise(addr, request_size, MADV_DONTNEED);
+}
+#endif
+
 int
 os_mprotect(void *addr, size_t size, int prot)
 {
@@ -133,6 +133,10 @@ enum {
     /* Don't interpret addr as a hint: place the mapping at exactly
        that address. */
     MMAP_MAP_FIXED = 2,
+    /* Share the mapped pages with the file and other processes instead
+       of creating private copy-on-write pages, only used by
+       os_mmap_file() */
+    MMAP_MAP_SHARED = 4,
 };
 
 void *
@@ -165,6 +169,66 @@ os_mremap_slow(void *old_addr, size_t old_size, size_t new_size)
 void *
 os_mremap(void *old_addr, size_t old_size, size_t new_size);
 
+#ifdef OS_ENABLE_FILE_MMAP
+/**
+ * Map `size` bytes of `file` starting from the page aligned `offset`.
+ * The pages are private copy-on-write pages unless MMAP_MAP_SHARED is
+ * set in `flags`.
+ *
+ * @return the mapped address, NULL if failed
+ */
+void *
+os_mmap_file(void *hint, size_t size, int prot, int flags,
+             os_file_handle file, uint64 offset);
+
+/**
+ * Create an anonymous file of `size` bytes backed by memory, e.g. a
+ * memfd on Linux, whose content is initialized as zero.
+ *
+ * @return the file handle, os_get_invalid_handle() if failed or
+ *         not supported
+ */
+os_file_handle
+os_mem_file_create(const char *name, uint64 size);
+
+/**
+ * Close the file created by os_mem_file_create, the memory is released
+ * after all the mappings of the file are unmapped.
+ */
+void
+os_mem_file_destroy(os_file_handle file);
+
+/**
+ * Open an existing file for reading so as to map it with os_mmap_file.
+ *
+ * @param path the path of the file
+ * @param p_size output of the file size
+ *
+ * @return the file handle, os_get_invalid_handle() if failed
+ */
+os_file_handle
+os_mmap_file_open(const char *path, uint64 *p_size);
+
+/**
+ * Close the file opened by os_mmap_file_open, the mappings of the file
+ * are still valid after it is closed.
+ */
+void
+os_mmap_file_close(os_file_handle file);
+#endif
+
+#ifdef OS_ENABLE_MEM_DISCARD
+/**
+ * Release the physical pages of a private anonymous mapping while keeping
+ * the address range and its protection, the pages read as zero when they
+ * are accessed again.
+ *
+ * @return 0 if success, otherwise failed
+ */
+int
+os_mem_discard(void *addr, size_t size);
+#endif
+
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
 void *
 os_get_dbus_mirror(void *ibus);
@@ -116,6 +116,13 @@ os_sigreturn();
 
 #define os_getpagesize getpagesize
 
+/* Support mapping file descriptors (including memfd backed anonymous
+   files) with os_mmap_file() */
+#define OS_ENABLE_FILE_MMAP
+
+/* Support releasing the pages of anonymous mappings with os_mem_discard() */
+#define OS_ENABLE_MEM_DISCARD
+
 #if WASM_DISABLE_WAKEUP_BLOCKING_OP == 0
 #define OS_ENABLE_WAKEUP_BLOCKING_OP
 #endif
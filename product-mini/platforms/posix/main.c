@@ -80,9 +80,17 @@ print_help(void)
     printf("                           Use comma to separate, e.g. --enable-segue=i32.load,i64.store\n");
     printf("                           and --enable-segue means all flags are added.\n");
 #endif
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    printf("  --llvm-jit-cache-dir=<dir> Cache the LLVM JIT compiled code in the directory\n");
+    printf("                           and reuse it the next time the module is loaded\n");
+#endif
 #endif /* WASM_ENABLE_JIT != 0 */
 #if WASM_ENABLE_LINUX_PERF != 0
     printf("  --enable-linux-perf      Enable linux perf support. It works in aot and llvm-jit.\n");
+#endif
+#ifdef OS_ENABLE_FILE_MMAP
+    printf("  --mmap-file              Map the wasm/aot file into memory rather than read it,\n");
+    printf("                           the pages not modified are shared with the page cache\n");
 #endif
     printf("  --repl                   Start a very simple REPL (read-eval-print-loop) mode\n"
            "                           that runs commands in the form of \"FUNC ARG...\"\n");
@@ -597,6 +605,9 @@ main(int argc, char *argv[])
     uint32 llvm_jit_size_level = 3;
     uint32 llvm_jit_opt_level = 3;
     uint32 segue_flags = 0;
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    const char *llvm_jit_cache_dir = NULL;
+#endif
 #endif
 #if WASM_ENABLE_LINUX_PERF != 0
     bool enable_linux_perf = false;
@@ -612,6 +623,9 @@ main(int argc, char *argv[])
 #endif
     bool is_repl_mode = false;
     bool is_xip_file = false;
+#ifdef OS_ENABLE_FILE_MMAP
+    bool mmap_file = false;
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     bool disable_bounds_checks = false;
 #endif
@@ -755,6 +769,13 @@ main(int argc, char *argv[])
             if (segue_flags == (uint32)-1)
                 return print_help();
         }
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+        else if (!strncmp(argv[0], "--llvm-jit-cache-dir=", 21)) {
+            if (argv[0][21] == '\0')
+                return print_help();
+            llvm_jit_cache_dir = argv[0] + 21;
+        }
+#endif
 #endif /* end of WASM_ENABLE_JIT != 0 */
 #if BH_HAS_DLFCN
         else if (!strncmp(argv[0], "--native-lib=", 13)) {
@@ -773,6 +794,11 @@ main(int argc, char *argv[])
             enable_linux_perf = true;
         }
 #endif
+#ifdef OS_ENABLE_FILE_MMAP
+        else if (!strcmp(argv[0], "--mmap-file")) {
+            mmap_file = true;
+        }
+#endif
 #if WASM_ENABLE_MULTI_MODULE != 0
         else if (!strncmp(argv[0],
                           "--module-path=", strlen("--module-path="))) {
@@ -880,6 +906,9 @@ main(int argc, char *argv[])
     init_args.llvm_jit_size_level = llvm_jit_size_level;
     init_args.llvm_jit_opt_level = llvm_jit_opt_level;
     init_args.segue_flags = segue_flags;
+#if WASM_ENABLE_LLVM_JIT_CACHE != 0
+    init_args.llvm_jit_cache_dir = llvm_jit_cache_dir;
+#endif
 #endif
 #if WASM_ENABLE_LINUX_PERF != 0
     init_args.enable_linux_perf = enable_linux_perf;
@@ -907,6 +936,26 @@ main(int argc, char *argv[])
         native_lib_list, native_lib_count, native_lib_loaded_list);
 #endif
 
+#if WASM_ENABLE_MULTI_MODULE != 0
+    wasm_runtime_set_module_reader(module_reader_callback,
+                                   module_destroyer_callback);
+#endif
+
+#ifdef OS_ENABLE_FILE_MMAP
+    if (mmap_file) {
+        LoadArgs load_args = { 0 };
+
+        /* load WASM module from the WASM bin file mapped */
+        load_args.name = "";
+        if (!(wasm_module = wasm_runtime_load_from_file(
+                  wasm_file, &load_args, error_buf, sizeof(error_buf)))) {
+            printf("%s\n", error_buf);
+            goto fail1;
+        }
+        goto module_loaded;
+    }
+#endif
+
     /* load WASM byte buffer from WASM bin file */
     if (!(wasm_file_buf =
               (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
@@ -941,11 +990,6 @@ main(int argc, char *argv[])
     }
 #endif
 
-#if WASM_ENABLE_MULTI_MODULE != 0
-    wasm_runtime_set_module_reader(module_reader_callback,
-                                   module_destroyer_callback);
-#endif
-
     /* load WASM module */
     if (!(wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
                                           error_buf, sizeof(error_buf)))) {
@@ -953,6 +997,10 @@ main(int argc, char *argv[])
         goto fail2;
     }
 
+#ifdef OS_ENABLE_FILE_MMAP
+module_loaded:
+#endif
+
 #if WASM_ENABLE_DYNAMIC_AOT_DEBUG != 0
     if (!wasm_runtime_set_module_name(wasm_module, wasm_file, error_buf,
                                       sizeof(error_buf))) {
@@ -1072,7 +1120,7 @@ main(int argc, char *argv[])
         printf("%s\n", exception);
 
 #if WASM_ENABLE_STATIC_PGO != 0 && WASM_ENABLE_AOT != 0
-    if (get_package_type(wasm_file_buf, wasm_file_size) == Wasm_Module_AoT
+    if (wasm_runtime_get_module_package_type(wasm_module) == Wasm_Module_AoT
         && gen_prof_file)
         dump_pgo_prof_data(wasm_module_inst, gen_prof_file);
 #endif
@@ -1101,11 +1149,14 @@ fail3:
     wasm_runtime_unload(wasm_module);
 
 fail2:
-    /* free the file buffer */
-    if (!is_xip_file)
-        wasm_runtime_free(wasm_file_buf);
-    else
-        os_munmap(wasm_file_buf, wasm_file_size);
+    /* free the file buffer, which is NULL if the file is mapped by the
+       runtime */
+    if (wasm_file_buf) {
+        if (!is_xip_file)
+            wasm_runtime_free(wasm_file_buf);
+        else
+            os_munmap(wasm_file_buf, wasm_file_size);
+    }
 
 fail1:
 #if BH_HAS_DLFCN
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "mem_alloc.h"
+#include "wasm_runtime_common.h"
+#include "wasm_exec_env.h"
+
+/* (module (memory 1 1 shared)) */
+static uint8_t shared_memory_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x05, 0x04, 0x01, 0x03, 0x01, 0x01,
+};
+
+class AllocThreadCacheTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        ASSERT_LE(mem_allocator_get_cache_struct_size(), sizeof(cache_buf));
+        allocator = mem_allocator_create(heap_buf, sizeof(heap_buf));
+        ASSERT_NE(allocator, nullptr);
+        cache = mem_allocator_cache_init(allocator, cache_buf,
+                                         sizeof(cache_buf));
+        ASSERT_NE(cache, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        mem_allocator_cache_destroy(cache);
+        if (allocator)
+            mem_allocator_destroy(allocator);
+        wasm_runtime_destroy();
+    }
+
+    uint32 get_heap_free_size()
+    {
+        mem_alloc_info_t info;
+
+        EXPECT_TRUE(mem_allocator_get_alloc_info(allocator, &info));
+        return info.total_free_size;
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char heap_buf[64 * 1024];
+    char cache_buf[1024];
+    mem_allocator_t allocator = nullptr;
+    mem_allocator_cache_t cache = nullptr;
+};
+
+TEST_F(AllocThreadCacheTest, freed_object_is_reused)
+{
+    void *ptr1, *ptr2;
+
+    ptr1 = mem_allocator_cache_malloc(cache, 24);
+    ASSERT_NE(ptr1, nullptr);
+    mem_allocator_cache_free(cache, ptr1);
+
+    ptr2 = mem_allocator_cache_malloc(cache, 24);
+    EXPECT_EQ(ptr2, ptr1);
+    mem_allocator_cache_free(cache, ptr2);
+}
+
+TEST_F(AllocThreadCacheTest, flush_returns_objects_to_heap)
+{
+    void *ptrs[16];
+    uint32 free_size, i;
+
+    free_size = get_heap_free_size();
+    for (i = 0; i < 16; i++) {
+        ptrs[i] = mem_allocator_cache_malloc(cache, 40);
+        ASSERT_NE(ptrs[i], nullptr);
+    }
+    for (i = 0; i < 16; i++)
+        mem_allocator_cache_free(cache, ptrs[i]);
+
+    /* The objects cached are still allocated in the heap */
+    EXPECT_LT(get_heap_free_size(), free_size);
+    mem_allocator_cache_flush(cache);
+    EXPECT_EQ(get_heap_free_size(), free_size);
+}
+
+TEST_F(AllocThreadCacheTest, large_object_isnt_cached)
+{
+    void *ptr;
+    uint32 free_size;
+
+    free_size = get_heap_free_size();
+    ptr = mem_allocator_cache_malloc(cache, 4096);
+    ASSERT_NE(ptr, nullptr);
+    mem_allocator_cache_free(cache, ptr);
+    EXPECT_EQ(get_heap_free_size(), free_size);
+}
+
+TEST_F(AllocThreadCacheTest, double_free_is_detected)
+{
+    void *ptr;
+
+    ptr = mem_allocator_cache_malloc(cache, 24);
+    ASSERT_NE(ptr, nullptr);
+    mem_allocator_cache_free(cache, ptr);
+    /* The object is found in the cache, bh_assert aborts in debug build */
+    EXPECT_DEATH(mem_allocator_cache_free(cache, ptr), "");
+}
+
+TEST_F(AllocThreadCacheTest, heap_destroyed_before_cache)
+{
+    void *ptr;
+
+    ptr = mem_allocator_cache_malloc(cache, 24);
+    ASSERT_NE(ptr, nullptr);
+    mem_allocator_cache_free(cache, ptr);
+
+    /* The heap detaches the cache, which then doesn't touch the heap
+       buffer any more */
+    mem_allocator_destroy(allocator);
+    allocator = nullptr;
+    memset(heap_buf, 0xff, sizeof(heap_buf));
+    EXPECT_EQ(mem_allocator_cache_get_allocator(cache), nullptr);
+    mem_allocator_cache_flush(cache);
+    mem_allocator_cache_destroy(cache);
+
+    /* The buffer can be used for the cache of another heap */
+    allocator = mem_allocator_create(heap_buf, sizeof(heap_buf));
+    ASSERT_NE(allocator, nullptr);
+    cache = mem_allocator_cache_init(allocator, cache_buf, sizeof(cache_buf));
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(mem_allocator_cache_get_allocator(cache), allocator);
+}
+
+TEST_F(AllocThreadCacheTest, cache_destroyed_before_heap)
+{
+    void *ptr;
+    uint32 free_size;
+
+    free_size = get_heap_free_size();
+    ptr = mem_allocator_cache_malloc(cache, 24);
+    ASSERT_NE(ptr, nullptr);
+    mem_allocator_cache_free(cache, ptr);
+
+    /* The objects cached are flushed and the cache is unlinked */
+    mem_allocator_cache_destroy(cache);
+    EXPECT_EQ(get_heap_free_size(), free_size);
+    EXPECT_EQ(mem_allocator_cache_get_allocator(cache), nullptr);
+    mem_allocator_destroy(allocator);
+    allocator = nullptr;
+}
+
+TEST_F(AllocThreadCacheTest, exec_env_outlives_module_instance)
+{
+    uint8_t wasm_buf[sizeof(shared_memory_wasm)];
+    char error_buf[128];
+    wasm_module_t module;
+    wasm_module_inst_t module_inst;
+    WASMExecEnv *exec_env;
+    uint64 offset;
+    int i;
+
+    memcpy(wasm_buf, shared_memory_wasm, sizeof(shared_memory_wasm));
+    module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                               sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << error_buf;
+    exec_env = nullptr;
+
+    for (i = 0; i < 2; i++) {
+        module_inst = wasm_runtime_instantiate(module, 8192, 8192, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        if (!exec_env) {
+            exec_env = wasm_exec_env_create_internal(module_inst, 8192);
+            ASSERT_NE(exec_env, nullptr);
+        }
+        else {
+            /* The exec_env is reused with another instance */
+            exec_env->module_inst = module_inst;
+        }
+
+        /* The objects of the app heap of the shared memory are cached by
+           the exec_env */
+        offset = wasm_runtime_module_malloc_internal(module_inst, exec_env,
+                                                     24, NULL);
+        ASSERT_NE(offset, 0u);
+        wasm_runtime_module_free_internal(module_inst, exec_env, offset);
+        EXPECT_EQ(wasm_runtime_module_malloc_internal(module_inst, exec_env,
+                                                      24, NULL),
+                  offset);
+        wasm_runtime_module_free_internal(module_inst, exec_env, offset);
+        EXPECT_NE(exec_env->alloc_cache, nullptr);
+
+        /* The app heap is destroyed with the instance, which detaches the
+           cache of the exec_env */
+        wasm_runtime_deinstantiate(module_inst);
+        EXPECT_EQ(mem_allocator_cache_get_allocator(exec_env->alloc_cache),
+                  nullptr);
+    }
+
+    wasm_exec_env_destroy_internal(exec_env);
+    wasm_runtime_unload(module);
+}
+
+static uint32
+get_global_heap_free_size()
+{
+    mem_alloc_info_t info;
+
+    EXPECT_TRUE(wasm_runtime_get_mem_alloc_info(&info));
+    return info.total_free_size;
+}
+
+TEST_F(AllocThreadCacheTest, global_heap_thread_cache)
+{
+    uint32 free_size;
+    void *ptr;
+
+    ASSERT_TRUE(wasm_runtime_init_thread_env());
+    free_size = get_global_heap_free_size();
+
+    ptr = wasm_runtime_malloc(24);
+    ASSERT_NE(ptr, nullptr);
+    wasm_runtime_free(ptr);
+    /* The object is kept by the cache of the thread and reused */
+    EXPECT_LT(get_global_heap_free_size(), free_size);
+    EXPECT_EQ(wasm_runtime_malloc(24), ptr);
+    wasm_runtime_free(ptr);
+
+    /* The objects cached are returned to the heap */
+    wasm_runtime_destroy_thread_env();
+    EXPECT_EQ(get_global_heap_free_size(), free_size);
+}
+
+TEST_F(AllocThreadCacheTest, global_heap_destroyed_before_thread_cache)
+{
+    uint32 free_size;
+    void *ptr;
+
+    ASSERT_TRUE(wasm_runtime_init_thread_env());
+    ptr = wasm_runtime_malloc(24);
+    ASSERT_NE(ptr, nullptr);
+    wasm_runtime_free(ptr);
+
+    /* Destroying the runtime detaches the cache of the thread, which
+       isn't used with the new global heap */
+    wasm_runtime_destroy();
+    ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+    free_size = get_global_heap_free_size();
+    ptr = wasm_runtime_malloc(24);
+    ASSERT_NE(ptr, nullptr);
+    wasm_runtime_free(ptr);
+    EXPECT_EQ(get_global_heap_free_size(), free_size);
+
+    wasm_runtime_destroy_thread_env();
+    EXPECT_EQ(get_global_heap_free_size(), free_size);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "wasm_runtime_common.h"
+#include "wasm_shared_memory.h"
+
+/* (module (memory 1 1 shared)) */
+static uint8_t shared_memory_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x05, 0x04, 0x01, 0x03, 0x01, 0x01,
+};
+
+/* (module (memory 1)) */
+static uint8_t memory_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x05, 0x03, 0x01, 0x00, 0x01,
+};
+
+/* A thread waiting on an address until it is notified */
+class Waiter
+{
+  public:
+    Waiter(wasm_module_inst_t module_inst, void *address)
+      : result(UINT32_MAX)
+      , done(false)
+    {
+        thread = std::thread([this, module_inst, address] {
+            wasm_runtime_init_thread_env();
+            result = wasm_runtime_atomic_wait(
+                (WASMModuleInstanceCommon *)module_inst, address, 0, -1,
+                false);
+            done = true;
+            wasm_runtime_destroy_thread_env();
+        });
+    }
+
+    ~Waiter() { thread.join(); }
+
+    std::atomic<uint32> result;
+    std::atomic<bool> done;
+
+  private:
+    std::thread thread;
+};
+
+class AtomicWaitTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        instantiate(shared_memory_wasm, sizeof(shared_memory_wasm));
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    void instantiate(const uint8_t *wasm, uint32 size)
+    {
+        memcpy(wasm_buf, wasm, size);
+        module = wasm_runtime_load(wasm_buf, size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        /* The waiters are searched in the cluster of the exec_env */
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    void *addr(uint64 offset)
+    {
+        return wasm_runtime_addr_app_to_native(module_inst, offset);
+    }
+
+    uint32 wait(uint64 offset, uint64 expect, int64 timeout)
+    {
+        return wasm_runtime_atomic_wait(
+            (WASMModuleInstanceCommon *)module_inst, addr(offset), expect,
+            timeout, false);
+    }
+
+    uint32 notify(uint64 offset, uint32 count)
+    {
+        return wasm_runtime_atomic_notify(
+            (WASMModuleInstanceCommon *)module_inst, addr(offset), count);
+    }
+
+    /* Notify one waiter of the address once it starts waiting */
+    void notify_one(uint64 offset)
+    {
+        while (notify(offset, 1) == 0)
+            os_usleep(100);
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(shared_memory_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+};
+
+TEST_F(AtomicWaitTest, value_not_equal)
+{
+    *(uint32 *)addr(0) = 1;
+    EXPECT_EQ(wait(0, 0, -1), 1u);
+    EXPECT_EQ(wasm_runtime_atomic_wait((WASMModuleInstanceCommon *)module_inst,
+                                       addr(8), 1, -1, true),
+              1u);
+}
+
+TEST_F(AtomicWaitTest, timeout)
+{
+    EXPECT_EQ(wait(0, 0, 1000000), 2u);
+    /* The waiter is removed after it times out */
+    EXPECT_EQ(notify(0, 1), 0u);
+}
+
+TEST_F(AtomicWaitTest, notify_without_waiters)
+{
+    EXPECT_EQ(notify(0, 1), 0u);
+    EXPECT_EQ(notify(4096, UINT32_MAX), 0u);
+}
+
+TEST_F(AtomicWaitTest, notify_wakes_waiter)
+{
+    Waiter waiter(module_inst, addr(16));
+
+    notify_one(16);
+    while (!waiter.done)
+        os_usleep(100);
+    EXPECT_EQ(waiter.result, 0u);
+    EXPECT_EQ(notify(16, 1), 0u);
+}
+
+TEST_F(AtomicWaitTest, notify_count)
+{
+    std::vector<Waiter *> waiters;
+    uint32 i, woken;
+
+    for (i = 0; i < 3; i++)
+        waiters.push_back(new Waiter(module_inst, addr(32)));
+    /* Wait until all the threads are waiting */
+    os_usleep(100000);
+
+    woken = notify(32, 2);
+    EXPECT_EQ(woken, 2u);
+    woken += notify(32, 2);
+    EXPECT_EQ(woken, 3u);
+    for (i = 0; i < 3; i++) {
+        delete waiters[i];
+    }
+}
+
+TEST_F(AtomicWaitTest, addresses_are_independent)
+{
+    /* Two addresses hashed into the same bucket, see get_wait_bucket, and
+       one which isn't */
+    uint64 offset0 = 64, offset1 = 0, offset2 = 68;
+    uint32 hash0, hash1;
+    uintptr_t base = (uintptr_t)addr(0);
+
+    hash0 = (uint32)((base + offset0) >> 2) * 2654435761U;
+    for (offset1 = offset0 + 4; offset1 < 65536; offset1 += 4) {
+        hash1 = (uint32)((base + offset1) >> 2) * 2654435761U;
+        if (hash1 >> 24 == hash0 >> 24)
+            break;
+    }
+    ASSERT_LT(offset1, 65536u);
+
+    Waiter waiter0(module_inst, addr(offset0));
+    Waiter waiter1(module_inst, addr(offset1));
+    Waiter waiter2(module_inst, addr(offset2));
+
+    /* Only the waiter of the address notified is woken */
+    notify_one(offset1);
+    while (!waiter1.done)
+        os_usleep(100);
+    os_usleep(10000);
+    EXPECT_FALSE(waiter0.done);
+    EXPECT_FALSE(waiter2.done);
+
+    notify_one(offset2);
+    notify_one(offset0);
+    while (!waiter0.done || !waiter2.done)
+        os_usleep(100);
+    EXPECT_EQ(waiter0.result, 0u);
+    EXPECT_EQ(waiter1.result, 0u);
+    EXPECT_EQ(waiter2.result, 0u);
+}
+
+TEST_F(AtomicWaitTest, out_of_bounds)
+{
+    uint8 *end = (uint8 *)addr(65532) + 4;
+    const char *exception;
+
+    EXPECT_EQ(wasm_runtime_atomic_wait((WASMModuleInstanceCommon *)module_inst,
+                                       end, 0, 0, false),
+              (uint32)-1);
+    exception = wasm_runtime_get_exception(module_inst);
+    ASSERT_NE(exception, nullptr);
+    EXPECT_NE(strstr(exception, "out of bounds"), nullptr) << exception;
+    wasm_runtime_clear_exception(module_inst);
+
+    EXPECT_EQ(wasm_runtime_atomic_notify(
+                  (WASMModuleInstanceCommon *)module_inst, end, 1),
+              (uint32)-1);
+    wasm_runtime_clear_exception(module_inst);
+}
+
+TEST_F(AtomicWaitTest, unshared_memory)
+{
+    const char *exception;
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+    instantiate(memory_wasm, sizeof(memory_wasm));
+
+    EXPECT_EQ(wait(0, 0, 0), (uint32)-1);
+    exception = wasm_runtime_get_exception(module_inst);
+    ASSERT_NE(exception, nullptr);
+    EXPECT_NE(strstr(exception, "expected shared memory"), nullptr)
+        << exception;
+    wasm_runtime_clear_exception(module_inst);
+
+    EXPECT_EQ(notify(0, 1), 0u);
+}
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "aot_llvm.h"
+#include "aot_compiler.h"
+#include "aot_emit_aot_file.h"
+
+/*
+ * Each function runs a loop of $n iterations, which sets $last to the
+ * iteration number $k, then accesses the memory at an address affine
+ * in $k, with $base as the start:
+ *
+ * (module
+ *   (memory 1)
+ *   (global $last (mut i32) (i32.const 0))
+ *   (func (export "up") (param $base i32) (param $n i32) (result i32)
+ *     (local $k i32) (local $s i32)
+ *     (block
+ *       (br_if 0 (i32.eqz (local.get $n)))
+ *       (loop
+ *         (global.set $last (local.get $k))
+ *         (local.set $s (i32.add (local.get $s)
+ *           (i32.load (i32.add (local.get $base)
+ *                              (i32.shl (local.get $k) (i32.const 2))))))
+ *         (br_if 0 (i32.lt_u (local.tee $k (i32.add (local.get $k)
+ *                                                   (i32.const 1)))
+ *                            (local.get $n)))))
+ *     (local.get $s))
+ *   ;; i32.load (i32.sub (local.get $base) (i32.shl (local.get $k) ..))
+ *   (func (export "down") ...)
+ *   ;; i32.load offset=65520 (i32.add (local.get $base) (i32.shl ..))
+ *   (func (export "up_offset") ...)
+ *   ;; i32.store (i32.add (local.get $base) (i32.shl ..))
+ *   ;;           (i32.add (local.get $k) (i32.const 1))
+ *   (func (export "store_up") ...)
+ *   ;; i32.load8_u (i32.add (local.get $base) (local.get $k))
+ *   (func (export "byte_up") ...)
+ *   (func (export "last") (result i32) (global.get $last)))
+ */
+static uint8_t loops_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x02, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x07, 0x06,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01, 0x06,
+    0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x35, 0x06, 0x02, 0x75,
+    0x70, 0x00, 0x00, 0x04, 0x64, 0x6f, 0x77, 0x6e, 0x00, 0x01, 0x09, 0x75,
+    0x70, 0x5f, 0x6f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x00, 0x02, 0x08, 0x73,
+    0x74, 0x6f, 0x72, 0x65, 0x5f, 0x75, 0x70, 0x00, 0x03, 0x07, 0x62, 0x79,
+    0x74, 0x65, 0x5f, 0x75, 0x70, 0x00, 0x04, 0x04, 0x6c, 0x61, 0x73, 0x74,
+    0x00, 0x05, 0x0a, 0xff, 0x01, 0x06, 0x31, 0x01, 0x02, 0x7f, 0x02, 0x40,
+    0x20, 0x01, 0x45, 0x0d, 0x00, 0x03, 0x40, 0x20, 0x02, 0x24, 0x00, 0x20,
+    0x03, 0x20, 0x00, 0x20, 0x02, 0x41, 0x02, 0x74, 0x6a, 0x28, 0x02, 0x00,
+    0x6a, 0x21, 0x03, 0x20, 0x02, 0x41, 0x01, 0x6a, 0x22, 0x02, 0x20, 0x01,
+    0x49, 0x0d, 0x00, 0x0b, 0x0b, 0x20, 0x03, 0x0b, 0x31, 0x01, 0x02, 0x7f,
+    0x02, 0x40, 0x20, 0x01, 0x45, 0x0d, 0x00, 0x03, 0x40, 0x20, 0x02, 0x24,
+    0x00, 0x20, 0x03, 0x20, 0x00, 0x20, 0x02, 0x41, 0x02, 0x74, 0x6b, 0x28,
+    0x02, 0x00, 0x6a, 0x21, 0x03, 0x20, 0x02, 0x41, 0x01, 0x6a, 0x22, 0x02,
+    0x20, 0x01, 0x49, 0x0d, 0x00, 0x0b, 0x0b, 0x20, 0x03, 0x0b, 0x33, 0x01,
+    0x02, 0x7f, 0x02, 0x40, 0x20, 0x01, 0x45, 0x0d, 0x00, 0x03, 0x40, 0x20,
+    0x02, 0x24, 0x00, 0x20, 0x03, 0x20, 0x00, 0x20, 0x02, 0x41, 0x02, 0x74,
+    0x6a, 0x28, 0x02, 0xf0, 0xff, 0x03, 0x6a, 0x21, 0x03, 0x20, 0x02, 0x41,
+    0x01, 0x6a, 0x22, 0x02, 0x20, 0x01, 0x49, 0x0d, 0x00, 0x0b, 0x0b, 0x20,
+    0x03, 0x0b, 0x31, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x20, 0x01, 0x45, 0x0d,
+    0x00, 0x03, 0x40, 0x20, 0x02, 0x24, 0x00, 0x20, 0x00, 0x20, 0x02, 0x41,
+    0x02, 0x74, 0x6a, 0x20, 0x02, 0x41, 0x01, 0x6a, 0x36, 0x02, 0x00, 0x20,
+    0x02, 0x41, 0x01, 0x6a, 0x22, 0x02, 0x20, 0x01, 0x49, 0x0d, 0x00, 0x0b,
+    0x0b, 0x20, 0x03, 0x0b, 0x2e, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x20, 0x01,
+    0x45, 0x0d, 0x00, 0x03, 0x40, 0x20, 0x02, 0x24, 0x00, 0x20, 0x03, 0x20,
+    0x00, 0x20, 0x02, 0x6a, 0x2d, 0x00, 0x00, 0x6a, 0x21, 0x03, 0x20, 0x02,
+    0x41, 0x01, 0x6a, 0x22, 0x02, 0x20, 0x01, 0x49, 0x0d, 0x00, 0x0b, 0x0b,
+    0x20, 0x03, 0x0b, 0x04, 0x00, 0x23, 0x00, 0x0b,
+};
+
+#define LOOP_FUNC_NUM 5
+#define MEMORY_SIZE 65536
+
+/* The result of a call */
+struct LoopResult {
+    bool trapped;
+    uint32 ret;
+    /* The iteration in which it returned or trapped */
+    uint32 last;
+    std::string exception;
+};
+
+class aot_bounds_check_versioning_test_suite : public testing::Test
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Allocator;
+        init_args.mem_alloc_option.allocator.malloc_func = (void *)malloc;
+        init_args.mem_alloc_option.allocator.realloc_func = (void *)realloc;
+        init_args.mem_alloc_option.allocator.free_func = (void *)free;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    /* Run the loops of the interpreter as the reference, and the loops of
+       the AOT code compiled with the software bounds checks */
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, loops_wasm, sizeof(loops_wasm));
+        wasm_module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                        sizeof(error_buf));
+        ASSERT_NE(wasm_module, nullptr) << error_buf;
+        ASSERT_TRUE(compile_aot());
+        aot_module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                       sizeof(error_buf));
+        ASSERT_NE(aot_module, nullptr) << error_buf;
+
+        ASSERT_TRUE(interp_inst = instantiate(wasm_module));
+        ASSERT_TRUE(aot_inst = instantiate(aot_module));
+    }
+
+    virtual void TearDown()
+    {
+        if (aot_inst)
+            wasm_runtime_deinstantiate(aot_inst);
+        if (interp_inst)
+            wasm_runtime_deinstantiate(interp_inst);
+        if (aot_module)
+            wasm_runtime_unload(aot_module);
+        if (wasm_module)
+            wasm_runtime_unload(wasm_module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+    }
+
+    bool compile_aot()
+    {
+        AOTCompData *comp_data;
+        AOTCompContext *comp_ctx;
+        AOTCompOption option = { 0 };
+        LLVMValueRef func;
+        LLVMBasicBlockRef block;
+        const char *name;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 1;
+
+        if (!(comp_data = aot_create_comp_data((WASMModule *)wasm_module,
+                                               NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx)) {
+            /* Count the loops cloned as the slow path of the versioning */
+            for (func = LLVMGetFirstFunction(comp_ctx->module); func;
+                 func = LLVMGetNextFunction(func)) {
+                for (block = LLVMGetFirstBasicBlock(func); block;
+                     block = LLVMGetNextBasicBlock(block)) {
+                    name = LLVMGetBasicBlockName(block);
+                    if (strstr(name, "loop") && strstr(name, "_begin.slow"))
+                        versioned_loops++;
+                }
+            }
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        }
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+
+    /* Each 4-byte word of the memory holds its address plus one */
+    wasm_module_inst_t instantiate(wasm_module_t module)
+    {
+        wasm_module_inst_t inst;
+        uint32 *words;
+        uint32 i;
+
+        inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                        sizeof(error_buf));
+        EXPECT_NE(inst, nullptr) << error_buf;
+        if (!inst)
+            return nullptr;
+        words = (uint32 *)wasm_runtime_addr_app_to_native(inst, 0);
+        for (i = 0; i < MEMORY_SIZE / 4; i++)
+            words[i] = i * 4 + 1;
+        return inst;
+    }
+
+    LoopResult call(wasm_module_inst_t inst, const char *name, uint32 base,
+                    uint32 n)
+    {
+        wasm_function_inst_t func;
+        wasm_exec_env_t exec_env;
+        uint32 argv[2] = { base, n };
+        LoopResult result = { false, 0, 0, "" };
+
+        func = wasm_runtime_lookup_function(inst, name);
+        EXPECT_NE(func, nullptr) << name;
+        exec_env = wasm_runtime_create_exec_env(inst, 8192);
+        EXPECT_NE(exec_env, nullptr);
+        if (!func || !exec_env)
+            return result;
+
+        if (wasm_runtime_call_wasm(exec_env, func, 2, argv)) {
+            result.ret = argv[0];
+        }
+        else {
+            result.trapped = true;
+            result.exception = wasm_runtime_get_exception(inst);
+            wasm_runtime_clear_exception(inst);
+        }
+        func = wasm_runtime_lookup_function(inst, "last");
+        if (func && wasm_runtime_call_wasm(exec_env, func, 0, argv))
+            result.last = argv[0];
+        wasm_runtime_destroy_exec_env(exec_env);
+        return result;
+    }
+
+    /* Run the loop in both the interpreter and AOT code, which must end
+       the same way and leave the same memory */
+    LoopResult run(const char *name, uint32 base, uint32 n)
+    {
+        LoopResult expected = call(interp_inst, name, base, n);
+        LoopResult result = call(aot_inst, name, base, n);
+
+        EXPECT_EQ(result.trapped, expected.trapped) << name;
+        EXPECT_EQ(result.ret, expected.ret) << name;
+        EXPECT_EQ(result.last, expected.last) << name;
+        EXPECT_EQ(result.exception, expected.exception) << name;
+        EXPECT_EQ(memcmp(wasm_runtime_addr_app_to_native(interp_inst, 0),
+                         wasm_runtime_addr_app_to_native(aot_inst, 0),
+                         MEMORY_SIZE),
+                  0)
+            << name;
+        return result;
+    }
+
+    /* Expect that the loop traps in the iteration */
+    void expect_trap(const char *name, uint32 base, uint32 n, uint32 last)
+    {
+        LoopResult result = run(name, base, n);
+
+        EXPECT_TRUE(result.trapped) << name << " " << base << " " << n;
+        EXPECT_EQ(result.exception, "Exception: out of bounds memory access");
+        EXPECT_EQ(result.last, last) << name << " " << base << " " << n;
+    }
+
+    void expect_no_trap(const char *name, uint32 base, uint32 n)
+    {
+        LoopResult result = run(name, base, n);
+
+        EXPECT_FALSE(result.trapped) << name << " " << base << " " << n;
+        EXPECT_EQ(result.last, n - 1) << name << " " << base << " " << n;
+    }
+
+  public:
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(loops_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    uint32 versioned_loops = 0;
+    wasm_module_t wasm_module = nullptr;
+    wasm_module_t aot_module = nullptr;
+    wasm_module_inst_t interp_inst = nullptr;
+    wasm_module_inst_t aot_inst = nullptr;
+};
+
+TEST_F(aot_bounds_check_versioning_test_suite, loops_versioned)
+{
+    EXPECT_EQ(versioned_loops, (uint32)LOOP_FUNC_NUM);
+}
+
+TEST_F(aot_bounds_check_versioning_test_suite, increasing_index)
+{
+    /* The last iteration accesses the last word of the memory */
+    expect_no_trap("up", 0, MEMORY_SIZE / 4);
+    expect_no_trap("up", 4, MEMORY_SIZE / 4 - 1);
+    /* The last iteration crosses the end of the memory */
+    expect_trap("up", 4, MEMORY_SIZE / 4, MEMORY_SIZE / 4 - 1);
+    expect_trap("up", 1, MEMORY_SIZE / 4, MEMORY_SIZE / 4 - 1);
+    expect_trap("up", MEMORY_SIZE - 8, 4, 2);
+    expect_trap("up", MEMORY_SIZE, 1, 0);
+}
+
+TEST_F(aot_bounds_check_versioning_test_suite, decreasing_index)
+{
+    /* Down to the first word of the memory */
+    expect_no_trap("down", MEMORY_SIZE - 4, MEMORY_SIZE / 4);
+    expect_no_trap("down", 12, 4);
+    /* The index becomes negative and wraps around to the top */
+    expect_trap("down", MEMORY_SIZE - 4, MEMORY_SIZE / 4 + 1, MEMORY_SIZE / 4);
+    expect_trap("down", 12, 8, 4);
+    expect_trap("down", 2, 2, 1);
+    /* It starts out of bounds and decreases into the memory */
+    expect_trap("down", MEMORY_SIZE + 8, 8, 0);
+}
+
+TEST_F(aot_bounds_check_versioning_test_suite, wrapping_index)
+{
+    /* The 32-bit index wraps around from the top into the memory, the
+       accesses before it are out of bounds */
+    expect_trap("up", 0xFFFFFFF0, 8, 0);
+    expect_trap("byte_up", 0xFFFFFFFC, 8, 0);
+    /* It wraps around from the bottom to the top */
+    expect_trap("down", 0, 2, 1);
+    /* A large count which wraps the index around more than once */
+    expect_trap("up", 0, 0x40000001, MEMORY_SIZE / 4);
+}
+
+TEST_F(aot_bounds_check_versioning_test_suite, constant_offset)
+{
+    /* The offset is added to the index without wrapping */
+    expect_no_trap("up_offset", 0, 4);
+    expect_no_trap("up_offset", 12, 1);
+    expect_trap("up_offset", 0, 5, 4);
+    expect_trap("up_offset", 16, 1, 0);
+    expect_trap("up_offset", 0xFFFFFFF0, 8, 0);
+    expect_trap("up_offset", 0xFFFFFFF0 - 65520, 8, 0);
+}
+
+TEST_F(aot_bounds_check_versioning_test_suite, byte_access)
+{
+    expect_no_trap("byte_up", MEMORY_SIZE - 6, 6);
+    expect_trap("byte_up", MEMORY_SIZE - 6, 7, 6);
+}
+
+TEST_F(aot_bounds_check_versioning_test_suite, stores_before_trap)
+{
+    uint32 *words;
+
+    /* The iterations before the trap have stored their values */
+    expect_trap("store_up", MEMORY_SIZE - 16, 8, 4);
+    words = (uint32 *)wasm_runtime_addr_app_to_native(aot_inst,
+                                                      MEMORY_SIZE - 16);
+    EXPECT_EQ(words[0], 1u);
+    EXPECT_EQ(words[3], 4u);
+
+    expect_no_trap("store_up", 0, MEMORY_SIZE / 4);
+    words = (uint32 *)wasm_runtime_addr_app_to_native(aot_inst, 0);
+    EXPECT_EQ(words[MEMORY_SIZE / 4 - 1], MEMORY_SIZE / 4);
+}
@@ -9,6 +9,7 @@
 #include "bh_read_file.h"
 #include "aot_emit_control.h"
 #include "aot_emit_function.h"
+#include "aot_emit_aot_file.h"
 
 static std::string CWD;
 static std::string MAIN_WASM = "/main.wasm";
@@ -82,3 +83,180 @@ TEST_F(aot_emit_function_test_suite, aot_compile_op_call)
     func_ctx = comp_ctx->func_ctxes[1];
     EXPECT_EQ(false, aot_compile_op_call(comp_ctx, func_ctx, 9999, true));
 }
+
+/*
+ * (module
+ *   (type $t0 (func (result i32)))
+ *   (type $t1 (func (param i32) (result i32)))
+ *   (table 3 funcref)
+ *   (func $f42 (type $t0) (i32.const 42))
+ *   (func $f7 (type $t0) (i32.const 7))
+ *   (func $g (type $t1) (local.get 0))
+ *   (func (export "call") (param i32) (result i32)
+ *     (call_indirect (type $t0) (local.get 0)))
+ *   (func (export "copy") (param i32 i32)
+ *     (table.copy (local.get 0) (local.get 1) (i32.const 1)))
+ *   (func (export "clear") (param i32)
+ *     (table.set (local.get 0) (ref.null func)))
+ *   (elem (i32.const 0) $f42 $g $f7))
+ */
+static uint8_t call_indirect_cache_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x13, 0x04, 0x60,
+    0x00, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f,
+    0x00, 0x60, 0x01, 0x7f, 0x00, 0x03, 0x07, 0x06, 0x00, 0x00, 0x01, 0x01,
+    0x02, 0x03, 0x04, 0x04, 0x01, 0x70, 0x00, 0x03, 0x07, 0x17, 0x03, 0x04,
+    0x63, 0x61, 0x6c, 0x6c, 0x00, 0x03, 0x04, 0x63, 0x6f, 0x70, 0x79, 0x00,
+    0x04, 0x05, 0x63, 0x6c, 0x65, 0x61, 0x72, 0x00, 0x05, 0x09, 0x09, 0x01,
+    0x00, 0x41, 0x00, 0x0b, 0x03, 0x00, 0x02, 0x01, 0x0a, 0x2e, 0x06, 0x04,
+    0x00, 0x41, 0x2a, 0x0b, 0x04, 0x00, 0x41, 0x07, 0x0b, 0x04, 0x00, 0x20,
+    0x00, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x11, 0x00, 0x00, 0x0b, 0x0c, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0x41, 0x01, 0xfc, 0x0e, 0x00, 0x00, 0x0b, 0x08,
+    0x00, 0x20, 0x00, 0xd0, 0x70, 0x26, 0x00, 0x0b,
+};
+
+/* Call the function of the module instance, return the i32 result, or -1
+   and the exception in exception_buf if it traps */
+static int32
+call_i32(wasm_module_inst_t module_inst, wasm_exec_env_t exec_env,
+         const char *name, uint32 argc, uint32 *argv,
+         std::string &exception_buf)
+{
+    wasm_function_inst_t func;
+
+    exception_buf.clear();
+    func = wasm_runtime_lookup_function(module_inst, name);
+    EXPECT_NE(func, nullptr) << name;
+    if (!wasm_runtime_call_wasm(exec_env, func, argc, argv)) {
+        exception_buf = wasm_runtime_get_exception(module_inst);
+        wasm_runtime_clear_exception(module_inst);
+        return -1;
+    }
+    return argc > 0 ? (int32)argv[0] : 0;
+}
+
+TEST_F(aot_emit_function_test_suite, call_indirect_cache)
+{
+    uint8_t wasm_buf[sizeof(call_indirect_cache_wasm)];
+    char error_buf[128] = { 0 };
+    wasm_module_t wasm_module = nullptr, aot_module = nullptr;
+    wasm_module_inst_t module_inst, module_inst2;
+    wasm_exec_env_t exec_env, exec_env2;
+    struct AOTCompData *comp_data = nullptr;
+    struct AOTCompContext *comp_ctx = nullptr;
+    AOTCompOption option = { 0 };
+    uint8 *aot_file_buf;
+    uint32 aot_file_size, argv[2];
+    std::string exception;
+
+    option.opt_level = 3;
+    option.size_level = 3;
+    option.output_format = AOT_FORMAT_FILE;
+    option.bounds_checks = 2;
+    option.enable_aux_stack_check = true;
+    option.enable_bulk_memory = true;
+    option.enable_ref_types = true;
+    option.enable_call_indirect_overlong = true;
+
+    memcpy(wasm_buf, call_indirect_cache_wasm, sizeof(wasm_buf));
+    wasm_module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(wasm_module, nullptr) << error_buf;
+    comp_data = aot_create_comp_data((WASMModule *)wasm_module, NULL, false);
+    ASSERT_NE(comp_data, nullptr);
+    comp_ctx = aot_create_comp_context(comp_data, &option);
+    ASSERT_NE(comp_ctx, nullptr) << aot_get_last_error();
+    EXPECT_TRUE(comp_ctx->enable_call_indirect_cache);
+    ASSERT_TRUE(aot_compile_wasm(comp_ctx)) << aot_get_last_error();
+    aot_file_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+    ASSERT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+    aot_destroy_comp_context(comp_ctx);
+    aot_destroy_comp_data(comp_data);
+    wasm_runtime_unload(wasm_module);
+
+    aot_module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                   sizeof(error_buf));
+    ASSERT_NE(aot_module, nullptr) << error_buf;
+    module_inst = wasm_runtime_instantiate(aot_module, 8192, 0, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_NE(module_inst, nullptr) << error_buf;
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_NE(exec_env, nullptr);
+
+    /* Fill the cache of the call_indirect site with $f42 */
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), 42);
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), 42);
+
+    /* The elements not cached are still checked */
+    argv[0] = 1;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), -1);
+    EXPECT_NE(exception.find("indirect call type mismatch"), std::string::npos)
+        << exception;
+    argv[0] = 3;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), -1);
+    EXPECT_NE(exception.find("undefined element"), std::string::npos)
+        << exception;
+
+    /* The element of the cached function is replaced with $g */
+    argv[0] = 0;
+    argv[1] = 1;
+    call_i32(module_inst, exec_env, "copy", 2, argv, exception);
+    EXPECT_TRUE(exception.empty()) << exception;
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), -1);
+    EXPECT_NE(exception.find("indirect call type mismatch"), std::string::npos)
+        << exception;
+
+    /* The element is cleared */
+    argv[0] = 0;
+    call_i32(module_inst, exec_env, "clear", 1, argv, exception);
+    EXPECT_TRUE(exception.empty()) << exception;
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), -1);
+    EXPECT_NE(exception.find("uninitialized element"), std::string::npos)
+        << exception;
+
+    /* Fill the other entry with $f7, and check that a full cache doesn't
+       skip checking the other functions */
+    argv[0] = 0;
+    argv[1] = 2;
+    call_i32(module_inst, exec_env, "copy", 2, argv, exception);
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), 7);
+    argv[0] = 0;
+    argv[1] = 1;
+    call_i32(module_inst, exec_env, "copy", 2, argv, exception);
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), -1);
+    EXPECT_NE(exception.find("indirect call type mismatch"), std::string::npos)
+        << exception;
+
+    /* The cache is shared by the instances of the module, the table of the
+       new instance is initialized again */
+    module_inst2 = wasm_runtime_instantiate(aot_module, 8192, 0, error_buf,
+                                            sizeof(error_buf));
+    ASSERT_NE(module_inst2, nullptr) << error_buf;
+    exec_env2 = wasm_runtime_create_exec_env(module_inst2, 8192);
+    ASSERT_NE(exec_env2, nullptr);
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst2, exec_env2, "call", 1, argv, exception),
+              42);
+    argv[0] = 2;
+    EXPECT_EQ(call_i32(module_inst2, exec_env2, "call", 1, argv, exception),
+              7);
+    argv[0] = 1;
+    EXPECT_EQ(call_i32(module_inst2, exec_env2, "call", 1, argv, exception),
+              -1);
+    EXPECT_NE(exception.find("indirect call type mismatch"), std::string::npos)
+        << exception;
+    argv[0] = 0;
+    EXPECT_EQ(call_i32(module_inst, exec_env, "call", 1, argv, exception), -1);
+
+    wasm_runtime_destroy_exec_env(exec_env2);
+    wasm_runtime_deinstantiate(module_inst2);
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(aot_module);
+    wasm_runtime_free(aot_file_buf);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_platform.h"
+
+extern "C" {
+uint8 *
+aot_emit_aot_file_buf(AOTCompContext *comp_ctx, AOTCompData *comp_data,
+                      uint32 *p_aot_file_size);
+}
+
+/*
+ * 48 functions, enough to be split into 3 shards, each calling the next
+ * one across the shards:
+ *   (func $f0 (export "f0") (param i32) (result i32)
+ *     (i32.add (call $f1 (local.get 0)) (i32.const 0)))
+ *   ...
+ *   (func $f46 (param i32) (result i32)
+ *     (i32.add (call $f47 (local.get 0)) (i32.const 46)))
+ *   (func $f47 (param i32) (result i32) (local.get 0))
+ */
+static uint8_t chain_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x31, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x06, 0x01, 0x02, 0x66,
+    0x30, 0x00, 0x00, 0x0a, 0xdc, 0x03, 0x30, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x01, 0x41, 0x00, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x02, 0x41,
+    0x01, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x03, 0x41, 0x02, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x04, 0x41, 0x03, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x05, 0x41, 0x04, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x06, 0x41, 0x05, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x07, 0x41, 0x06, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x08, 0x41,
+    0x07, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x09, 0x41, 0x08, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x0a, 0x41, 0x09, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x0b, 0x41, 0x0a, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x0c, 0x41, 0x0b, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x0d, 0x41, 0x0c, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x0e, 0x41,
+    0x0d, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x0f, 0x41, 0x0e, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x10, 0x41, 0x0f, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x11, 0x41, 0x10, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x12, 0x41, 0x11, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x13, 0x41, 0x12, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x14, 0x41,
+    0x13, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x15, 0x41, 0x14, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x16, 0x41, 0x15, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x17, 0x41, 0x16, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x18, 0x41, 0x17, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x19, 0x41, 0x18, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x1a, 0x41,
+    0x19, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x1b, 0x41, 0x1a, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x1c, 0x41, 0x1b, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x1d, 0x41, 0x1c, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x1e, 0x41, 0x1d, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x1f, 0x41, 0x1e, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x20, 0x41,
+    0x1f, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x21, 0x41, 0x20, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x22, 0x41, 0x21, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x23, 0x41, 0x22, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x24, 0x41, 0x23, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x25, 0x41, 0x24, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x26, 0x41,
+    0x25, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x27, 0x41, 0x26, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x28, 0x41, 0x27, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x29, 0x41, 0x28, 0x6a, 0x0b, 0x09, 0x00, 0x20,
+    0x00, 0x10, 0x2a, 0x41, 0x29, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10,
+    0x2b, 0x41, 0x2a, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x2c, 0x41,
+    0x2b, 0x6a, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x2d, 0x41, 0x2c, 0x6a,
+    0x0b, 0x09, 0x00, 0x20, 0x00, 0x10, 0x2e, 0x41, 0x2d, 0x6a, 0x0b, 0x09,
+    0x00, 0x20, 0x00, 0x10, 0x2f, 0x41, 0x2e, 0x6a, 0x0b, 0x04, 0x00, 0x20,
+    0x00, 0x0b,
+};
+
+class aot_parallel_opt_test_suite : public testing::Test
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Allocator;
+        init_args.mem_alloc_option.allocator.malloc_func = (void *)malloc;
+        init_args.mem_alloc_option.allocator.realloc_func = (void *)realloc;
+        init_args.mem_alloc_option.allocator.free_func = (void *)free;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, chain_wasm, sizeof(chain_wasm));
+        wasm_module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                        sizeof(error_buf));
+        ASSERT_NE(wasm_module, nullptr) << error_buf;
+    }
+
+    virtual void TearDown()
+    {
+        if (wasm_module)
+            wasm_runtime_unload(wasm_module);
+    }
+
+    /* Compile the module with the number of jobs, return the AOT file */
+    std::vector<uint8_t> compile(uint32_t jobs)
+    {
+        std::vector<uint8_t> aot_file;
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx = nullptr;
+        AOTCompOption option = { 0 };
+        uint8 *aot_file_buf = nullptr;
+        uint32 aot_file_size = 0;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.stack_bounds_checks = 2;
+        option.enable_aux_stack_check = true;
+        option.jobs = jobs;
+
+        comp_data = aot_create_comp_data(wasm_module, NULL, false);
+        EXPECT_NE(comp_data, nullptr);
+        if (comp_data)
+            comp_ctx = aot_create_comp_context(comp_data, &option);
+        EXPECT_NE(comp_ctx, nullptr) << aot_get_last_error();
+        if (comp_ctx && aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+
+        if (aot_file_buf) {
+            aot_file.assign(aot_file_buf, aot_file_buf + aot_file_size);
+            wasm_runtime_free(aot_file_buf);
+        }
+        if (comp_ctx)
+            aot_destroy_comp_context(comp_ctx);
+        if (comp_data)
+            aot_destroy_comp_data(comp_data);
+        return aot_file;
+    }
+
+    /* Load the AOT file and return f0(arg), or UINT32_MAX on failure */
+    uint32_t run(std::vector<uint8_t> aot_file, uint32_t arg)
+    {
+        wasm_module_t module;
+        wasm_module_inst_t module_inst = nullptr;
+        wasm_function_inst_t func;
+        uint32_t argv[1] = { arg }, ret = UINT32_MAX;
+
+        module = wasm_runtime_load(aot_file.data(), aot_file.size(),
+                                   error_buf, sizeof(error_buf));
+        if (module)
+            module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                                   sizeof(error_buf));
+        if (module_inst
+            && (func = wasm_runtime_lookup_function(module_inst, "f0"))
+            && call(module_inst, func, argv))
+            ret = argv[0];
+
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        return ret;
+    }
+
+    bool call(wasm_module_inst_t module_inst, wasm_function_inst_t func,
+              uint32_t *argv)
+    {
+        wasm_exec_env_t exec_env =
+            wasm_runtime_create_exec_env(module_inst, 8192);
+        bool ret;
+
+        if (!exec_env)
+            return false;
+        ret = wasm_runtime_call_wasm(exec_env, func, 1, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+  public:
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(chain_wasm)];
+    wasm_module_t wasm_module = nullptr;
+};
+
+TEST_F(aot_parallel_opt_test_suite, same_output_for_any_jobs)
+{
+    std::vector<uint8_t> one_job = compile(1);
+
+    ASSERT_FALSE(one_job.empty());
+    EXPECT_EQ(compile(2), one_job);
+    EXPECT_EQ(compile(3), one_job);
+    EXPECT_EQ(compile(8), one_job);
+    /* The threads finish in any order from run to run */
+    EXPECT_EQ(compile(3), one_job);
+}
+
+TEST_F(aot_parallel_opt_test_suite, linked_shards_run)
+{
+    /* 0 + 1 + ... + 46 */
+    EXPECT_EQ(run(compile(1), 5), 5u + 1081u);
+    EXPECT_EQ(run(compile(3), 5), 5u + 1081u);
+    /* The whole module optimized at once computes the same */
+    EXPECT_EQ(run(compile(0), 5), 5u + 1081u);
+}
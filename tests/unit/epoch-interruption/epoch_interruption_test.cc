@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (func (export "loop") (param $n i32) (result i32)
+ *     (local $i i32)
+ *     (loop $l
+ *       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+ *       (br_if $l (i32.lt_u (local.get $i) (local.get $n))))
+ *     (local.get $i))
+ *   (func (export "spin")
+ *     (loop $l (br $l))))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01,
+    0x07, 0x0f, 0x02, 0x04, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x00, 0x04, 0x73,
+    0x70, 0x69, 0x6e, 0x00, 0x01, 0x0a, 0x21, 0x02, 0x17, 0x01, 0x01, 0x7f,
+    0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x20, 0x01, 0x20,
+    0x00, 0x49, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b, 0x07, 0x00, 0x03, 0x40,
+    0x0c, 0x00, 0x0b, 0x0b,
+};
+
+enum TestMode { Test_Interp, Test_LLVM_JIT, Test_AOT };
+
+/* A timer thread bumping the epoch every millisecond */
+class EpochTicker
+{
+  public:
+    EpochTicker()
+      : stopped(false)
+    {
+        thread = std::thread([this] {
+            while (!stopped) {
+                wasm_runtime_increment_epoch();
+                os_usleep(1000);
+            }
+        });
+    }
+
+    ~EpochTicker()
+    {
+        stopped = true;
+        thread.join();
+    }
+
+  private:
+    std::atomic<bool> stopped;
+    std::thread thread;
+};
+
+struct DeadlineCallbackData {
+    uint32 calls;
+    uint32 extensions;
+};
+
+static bool
+deadline_callback(wasm_exec_env_t exec_env, void *user_data)
+{
+    DeadlineCallbackData *data = (DeadlineCallbackData *)user_data;
+
+    data->calls++;
+    if (data->extensions == 0)
+        return false;
+    data->extensions--;
+    wasm_runtime_set_epoch_deadline(wasm_runtime_get_module_inst(exec_env),
+                                    1);
+    return true;
+}
+
+class EpochInterruptionTest : public testing::TestWithParam<TestMode>
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        if (GetParam() == Test_AOT) {
+            ASSERT_TRUE(compile_aot());
+            wasm_runtime_unload(module);
+            module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                       sizeof(error_buf));
+            ASSERT_NE(module, nullptr) << error_buf;
+        }
+
+        module_inst = instantiate();
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+    }
+
+    /* Compile the wasm module to an AOT file with epoch interruption */
+    bool compile_aot()
+    {
+        AOTCompOption option = { 0 };
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.enable_epoch_interruption = true;
+
+        if (!(comp_data = aot_create_comp_data(module, NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+
+    wasm_module_inst_t instantiate()
+    {
+        wasm_module_inst_t inst;
+
+        inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                        sizeof(error_buf));
+        if (inst && GetParam() != Test_AOT
+            && !wasm_runtime_set_running_mode(
+                inst, GetParam() == Test_Interp ? Mode_Interp
+                                                : Mode_LLVM_JIT)) {
+            wasm_runtime_deinstantiate(inst);
+            return nullptr;
+        }
+        return inst;
+    }
+
+    /* Call the function of the instance, return false if it traps */
+    bool call(wasm_module_inst_t inst, wasm_exec_env_t env, const char *name,
+              uint32 argc, uint32 *argv)
+    {
+        wasm_function_inst_t func;
+
+        exception.clear();
+        func = wasm_runtime_lookup_function(inst, name);
+        EXPECT_NE(func, nullptr) << name;
+        if (!wasm_runtime_call_wasm(env, func, argc, argv)) {
+            exception = wasm_runtime_get_exception(inst);
+            wasm_runtime_clear_exception(inst);
+            return false;
+        }
+        return true;
+    }
+
+  public:
+    static char global_heap_buf[512 * 1024];
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    std::string exception;
+};
+
+char EpochInterruptionTest::global_heap_buf[512 * 1024];
+
+TEST_P(EpochInterruptionTest, no_deadline)
+{
+    uint32 argv[1] = { 100000 }, i;
+
+    for (i = 0; i < 10; i++)
+        wasm_runtime_increment_epoch();
+    EXPECT_TRUE(call(module_inst, exec_env, "loop", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 100000u);
+}
+
+TEST_P(EpochInterruptionTest, deadline_already_reached)
+{
+    uint32 argv[1] = { 1000 };
+
+    wasm_runtime_set_epoch_deadline(module_inst, 0);
+    EXPECT_FALSE(call(module_inst, exec_env, "spin", 0, NULL));
+    EXPECT_EQ(exception, "Exception: epoch deadline reached");
+    EXPECT_FALSE(call(module_inst, exec_env, "loop", 1, argv));
+    EXPECT_EQ(exception, "Exception: epoch deadline reached");
+
+    /* It runs again once the deadline is moved */
+    wasm_runtime_set_epoch_deadline(module_inst, 1000000);
+    argv[0] = 1000;
+    EXPECT_TRUE(call(module_inst, exec_env, "loop", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 1000u);
+}
+
+TEST_P(EpochInterruptionTest, infinite_loop_interrupted)
+{
+    EpochTicker ticker;
+
+    wasm_runtime_set_epoch_deadline(module_inst, 5);
+    EXPECT_FALSE(call(module_inst, exec_env, "spin", 0, NULL));
+    EXPECT_EQ(exception, "Exception: epoch deadline reached");
+}
+
+TEST_P(EpochInterruptionTest, callback_extends_deadline)
+{
+    DeadlineCallbackData data = { 0, 3 };
+    EpochTicker ticker;
+
+    wasm_runtime_set_epoch_deadline_callback(module_inst, deadline_callback,
+                                             &data);
+    wasm_runtime_set_epoch_deadline(module_inst, 1);
+    EXPECT_FALSE(call(module_inst, exec_env, "spin", 0, NULL));
+    EXPECT_EQ(exception, "Exception: epoch deadline reached");
+    EXPECT_EQ(data.calls, 4u);
+}
+
+TEST_P(EpochInterruptionTest, deadline_per_instance)
+{
+    wasm_module_inst_t module_inst2;
+    wasm_exec_env_t exec_env2;
+    uint32 argv[1] = { 1000 };
+
+    module_inst2 = instantiate();
+    ASSERT_NE(module_inst2, nullptr) << error_buf;
+    exec_env2 = wasm_runtime_create_exec_env(module_inst2, 8192);
+    ASSERT_NE(exec_env2, nullptr);
+
+    /* Only the instance whose deadline is reached is interrupted */
+    wasm_runtime_set_epoch_deadline(module_inst, 0);
+    EXPECT_TRUE(call(module_inst2, exec_env2, "loop", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 1000u);
+    EXPECT_FALSE(call(module_inst, exec_env, "spin", 0, NULL));
+    EXPECT_EQ(exception, "Exception: epoch deadline reached");
+
+    wasm_runtime_destroy_exec_env(exec_env2);
+    wasm_runtime_deinstantiate(module_inst2);
+}
+
+INSTANTIATE_TEST_SUITE_P(RunningMode, EpochInterruptionTest,
+                         testing::Values(Test_Interp, Test_LLVM_JIT,
+                                         Test_AOT));
@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2024 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#if WASM_ENABLE_JIT != 0
+#include "aot_export.h"
+#endif
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (type $r (func (result i32)))
+ *   (table 1 funcref)
+ *   (elem (i32.const 0) $throw_7)
+ *   (tag $e (param i32))
+ *   (tag $e2 (param i64 i32))
+ *   (func $throw (param i32) (throw $e (local.get 0)))
+ *   (func $recurse (param i32) (result i32)
+ *     (if (i32.eqz (local.get 0)) (then (throw $e (i32.const 42))))
+ *     (call $recurse (i32.sub (local.get 0) (i32.const 1))))
+ *   (func $throw_7 (type $r) (throw $e (i32.const 7)))
+ *   (func $tail_call (result i32)
+ *     try (result i32)
+ *       (return_call_indirect (type $r) (i32.const 0))
+ *     catch $e
+ *       (i32.add (i32.const 100))
+ *     end)
+ *   (func $delegate_to_caller (result i32)
+ *     try (result i32)
+ *       (call $throw (i32.const 6)) (i32.const 0)
+ *     delegate 0)
+ *   (func (export "catch_from_callee") (result i32)
+ *     try (result i32)
+ *       (call $throw (i32.const 5)) (i32.const 0)
+ *     catch $e
+ *       (i32.add (i32.const 1))
+ *     end)
+ *   (func (export "catch_all") (result i32)
+ *     try (result i32)
+ *       (call $throw (i32.const 3)) (i32.const 0)
+ *     catch $e2
+ *       drop drop (i32.const 50)
+ *     catch_all
+ *       (i32.const 77)
+ *     end)
+ *   (func (export "multi_value") (result i32) (local i32)
+ *     try (result i32)
+ *       (throw $e2 (i64.const 0x100000002) (i32.const 9))
+ *     catch $e2
+ *       (local.set 0) (i32.wrap_i64) (i32.add (local.get 0))
+ *     end)
+ *   (func (export "rethrow") (result i32)
+ *     try (result i32)
+ *       try (result i32)
+ *         (throw $e (i32.const 4))
+ *       catch $e
+ *         drop (rethrow 0)
+ *       end
+ *     catch $e
+ *       (i32.add (i32.const 1000))
+ *     end)
+ *   (func (export "rethrow_outer") (result i32)
+ *     try (result i32)
+ *       try (result i32)
+ *         (throw $e (i32.const 21))
+ *       catch $e
+ *         drop (block (rethrow 1)) (i32.const 0)
+ *       end
+ *     catch $e
+ *     end)
+ *   (func (export "delegate") (result i32)
+ *     try (result i32)
+ *       try (result i32)
+ *         (call $throw (i32.const 8)) (i32.const 0)
+ *       delegate 0
+ *     catch $e
+ *       (i32.mul (i32.const 2))
+ *     end)
+ *   (func (export "delegate_to_caller") (result i32)
+ *     try (result i32) (call $delegate_to_caller) catch $e end)
+ *   (func (export "unwind_frames") (result i32)
+ *     try (result i32) (call $recurse (i32.const 5)) catch $e end)
+ *   (func (export "tail_call") (result i32)
+ *     try (result i32)
+ *       (call $tail_call)
+ *     catch $e
+ *       (i32.add (i32.const 200))
+ *     end)
+ *   (func (export "uncaught") (result i32)
+ *     (call $throw (i32.const 1)) (i32.const 0))
+ *   (func (export "trap") (result i32)
+ *     try (result i32) unreachable catch_all (i32.const 1) end))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x13, 0x04, 0x60,
+    0x00, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x00, 0x60, 0x02, 0x7e, 0x7f, 0x00,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x11, 0x10, 0x01, 0x03, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x04, 0x01, 0x70, 0x00, 0x01, 0x0d, 0x05, 0x02, 0x00, 0x01, 0x00,
+    0x02, 0x07, 0x97, 0x01, 0x0b, 0x11, 0x63, 0x61, 0x74, 0x63, 0x68, 0x5f,
+    0x66, 0x72, 0x6f, 0x6d, 0x5f, 0x63, 0x61, 0x6c, 0x6c, 0x65, 0x65, 0x00,
+    0x05, 0x09, 0x63, 0x61, 0x74, 0x63, 0x68, 0x5f, 0x61, 0x6c, 0x6c, 0x00,
+    0x06, 0x0b, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x5f, 0x76, 0x61, 0x6c, 0x75,
+    0x65, 0x00, 0x07, 0x07, 0x72, 0x65, 0x74, 0x68, 0x72, 0x6f, 0x77, 0x00,
+    0x08, 0x0d, 0x72, 0x65, 0x74, 0x68, 0x72, 0x6f, 0x77, 0x5f, 0x6f, 0x75,
+    0x74, 0x65, 0x72, 0x00, 0x09, 0x08, 0x64, 0x65, 0x6c, 0x65, 0x67, 0x61,
+    0x74, 0x65, 0x00, 0x0a, 0x12, 0x64, 0x65, 0x6c, 0x65, 0x67, 0x61, 0x74,
+    0x65, 0x5f, 0x74, 0x6f, 0x5f, 0x63, 0x61, 0x6c, 0x6c, 0x65, 0x72, 0x00,
+    0x0b, 0x0d, 0x75, 0x6e, 0x77, 0x69, 0x6e, 0x64, 0x5f, 0x66, 0x72, 0x61,
+    0x6d, 0x65, 0x73, 0x00, 0x0c, 0x09, 0x74, 0x61, 0x69, 0x6c, 0x5f, 0x63,
+    0x61, 0x6c, 0x6c, 0x00, 0x0d, 0x08, 0x75, 0x6e, 0x63, 0x61, 0x75, 0x67,
+    0x68, 0x74, 0x00, 0x0e, 0x04, 0x74, 0x72, 0x61, 0x70, 0x00, 0x0f, 0x09,
+    0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x02, 0x0a, 0xff, 0x01, 0x10,
+    0x06, 0x00, 0x20, 0x00, 0x08, 0x00, 0x0b, 0x13, 0x00, 0x20, 0x00, 0x45,
+    0x04, 0x40, 0x41, 0x2a, 0x08, 0x00, 0x0b, 0x20, 0x00, 0x41, 0x01, 0x6b,
+    0x10, 0x01, 0x0b, 0x06, 0x00, 0x41, 0x07, 0x08, 0x00, 0x0b, 0x10, 0x00,
+    0x06, 0x7f, 0x41, 0x00, 0x13, 0x00, 0x00, 0x07, 0x00, 0x41, 0xe4, 0x00,
+    0x6a, 0x0b, 0x0b, 0x0c, 0x00, 0x06, 0x7f, 0x41, 0x06, 0x10, 0x00, 0x41,
+    0x00, 0x18, 0x00, 0x0b, 0x10, 0x00, 0x06, 0x7f, 0x41, 0x05, 0x10, 0x00,
+    0x41, 0x00, 0x07, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x0b, 0x15, 0x00, 0x06,
+    0x7f, 0x41, 0x03, 0x10, 0x00, 0x41, 0x00, 0x07, 0x01, 0x1a, 0x1a, 0x41,
+    0x32, 0x19, 0x41, 0xcd, 0x00, 0x0b, 0x0b, 0x19, 0x01, 0x01, 0x7f, 0x06,
+    0x7f, 0x42, 0x82, 0x80, 0x80, 0x80, 0x10, 0x41, 0x09, 0x08, 0x01, 0x07,
+    0x01, 0x21, 0x00, 0xa7, 0x20, 0x00, 0x6a, 0x0b, 0x0b, 0x17, 0x00, 0x06,
+    0x7f, 0x06, 0x7f, 0x41, 0x04, 0x08, 0x00, 0x07, 0x00, 0x1a, 0x09, 0x00,
+    0x0b, 0x07, 0x00, 0x41, 0xe8, 0x07, 0x6a, 0x0b, 0x0b, 0x18, 0x00, 0x06,
+    0x7f, 0x06, 0x7f, 0x41, 0x15, 0x08, 0x00, 0x07, 0x00, 0x1a, 0x02, 0x40,
+    0x09, 0x01, 0x0b, 0x41, 0x00, 0x0b, 0x07, 0x00, 0x0b, 0x0b, 0x14, 0x00,
+    0x06, 0x7f, 0x06, 0x7f, 0x41, 0x08, 0x10, 0x00, 0x41, 0x00, 0x18, 0x00,
+    0x07, 0x00, 0x41, 0x02, 0x6c, 0x0b, 0x0b, 0x09, 0x00, 0x06, 0x7f, 0x10,
+    0x04, 0x07, 0x00, 0x0b, 0x0b, 0x0b, 0x00, 0x06, 0x7f, 0x41, 0x05, 0x10,
+    0x01, 0x07, 0x00, 0x0b, 0x0b, 0x0d, 0x00, 0x06, 0x7f, 0x10, 0x03, 0x07,
+    0x00, 0x41, 0xc8, 0x01, 0x6a, 0x0b, 0x0b, 0x08, 0x00, 0x41, 0x01, 0x10,
+    0x00, 0x41, 0x00, 0x0b, 0x09, 0x00, 0x06, 0x7f, 0x00, 0x19, 0x41, 0x01,
+    0x0b, 0x0b,
+};
+
+/* The interpreter is the fast interpreter unless LLVM JIT is enabled, in
+   which case it is the classic interpreter */
+enum TestMode { Test_Interp, Test_LLVM_JIT, Test_AOT };
+
+class ExceptionHandlingModesTest : public testing::TestWithParam<TestMode>
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+#if WASM_ENABLE_JIT != 0
+        if (GetParam() == Test_AOT) {
+            ASSERT_TRUE(compile_aot());
+            wasm_runtime_unload(module);
+            module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                       sizeof(error_buf));
+            ASSERT_NE(module, nullptr) << error_buf;
+        }
+#endif
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        if (GetParam() != Test_AOT) {
+            ASSERT_TRUE(wasm_runtime_set_running_mode(
+                module_inst, GetParam() == Test_Interp ? Mode_Interp
+                                                       : Mode_LLVM_JIT));
+        }
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+    }
+
+#if WASM_ENABLE_JIT != 0
+    /* Compile the wasm module to an AOT file with tail calls enabled */
+    bool compile_aot()
+    {
+        AOTCompOption option = { 0 };
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.enable_tail_call = true;
+
+        if (!(comp_data = aot_create_comp_data(module, NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+#endif
+
+    /* Call the function, return its i32 result, or the exception message
+       in `exception` and 0 if it doesn't return */
+    uint32 call(const char *name)
+    {
+        wasm_function_inst_t func;
+        uint32 argv[1] = { 0 };
+
+        exception.clear();
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_NE(func, nullptr) << name;
+        if (!wasm_runtime_call_wasm(exec_env, func, 0, argv)) {
+            exception = wasm_runtime_get_exception(module_inst);
+            wasm_runtime_clear_exception(module_inst);
+            return 0;
+        }
+        return argv[0];
+    }
+
+  public:
+    static char global_heap_buf[512 * 1024];
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    std::string exception;
+};
+
+char ExceptionHandlingModesTest::global_heap_buf[512 * 1024];
+
+TEST_P(ExceptionHandlingModesTest, catch_from_callee)
+{
+    EXPECT_EQ(call("catch_from_callee"), 6u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, catch_all)
+{
+    EXPECT_EQ(call("catch_all"), 77u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, multi_value)
+{
+    EXPECT_EQ(call("multi_value"), 11u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, rethrow)
+{
+    /* The values of the exception are kept while rethrowing it */
+    EXPECT_EQ(call("rethrow"), 1004u) << exception;
+    EXPECT_EQ(call("rethrow_outer"), 21u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, delegate)
+{
+    EXPECT_EQ(call("delegate"), 16u) << exception;
+    /* delegate to the function level passes the exception to the caller */
+    EXPECT_EQ(call("delegate_to_caller"), 6u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, unwind_frames)
+{
+    EXPECT_EQ(call("unwind_frames"), 42u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, tail_call_in_try)
+{
+    /* The try block of the function making the tail call no longer
+       exists when the callee throws */
+    EXPECT_EQ(call("tail_call"), 207u) << exception;
+}
+
+TEST_P(ExceptionHandlingModesTest, uncaught_and_trap)
+{
+    call("uncaught");
+    EXPECT_EQ(exception, "Exception: uncaught wasm exception");
+    /* Traps aren't caught by catch_all */
+    call("trap");
+    EXPECT_EQ(exception, "Exception: unreachable");
+    /* The instance still runs after them */
+    EXPECT_EQ(call("catch_from_callee"), 6u) << exception;
+}
+
+#if WASM_ENABLE_JIT != 0
+INSTANTIATE_TEST_SUITE_P(RunningMode, ExceptionHandlingModesTest,
+                         testing::Values(Test_Interp, Test_LLVM_JIT,
+                                         Test_AOT));
+#else
+INSTANTIATE_TEST_SUITE_P(RunningMode, ExceptionHandlingModesTest,
+                         testing::Values(Test_Interp));
+#endif
@@ -159,3 +159,79 @@ TEST_F(ExceptionHandlingTest, rethrow_handles_invalid_tagindex_like_throw)
     EXPECT_TRUE(exception_tag_index >= tag_count)
         << "INVALID_TAGINDEX should be >= any reasonable tag_count";
 }
+
+/*
+ * Test that the lookup of the handlers of a try block skips the tag index
+ * of the catch of a nested try block. Tag index 11 is encoded as 0x0B,
+ * which would otherwise be taken as the end of the nested block, and the
+ * catch_all of the outer try block wouldn't be found.
+ */
+TEST_F(ExceptionHandlingTest, nested_catch_tag_index_skipped)
+{
+    /*
+     * (module
+     *   (tag) ... (tag)  ;; 12 tags
+     *   (func (export "f") (result i32)
+     *     try (result i32)
+     *       try
+     *         throw 11
+     *       catch 11
+     *       end
+     *       throw 0
+     *     catch_all
+     *       i32.const 2
+     *     end))
+     */
+    uint8_t wasm_eh[] = {
+        0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00,
+        /* Type section: () -> (), () -> i32 */
+        0x01, 0x08, 0x02, 0x60, 0x00, 0x00, 0x60, 0x00, 0x01, 0x7F,
+        /* Function section: 1 func, type 1 */
+        0x03, 0x02, 0x01, 0x01,
+        /* Tag section (id=13): 12 tags, attribute=0, type=0 */
+        0x0D, 0x19, 0x0C,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        /* Export: "f" = func 0 */
+        0x07, 0x05, 0x01, 0x01, 0x66, 0x00, 0x00,
+        /* Code section */
+        0x0A, 0x13, 0x01,
+        0x11, 0x00,       /* body size=17, 0 locals */
+        0x06, 0x7F,       /* try (result i32) */
+        0x06, 0x40,       /* try (void) */
+        0x08, 0x0B,       /* throw 11 */
+        0x07, 0x0B,       /* catch 11 */
+        0x0B,             /* end try */
+        0x08, 0x00,       /* throw 0 */
+        0x19,             /* catch_all */
+        0x41, 0x02,       /* i32.const 2 */
+        0x0B,             /* end try */
+        0x0B,             /* end func */
+    };
+    uint32 argv[1] = { 0 };
+
+    memset(error_buf, 0, sizeof(error_buf));
+    wasm_module_t module = wasm_runtime_load(
+        wasm_eh, sizeof(wasm_eh), error_buf, sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << "Module load failed: " << error_buf;
+
+    wasm_module_inst_t inst = wasm_runtime_instantiate(
+        module, 8192, 8192, error_buf, sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << "Instantiation failed: " << error_buf;
+
+    wasm_function_inst_t func = wasm_runtime_lookup_function(inst, "f");
+    ASSERT_NE(func, nullptr) << "Function 'f' should be found";
+
+    wasm_exec_env_t exec_env = wasm_runtime_create_exec_env(inst, 8192);
+    ASSERT_NE(exec_env, nullptr) << "Failed to create exec env";
+
+    bool ok = wasm_runtime_call_wasm(exec_env, func, 0, argv);
+    ASSERT_TRUE(ok) << "wasm_runtime_call_wasm failed: "
+                    << wasm_runtime_get_exception(inst);
+    EXPECT_EQ(argv[0], 2u) << "The exception should be caught by catch_all";
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(inst);
+    wasm_runtime_unload(module);
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "wasm_runtime.h"
+#include "ems_gc_internal.h"
+
+/* (module) */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+};
+
+class GCLazySweepTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        /* The GC reclaim of the heap is enabled with the exec_env */
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        heap = (gc_heap_t *)((WASMModuleInstance *)module_inst)
+                   ->e->common.gc_heap_handle;
+        ASSERT_NE(heap, nullptr);
+        ASSERT_FALSE(gc_is_sweeping(heap));
+    }
+
+    virtual void TearDown()
+    {
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+        wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    /* Allocate an unreachable WO, which is reclaimed by the next GC */
+    void *alloc_garbage(gc_size_t size)
+    {
+        void *obj = gc_alloc_wo(heap, size);
+
+        if (obj)
+            memset(obj, 0, size);
+        return obj;
+    }
+
+    void *alloc_vo(gc_size_t size, uint8 pattern)
+    {
+        void *obj = gc_alloc_vo(heap, size);
+
+        if (obj)
+            memset(obj, pattern, size);
+        return obj;
+    }
+
+    bool check_vo(void *obj, gc_size_t size, uint8 pattern)
+    {
+        gc_size_t i;
+
+        for (i = 0; i < size; i++) {
+            if (((uint8 *)obj)[i] != pattern)
+                return false;
+        }
+        return true;
+    }
+
+    gc_size_t hmu_size_of(void *obj)
+    {
+        return hmu_get_size(obj_to_hmu((gc_object_t)obj));
+    }
+
+    /* Fill the heap with garbage until the next allocation triggers GC */
+    void fill_with_garbage()
+    {
+        while (heap->total_free_size > heap->gc_threshold + 1024)
+            ASSERT_NE(alloc_garbage(128), nullptr);
+    }
+
+    void finish_sweep()
+    {
+        os_mutex_lock(&heap->lock);
+        if (gc_is_sweeping(heap))
+            gci_sweep_heap_step(heap, 0);
+        os_mutex_unlock(&heap->lock);
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    gc_heap_t *heap = nullptr;
+};
+
+TEST_F(GCLazySweepTest, gc_defers_sweeping)
+{
+    ASSERT_NE(alloc_garbage(128), nullptr);
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+
+    /* Only marked, nothing is reclaimed yet */
+    EXPECT_TRUE(gc_is_sweeping(heap));
+    EXPECT_EQ(heap->sweep_offset, 0u);
+    EXPECT_EQ(heap->total_free_size, 0u);
+
+    finish_sweep();
+    EXPECT_FALSE(gc_is_sweeping(heap));
+    EXPECT_EQ(heap->total_free_size, heap->current_size);
+}
+
+TEST_F(GCLazySweepTest, allocation_sweeps_step_by_step)
+{
+    void *vos[64], *obj;
+    gc_size_t live_size = 0;
+    uint32 vo_count = 0, i;
+
+    /* A step stops at the first live hmu after its budget, keep a live
+       VO every 4KB */
+    while (heap->total_free_size > heap->gc_threshold + 4096
+           && vo_count < 64) {
+        vos[vo_count] = alloc_vo(64, (uint8)vo_count);
+        ASSERT_NE(vos[vo_count], nullptr);
+        live_size += hmu_size_of(vos[vo_count]);
+        vo_count++;
+        for (i = 0; i < 30; i++)
+            ASSERT_NE(alloc_garbage(128), nullptr);
+    }
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_TRUE(gc_is_sweeping(heap));
+
+    /* The allocation sweeps only a part of the heap */
+    obj = alloc_garbage(128);
+    ASSERT_NE(obj, nullptr);
+    live_size += hmu_size_of(obj);
+    EXPECT_TRUE(gc_is_sweeping(heap));
+    EXPECT_GE(heap->sweep_offset, (gc_size_t)GC_LAZY_SWEEP_STEP_SIZE);
+    EXPECT_LE(heap->sweep_offset, (gc_size_t)GC_LAZY_SWEEP_STEP_SIZE + 8192);
+    EXPECT_LT((gc_uint8 *)obj, heap->base_addr + heap->sweep_offset);
+
+    /* The live objects are kept */
+    finish_sweep();
+    EXPECT_EQ(heap->total_free_size, heap->current_size - live_size);
+    for (i = 0; i < vo_count; i++) {
+        EXPECT_TRUE(check_vo(vos[i], 64, (uint8)i));
+        gc_free_vo(heap, vos[i]);
+    }
+}
+
+TEST_F(GCLazySweepTest, free_vo_not_swept)
+{
+    gc_size_t live_size;
+    void *vo1, *vo2, *obj;
+
+    vo1 = alloc_vo(64, 0x11);
+    ASSERT_NE(vo1, nullptr);
+    fill_with_garbage();
+    /* At the end of the heap, far from the first sweep step */
+    vo2 = alloc_vo(64, 0x22);
+    ASSERT_NE(vo2, nullptr);
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    obj = alloc_garbage(128);
+    ASSERT_NE(obj, nullptr);
+    ASSERT_TRUE(gc_is_hmu_unswept(heap, obj_to_hmu((gc_object_t)vo2)));
+
+    /* It is only flagged as freed and reclaimed by the sweeper */
+    EXPECT_EQ(gc_free_vo(heap, vo2), GC_SUCCESS);
+    EXPECT_TRUE(hmu_is_vo_freed(obj_to_hmu((gc_object_t)vo2)));
+
+    live_size = hmu_size_of(vo1) + hmu_size_of(obj);
+    finish_sweep();
+    EXPECT_EQ(heap->total_free_size, heap->current_size - live_size);
+    EXPECT_TRUE(check_vo(vo1, 64, 0x11));
+
+    /* The vo swept is freed to the heap directly */
+    EXPECT_EQ(gc_free_vo(heap, vo1), GC_SUCCESS);
+    EXPECT_EQ(heap->total_free_size, heap->current_size - hmu_size_of(obj));
+}
+
+TEST_F(GCLazySweepTest, sweep_finished_before_next_gc)
+{
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_TRUE(gc_is_sweeping(heap));
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    EXPECT_TRUE(gc_is_sweeping(heap));
+    EXPECT_EQ(heap->sweep_offset, 0u);
+    finish_sweep();
+    EXPECT_EQ(heap->total_free_size, heap->current_size);
+}
+
+TEST_F(GCLazySweepTest, allocate_through_many_gcs)
+{
+    void *vos[8];
+    uint32 i;
+
+    for (i = 0; i < 8; i++) {
+        vos[i] = alloc_vo(32 + i * 8, (uint8)i);
+        ASSERT_NE(vos[i], nullptr);
+    }
+    /* Allocate about 16 times of the heap size */
+    for (i = 0; i < heap->current_size / 8; i++) {
+        ASSERT_NE(alloc_garbage(64 + (i % 8) * 16), nullptr);
+        if (i % 1000 == 0) {
+            /* Free and allocate again in both the parts swept and not */
+            gc_free_vo(heap, vos[i / 1000 % 8]);
+            vos[i / 1000 % 8] =
+                alloc_vo(32 + (i / 1000 % 8) * 8, (uint8)(i / 1000 % 8));
+            ASSERT_NE(vos[i / 1000 % 8], nullptr);
+        }
+    }
+
+    for (i = 0; i < 8; i++) {
+        EXPECT_TRUE(check_vo(vos[i], 32 + i * 8, (uint8)i));
+        gc_free_vo(heap, vos[i]);
+    }
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    finish_sweep();
+    EXPECT_EQ(heap->total_free_size, heap->current_size);
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "wasm_runtime.h"
+#include "wasm_exec_env.h"
+#include "mem_alloc.h"
+#include "ems_gc_internal.h"
+
+/* (module) */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+};
+
+class GCTlabTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        /* The GC reclaim of the heap is enabled with the exec_env */
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        heap = get_heap(module_inst);
+        ASSERT_NE(heap, nullptr);
+        memset(&tlab, 0, sizeof(gc_tlab_t));
+    }
+
+    virtual void TearDown()
+    {
+        gc_retire_tlab(&tlab);
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    gc_heap_t *get_heap(wasm_module_inst_t inst)
+    {
+        return (gc_heap_t *)((WASMModuleInstance *)inst)
+            ->e->common.gc_heap_handle;
+    }
+
+    /* Allocate an unreachable WO, which is reclaimed by the next GC */
+    void *alloc_garbage(gc_tlab_t *tlab, gc_size_t size)
+    {
+        void *obj = gc_alloc_wo_tlab(heap, tlab, size);
+
+        if (obj)
+            memset(obj, 0, size);
+        return obj;
+    }
+
+    bool is_tlab_linked(gc_heap_t *heap, gc_tlab_t *tlab)
+    {
+        gc_tlab_t *p = heap->tlab_list;
+
+        while (p && p != tlab)
+            p = p->next;
+        return p != nullptr;
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    gc_heap_t *heap = nullptr;
+    gc_tlab_t tlab;
+};
+
+TEST_F(GCTlabTest, bump_allocation)
+{
+    uint8 *obj1, *obj2;
+    hmu_t *rest;
+
+    obj1 = (uint8 *)alloc_garbage(&tlab, 24);
+    ASSERT_NE(obj1, nullptr);
+    EXPECT_EQ(tlab.heap, (gc_handle_t)heap);
+    EXPECT_TRUE(is_tlab_linked(heap, &tlab));
+    EXPECT_EQ(hmu_get_ut(obj_to_hmu(obj1)), HMU_WO);
+
+    obj2 = (uint8 *)alloc_garbage(&tlab, 24);
+    ASSERT_NE(obj2, nullptr);
+    EXPECT_EQ(obj2, obj1 + hmu_get_size(obj_to_hmu(obj1)));
+    EXPECT_EQ((uint8 *)obj_to_hmu(obj2) + hmu_get_size(obj_to_hmu(obj2)),
+              tlab.top);
+
+    /* The rest of the TLAB is a freed VO so that the heap is walkable */
+    rest = (hmu_t *)tlab.top;
+    EXPECT_EQ(hmu_get_ut(rest), HMU_VO);
+    EXPECT_TRUE(hmu_is_vo_freed(rest));
+    EXPECT_EQ(tlab.top + hmu_get_size(rest),
+              tlab.limit + GC_TLAB_MIN_REST_SIZE);
+}
+
+TEST_F(GCTlabTest, large_object_from_heap)
+{
+    uint8 *top;
+
+    ASSERT_NE(alloc_garbage(&tlab, 24), nullptr);
+    top = tlab.top;
+    ASSERT_NE(alloc_garbage(&tlab, GC_TLAB_MAX_OBJ_SIZE + 8), nullptr);
+    EXPECT_EQ(tlab.top, top);
+}
+
+TEST_F(GCTlabTest, refill_when_exhausted)
+{
+    uint8 *limit;
+    uint32 i;
+
+    ASSERT_NE(alloc_garbage(&tlab, 24), nullptr);
+    limit = tlab.limit;
+    for (i = 0; i < 1000 && tlab.limit == limit; i++)
+        ASSERT_NE(alloc_garbage(&tlab, 64), nullptr);
+    EXPECT_NE(tlab.limit, limit);
+    /* The old buffer is unlinked and the new one is linked */
+    EXPECT_EQ(heap->tlab_list, &tlab);
+    EXPECT_EQ(tlab.next, nullptr);
+}
+
+TEST_F(GCTlabTest, retire_tlab)
+{
+    ASSERT_NE(alloc_garbage(&tlab, 24), nullptr);
+    gc_retire_tlab(&tlab);
+    EXPECT_EQ(tlab.heap, nullptr);
+    EXPECT_EQ(tlab.top, nullptr);
+    EXPECT_EQ(tlab.limit, nullptr);
+    EXPECT_FALSE(is_tlab_linked(heap, &tlab));
+    /* Retiring it again does nothing */
+    gc_retire_tlab(&tlab);
+
+    /* The rest of the buffer is reclaimed with the garbage */
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    EXPECT_EQ(heap->total_free_size, heap->current_size);
+}
+
+TEST_F(GCTlabTest, gc_retires_tlabs)
+{
+    gc_tlab_t tlab2;
+
+    memset(&tlab2, 0, sizeof(gc_tlab_t));
+    ASSERT_NE(alloc_garbage(&tlab, 24), nullptr);
+    ASSERT_NE(alloc_garbage(&tlab2, 24), nullptr);
+    EXPECT_TRUE(is_tlab_linked(heap, &tlab));
+    EXPECT_TRUE(is_tlab_linked(heap, &tlab2));
+
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    EXPECT_EQ(tlab.heap, nullptr);
+    EXPECT_EQ(tlab2.heap, nullptr);
+    EXPECT_EQ(heap->tlab_list, nullptr);
+    EXPECT_EQ(heap->total_free_size, heap->current_size);
+
+    /* The TLAB is refilled by the next allocation */
+    ASSERT_NE(alloc_garbage(&tlab, 24), nullptr);
+    EXPECT_EQ(tlab.heap, (gc_handle_t)heap);
+}
+
+TEST_F(GCTlabTest, allocate_through_many_gcs)
+{
+    uint32 i;
+
+    /* Allocate about 16 times of the heap size */
+    for (i = 0; i < heap->current_size / 4; i++)
+        ASSERT_NE(alloc_garbage(&tlab, 24 + (i % 8) * 8), nullptr);
+
+    gc_retire_tlab(&tlab);
+    EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    EXPECT_EQ(heap->total_free_size, heap->current_size);
+}
+
+TEST_F(GCTlabTest, heap_destroy_retires_tlabs)
+{
+    ASSERT_NE(alloc_garbage(&tlab, 24), nullptr);
+    wasm_runtime_destroy_exec_env(exec_env);
+    exec_env = nullptr;
+    wasm_runtime_deinstantiate(module_inst);
+    module_inst = nullptr;
+    heap = nullptr;
+
+    /* The TLAB doesn't refer to the heap destroyed */
+    EXPECT_EQ(tlab.heap, nullptr);
+    EXPECT_EQ(tlab.top, nullptr);
+    gc_retire_tlab(&tlab);
+}
+
+TEST_F(GCTlabTest, exec_env_retires_tlab)
+{
+    wasm_module_inst_t module_inst2;
+    void *obj;
+
+    obj = mem_allocator_malloc_with_gc_tlab(heap, &exec_env->gc_tlab, 24);
+    ASSERT_NE(obj, nullptr);
+    EXPECT_EQ(exec_env->gc_tlab.heap, (void *)heap);
+    EXPECT_TRUE(is_tlab_linked(heap, (gc_tlab_t *)&exec_env->gc_tlab));
+
+    /* Switching the module instance retires the TLAB of the old heap */
+    module_inst2 = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                            sizeof(error_buf));
+    ASSERT_NE(module_inst2, nullptr) << error_buf;
+    wasm_exec_env_set_module_inst(exec_env,
+                                  (WASMModuleInstanceCommon *)module_inst2);
+    EXPECT_EQ(exec_env->gc_tlab.heap, nullptr);
+    EXPECT_EQ(heap->tlab_list, nullptr);
+
+    obj = mem_allocator_malloc_with_gc_tlab(get_heap(module_inst2),
+                                            &exec_env->gc_tlab, 24);
+    ASSERT_NE(obj, nullptr);
+    EXPECT_EQ(exec_env->gc_tlab.heap, (void *)get_heap(module_inst2));
+    wasm_exec_env_set_module_inst(exec_env,
+                                  (WASMModuleInstanceCommon *)module_inst);
+    EXPECT_EQ(get_heap(module_inst2)->tlab_list, nullptr);
+    wasm_runtime_deinstantiate(module_inst2);
+
+    /* Destroying the exec_env retires its TLAB */
+    obj = mem_allocator_malloc_with_gc_tlab(heap, &exec_env->gc_tlab, 24);
+    ASSERT_NE(obj, nullptr);
+    EXPECT_TRUE(is_tlab_linked(heap, (gc_tlab_t *)&exec_env->gc_tlab));
+    wasm_runtime_destroy_exec_env(exec_env);
+    exec_env = nullptr;
+    EXPECT_EQ(heap->tlab_list, nullptr);
+}
@@ -92,4 +92,42 @@ TEST_F(WasmGCTest, Test_nested_struct)
     //FIXME: Revert the change when anyref support is added
     ASSERT_FALSE(load_wasm_file("nested_struct_field_any.wasm"));
     ASSERT_FALSE(load_wasm_file("nested_array_elem_any.wasm"));
-}
\ No newline at end of file
+}
+TEST_F(WasmGCTest, Test_call_indirect_subtype)
+{
+    const char *funcs[] = { "call_super", "call_same", "call_other" };
+    uint32 argv[1], i;
+    bool ret;
+
+    ASSERT_TRUE(load_wasm_file("call_indirect_subtype.wasm")) << error_buf;
+    module_inst = wasm_runtime_instantiate(module, 8192, 8192, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_NE(module_inst, nullptr) << error_buf;
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_NE(exec_env, nullptr);
+
+    for (i = 0; i < sizeof(funcs) / sizeof(funcs[0]); i++) {
+        func_inst = wasm_runtime_lookup_function(module_inst, funcs[i]);
+        ASSERT_NE(func_inst, nullptr) << funcs[i];
+        argv[0] = 0;
+        ret = wasm_runtime_call_wasm(exec_env, func_inst, 0, argv);
+        if (i < 2) {
+            /* The callee type is a subtype of the type expected */
+            EXPECT_TRUE(ret) << funcs[i] << ": "
+                             << wasm_runtime_get_exception(module_inst);
+            EXPECT_EQ(argv[0], 42u) << funcs[i];
+        }
+        else {
+            EXPECT_FALSE(ret) << funcs[i];
+            EXPECT_NE(strstr(wasm_runtime_get_exception(module_inst),
+                             "indirect call type mismatch"),
+                      nullptr)
+                << funcs[i];
+            wasm_runtime_clear_exception(module_inst);
+        }
+    }
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+}
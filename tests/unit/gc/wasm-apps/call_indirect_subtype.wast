@@ -0,0 +1,24 @@
+(module
+  (type $t0 (sub (func (result i32))))
+  (type $t1 (sub $t0 (func (result i32))))
+  (type $t2 (func (result i32)))
+
+  (table 1 funcref)
+  (elem (i32.const 0) $f)
+
+  (func $f (type $t1) (i32.const 42))
+
+  ;; the callee type is a subtype of the type expected
+  (func (export "call_super") (type $t0)
+    (call_indirect (type $t0) (i32.const 0))
+  )
+
+  (func (export "call_same") (type $t0)
+    (call_indirect (type $t1) (i32.const 0))
+  )
+
+  ;; the same structure, but not a supertype of the callee type
+  (func (export "call_other") (type $t0)
+    (call_indirect (type $t2) (i32.const 0))
+  )
+)
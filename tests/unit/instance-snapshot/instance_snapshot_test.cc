@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (memory 1)
+ *   (global $g (mut i32) (i32.const 0))
+ *   (func $start (global.set $g (i32.add (global.get $g) (i32.const 1))))
+ *   (start $start)
+ *   (func (export "bump")
+ *     (global.set $g (i32.add (global.get $g) (i32.const 10)))
+ *     (i32.store (i32.const 0) (global.get $g)))
+ *   (func (export "get_global") (result i32) (global.get $g))
+ *   (func (export "load") (param i32) (result i32)
+ *     (i32.load (local.get 0)))
+ *   (data (i32.const 0) "\2a"))
+ */
+static uint8_t snapshot_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0d, 0x03, 0x60,
+    0x00, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03,
+    0x05, 0x04, 0x00, 0x00, 0x01, 0x02, 0x05, 0x03, 0x01, 0x00, 0x01, 0x06,
+    0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x1c, 0x03, 0x04, 0x62,
+    0x75, 0x6d, 0x70, 0x00, 0x01, 0x0a, 0x67, 0x65, 0x74, 0x5f, 0x67, 0x6c,
+    0x6f, 0x62, 0x61, 0x6c, 0x00, 0x02, 0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00,
+    0x03, 0x08, 0x01, 0x00, 0x0a, 0x29, 0x04, 0x09, 0x00, 0x23, 0x00, 0x41,
+    0x01, 0x6a, 0x24, 0x00, 0x0b, 0x10, 0x00, 0x23, 0x00, 0x41, 0x0a, 0x6a,
+    0x24, 0x00, 0x41, 0x00, 0x23, 0x00, 0x36, 0x02, 0x00, 0x0b, 0x04, 0x00,
+    0x23, 0x00, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x0b,
+    0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x2a,
+};
+
+class InstanceSnapshotTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        /* The loader may modify the buffer, load from a copy */
+        memcpy(wasm_buf, snapshot_wasm, sizeof(snapshot_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+    }
+
+    virtual void TearDown()
+    {
+        if (module)
+            wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    uint32_t call_i32(wasm_module_inst_t inst, const char *name,
+                      uint32_t arg = 0)
+    {
+        wasm_function_inst_t func;
+        wasm_exec_env_t exec_env;
+        uint32_t argv[1] = { arg };
+        bool ret;
+
+        func = wasm_runtime_lookup_function(inst, name);
+        EXPECT_NE(func, nullptr);
+        exec_env = wasm_runtime_get_exec_env_singleton(inst);
+        EXPECT_NE(exec_env, nullptr);
+        ret = wasm_runtime_call_wasm(exec_env, func,
+                                     wasm_func_get_param_count(func, inst),
+                                     argv);
+        EXPECT_TRUE(ret) << wasm_runtime_get_exception(inst);
+        return argv[0];
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(snapshot_wasm)];
+    wasm_module_t module = nullptr;
+};
+
+TEST_F(InstanceSnapshotTest, restore_captured_state)
+{
+    wasm_module_inst_t inst, restored;
+    wasm_instance_snapshot_t snapshot;
+
+    inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    EXPECT_EQ(call_i32(inst, "get_global"), 1u);
+    EXPECT_EQ(call_i32(inst, "load", 0), 42u);
+    call_i32(inst, "bump");
+
+    snapshot = wasm_runtime_create_instance_snapshot(inst, error_buf,
+                                                     sizeof(error_buf));
+    ASSERT_NE(snapshot, nullptr) << error_buf;
+    /* The snapshot is independent from the captured instance */
+    wasm_runtime_deinstantiate(inst);
+
+    restored = wasm_runtime_instantiate_from_snapshot(snapshot, NULL,
+                                                      error_buf,
+                                                      sizeof(error_buf));
+    ASSERT_NE(restored, nullptr) << error_buf;
+    /* Neither the start function nor the data segment initialization
+       is run again */
+    EXPECT_EQ(call_i32(restored, "get_global"), 11u);
+    EXPECT_EQ(call_i32(restored, "load", 0), 11u);
+
+    wasm_runtime_deinstantiate(restored);
+    wasm_runtime_destroy_instance_snapshot(snapshot);
+}
+
+TEST_F(InstanceSnapshotTest, restored_instances_are_isolated)
+{
+    wasm_module_inst_t inst, restored1, restored2;
+    wasm_instance_snapshot_t snapshot;
+
+    inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    snapshot = wasm_runtime_create_instance_snapshot(inst, error_buf,
+                                                     sizeof(error_buf));
+    ASSERT_NE(snapshot, nullptr) << error_buf;
+
+    restored1 = wasm_runtime_instantiate_from_snapshot(snapshot, NULL,
+                                                       error_buf,
+                                                       sizeof(error_buf));
+    ASSERT_NE(restored1, nullptr) << error_buf;
+    restored2 = wasm_runtime_instantiate_from_snapshot(snapshot, NULL,
+                                                       error_buf,
+                                                       sizeof(error_buf));
+    ASSERT_NE(restored2, nullptr) << error_buf;
+
+    /* Writes of one instance are visible neither to the other instances
+       nor to the snapshot */
+    call_i32(restored1, "bump");
+    call_i32(restored1, "bump");
+    EXPECT_EQ(call_i32(restored1, "get_global"), 21u);
+    EXPECT_EQ(call_i32(restored1, "load", 0), 21u);
+    EXPECT_EQ(call_i32(restored2, "get_global"), 1u);
+    EXPECT_EQ(call_i32(restored2, "load", 0), 42u);
+    EXPECT_EQ(call_i32(inst, "load", 0), 42u);
+
+    wasm_runtime_deinstantiate(restored2);
+    restored2 = wasm_runtime_instantiate_from_snapshot(snapshot, NULL,
+                                                       error_buf,
+                                                       sizeof(error_buf));
+    ASSERT_NE(restored2, nullptr) << error_buf;
+    EXPECT_EQ(call_i32(restored2, "load", 0), 42u);
+
+    wasm_runtime_deinstantiate(restored2);
+    wasm_runtime_deinstantiate(restored1);
+    wasm_runtime_destroy_instance_snapshot(snapshot);
+    wasm_runtime_deinstantiate(inst);
+}
+
+TEST_F(InstanceSnapshotTest, reject_instance_with_app_heap)
+{
+    wasm_module_inst_t inst;
+    wasm_instance_snapshot_t snapshot;
+
+    inst = wasm_runtime_instantiate(module, 8192, 8192, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+
+    snapshot = wasm_runtime_create_instance_snapshot(inst, error_buf,
+                                                     sizeof(error_buf));
+    EXPECT_EQ(snapshot, nullptr);
+    EXPECT_NE(strstr(error_buf, "host managed heap"), nullptr) << error_buf;
+
+    wasm_runtime_deinstantiate(inst);
+}
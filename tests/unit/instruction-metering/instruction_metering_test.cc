@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (global $g (export "g") (mut i32) (i32.const 0))
+ *   (func (export "loop") (param $n i32) (result i32)
+ *     (local $i i32)
+ *     (loop $l
+ *       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+ *       (br_if $l (i32.lt_u (local.get $i) (local.get $n))))
+ *     (local.get $i))
+ *   (func (export "store")
+ *     (global.set $g (i32.const 1))
+ *     (block)
+ *     (global.set $g (i32.const 2))))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01,
+    0x06, 0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x14, 0x03, 0x04,
+    0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x00, 0x05, 0x73, 0x74, 0x6f, 0x72, 0x65,
+    0x00, 0x01, 0x01, 0x67, 0x03, 0x00, 0x0a, 0x27, 0x02, 0x17, 0x01, 0x01,
+    0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x20, 0x01,
+    0x20, 0x00, 0x49, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b, 0x0d, 0x00, 0x41,
+    0x01, 0x24, 0x00, 0x02, 0x40, 0x0b, 0x41, 0x02, 0x24, 0x00, 0x0b,
+};
+
+/* The opcodes executed by each iteration of the loop */
+#define LOOP_INSTRUCTIONS 8
+
+enum TestMode { Test_Interp, Test_LLVM_JIT, Test_AOT };
+
+struct LimitCallbackData {
+    uint32 calls;
+    uint32 refills;
+    int refill_count;
+};
+
+static bool
+limit_callback(wasm_exec_env_t exec_env, void *user_data)
+{
+    LimitCallbackData *data = (LimitCallbackData *)user_data;
+
+    /* What was left is consumed before the callback is called */
+    EXPECT_EQ(wasm_runtime_get_instruction_count_limit(exec_env), 0);
+    data->calls++;
+    if (data->refills == 0)
+        return false;
+    data->refills--;
+    wasm_runtime_set_instruction_count_limit(exec_env, data->refill_count);
+    return true;
+}
+
+class InstructionMeteringTest : public testing::TestWithParam<TestMode>
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        if (GetParam() == Test_AOT) {
+            ASSERT_TRUE(compile_aot());
+            wasm_runtime_unload(module);
+            module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                       sizeof(error_buf));
+            ASSERT_NE(module, nullptr) << error_buf;
+        }
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        if (GetParam() != Test_AOT) {
+            ASSERT_TRUE(wasm_runtime_set_running_mode(
+                module_inst,
+                GetParam() == Test_Interp ? Mode_Interp : Mode_LLVM_JIT));
+        }
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+        func = wasm_runtime_lookup_function(module_inst, "loop");
+        ASSERT_NE(func, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+    }
+
+    /* Compile the wasm module to an AOT file with instruction metering */
+    bool compile_aot()
+    {
+        AOTCompOption option = { 0 };
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.enable_instruction_metering = true;
+
+        if (!(comp_data = aot_create_comp_data(module, NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+
+    /* Run the loop n times, return the iterations run or -1 if it traps */
+    int32 run_loop(uint32 n)
+    {
+        uint32 argv[1] = { n };
+
+        exception.clear();
+        if (!wasm_runtime_call_wasm(exec_env, func, 1, argv)) {
+            exception = wasm_runtime_get_exception(module_inst);
+            wasm_runtime_clear_exception(module_inst);
+            return -1;
+        }
+        return (int32)argv[0];
+    }
+
+  public:
+    static char global_heap_buf[512 * 1024];
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    wasm_function_inst_t func = nullptr;
+    std::string exception;
+};
+
+char InstructionMeteringTest::global_heap_buf[512 * 1024];
+
+TEST_P(InstructionMeteringTest, no_limit)
+{
+    EXPECT_EQ(wasm_runtime_get_instruction_count_limit(exec_env), -1);
+    EXPECT_EQ(run_loop(1000), 1000);
+    EXPECT_EQ(wasm_runtime_get_instruction_count_limit(exec_env), -1);
+}
+
+TEST_P(InstructionMeteringTest, instructions_charged)
+{
+    int limit = 100000, left;
+
+    wasm_runtime_set_instruction_count_limit(exec_env, limit);
+    EXPECT_EQ(run_loop(1000), 1000);
+    left = wasm_runtime_get_instruction_count_limit(exec_env);
+    /* The counts are exact at the basic block level, allow the opcodes
+       around the loop */
+    EXPECT_LE(left, limit - 1000 * LOOP_INSTRUCTIONS);
+    EXPECT_GE(left, limit - 1000 * LOOP_INSTRUCTIONS - 16);
+}
+
+TEST_P(InstructionMeteringTest, limit_exceeded)
+{
+    wasm_runtime_set_instruction_count_limit(exec_env, 100);
+    EXPECT_EQ(run_loop(1000), -1);
+    EXPECT_EQ(exception, "Exception: instruction limit exceeded");
+    EXPECT_EQ(wasm_runtime_get_instruction_count_limit(exec_env), 0);
+
+    /* It runs again once the limit is refilled */
+    wasm_runtime_set_instruction_count_limit(exec_env, 100000);
+    EXPECT_EQ(run_loop(1000), 1000);
+}
+
+TEST_P(InstructionMeteringTest, callback_refills_limit)
+{
+    LimitCallbackData data = { 0, UINT32_MAX, 100 };
+    int left;
+
+    wasm_runtime_set_instruction_limit_callback(exec_env, limit_callback,
+                                                &data);
+    wasm_runtime_set_instruction_count_limit(exec_env, 100);
+    EXPECT_EQ(run_loop(1000), 1000) << exception;
+
+    /* It is called each time the 100 instructions are exhausted */
+    EXPECT_GE(data.calls, 1000 * LOOP_INSTRUCTIONS / 100 - 1);
+    EXPECT_LE(data.calls, 1000 * LOOP_INSTRUCTIONS / 100 + 1);
+    left = wasm_runtime_get_instruction_count_limit(exec_env);
+    EXPECT_GE(left, 0);
+    EXPECT_LE(left, 100);
+}
+
+TEST_P(InstructionMeteringTest, callback_declines)
+{
+    LimitCallbackData data = { 0, 2, 100 };
+
+    wasm_runtime_set_instruction_limit_callback(exec_env, limit_callback,
+                                                &data);
+    wasm_runtime_set_instruction_count_limit(exec_env, 100);
+    EXPECT_EQ(run_loop(1000), -1);
+    EXPECT_EQ(exception, "Exception: instruction limit exceeded");
+    EXPECT_EQ(data.calls, 3u);
+
+    /* The callback isn't called without a limit */
+    wasm_runtime_set_instruction_count_limit(exec_env, -1);
+    EXPECT_EQ(run_loop(1000), 1000);
+    EXPECT_EQ(data.calls, 3u);
+}
+
+TEST_P(InstructionMeteringTest, charged_at_block_entry)
+{
+    wasm_function_inst_t store;
+    wasm_global_inst_t global;
+
+    /* The first basic block of "store" has 4 opcodes and the second one
+       3. The limit is enough to run the first one, but the second one is
+       charged at its entry and none of its opcodes runs, while the
+       classic interpreter stops before its second opcode. */
+    store = wasm_runtime_lookup_function(module_inst, "store");
+    ASSERT_NE(store, nullptr);
+    ASSERT_TRUE(wasm_runtime_get_export_global_inst(module_inst, "g",
+                                                    &global));
+    wasm_runtime_set_instruction_count_limit(exec_env, 4);
+    EXPECT_FALSE(wasm_runtime_call_wasm(exec_env, store, 0, NULL));
+    EXPECT_STREQ(wasm_runtime_get_exception(module_inst),
+                 "Exception: instruction limit exceeded");
+    wasm_runtime_clear_exception(module_inst);
+    EXPECT_EQ(*(int32 *)global.global_data, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(RunningMode, InstructionMeteringTest,
+                         testing::Values(Test_Interp, Test_LLVM_JIT,
+                                         Test_AOT));
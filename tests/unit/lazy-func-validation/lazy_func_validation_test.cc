@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (func (export "good") (result i32) (i32.const 42))
+ *   ;; invalid: returns an i64 for an i32 result
+ *   (func $bad (export "bad") (result i32) (i64.const 0))
+ *   (func (export "call_bad") (result i32) (call $bad)))
+ */
+static uint8_t lazy_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x00, 0x01, 0x7f, 0x03, 0x04, 0x03, 0x00, 0x00, 0x00, 0x07, 0x19, 0x03,
+    0x04, 0x67, 0x6f, 0x6f, 0x64, 0x00, 0x00, 0x03, 0x62, 0x61, 0x64, 0x00,
+    0x01, 0x08, 0x63, 0x61, 0x6c, 0x6c, 0x5f, 0x62, 0x61, 0x64, 0x00, 0x02,
+    0x0a, 0x10, 0x03, 0x04, 0x00, 0x41, 0x2a, 0x0b, 0x04, 0x00, 0x42, 0x00,
+    0x0b, 0x04, 0x00, 0x10, 0x01, 0x0b,
+};
+
+class LazyFuncValidationTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        /* The loader may modify the buffer, load from a copy, which must
+           be kept until the module is unloaded since the function bodies
+           are validated later */
+        memcpy(wasm_buf, lazy_wasm, sizeof(lazy_wasm));
+    }
+
+    virtual void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    bool load(bool binary_freeable, bool prepare_exports_in_background)
+    {
+        LoadArgs args;
+
+        memset(&args, 0, sizeof(LoadArgs));
+        args.name = (char *)"";
+        args.wasm_binary_freeable = binary_freeable;
+        args.prepare_exports_in_background = prepare_exports_in_background;
+        module = wasm_runtime_load_ex(wasm_buf, sizeof(wasm_buf), &args,
+                                      error_buf, sizeof(error_buf));
+        return module != nullptr;
+    }
+
+    void instantiate()
+    {
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+    }
+
+    bool call_i32(const char *name, uint32_t *p_result)
+    {
+        wasm_function_inst_t func;
+        wasm_exec_env_t exec_env;
+        uint32_t argv[1] = { 0 };
+
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_NE(func, nullptr);
+        exec_env = wasm_runtime_get_exec_env_singleton(module_inst);
+        EXPECT_NE(exec_env, nullptr);
+        if (!wasm_runtime_call_wasm(exec_env, func, 0, argv))
+            return false;
+        *p_result = argv[0];
+        return true;
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(lazy_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+};
+
+TEST_F(LazyFuncValidationTest, invalid_body_fails_on_first_call)
+{
+    const char *exception;
+    uint32_t result = 0;
+
+    /* The invalid function body isn't validated while loading */
+    ASSERT_TRUE(load(false, false)) << error_buf;
+    instantiate();
+
+    EXPECT_TRUE(call_i32("good", &result));
+    EXPECT_EQ(result, 42u);
+
+    EXPECT_FALSE(call_i32("bad", &result));
+    exception = wasm_runtime_get_exception(module_inst);
+    ASSERT_NE(exception, nullptr);
+    EXPECT_NE(strstr(exception, "type mismatch"), nullptr) << exception;
+    wasm_runtime_clear_exception(module_inst);
+
+    /* The function isn't validated again once it failed */
+    EXPECT_FALSE(call_i32("bad", &result));
+    exception = wasm_runtime_get_exception(module_inst);
+    ASSERT_NE(exception, nullptr);
+    EXPECT_NE(strstr(exception, "failed to validate"), nullptr) << exception;
+    wasm_runtime_clear_exception(module_inst);
+
+    /* Neither is it when it is called by another function */
+    EXPECT_FALSE(call_i32("call_bad", &result));
+    exception = wasm_runtime_get_exception(module_inst);
+    ASSERT_NE(exception, nullptr);
+    EXPECT_NE(strstr(exception, "failed to validate"), nullptr) << exception;
+    wasm_runtime_clear_exception(module_inst);
+
+    /* The valid functions still run */
+    EXPECT_TRUE(call_i32("good", &result));
+    EXPECT_EQ(result, 42u);
+}
+
+TEST_F(LazyFuncValidationTest, freeable_binary_is_validated_eagerly)
+{
+    EXPECT_FALSE(load(true, false));
+    EXPECT_NE(strstr(error_buf, "type mismatch"), nullptr) << error_buf;
+}
+
+TEST_F(LazyFuncValidationTest, prepare_exports_in_background)
+{
+    const char *exception;
+    uint32_t result = 0;
+
+    ASSERT_TRUE(load(false, true)) << error_buf;
+    instantiate();
+
+    /* The results don't depend on whether the background thread has
+       prepared the functions yet */
+    EXPECT_TRUE(call_i32("good", &result));
+    EXPECT_EQ(result, 42u);
+    EXPECT_FALSE(call_i32("call_bad", &result));
+    exception = wasm_runtime_get_exception(module_inst);
+    ASSERT_NE(exception, nullptr);
+    EXPECT_TRUE(strstr(exception, "type mismatch")
+                || strstr(exception, "failed to validate"))
+        << exception;
+}
+
+TEST_F(LazyFuncValidationTest, unload_while_preparing_in_background)
+{
+    /* Unloading stops and joins the background thread */
+    ASSERT_TRUE(load(false, true)) << error_buf;
+    wasm_runtime_unload(module);
+    module = nullptr;
+}
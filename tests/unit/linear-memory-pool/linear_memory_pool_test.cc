@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+/* (module (memory 1)
+     (func (drop (memory.grow (i32.const 0))))), the memory.grow keeps
+   the loader from capping the memory at its initial size */
+static uint8_t memory_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    /* Type section: () -> () */
+    0x01, 0x04, 0x01, 0x60, 0x00, 0x00,
+    /* Function section */
+    0x03, 0x02, 0x01, 0x00,
+    /* Memory section: 1 memory, min 1 page */
+    0x05, 0x03, 0x01, 0x00, 0x01,
+    /* Code section */
+    0x0a, 0x09, 0x01, 0x07, 0x00, 0x41, 0x00, 0x40, 0x00, 0x1a, 0x0b,
+};
+
+/* (module (table 1024 1024 funcref)) */
+static uint8_t table_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    /* Table section: 1 funcref table, min 1024, max 1024 */
+    0x04, 0x07, 0x01, 0x70, 0x01, 0x80, 0x08, 0x80, 0x08,
+};
+
+class LinearMemoryPoolTest : public testing::Test
+{
+  protected:
+    void init_runtime(uint32_t slot_count, bool use_pool = true,
+                      uint32_t instance_slot_count = 0,
+                      uint32_t instance_slot_size = 0)
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        if (use_pool) {
+            init_args.mem_alloc_type = Alloc_With_Pool;
+            init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+            init_args.mem_alloc_option.pool.heap_size =
+                sizeof(global_heap_buf);
+        }
+        else {
+            init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        }
+        init_args.linear_memory_slot_count = slot_count;
+        init_args.instance_slot_count = instance_slot_count;
+        init_args.instance_slot_size = instance_slot_size;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        runtime_inited = true;
+
+        memcpy(wasm_buf, memory_wasm, sizeof(memory_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+    }
+
+    virtual void TearDown()
+    {
+        if (table_module)
+            wasm_runtime_unload(table_module);
+        if (module)
+            wasm_runtime_unload(module);
+        if (runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+    wasm_module_inst_t instantiate()
+    {
+        wasm_module_inst_t inst = wasm_runtime_instantiate(
+            module, 8192, 0, error_buf, sizeof(error_buf));
+        EXPECT_NE(inst, nullptr) << error_buf;
+        return inst;
+    }
+
+    uint8_t *memory_base(wasm_module_inst_t inst)
+    {
+        return (uint8_t *)wasm_runtime_addr_app_to_native(inst, 0);
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(memory_wasm)];
+    uint8_t table_wasm_buf[sizeof(table_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_t table_module = nullptr;
+    bool runtime_inited = false;
+};
+
+TEST_F(LinearMemoryPoolTest, slot_reused_and_zeroed)
+{
+    memory_slot_info_t info;
+    wasm_module_inst_t inst;
+    uint8_t *base;
+
+    init_runtime(2);
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.slot_count, 2u);
+    EXPECT_EQ(info.free_slot_count, 2u);
+    EXPECT_EQ(info.highmark_slot_count, 0u);
+
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    base = memory_base(inst);
+    ASSERT_NE(base, nullptr);
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 1u);
+
+    memset(base, 0x5a, 4096);
+    base[65535] = 0x5a;
+    wasm_runtime_deinstantiate(inst);
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 2u);
+
+    /* The slot released most recently is reused, with its pages zeroed */
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    EXPECT_EQ(memory_base(inst), base);
+    EXPECT_EQ(base[0], 0);
+    EXPECT_EQ(base[4095], 0);
+    EXPECT_EQ(base[65535], 0);
+    wasm_runtime_deinstantiate(inst);
+
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 2u);
+    EXPECT_EQ(info.highmark_slot_count, 1u);
+}
+
+TEST_F(LinearMemoryPoolTest, fall_back_to_mmap_when_exhausted)
+{
+    memory_slot_info_t info;
+    wasm_module_inst_t insts[3];
+    uint32_t i;
+
+    init_runtime(2);
+    for (i = 0; i < 3; i++) {
+        insts[i] = instantiate();
+        ASSERT_NE(insts[i], nullptr);
+        memory_base(insts[i])[0] = (uint8_t)(i + 1);
+    }
+
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 0u);
+    EXPECT_EQ(info.highmark_slot_count, 2u);
+    for (i = 0; i < 3; i++)
+        EXPECT_EQ(memory_base(insts[i])[0], i + 1);
+
+    for (i = 0; i < 3; i++)
+        wasm_runtime_deinstantiate(insts[i]);
+
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 2u);
+    EXPECT_EQ(info.highmark_slot_count, 2u);
+}
+
+TEST_F(LinearMemoryPoolTest, no_slots_reserved)
+{
+    memory_slot_info_t info;
+    mem_alloc_info_t mem_alloc_info;
+    wasm_module_inst_t inst;
+
+    init_runtime(0);
+    EXPECT_FALSE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_TRUE(wasm_runtime_get_mem_alloc_info(&mem_alloc_info));
+    EXPECT_GT(mem_alloc_info.total_size, 0u);
+    EXPECT_LE(mem_alloc_info.total_size, sizeof(global_heap_buf));
+
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    wasm_runtime_deinstantiate(inst);
+}
+
+TEST_F(LinearMemoryPoolTest, system_allocator_mode)
+{
+    memory_slot_info_t info;
+    mem_alloc_info_t mem_alloc_info;
+
+    init_runtime(1, false);
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.slot_count, 1u);
+    /* The allocator info is still only available in pool mode */
+    EXPECT_FALSE(wasm_runtime_get_mem_alloc_info(&mem_alloc_info));
+}
+
+TEST_F(LinearMemoryPoolTest, enlarged_memory_zeroed_on_reuse)
+{
+    memory_slot_info_t info;
+    wasm_module_inst_t inst;
+    uint8_t *base;
+
+    init_runtime(1);
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    base = memory_base(inst);
+    ASSERT_TRUE(wasm_runtime_enlarge_memory(inst, 2));
+    /* Enlarging memory never moves the data of a slot */
+    EXPECT_EQ(memory_base(inst), base);
+    base[3 * 65536 - 1] = 0x5a;
+    wasm_runtime_deinstantiate(inst);
+
+    /* The pages added by memory.grow are released with the slot too */
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    EXPECT_EQ(memory_base(inst), base);
+    ASSERT_TRUE(wasm_runtime_enlarge_memory(inst, 2));
+    EXPECT_EQ(base[3 * 65536 - 1], 0);
+    wasm_runtime_deinstantiate(inst);
+
+    ASSERT_TRUE(wasm_runtime_get_memory_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 1u);
+    EXPECT_EQ(info.highmark_slot_count, 1u);
+}
+
+TEST_F(LinearMemoryPoolTest, instance_slot_reused_and_zeroed)
+{
+    memory_slot_info_t info;
+    wasm_module_inst_t inst, inst2;
+    uint8_t *slot;
+    uint32_t i;
+
+    init_runtime(0, true, 2, 16384);
+    EXPECT_FALSE(wasm_runtime_get_memory_slot_info(&info));
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.slot_count, 2u);
+    EXPECT_EQ(info.free_slot_count, 2u);
+    EXPECT_EQ(info.highmark_slot_count, 0u);
+
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 1u);
+    slot = (uint8_t *)inst;
+    wasm_runtime_deinstantiate(inst);
+
+    /* The slot is zeroed when the instance is destroyed */
+    for (i = 0; i < 4096; i++)
+        ASSERT_EQ(slot[i], 0) << i;
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 2u);
+
+    /* The slot released most recently is reused */
+    inst = instantiate();
+    ASSERT_NE(inst, nullptr);
+    EXPECT_EQ((uint8_t *)inst, slot);
+    inst2 = instantiate();
+    ASSERT_NE(inst2, nullptr);
+    EXPECT_NE((uint8_t *)inst2, slot);
+    EXPECT_NE(memory_base(inst), memory_base(inst2));
+    wasm_runtime_deinstantiate(inst2);
+    wasm_runtime_deinstantiate(inst);
+
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 2u);
+    EXPECT_EQ(info.highmark_slot_count, 2u);
+}
+
+TEST_F(LinearMemoryPoolTest, instance_slot_fall_back_to_heap)
+{
+    memory_slot_info_t info;
+    wasm_module_inst_t insts[2], inst;
+
+    init_runtime(0, true, 1, 4096);
+
+    /* An instance which doesn't fit in a slot is allocated from the
+       runtime heap, the 1024 table elements take 8KB here */
+    memcpy(table_wasm_buf, table_wasm, sizeof(table_wasm));
+    table_module = wasm_runtime_load(table_wasm_buf, sizeof(table_wasm_buf),
+                                     error_buf, sizeof(error_buf));
+    ASSERT_NE(table_module, nullptr) << error_buf;
+    inst = wasm_runtime_instantiate(table_module, 8192, 0, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 1u);
+    wasm_runtime_deinstantiate(inst);
+
+    /* So is an instance created when all the slots are in use */
+    insts[0] = instantiate();
+    ASSERT_NE(insts[0], nullptr);
+    insts[1] = instantiate();
+    ASSERT_NE(insts[1], nullptr);
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 0u);
+    wasm_runtime_deinstantiate(insts[0]);
+    wasm_runtime_deinstantiate(insts[1]);
+
+    ASSERT_TRUE(wasm_runtime_get_instance_slot_info(&info));
+    EXPECT_EQ(info.free_slot_count, 1u);
+    EXPECT_EQ(info.highmark_slot_count, 1u);
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (func (export "mul_add") (param i32 i32) (result i32)
+ *     (i32.add (i32.mul (local.get 0) (local.get 1)) (i32.const 7))))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x0b, 0x01,
+    0x07, 0x6d, 0x75, 0x6c, 0x5f, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x0c,
+    0x01, 0x0a, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6c, 0x41, 0x07, 0x6a, 0x0b,
+};
+
+/* The offset of the immediate of i32.const */
+#define CONST_OFFSET 45
+
+static char cache_dir[] = "/tmp/wamr_jit_cache_XXXXXX";
+
+class LLVMJitCacheTest : public testing::Test
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        ASSERT_NE(mkdtemp(cache_dir), nullptr);
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Allocator;
+        init_args.mem_alloc_option.allocator.malloc_func = (void *)malloc;
+        init_args.mem_alloc_option.allocator.realloc_func = (void *)realloc;
+        init_args.mem_alloc_option.allocator.free_func = (void *)free;
+        init_args.llvm_jit_cache_dir = cache_dir;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase()
+    {
+        wasm_runtime_destroy();
+        rmdir(cache_dir);
+    }
+
+    /* Each test starts with an empty cache */
+    virtual void SetUp()
+    {
+        std::vector<std::string> files = cache_files();
+
+        for (auto &file : files)
+            remove(file.c_str());
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+    }
+
+    virtual void TearDown() { unload(); }
+
+    static std::vector<std::string> cache_files()
+    {
+        std::vector<std::string> files;
+        DIR *dir = opendir(cache_dir);
+        struct dirent *entry;
+
+        if (!dir)
+            return files;
+        while ((entry = readdir(dir))) {
+            if (entry->d_name[0] != '.')
+                files.push_back(std::string(cache_dir) + "/" + entry->d_name);
+        }
+        closedir(dir);
+        return files;
+    }
+
+    static ino_t inode(const std::string &path)
+    {
+        struct stat st;
+
+        return stat(path.c_str(), &st) == 0 ? st.st_ino : 0;
+    }
+
+    static off_t file_size(const std::string &path)
+    {
+        struct stat st;
+
+        return stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+    }
+
+    bool load()
+    {
+        /* The loader may modify the buffer, load a copy of it */
+        memcpy(load_buf, wasm_buf, sizeof(wasm_buf));
+        module = wasm_runtime_load(load_buf, sizeof(load_buf), error_buf,
+                                   sizeof(error_buf));
+        if (!module)
+            return false;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        return module_inst != nullptr;
+    }
+
+    void unload()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        module_inst = nullptr;
+        module = nullptr;
+    }
+
+    /* Return mul_add(a, b), or UINT32_MAX if it traps */
+    uint32 mul_add(uint32 a, uint32 b)
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, "mul_add");
+        wasm_exec_env_t exec_env;
+        uint32 argv[2] = { a, b };
+        bool ret;
+
+        if (!func
+            || !(exec_env = wasm_runtime_create_exec_env(module_inst, 8192)))
+            return UINT32_MAX;
+        ret = wasm_runtime_call_wasm(exec_env, func, 2, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret ? argv[0] : UINT32_MAX;
+    }
+
+  public:
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8_t load_buf[sizeof(test_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+};
+
+TEST_F(LLVMJitCacheTest, miss_compiles_aot_file)
+{
+    ASSERT_TRUE(load()) << error_buf;
+
+    /* The module is loaded from the AOT file compiled on the miss */
+    EXPECT_EQ(wasm_runtime_get_module_package_type(module), Wasm_Module_AoT);
+    EXPECT_EQ(cache_files().size(), 1u);
+    EXPECT_EQ(mul_add(6, 7), 49u);
+
+    /* It only runs the code compiled by LLVM */
+    EXPECT_EQ(wasm_runtime_get_running_mode(module_inst), Mode_LLVM_JIT);
+    EXPECT_TRUE(wasm_runtime_set_running_mode(module_inst, Mode_LLVM_JIT));
+    EXPECT_FALSE(wasm_runtime_set_running_mode(module_inst, Mode_Interp));
+}
+
+TEST_F(LLVMJitCacheTest, hit_loads_cached_file)
+{
+    std::vector<std::string> files;
+    ino_t ino;
+
+    ASSERT_TRUE(load()) << error_buf;
+    unload();
+    files = cache_files();
+    ASSERT_EQ(files.size(), 1u);
+    ino = inode(files[0]);
+
+    /* A miss would have renamed a new file over the cached one */
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_EQ(wasm_runtime_get_module_package_type(module), Wasm_Module_AoT);
+    files = cache_files();
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_EQ(inode(files[0]), ino);
+    EXPECT_EQ(mul_add(3, 4), 19u);
+}
+
+TEST_F(LLVMJitCacheTest, modified_binary_misses)
+{
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_EQ(mul_add(6, 7), 49u);
+    unload();
+
+    /* (i32.const 8), the cache file of the old binary must not be used */
+    wasm_buf[CONST_OFFSET] = 8;
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_EQ(cache_files().size(), 2u);
+    EXPECT_EQ(mul_add(6, 7), 50u);
+}
+
+TEST_F(LLVMJitCacheTest, corrupted_file_is_regenerated)
+{
+    std::vector<std::string> files;
+    FILE *file;
+
+    ASSERT_TRUE(load()) << error_buf;
+    unload();
+    files = cache_files();
+    ASSERT_EQ(files.size(), 1u);
+
+    /* Truncate the cache file */
+    ASSERT_NE(file = fopen(files[0].c_str(), "r+b"), nullptr);
+    ASSERT_EQ(ftruncate(fileno(file), 16), 0);
+    fclose(file);
+
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_EQ(wasm_runtime_get_module_package_type(module), Wasm_Module_AoT);
+    EXPECT_EQ(mul_add(6, 7), 49u);
+    files = cache_files();
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_GT(file_size(files[0]), 16);
+}
+
+TEST_F(LLVMJitCacheTest, invalid_binary_is_not_cached)
+{
+    /* Unknown opcode 0xff in the function body */
+    wasm_buf[CONST_OFFSET - 1] = 0xff;
+    EXPECT_FALSE(load());
+    EXPECT_EQ(cache_files().size(), 0u);
+}
+
+TEST_F(LLVMJitCacheTest, interp_mode_is_not_cached)
+{
+    ASSERT_TRUE(wasm_runtime_set_default_running_mode(Mode_Interp));
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_TRUE(wasm_runtime_set_default_running_mode(Mode_LLVM_JIT));
+
+    EXPECT_EQ(wasm_runtime_get_module_package_type(module),
+              Wasm_Module_Bytecode);
+    EXPECT_EQ(cache_files().size(), 0u);
+    EXPECT_EQ(mul_add(6, 7), 49u);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (memory 1)
+ *   (func (export "load") (param i32) (result i32)
+ *     (i32.load (local.get 0)))
+ *   (data (i32.const 0) "\2a\00\00\00"))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x05, 0x03, 0x01, 0x00,
+    0x01, 0x07, 0x08, 0x01, 0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00, 0x00, 0x0a,
+    0x09, 0x01, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x0b, 0x0a,
+    0x01, 0x00, 0x41, 0x00, 0x0b, 0x04, 0x2a, 0x00, 0x00, 0x00,
+};
+
+class LoadFromFileTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        int fd;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        memset(&load_args, 0, sizeof(LoadArgs));
+        load_args.name = (char *)"";
+
+        snprintf(wasm_file, sizeof(wasm_file), "load_from_file_XXXXXX");
+        ASSERT_GE(fd = mkstemp(wasm_file), 0);
+        ASSERT_EQ(write(fd, test_wasm, sizeof(test_wasm)),
+                  (ssize_t)sizeof(test_wasm));
+        close(fd);
+    }
+
+    virtual void TearDown()
+    {
+        unlink(wasm_file);
+        wasm_runtime_destroy();
+    }
+
+    uint32_t call_load(wasm_module_inst_t inst, uint32_t addr)
+    {
+        wasm_function_inst_t func;
+        wasm_exec_env_t exec_env;
+        uint32_t argv[1] = { addr };
+
+        func = wasm_runtime_lookup_function(inst, "load");
+        EXPECT_NE(func, nullptr);
+        exec_env = wasm_runtime_get_exec_env_singleton(inst);
+        EXPECT_NE(exec_env, nullptr);
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv))
+            << wasm_runtime_get_exception(inst);
+        return argv[0];
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    LoadArgs load_args;
+    char error_buf[128];
+    char wasm_file[64];
+};
+
+TEST_F(LoadFromFileTest, load_and_run)
+{
+    wasm_module_t module;
+    wasm_module_inst_t inst;
+
+    module = wasm_runtime_load_from_file(wasm_file, &load_args, error_buf,
+                                         sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << error_buf;
+
+    /* The module refers to the mapping, not to the file name */
+    unlink(wasm_file);
+
+    inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    EXPECT_EQ(call_load(inst, 0), 42u);
+
+    wasm_runtime_deinstantiate(inst);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(LoadFromFileTest, file_not_modified)
+{
+    wasm_module_t module;
+    wasm_module_inst_t inst;
+    uint8_t content[sizeof(test_wasm) + 1];
+    FILE *file;
+
+    /* wasm_binary_freeable is ignored, the module keeps the mapping */
+    load_args.wasm_binary_freeable = true;
+    module = wasm_runtime_load_from_file(wasm_file, &load_args, error_buf,
+                                         sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << error_buf;
+    inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    EXPECT_EQ(call_load(inst, 0), 42u);
+
+    /* The loader and the interpreter write to private copy-on-write
+       pages, which are never written back to the file */
+    ASSERT_NE(file = fopen(wasm_file, "rb"), nullptr);
+    EXPECT_EQ(fread(content, 1, sizeof(content), file), sizeof(test_wasm));
+    fclose(file);
+    EXPECT_EQ(memcmp(content, test_wasm, sizeof(test_wasm)), 0);
+
+    wasm_runtime_deinstantiate(inst);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(LoadFromFileTest, load_twice)
+{
+    wasm_module_t module1, module2;
+    wasm_module_inst_t inst1, inst2;
+
+    module1 = wasm_runtime_load_from_file(wasm_file, &load_args, error_buf,
+                                          sizeof(error_buf));
+    ASSERT_NE(module1, nullptr) << error_buf;
+    module2 = wasm_runtime_load_from_file(wasm_file, &load_args, error_buf,
+                                          sizeof(error_buf));
+    ASSERT_NE(module2, nullptr) << error_buf;
+
+    inst1 = wasm_runtime_instantiate(module1, 8192, 0, error_buf,
+                                     sizeof(error_buf));
+    ASSERT_NE(inst1, nullptr) << error_buf;
+    /* Each module has its own mapping */
+    wasm_runtime_unload(module2);
+    EXPECT_EQ(call_load(inst1, 0), 42u);
+
+    inst2 = wasm_runtime_instantiate(module1, 8192, 0, error_buf,
+                                     sizeof(error_buf));
+    ASSERT_NE(inst2, nullptr) << error_buf;
+    EXPECT_EQ(call_load(inst2, 0), 42u);
+
+    wasm_runtime_deinstantiate(inst2);
+    wasm_runtime_deinstantiate(inst1);
+    wasm_runtime_unload(module1);
+}
+
+TEST_F(LoadFromFileTest, load_failures)
+{
+    FILE *file;
+
+    EXPECT_EQ(wasm_runtime_load_from_file("nonexistent.wasm", &load_args,
+                                          error_buf, sizeof(error_buf)),
+              nullptr);
+    EXPECT_NE(strstr(error_buf, "open file failed"), nullptr) << error_buf;
+
+    EXPECT_EQ(wasm_runtime_load_from_file(wasm_file, NULL, error_buf,
+                                          sizeof(error_buf)),
+              nullptr);
+    EXPECT_NE(strstr(error_buf, "null load arguments"), nullptr)
+        << error_buf;
+
+    /* Truncate the file */
+    ASSERT_NE(file = fopen(wasm_file, "wb"), nullptr);
+    fclose(file);
+    EXPECT_EQ(wasm_runtime_load_from_file(wasm_file, &load_args, error_buf,
+                                          sizeof(error_buf)),
+              nullptr);
+    EXPECT_NE(strstr(error_buf, "invalid file size"), nullptr) << error_buf;
+}
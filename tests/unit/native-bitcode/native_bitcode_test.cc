@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_platform.h"
+#include "llvm-c/Core.h"
+#include "llvm-c/BitWriter.h"
+
+/*
+ * (module
+ *   (import "env" "hash32" (func $hash32 (param i32) (result i32)))
+ *   (import "env" "ext_hash" (func $ext_hash (param i32) (result i32)))
+ *   (import "env" "wide_hash" (func $wide_hash (param i32) (result i32)))
+ *   (func (export "hash32") (param i32) (result i32)
+ *     (call $hash32 (local.get 0)))
+ *   (func (export "ext_hash") (param i32) (result i32)
+ *     (call $ext_hash (local.get 0)))
+ *   (func (export "wide_hash") (param i32) (result i32)
+ *     (call $wide_hash (local.get 0))))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x2d, 0x03, 0x03, 0x65, 0x6e, 0x76, 0x06,
+    0x68, 0x61, 0x73, 0x68, 0x33, 0x32, 0x00, 0x00, 0x03, 0x65, 0x6e, 0x76,
+    0x08, 0x65, 0x78, 0x74, 0x5f, 0x68, 0x61, 0x73, 0x68, 0x00, 0x00, 0x03,
+    0x65, 0x6e, 0x76, 0x09, 0x77, 0x69, 0x64, 0x65, 0x5f, 0x68, 0x61, 0x73,
+    0x68, 0x00, 0x00, 0x03, 0x04, 0x03, 0x00, 0x00, 0x00, 0x07, 0x21, 0x03,
+    0x06, 0x68, 0x61, 0x73, 0x68, 0x33, 0x32, 0x00, 0x03, 0x08, 0x65, 0x78,
+    0x74, 0x5f, 0x68, 0x61, 0x73, 0x68, 0x00, 0x04, 0x09, 0x77, 0x69, 0x64,
+    0x65, 0x5f, 0x68, 0x61, 0x73, 0x68, 0x00, 0x05, 0x0a, 0x16, 0x03, 0x06,
+    0x00, 0x20, 0x00, 0x10, 0x00, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x10, 0x01,
+    0x0b, 0x06, 0x00, 0x20, 0x00, 0x10, 0x02, 0x0b,
+};
+
+enum TestMode { Test_Interp, Test_LLVM_JIT, Test_AOT };
+
+/* The value returned by the hash32 of the bitcode */
+static uint32
+hash32(uint32 x)
+{
+    return x * 31 + 7;
+}
+
+/*
+ * The host functions of "env" as LLVM bitcode, no native symbols are
+ * registered for them, so an import call only succeeds if it is inlined:
+ *
+ * define i32 @hash32(ptr %exec_env, i32 %x)       ; x * 31 + 7
+ * define i32 @wide_hash(ptr %exec_env, i64 %x)    ; mismatched param type
+ */
+static LLVMMemoryBufferRef
+build_env_bitcode(LLVMContextRef context)
+{
+    LLVMModuleRef module = LLVMModuleCreateWithNameInContext("env", context);
+    LLVMBuilderRef builder = LLVMCreateBuilderInContext(context);
+    LLVMTypeRef i32_type = LLVMInt32TypeInContext(context);
+    LLVMTypeRef i64_type = LLVMInt64TypeInContext(context);
+    LLVMTypeRef ptr_type = LLVMPointerType(LLVMInt8TypeInContext(context), 0);
+    LLVMTypeRef param_types[2] = { ptr_type, i32_type };
+    LLVMValueRef func, value;
+    LLVMMemoryBufferRef buf;
+
+    func = LLVMAddFunction(module, "hash32",
+                           LLVMFunctionType(i32_type, param_types, 2, false));
+    LLVMPositionBuilderAtEnd(
+        builder, LLVMAppendBasicBlockInContext(context, func, "entry"));
+    value = LLVMBuildMul(builder, LLVMGetParam(func, 1),
+                         LLVMConstInt(i32_type, 31, false), "mul");
+    value = LLVMBuildAdd(builder, value, LLVMConstInt(i32_type, 7, false),
+                         "add");
+    LLVMBuildRet(builder, value);
+
+    param_types[1] = i64_type;
+    func = LLVMAddFunction(module, "wide_hash",
+                           LLVMFunctionType(i32_type, param_types, 2, false));
+    LLVMPositionBuilderAtEnd(
+        builder, LLVMAppendBasicBlockInContext(context, func, "entry"));
+    LLVMBuildRet(builder, LLVMBuildTrunc(builder, LLVMGetParam(func, 1),
+                                         i32_type, "trunc"));
+
+    buf = LLVMWriteBitcodeToMemoryBuffer(module);
+    LLVMDisposeBuilder(builder);
+    LLVMDisposeModule(module);
+    return buf;
+}
+
+/*
+ * define i32 @ext_hash(ptr %exec_env, i32 %x)     ; calls @external
+ * declare i32 @external(i32)
+ */
+static LLVMMemoryBufferRef
+build_external_bitcode(LLVMContextRef context)
+{
+    LLVMModuleRef module = LLVMModuleCreateWithNameInContext("ext", context);
+    LLVMBuilderRef builder = LLVMCreateBuilderInContext(context);
+    LLVMTypeRef i32_type = LLVMInt32TypeInContext(context);
+    LLVMTypeRef ptr_type = LLVMPointerType(LLVMInt8TypeInContext(context), 0);
+    LLVMTypeRef param_types[2] = { ptr_type, i32_type };
+    LLVMTypeRef external_type = LLVMFunctionType(i32_type, &i32_type, 1, false);
+    LLVMValueRef func, external, arg;
+    LLVMMemoryBufferRef buf;
+
+    external = LLVMAddFunction(module, "external", external_type);
+    func = LLVMAddFunction(module, "ext_hash",
+                           LLVMFunctionType(i32_type, param_types, 2, false));
+    LLVMPositionBuilderAtEnd(
+        builder, LLVMAppendBasicBlockInContext(context, func, "entry"));
+    arg = LLVMGetParam(func, 1);
+    LLVMBuildRet(builder, LLVMBuildCall2(builder, external_type, external,
+                                         &arg, 1, "call"));
+
+    buf = LLVMWriteBitcodeToMemoryBuffer(module);
+    LLVMDisposeBuilder(builder);
+    LLVMDisposeModule(module);
+    return buf;
+}
+
+class NativeBitcodeTest : public testing::TestWithParam<TestMode>
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        context = LLVMContextCreate();
+        env_bitcode = build_env_bitcode(context);
+        external_bitcode = build_external_bitcode(context);
+        ASSERT_TRUE(register_bitcode(env_bitcode));
+        ASSERT_TRUE(register_bitcode(external_bitcode));
+    }
+
+    static void TearDownTestCase()
+    {
+        unregister_bitcode(env_bitcode);
+        unregister_bitcode(external_bitcode);
+        LLVMDisposeMemoryBuffer(env_bitcode);
+        LLVMDisposeMemoryBuffer(external_bitcode);
+        LLVMContextDispose(context);
+        wasm_runtime_destroy();
+    }
+
+    static bool register_bitcode(LLVMMemoryBufferRef buf)
+    {
+        return wasm_runtime_register_native_bitcode(
+            "env", (const uint8_t *)LLVMGetBufferStart(buf),
+            (uint32_t)LLVMGetBufferSize(buf));
+    }
+
+    static bool unregister_bitcode(LLVMMemoryBufferRef buf)
+    {
+        return wasm_runtime_unregister_native_bitcode(
+            "env", (const uint8_t *)LLVMGetBufferStart(buf));
+    }
+
+    virtual void SetUp() { ASSERT_TRUE(load()); }
+
+    virtual void TearDown() { unload(); }
+
+    bool load()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        EXPECT_NE(module, nullptr) << error_buf;
+        if (!module)
+            return false;
+        if (GetParam() == Test_AOT) {
+            if (!compile_aot())
+                return false;
+            wasm_runtime_unload(module);
+            module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                       sizeof(error_buf));
+            EXPECT_NE(module, nullptr) << error_buf;
+            if (!module)
+                return false;
+        }
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        EXPECT_NE(module_inst, nullptr) << error_buf;
+        if (!module_inst)
+            return false;
+        if (GetParam() != Test_AOT
+            && !wasm_runtime_set_running_mode(
+                module_inst, GetParam() == Test_Interp ? Mode_Interp
+                                                       : Mode_LLVM_JIT))
+            return false;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        return exec_env != nullptr;
+    }
+
+    void unload()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+        exec_env = nullptr;
+        module_inst = nullptr;
+        module = nullptr;
+        aot_file_buf = nullptr;
+    }
+
+    bool compile_aot()
+    {
+        AOTCompOption option = { 0 };
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+
+        if (!(comp_data = aot_create_comp_data(module, NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+
+    /* Call the function of the instance, return false if it traps */
+    bool call(const char *name, uint32 argc, uint32 *argv)
+    {
+        wasm_function_inst_t func;
+
+        exception.clear();
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_NE(func, nullptr) << name;
+        if (!wasm_runtime_call_wasm(exec_env, func, argc, argv)) {
+            exception = wasm_runtime_get_exception(module_inst);
+            wasm_runtime_clear_exception(module_inst);
+            return false;
+        }
+        return true;
+    }
+
+    /* AOT code reports it without the import name */
+    bool is_unlinked_exception()
+    {
+        return exception.rfind(
+                   "Exception: failed to call unlinked import function", 0)
+               == 0;
+    }
+
+  public:
+    static char global_heap_buf[512 * 1024];
+    static LLVMContextRef context;
+    static LLVMMemoryBufferRef env_bitcode;
+    static LLVMMemoryBufferRef external_bitcode;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    std::string exception;
+};
+
+char NativeBitcodeTest::global_heap_buf[512 * 1024];
+LLVMContextRef NativeBitcodeTest::context;
+LLVMMemoryBufferRef NativeBitcodeTest::env_bitcode;
+LLVMMemoryBufferRef NativeBitcodeTest::external_bitcode;
+
+TEST_P(NativeBitcodeTest, import_call_inlined)
+{
+    uint32 argv[1] = { 12345 };
+
+    if (GetParam() == Test_Interp) {
+        /* The interpreter still calls the native, which isn't registered */
+        EXPECT_FALSE(call("hash32", 1, argv));
+        EXPECT_TRUE(is_unlinked_exception()) << exception;
+        return;
+    }
+
+    ASSERT_TRUE(call("hash32", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], hash32(12345));
+}
+
+TEST_P(NativeBitcodeTest, external_call_not_inlined)
+{
+    uint32 argv[1] = { 1 };
+
+    /* The bitcode calling an external function is ignored */
+    EXPECT_FALSE(call("ext_hash", 1, argv));
+    EXPECT_TRUE(is_unlinked_exception()) << exception;
+}
+
+TEST_P(NativeBitcodeTest, mismatched_type_not_inlined)
+{
+    uint32 argv[1] = { 1 };
+
+    EXPECT_FALSE(call("wide_hash", 1, argv));
+    EXPECT_TRUE(is_unlinked_exception()) << exception;
+}
+
+TEST_P(NativeBitcodeTest, unregistered_bitcode_not_inlined)
+{
+    uint32 argv[1] = { 1 };
+
+    unload();
+    ASSERT_TRUE(unregister_bitcode(env_bitcode));
+    EXPECT_FALSE(unregister_bitcode(env_bitcode));
+    EXPECT_TRUE(load());
+    ASSERT_TRUE(register_bitcode(env_bitcode));
+
+    EXPECT_FALSE(call("hash32", 1, argv));
+    EXPECT_TRUE(is_unlinked_exception()) << exception;
+}
+
+INSTANTIATE_TEST_SUITE_P(RunningMode, NativeBitcodeTest,
+                         testing::Values(Test_Interp, Test_LLVM_JIT,
+                                         Test_AOT));
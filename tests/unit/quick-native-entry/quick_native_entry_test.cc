@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "aot_runtime.h"
+#include "aot_compiler.h"
+#include "aot_emit_aot_file.h"
+
+/*
+ * (module
+ *   (import "env" "add" (func $add (param i32 i32) (result i32)))
+ *   (import "env" "mul64" (func $mul64 (param i64 i64) (result i64)))
+ *   (import "env" "strlen" (func $strlen (param i32) (result i32)))
+ *   (import "env" "fail" (func $fail (param i32) (result i32)))
+ *   (table 1 funcref)
+ *   (memory 1)
+ *   (elem (i32.const 0) $add)
+ *   (func (export "add") (param i32 i32) (result i32)
+ *     (call $add (local.get 0) (local.get 1)))
+ *   (func (export "mul64") (param i64 i64) (result i64)
+ *     (call $mul64 (local.get 0) (local.get 1)))
+ *   (func (export "strlen") (param i32) (result i32)
+ *     (call $strlen (local.get 0)))
+ *   (func (export "fail") (param i32) (result i32)
+ *     (call $fail (local.get 0)))
+ *   (func (export "add_indirect") (param i32 i32) (result i32)
+ *     (call_indirect (type 0) (local.get 0) (local.get 1) (i32.const 0)))
+ *   (data (i32.const 16) "hello\00"))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12, 0x03, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7e, 0x7e, 0x01, 0x7e, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x2f, 0x04, 0x03, 0x65, 0x6e, 0x76, 0x03,
+    0x61, 0x64, 0x64, 0x00, 0x00, 0x03, 0x65, 0x6e, 0x76, 0x05, 0x6d, 0x75,
+    0x6c, 0x36, 0x34, 0x00, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x06, 0x73, 0x74,
+    0x72, 0x6c, 0x65, 0x6e, 0x00, 0x02, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x66,
+    0x61, 0x69, 0x6c, 0x00, 0x02, 0x03, 0x06, 0x05, 0x00, 0x01, 0x02, 0x02,
+    0x00, 0x04, 0x04, 0x01, 0x70, 0x00, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01,
+    0x07, 0x2e, 0x05, 0x03, 0x61, 0x64, 0x64, 0x00, 0x04, 0x05, 0x6d, 0x75,
+    0x6c, 0x36, 0x34, 0x00, 0x05, 0x06, 0x73, 0x74, 0x72, 0x6c, 0x65, 0x6e,
+    0x00, 0x06, 0x04, 0x66, 0x61, 0x69, 0x6c, 0x00, 0x07, 0x0c, 0x61, 0x64,
+    0x64, 0x5f, 0x69, 0x6e, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74, 0x00, 0x08,
+    0x09, 0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x00, 0x0a, 0x2d, 0x05,
+    0x08, 0x00, 0x20, 0x00, 0x20, 0x01, 0x10, 0x00, 0x0b, 0x08, 0x00, 0x20,
+    0x00, 0x20, 0x01, 0x10, 0x01, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x10, 0x02,
+    0x0b, 0x06, 0x00, 0x20, 0x00, 0x10, 0x03, 0x0b, 0x0b, 0x00, 0x20, 0x00,
+    0x20, 0x01, 0x41, 0x00, 0x11, 0x00, 0x00, 0x0b, 0x0b, 0x0c, 0x01, 0x00,
+    0x41, 0x10, 0x0b, 0x06, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x00,
+};
+
+/* The indexes of the imports in test_wasm */
+enum { IMPORT_ADD, IMPORT_MUL64, IMPORT_STRLEN, IMPORT_FAIL, IMPORT_NUM };
+
+enum TestMode { Test_Interp, Test_LLVM_JIT, Test_AOT };
+
+static int add_attachment;
+static void *last_attachment;
+
+static int32
+add_native(wasm_exec_env_t exec_env, int32 a, int32 b)
+{
+    last_attachment = wasm_runtime_get_function_attachment(exec_env);
+    return a + b;
+}
+
+static int64
+mul64_native(wasm_exec_env_t exec_env, int64 a, int64 b)
+{
+    return a * b;
+}
+
+static int32
+strlen_native(wasm_exec_env_t exec_env, const char *str)
+{
+    return (int32)strlen(str);
+}
+
+static int32
+fail_native(wasm_exec_env_t exec_env, int32 a)
+{
+    wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                               "native failed");
+    return a;
+}
+
+static NativeSymbol native_symbols[] = {
+    { "add", (void *)add_native, "(ii)i", &add_attachment },
+    { "mul64", (void *)mul64_native, "(II)I", NULL },
+    { "strlen", (void *)strlen_native, "($)i", NULL },
+    { "fail", (void *)fail_native, "(i)i", NULL },
+};
+
+class QuickNativeEntryTest : public testing::TestWithParam<TestMode>
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        init_args.native_module_name = "env";
+        init_args.native_symbols = native_symbols;
+        init_args.n_native_symbols =
+            sizeof(native_symbols) / sizeof(NativeSymbol);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        if (GetParam() == Test_AOT) {
+            ASSERT_TRUE(compile_aot());
+            wasm_runtime_unload(module);
+            module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                       sizeof(error_buf));
+            ASSERT_NE(module, nullptr) << error_buf;
+        }
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        if (GetParam() != Test_AOT)
+            ASSERT_TRUE(wasm_runtime_set_running_mode(
+                module_inst, GetParam() == Test_Interp ? Mode_Interp
+                                                       : Mode_LLVM_JIT));
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+    }
+
+    bool compile_aot()
+    {
+        AOTCompOption option = { 0 };
+        AOTCompData *comp_data;
+        AOTCompContext *comp_ctx;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+
+        if (!(comp_data =
+                  aot_create_comp_data((WASMModule *)module, NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+
+    /* The quick entry linked to the import, NULL if it takes the generic
+       wasm_runtime_invoke_native path */
+    void *quick_native_entry(uint32 import_idx)
+    {
+        if (GetParam() == Test_AOT)
+            return ((AOTModule *)module)
+                ->import_funcs[import_idx]
+                .quick_native_entry;
+        return ((WASMModule *)module)
+            ->import_functions[import_idx]
+            .u.function.quick_native_entry;
+    }
+
+    /* Call the function of the instance, return false if it traps */
+    bool call(const char *name, uint32 argc, uint32 *argv)
+    {
+        wasm_function_inst_t func;
+
+        exception.clear();
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_NE(func, nullptr) << name;
+        if (!wasm_runtime_call_wasm(exec_env, func, argc, argv)) {
+            exception = wasm_runtime_get_exception(module_inst);
+            wasm_runtime_clear_exception(module_inst);
+            return false;
+        }
+        return true;
+    }
+
+  public:
+    static char global_heap_buf[512 * 1024];
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    std::string exception;
+};
+
+char QuickNativeEntryTest::global_heap_buf[512 * 1024];
+
+TEST_P(QuickNativeEntryTest, plain_signatures_are_linked_to_quick_entries)
+{
+    EXPECT_NE(quick_native_entry(IMPORT_ADD), nullptr);
+    EXPECT_NE(quick_native_entry(IMPORT_MUL64), nullptr);
+    EXPECT_NE(quick_native_entry(IMPORT_FAIL), nullptr);
+    /* The string param must be validated and converted */
+    EXPECT_EQ(quick_native_entry(IMPORT_STRLEN), nullptr);
+}
+
+TEST_P(QuickNativeEntryTest, i32_params)
+{
+    uint32 argv[2] = { 40, 2 };
+
+    last_attachment = NULL;
+    ASSERT_TRUE(call("add", 2, argv)) << exception;
+    EXPECT_EQ(argv[0], 42u);
+    /* AOT and JIT code call the native directly, without the attachment */
+    if (GetParam() == Test_Interp)
+        EXPECT_EQ(last_attachment, &add_attachment);
+
+    argv[0] = (uint32)-7;
+    argv[1] = 3;
+    ASSERT_TRUE(call("add", 2, argv)) << exception;
+    EXPECT_EQ((int32)argv[0], -4);
+}
+
+TEST_P(QuickNativeEntryTest, i64_params)
+{
+    uint32 argv[4];
+    int64 a = 0x100000003LL, b = -5, ret;
+
+    memcpy(argv, &a, sizeof(int64));
+    memcpy(argv + 2, &b, sizeof(int64));
+    ASSERT_TRUE(call("mul64", 4, argv)) << exception;
+    memcpy(&ret, argv, sizeof(int64));
+    EXPECT_EQ(ret, a * b);
+}
+
+TEST_P(QuickNativeEntryTest, call_indirect)
+{
+    uint32 argv[2] = { 100, 23 };
+
+    /* It goes through the runtime, the quick entry must pass the
+       attachment of the symbol too */
+    last_attachment = NULL;
+    ASSERT_TRUE(call("add_indirect", 2, argv)) << exception;
+    EXPECT_EQ(argv[0], 123u);
+    EXPECT_EQ(last_attachment, &add_attachment);
+}
+
+TEST_P(QuickNativeEntryTest, string_param_takes_generic_path)
+{
+    uint32 argv[1] = { 16 };
+
+    ASSERT_TRUE(call("strlen", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 5u);
+
+    /* Out of bounds strings are still rejected */
+    argv[0] = 65536;
+    EXPECT_FALSE(call("strlen", 1, argv));
+    EXPECT_EQ(exception, "Exception: out of bounds memory access");
+}
+
+TEST_P(QuickNativeEntryTest, exception_thrown_by_native)
+{
+    uint32 argv[2] = { 1 };
+
+    EXPECT_FALSE(call("fail", 1, argv));
+    EXPECT_EQ(exception, "Exception: native failed");
+
+    /* The instance runs again once the exception is cleared */
+    argv[0] = 1;
+    argv[1] = 2;
+    ASSERT_TRUE(call("add", 2, argv)) << exception;
+    EXPECT_EQ(argv[0], 3u);
+}
+
+INSTANTIATE_TEST_SUITE_P(RunningMode, QuickNativeEntryTest,
+                         testing::Values(Test_Interp, Test_LLVM_JIT,
+                                         Test_AOT));
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (func (export "mul_add") (param i32 i32) (result i32)
+ *     (i32.add (i32.mul (local.get 0) (local.get 1)) (i32.const 7))))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x0b, 0x01,
+    0x07, 0x6d, 0x75, 0x6c, 0x5f, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x0c,
+    0x01, 0x0a, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6c, 0x41, 0x07, 0x6a, 0x0b,
+};
+
+/* A mapping of /proc/self/maps */
+struct Mapping {
+    uintptr_t start, end;
+    std::string perms, path;
+    uint32 anonymous_kb;
+};
+
+class SharedTextTest : public testing::Test
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Allocator;
+        init_args.mem_alloc_option.allocator.malloc_func = (void *)malloc;
+        init_args.mem_alloc_option.allocator.realloc_func = (void *)realloc;
+        init_args.mem_alloc_option.allocator.free_func = (void *)free;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        snprintf(aot_file, sizeof(aot_file), "/tmp/shared_text_XXXXXX");
+        ASSERT_TRUE(bh_mkstemp(aot_file, sizeof(aot_file)));
+        memset(&load_args, 0, sizeof(LoadArgs));
+        load_args.name = (char *)"";
+    }
+
+    virtual void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        unlink(aot_file);
+    }
+
+    /* Compile the module into an XIP AOT file like wamrc --xip, or
+       --shared-text */
+    bool compile_xip(bool shared_text)
+    {
+        uint8_t wasm_buf[sizeof(test_wasm)];
+        wasm_module_t wasm_module;
+        aot_comp_data_t comp_data = nullptr;
+        aot_comp_context_t comp_ctx = nullptr;
+        AOTCompOption option = { 0 };
+        bool ret = false;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.stack_bounds_checks = 2;
+        option.enable_aux_stack_check = true;
+        option.is_indirect_mode = true;
+        option.disable_llvm_intrinsics = true;
+        option.enable_shared_text = shared_text;
+
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        wasm_module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                        sizeof(error_buf));
+        if (!wasm_module)
+            return false;
+        if ((comp_data = aot_create_comp_data(wasm_module, NULL, false))
+            && (comp_ctx = aot_create_comp_context(comp_data, &option))
+            && aot_compile_wasm(comp_ctx))
+            ret = aot_emit_aot_file(comp_ctx, comp_data, aot_file);
+
+        if (comp_ctx)
+            aot_destroy_comp_context(comp_ctx);
+        if (comp_data)
+            aot_destroy_comp_data(comp_data);
+        wasm_runtime_unload(wasm_module);
+        return ret;
+    }
+
+    bool load()
+    {
+        module = wasm_runtime_load_from_file(aot_file, &load_args, error_buf,
+                                             sizeof(error_buf));
+        if (!module)
+            return false;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        return module_inst != nullptr;
+    }
+
+    uint32 mul_add(uint32 a, uint32 b)
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, "mul_add");
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+        uint32 argv[2] = { a, b };
+
+        if (!func || !exec_env
+            || !wasm_runtime_call_wasm(exec_env, func, 2, argv))
+            return UINT32_MAX;
+        return argv[0];
+    }
+
+    static std::vector<Mapping> mappings()
+    {
+        std::vector<Mapping> result;
+        std::ifstream smaps("/proc/self/smaps");
+        std::string line;
+
+        while (std::getline(smaps, line)) {
+            std::istringstream iss(line);
+            Mapping m;
+            char dash;
+
+            if (line.compare(0, 10, "Anonymous:") == 0) {
+                if (!result.empty())
+                    result.back().anonymous_kb =
+                        (uint32)atoi(line.c_str() + 10);
+                continue;
+            }
+            if (!(iss >> std::hex >> m.start >> dash >> m.end >> m.perms)
+                || dash != '-')
+                continue;
+            /* offset, dev, inode, path */
+            std::string offset, dev, inode;
+            iss >> offset >> dev >> inode;
+            std::getline(iss >> std::ws, m.path);
+            m.anonymous_kb = 0;
+            result.push_back(m);
+        }
+        return result;
+    }
+
+  public:
+    char error_buf[128];
+    char aot_file[64];
+    LoadArgs load_args;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+};
+
+TEST_F(SharedTextTest, text_is_read_only_executable)
+{
+    uint32 exec_mappings = 0;
+
+    ASSERT_TRUE(compile_xip(true)) << aot_get_last_error();
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_EQ(mul_add(6, 7), 49u);
+
+    for (const Mapping &m : mappings()) {
+        if (m.path != aot_file)
+            continue;
+        /* The file is never mapped writable and executable */
+        EXPECT_FALSE(m.perms[1] == 'w' && m.perms[2] == 'x') << m.perms;
+        if (m.perms[2] == 'x') {
+            exec_mappings++;
+            EXPECT_EQ(m.perms, "r-xp");
+            /* No page of the code is copied with --shared-text */
+            EXPECT_EQ(m.anonymous_kb, 0u);
+        }
+    }
+    EXPECT_EQ(exec_mappings, 1u);
+}
+
+TEST_F(SharedTextTest, xip_text_is_read_only_executable)
+{
+    uint32 exec_mappings = 0;
+
+    /* The code isn't page aligned, the pages around it are protected */
+    ASSERT_TRUE(compile_xip(false)) << aot_get_last_error();
+    ASSERT_TRUE(load()) << error_buf;
+    EXPECT_EQ(mul_add(3, 4), 19u);
+
+    for (const Mapping &m : mappings()) {
+        if (m.path != aot_file)
+            continue;
+        EXPECT_FALSE(m.perms[1] == 'w' && m.perms[2] == 'x') << m.perms;
+        if (m.perms[2] == 'x') {
+            exec_mappings++;
+            EXPECT_EQ(m.perms, "r-xp");
+        }
+    }
+    EXPECT_EQ(exec_mappings, 1u);
+}
+
+TEST_F(SharedTextTest, unloaded_file_is_unmapped)
+{
+    ASSERT_TRUE(compile_xip(true)) << aot_get_last_error();
+    ASSERT_TRUE(load()) << error_buf;
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+    module_inst = nullptr;
+    module = nullptr;
+
+    for (const Mapping &m : mappings())
+        EXPECT_NE(m.path, aot_file);
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <climits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "wasm_runtime.h"
+#include "bh_platform.h"
+
+/*
+ * For each i32 comparison <op> (eqz, eq, ne, lt_s .. ge_u):
+ *   ;; fused into EXT_OP_BR_IF_I32_<OP>
+ *   (func (export "f_<op>") (param i32 i32) (result i32)
+ *     (block (br_if 0 (i32.<op> (local.get 0) (local.get 1)))
+ *            (return (i32.const 0)))
+ *     (i32.const 1))
+ *   ;; the same with a nop between the comparison and br_if, not fused
+ *   (func (export "u_<op>") (param i32 i32) (result i32) ...)
+ *   ;; fused with a constant operand, on the right and on the left
+ *   (func (export "rc_<op>") (param i32) (result i32)
+ *     ... (i32.<op> (local.get 0) (i32.const 5)) ...)
+ *   (func (export "lc_<op>") (param i32) (result i32)
+ *     ... (i32.<op> (i32.const -3) (local.get 0)) ...)
+ * eqz only takes local 0 and has no rc_/lc_ variants, and:
+ *   (func (export "count") (param $n i32) (result i32)
+ *     (local $i i32)
+ *     (loop
+ *       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+ *       (br_if 0 (i32.lt_s (local.get $i) (local.get $n))))
+ *     (local.get $i))
+ *   (func (export "value") (param i32 i32) (result i32)
+ *     (block (result i32)
+ *       (i32.const 7)
+ *       (br_if 0 (i32.lt_s (local.get 0) (local.get 1)))
+ *       (drop) (i32.const 9)))
+ */
+static uint8_t superinst_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x2d,
+    0x2c, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00,
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00,
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00,
+    0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x07, 0x8d, 0x03,
+    0x2c, 0x05, 0x66, 0x5f, 0x65, 0x71, 0x7a, 0x00, 0x00, 0x05, 0x75, 0x5f,
+    0x65, 0x71, 0x7a, 0x00, 0x01, 0x04, 0x66, 0x5f, 0x65, 0x71, 0x00, 0x02,
+    0x04, 0x75, 0x5f, 0x65, 0x71, 0x00, 0x03, 0x05, 0x72, 0x63, 0x5f, 0x65,
+    0x71, 0x00, 0x04, 0x05, 0x6c, 0x63, 0x5f, 0x65, 0x71, 0x00, 0x05, 0x04,
+    0x66, 0x5f, 0x6e, 0x65, 0x00, 0x06, 0x04, 0x75, 0x5f, 0x6e, 0x65, 0x00,
+    0x07, 0x05, 0x72, 0x63, 0x5f, 0x6e, 0x65, 0x00, 0x08, 0x05, 0x6c, 0x63,
+    0x5f, 0x6e, 0x65, 0x00, 0x09, 0x06, 0x66, 0x5f, 0x6c, 0x74, 0x5f, 0x73,
+    0x00, 0x0a, 0x06, 0x75, 0x5f, 0x6c, 0x74, 0x5f, 0x73, 0x00, 0x0b, 0x07,
+    0x72, 0x63, 0x5f, 0x6c, 0x74, 0x5f, 0x73, 0x00, 0x0c, 0x07, 0x6c, 0x63,
+    0x5f, 0x6c, 0x74, 0x5f, 0x73, 0x00, 0x0d, 0x06, 0x66, 0x5f, 0x6c, 0x74,
+    0x5f, 0x75, 0x00, 0x0e, 0x06, 0x75, 0x5f, 0x6c, 0x74, 0x5f, 0x75, 0x00,
+    0x0f, 0x07, 0x72, 0x63, 0x5f, 0x6c, 0x74, 0x5f, 0x75, 0x00, 0x10, 0x07,
+    0x6c, 0x63, 0x5f, 0x6c, 0x74, 0x5f, 0x75, 0x00, 0x11, 0x06, 0x66, 0x5f,
+    0x67, 0x74, 0x5f, 0x73, 0x00, 0x12, 0x06, 0x75, 0x5f, 0x67, 0x74, 0x5f,
+    0x73, 0x00, 0x13, 0x07, 0x72, 0x63, 0x5f, 0x67, 0x74, 0x5f, 0x73, 0x00,
+    0x14, 0x07, 0x6c, 0x63, 0x5f, 0x67, 0x74, 0x5f, 0x73, 0x00, 0x15, 0x06,
+    0x66, 0x5f, 0x67, 0x74, 0x5f, 0x75, 0x00, 0x16, 0x06, 0x75, 0x5f, 0x67,
+    0x74, 0x5f, 0x75, 0x00, 0x17, 0x07, 0x72, 0x63, 0x5f, 0x67, 0x74, 0x5f,
+    0x75, 0x00, 0x18, 0x07, 0x6c, 0x63, 0x5f, 0x67, 0x74, 0x5f, 0x75, 0x00,
+    0x19, 0x06, 0x66, 0x5f, 0x6c, 0x65, 0x5f, 0x73, 0x00, 0x1a, 0x06, 0x75,
+    0x5f, 0x6c, 0x65, 0x5f, 0x73, 0x00, 0x1b, 0x07, 0x72, 0x63, 0x5f, 0x6c,
+    0x65, 0x5f, 0x73, 0x00, 0x1c, 0x07, 0x6c, 0x63, 0x5f, 0x6c, 0x65, 0x5f,
+    0x73, 0x00, 0x1d, 0x06, 0x66, 0x5f, 0x6c, 0x65, 0x5f, 0x75, 0x00, 0x1e,
+    0x06, 0x75, 0x5f, 0x6c, 0x65, 0x5f, 0x75, 0x00, 0x1f, 0x07, 0x72, 0x63,
+    0x5f, 0x6c, 0x65, 0x5f, 0x75, 0x00, 0x20, 0x07, 0x6c, 0x63, 0x5f, 0x6c,
+    0x65, 0x5f, 0x75, 0x00, 0x21, 0x06, 0x66, 0x5f, 0x67, 0x65, 0x5f, 0x73,
+    0x00, 0x22, 0x06, 0x75, 0x5f, 0x67, 0x65, 0x5f, 0x73, 0x00, 0x23, 0x07,
+    0x72, 0x63, 0x5f, 0x67, 0x65, 0x5f, 0x73, 0x00, 0x24, 0x07, 0x6c, 0x63,
+    0x5f, 0x67, 0x65, 0x5f, 0x73, 0x00, 0x25, 0x06, 0x66, 0x5f, 0x67, 0x65,
+    0x5f, 0x75, 0x00, 0x26, 0x06, 0x75, 0x5f, 0x67, 0x65, 0x5f, 0x75, 0x00,
+    0x27, 0x07, 0x72, 0x63, 0x5f, 0x67, 0x65, 0x5f, 0x75, 0x00, 0x28, 0x07,
+    0x6c, 0x63, 0x5f, 0x67, 0x65, 0x5f, 0x75, 0x00, 0x29, 0x05, 0x63, 0x6f,
+    0x75, 0x6e, 0x74, 0x00, 0x2a, 0x05, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x00,
+    0x2b, 0x0a, 0xa6, 0x06, 0x2c, 0x0f, 0x00, 0x02, 0x40, 0x20, 0x00, 0x45,
+    0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x10, 0x00, 0x02,
+    0x40, 0x20, 0x00, 0x45, 0x01, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41,
+    0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x46, 0x0d,
+    0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x12, 0x00, 0x02, 0x40,
+    0x20, 0x00, 0x20, 0x01, 0x46, 0x01, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b,
+    0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x41, 0x05, 0x46,
+    0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02,
+    0x40, 0x41, 0x7d, 0x20, 0x00, 0x46, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b,
+    0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x47,
+    0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x12, 0x00, 0x02,
+    0x40, 0x20, 0x00, 0x20, 0x01, 0x47, 0x01, 0x0d, 0x00, 0x41, 0x00, 0x0f,
+    0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x41, 0x05,
+    0x47, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00,
+    0x02, 0x40, 0x41, 0x7d, 0x20, 0x00, 0x47, 0x0d, 0x00, 0x41, 0x00, 0x0f,
+    0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01,
+    0x48, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x12, 0x00,
+    0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x48, 0x01, 0x0d, 0x00, 0x41, 0x00,
+    0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x41,
+    0x05, 0x48, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11,
+    0x00, 0x02, 0x40, 0x41, 0x7d, 0x20, 0x00, 0x48, 0x0d, 0x00, 0x41, 0x00,
+    0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20,
+    0x01, 0x49, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x12,
+    0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x49, 0x01, 0x0d, 0x00, 0x41,
+    0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00,
+    0x41, 0x05, 0x49, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b,
+    0x11, 0x00, 0x02, 0x40, 0x41, 0x7d, 0x20, 0x00, 0x49, 0x0d, 0x00, 0x41,
+    0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20, 0x00,
+    0x20, 0x01, 0x4a, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b,
+    0x12, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x4a, 0x01, 0x0d, 0x00,
+    0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20,
+    0x00, 0x41, 0x05, 0x4a, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01,
+    0x0b, 0x11, 0x00, 0x02, 0x40, 0x41, 0x7d, 0x20, 0x00, 0x4a, 0x0d, 0x00,
+    0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x20,
+    0x00, 0x20, 0x01, 0x4b, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01,
+    0x0b, 0x12, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x4b, 0x01, 0x0d,
+    0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40,
+    0x20, 0x00, 0x41, 0x05, 0x4b, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41,
+    0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x41, 0x7d, 0x20, 0x00, 0x4b, 0x0d,
+    0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40,
+    0x20, 0x00, 0x20, 0x01, 0x4c, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41,
+    0x01, 0x0b, 0x12, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x4c, 0x01,
+    0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02,
+    0x40, 0x20, 0x00, 0x41, 0x05, 0x4c, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b,
+    0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x41, 0x7d, 0x20, 0x00, 0x4c,
+    0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02,
+    0x40, 0x20, 0x00, 0x20, 0x01, 0x4d, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b,
+    0x41, 0x01, 0x0b, 0x12, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x4d,
+    0x01, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00,
+    0x02, 0x40, 0x20, 0x00, 0x41, 0x05, 0x4d, 0x0d, 0x00, 0x41, 0x00, 0x0f,
+    0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x41, 0x7d, 0x20, 0x00,
+    0x4d, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00,
+    0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x4e, 0x0d, 0x00, 0x41, 0x00, 0x0f,
+    0x0b, 0x41, 0x01, 0x0b, 0x12, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01,
+    0x4e, 0x01, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11,
+    0x00, 0x02, 0x40, 0x20, 0x00, 0x41, 0x05, 0x4e, 0x0d, 0x00, 0x41, 0x00,
+    0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x41, 0x7d, 0x20,
+    0x00, 0x4e, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11,
+    0x00, 0x02, 0x40, 0x20, 0x00, 0x20, 0x01, 0x4f, 0x0d, 0x00, 0x41, 0x00,
+    0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x12, 0x00, 0x02, 0x40, 0x20, 0x00, 0x20,
+    0x01, 0x4f, 0x01, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b,
+    0x11, 0x00, 0x02, 0x40, 0x20, 0x00, 0x41, 0x05, 0x4f, 0x0d, 0x00, 0x41,
+    0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b, 0x11, 0x00, 0x02, 0x40, 0x41, 0x7d,
+    0x20, 0x00, 0x4f, 0x0d, 0x00, 0x41, 0x00, 0x0f, 0x0b, 0x41, 0x01, 0x0b,
+    0x17, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21,
+    0x01, 0x20, 0x01, 0x20, 0x00, 0x48, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b,
+    0x11, 0x00, 0x02, 0x7f, 0x41, 0x07, 0x20, 0x00, 0x20, 0x01, 0x48, 0x0d,
+    0x00, 0x1a, 0x41, 0x09, 0x0b, 0x0b,
+};
+
+static const char *cmp_ops[] = { "eqz",  "eq",   "ne",   "lt_s",
+                                 "lt_u", "gt_s", "gt_u", "le_s",
+                                 "le_u", "ge_s", "ge_u" };
+
+static const int32 test_values[] = {
+    INT_MIN, INT_MIN + 1, -3, -1, 0, 1, 5, INT_MAX - 1, INT_MAX,
+};
+
+/* The result of the comparison in C, as the reference */
+static uint32
+compare(const std::string &op, int32 a, int32 b)
+{
+    uint32 ua = (uint32)a, ub = (uint32)b;
+
+    if (op == "eqz")
+        return a == 0;
+    if (op == "eq")
+        return a == b;
+    if (op == "ne")
+        return a != b;
+    if (op == "lt_s")
+        return a < b;
+    if (op == "lt_u")
+        return ua < ub;
+    if (op == "gt_s")
+        return a > b;
+    if (op == "gt_u")
+        return ua > ub;
+    if (op == "le_s")
+        return a <= b;
+    if (op == "le_u")
+        return ua <= ub;
+    if (op == "ge_s")
+        return a >= b;
+    return ua >= ub;
+}
+
+class SuperinstructionsTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        memcpy(wasm_buf, superinst_wasm, sizeof(superinst_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    WASMFunctionInstance *lookup(const std::string &name)
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name.c_str());
+
+        EXPECT_NE(func, nullptr) << name;
+        return (WASMFunctionInstance *)func;
+    }
+
+    /* Return the result of the function, or UINT32_MAX if it traps */
+    uint32 call(const std::string &name, uint32 argc, int32 a, int32 b = 0)
+    {
+        uint32 argv[2] = { (uint32)a, (uint32)b };
+
+        if (!wasm_runtime_call_wasm(exec_env, lookup(name), argc, argv)) {
+            wasm_runtime_clear_exception(module_inst);
+            return UINT32_MAX;
+        }
+        return argv[0];
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(superinst_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+};
+
+TEST_F(SuperinstructionsTest, comparison_is_fused)
+{
+    for (const char *op : cmp_ops) {
+        std::string name = op;
+
+        /* The fused op has no result offset, and the nop keeps the
+           other function from being fused */
+        EXPECT_LT(lookup("f_" + name)->u.func->code_compiled_size,
+                  lookup("u_" + name)->u.func->code_compiled_size)
+            << name;
+    }
+}
+
+TEST_F(SuperinstructionsTest, fused_same_as_unfused)
+{
+    for (const char *op : cmp_ops) {
+        std::string name = op;
+
+        for (int32 a : test_values) {
+            for (int32 b : test_values) {
+                uint32 expected = compare(name, a, b);
+
+                EXPECT_EQ(call("f_" + name, 2, a, b), expected)
+                    << name << " " << a << " " << b;
+                EXPECT_EQ(call("u_" + name, 2, a, b), expected)
+                    << name << " " << a << " " << b;
+                /* Swapped operands */
+                EXPECT_EQ(call("f_" + name, 2, b, a), compare(name, b, a))
+                    << name << " " << b << " " << a;
+            }
+        }
+    }
+}
+
+TEST_F(SuperinstructionsTest, fused_with_const_operand)
+{
+    for (const char *op : cmp_ops) {
+        std::string name = op;
+
+        if (name == "eqz")
+            continue;
+        for (int32 a : test_values) {
+            EXPECT_EQ(call("rc_" + name, 1, a), compare(name, a, 5))
+                << name << " " << a;
+            EXPECT_EQ(call("lc_" + name, 1, a), compare(name, -3, a))
+                << name << " " << a;
+        }
+    }
+}
+
+TEST_F(SuperinstructionsTest, fused_loop_back_edge)
+{
+    EXPECT_EQ(call("count", 1, 1000), 1000u);
+    /* The body runs once before the first check */
+    EXPECT_EQ(call("count", 1, 0), 1u);
+    EXPECT_EQ(call("count", 1, INT_MIN), 1u);
+}
+
+TEST_F(SuperinstructionsTest, fused_br_if_with_value)
+{
+    EXPECT_EQ(call("value", 2, -1, 0), 7u);
+    EXPECT_EQ(call("value", 2, 0, -1), 9u);
+    EXPECT_EQ(call("value", 2, INT_MIN, INT_MAX), 7u);
+    EXPECT_EQ(call("value", 2, INT_MAX, INT_MIN), 9u);
+    EXPECT_EQ(call("value", 2, 5, 5), 9u);
+}
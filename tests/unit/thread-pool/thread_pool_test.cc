@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <atomic>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+#include "wasm_runtime_common.h"
+#include "wasm_exec_env.h"
+#include "thread_manager.h"
+
+/* (module (memory 1)) */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x05, 0x03, 0x01, 0x00, 0x01,
+};
+
+/* The state shared with a spawned thread */
+typedef struct ThreadState {
+    std::atomic<WASMExecEnv *> exec_env;
+    /* whether to return only after a thread starts joining it */
+    bool wait_for_join;
+    std::atomic<bool> released;
+    std::atomic<bool> terminated;
+    korp_tid native_thread;
+} ThreadState;
+
+static void *
+thread_routine(void *arg)
+{
+    WASMExecEnv *exec_env = (WASMExecEnv *)arg;
+    ThreadState *state = (ThreadState *)exec_env->thread_arg;
+    uint32 wait_count;
+
+    state->native_thread = os_self_thread();
+    state->exec_env = exec_env;
+
+    while (!state->released)
+        os_usleep(100);
+
+    if (state->wait_for_join) {
+        /* Return after the joining thread increases the wait count, so
+           that the return value is kept for it */
+        do {
+            os_mutex_lock(&exec_env->wait_lock);
+            wait_count = exec_env->wait_count;
+            os_mutex_unlock(&exec_env->wait_lock);
+            if (wait_count == 0)
+                os_usleep(100);
+        } while (wait_count == 0);
+    }
+
+    return (void *)(uintptr_t)0x1234;
+}
+
+/* Run until the thread is terminated, like a wasm loop checking the
+   suspend flags */
+static void *
+terminated_thread_routine(void *arg)
+{
+    WASMExecEnv *exec_env = (WASMExecEnv *)arg;
+    ThreadState *state = (ThreadState *)exec_env->thread_arg;
+
+    state->exec_env = exec_env;
+    while (!(WASM_SUSPEND_FLAGS_GET(exec_env->suspend_flags)
+             & WASM_SUSPEND_FLAG_TERMINATE))
+        os_usleep(100);
+    state->terminated = true;
+    return NULL;
+}
+
+class ThreadPoolTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        /* Create the exec_env with a cluster to spawn threads from */
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        /* The runtime was destroyed by the test, the objects allocated
+           from global_heap_buf are simply dropped */
+        if (runtime_destroyed)
+            return;
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+        wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+    /* Spawn a thread and wait until it runs */
+    void spawn(ThreadState *state,
+               void *(*routine)(void *) = thread_routine)
+    {
+        struct InstantiationArgs2 args;
+        wasm_module_inst_t new_module_inst;
+
+        wasm_runtime_instantiation_args_set_defaults(&args);
+        wasm_runtime_instantiation_args_set_default_stack_size(&args, 8192);
+        new_module_inst = wasm_runtime_instantiate_internal(
+            module, module_inst, exec_env, &args, error_buf,
+            sizeof(error_buf));
+        ASSERT_NE(new_module_inst, nullptr) << error_buf;
+
+        state->exec_env = nullptr;
+        state->released = false;
+        state->terminated = false;
+        ASSERT_EQ(wasm_cluster_create_thread(exec_env, new_module_inst,
+                                             false, 0, 0, routine, state),
+                  0);
+        while (!state->exec_env)
+            os_usleep(100);
+    }
+
+    /* The count of the exec_envs of the cluster, including the main one */
+    uint32 get_exec_env_count()
+    {
+        WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
+        uint32 count;
+
+        os_mutex_lock(&cluster->lock);
+        count = (uint32)bh_list_length(&cluster->exec_env_list);
+        os_mutex_unlock(&cluster->lock);
+        return count;
+    }
+
+    uint32 get_heap_free_size()
+    {
+        mem_alloc_info_t info;
+
+        EXPECT_TRUE(wasm_runtime_get_mem_alloc_info(&info));
+        return info.total_free_size;
+    }
+
+  public:
+    char global_heap_buf[512 * 1024];
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    bool runtime_destroyed = false;
+};
+
+TEST_F(ThreadPoolTest, join_gets_return_value)
+{
+    ThreadState state;
+    void *ret_val = NULL;
+
+    state.wait_for_join = true;
+    spawn(&state);
+    state.released = true;
+    EXPECT_EQ(wasm_cluster_join_thread(state.exec_env, &ret_val), 0);
+    EXPECT_EQ(ret_val, (void *)(uintptr_t)0x1234);
+}
+
+TEST_F(ThreadPoolTest, native_threads_are_reused)
+{
+    std::set<korp_tid> native_threads;
+    ThreadState state;
+    void *ret_val;
+    uint32 i, n = 10;
+
+    state.wait_for_join = true;
+    for (i = 0; i < n; i++) {
+        spawn(&state);
+        state.released = true;
+        ret_val = NULL;
+        EXPECT_EQ(wasm_cluster_join_thread(state.exec_env, &ret_val), 0);
+        EXPECT_EQ(ret_val, (void *)(uintptr_t)0x1234);
+        native_threads.insert(state.native_thread);
+        /* Let the worker go back to the idle list */
+        while (get_exec_env_count() > 1)
+            os_usleep(100);
+        os_usleep(1000);
+    }
+
+    EXPECT_LT(native_threads.size(), (size_t)n);
+}
+
+TEST_F(ThreadPoolTest, concurrent_threads)
+{
+    ThreadState states[4];
+    void *ret_val;
+    uint32 i;
+
+    for (i = 0; i < 4; i++) {
+        states[i].wait_for_join = true;
+        spawn(&states[i]);
+    }
+    /* All the threads are running at the same time, each one in its own
+       native thread */
+    EXPECT_EQ(get_exec_env_count(), 5u);
+    for (i = 1; i < 4; i++)
+        EXPECT_NE(states[i].native_thread, states[0].native_thread);
+
+    for (i = 0; i < 4; i++)
+        states[i].released = true;
+    for (i = 0; i < 4; i++) {
+        ret_val = NULL;
+        EXPECT_EQ(wasm_cluster_join_thread(states[i].exec_env, &ret_val), 0);
+        EXPECT_EQ(ret_val, (void *)(uintptr_t)0x1234);
+    }
+}
+
+TEST_F(ThreadPoolTest, detached_thread_releases_resources)
+{
+    ThreadState state;
+    uint32 free_size;
+
+    /* Create the pooled native thread first */
+    state.wait_for_join = false;
+    spawn(&state);
+    state.released = true;
+    while (get_exec_env_count() > 1)
+        os_usleep(100);
+    os_usleep(1000);
+    free_size = get_heap_free_size();
+
+    spawn(&state);
+    EXPECT_EQ(wasm_cluster_detach_thread(state.exec_env), 0);
+    state.released = true;
+    /* The exec_env, the instance and the join state of the thread are
+       all freed with the cluster lock held */
+    while (get_exec_env_count() > 1)
+        os_usleep(100);
+    EXPECT_EQ(get_heap_free_size(), free_size);
+}
+
+TEST_F(ThreadPoolTest, join_after_exit)
+{
+    ThreadState state;
+    WASMExecEnv *thread_exec_env;
+    void *ret_val = (void *)1;
+
+    state.wait_for_join = false;
+    spawn(&state);
+    thread_exec_env = state.exec_env;
+    state.released = true;
+    while (get_exec_env_count() > 1)
+        os_usleep(100);
+
+    /* The thread has exited and isn't found any more */
+    EXPECT_EQ(wasm_cluster_join_thread(thread_exec_env, &ret_val), 0);
+    EXPECT_EQ(ret_val, nullptr);
+}
+
+TEST_F(ThreadPoolTest, exec_envs_are_reused)
+{
+    ThreadState state;
+    WASMExecEnv *first_exec_env;
+
+    state.wait_for_join = true;
+    spawn(&state);
+    first_exec_env = state.exec_env;
+    state.released = true;
+    EXPECT_EQ(wasm_cluster_join_thread(state.exec_env, NULL), 0);
+    while (get_exec_env_count() > 1)
+        os_usleep(100);
+
+    /* The exec_env is created in the buffer of the exited thread */
+    spawn(&state);
+    EXPECT_EQ(state.exec_env, first_exec_env);
+    state.released = true;
+    EXPECT_EQ(wasm_cluster_join_thread(state.exec_env, NULL), 0);
+}
+
+TEST_F(ThreadPoolTest, destroy_terminates_running_threads)
+{
+    ThreadState state;
+
+    spawn(&state, terminated_thread_routine);
+
+    /* The running thread is terminated rather than waited for forever,
+       and it has exited when the runtime is destroyed */
+    wasm_runtime_destroy();
+    runtime_destroyed = true;
+    EXPECT_TRUE(state.terminated);
+}
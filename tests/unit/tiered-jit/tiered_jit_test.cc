@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "wasm_runtime.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (func $add (export "add") (param i32 i32) (result i32)
+ *     (i32.add (local.get 0) (local.get 1)))
+ *   (func (export "sum") (param $n i32) (result i32)
+ *     (local $i i32) (local $acc i32)
+ *     (block $out
+ *       (loop $l
+ *         (br_if $out (i32.ge_u (local.get $i) (local.get $n)))
+ *         (local.set $acc (call $add (local.get $acc) (local.get $i)))
+ *         (local.set $i (i32.add (local.get $i) (i32.const 1)))
+ *         (br $l)))
+ *     (local.get $acc))
+ *   (func (export "count") (param $n i32) (result i32)
+ *     (local $i i32)
+ *     (loop $l
+ *       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+ *       (br_if $l (i32.lt_u (local.get $i) (local.get $n))))
+ *     (local.get $i))
+ *   (func (export "swap") (param i32 i64) (result i64 i32)
+ *     (local.get 1) (local.get 0))
+ *   (func (export "div") (param i32 i32) (result i32)
+ *     (i32.div_s (local.get 0) (local.get 1)))
+ *   (func (export "cold") (result i32)
+ *     (i32.const 42))
+ *   (func (export "tail") (param i32) (result i32)
+ *     (return_call $add (local.get 0) (i32.const 1))))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x17, 0x04, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02,
+    0x7f, 0x7e, 0x02, 0x7e, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x08, 0x07,
+    0x00, 0x01, 0x01, 0x02, 0x00, 0x03, 0x01, 0x07, 0x30, 0x07, 0x03, 0x61,
+    0x64, 0x64, 0x00, 0x00, 0x03, 0x73, 0x75, 0x6d, 0x00, 0x01, 0x05, 0x63,
+    0x6f, 0x75, 0x6e, 0x74, 0x00, 0x02, 0x04, 0x73, 0x77, 0x61, 0x70, 0x00,
+    0x03, 0x03, 0x64, 0x69, 0x76, 0x00, 0x04, 0x04, 0x63, 0x6f, 0x6c, 0x64,
+    0x00, 0x05, 0x04, 0x74, 0x61, 0x69, 0x6c, 0x00, 0x06, 0x0a, 0x63, 0x07,
+    0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x0b, 0x24, 0x01, 0x02, 0x7f,
+    0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20,
+    0x02, 0x20, 0x01, 0x10, 0x00, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a,
+    0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x17, 0x01, 0x01,
+    0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x20, 0x01,
+    0x20, 0x00, 0x49, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b, 0x06, 0x00, 0x20,
+    0x01, 0x20, 0x00, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6d, 0x0b,
+    0x04, 0x00, 0x41, 0x2a, 0x0b, 0x08, 0x00, 0x20, 0x00, 0x41, 0x01, 0x12,
+    0x00, 0x0b,
+};
+
+class TieredJitTest : public testing::Test
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Allocator;
+        init_args.mem_alloc_option.allocator.malloc_func = (void *)malloc;
+        init_args.mem_alloc_option.allocator.realloc_func = (void *)realloc;
+        init_args.mem_alloc_option.allocator.free_func = (void *)free;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    /* Each test loads its own module, so the hotness counts start
+       from zero */
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+    }
+
+    WASMFunctionInstance *lookup(const char *name)
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+
+        EXPECT_NE(func, nullptr) << name;
+        return (WASMFunctionInstance *)func;
+    }
+
+    uint32 hotness(const char *name) { return lookup(name)->u.func->hotness; }
+
+    bool is_compiled(const char *name)
+    {
+        WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+        uint32 func_idx = (uint32)(lookup(name) - inst->e->functions);
+
+        return inst->module
+            ->func_ptrs_compiled[func_idx - inst->module->import_function_count];
+    }
+
+    /* The backend threads compile the hot functions asynchronously */
+    bool wait_compiled(const char *name)
+    {
+        uint32 i;
+
+        for (i = 0; i < 6000 && !is_compiled(name); i++)
+            os_usleep(10000);
+        return is_compiled(name);
+    }
+
+    /* Call the function, return false if it traps */
+    bool call(const char *name, uint32 argc, uint32 *argv)
+    {
+        exception.clear();
+        if (!wasm_runtime_call_wasm(exec_env, lookup(name), argc, argv)) {
+            exception = wasm_runtime_get_exception(module_inst);
+            wasm_runtime_clear_exception(module_inst);
+            return false;
+        }
+        return true;
+    }
+
+  public:
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    std::string exception;
+};
+
+TEST_F(TieredJitTest, multi_tier_jit_by_default)
+{
+    EXPECT_EQ(wasm_runtime_get_running_mode(module_inst), Mode_Multi_Tier_JIT);
+    EXPECT_FALSE(is_compiled("add"));
+    EXPECT_FALSE(is_compiled("cold"));
+}
+
+TEST_F(TieredJitTest, hot_callee_tiers_up)
+{
+    uint32 argv[1] = { 10 };
+
+    /* The callee is interpreted until it gets hot */
+    EXPECT_TRUE(call("sum", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 45u);
+    EXPECT_EQ(hotness("add"), 10u);
+    EXPECT_FALSE(is_compiled("add"));
+
+    /* The count stops at the threshold */
+    argv[0] = 1000;
+    EXPECT_TRUE(call("sum", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 499500u);
+    EXPECT_EQ(hotness("add"), (uint32)WASM_TIERED_JIT_LLVM_JIT_THRESHOLD);
+    ASSERT_TRUE(wait_compiled("add"));
+
+    /* The interpreted caller calls the llvm jit callee now, which
+       doesn't count */
+    lookup("add")->u.func->hotness = 0;
+    argv[0] = 1000;
+    EXPECT_TRUE(call("sum", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 499500u);
+    EXPECT_EQ(hotness("add"), 0u);
+
+    /* The caller's loop got hot as well */
+    EXPECT_TRUE(wait_compiled("sum"));
+}
+
+TEST_F(TieredJitTest, hot_loop_tiers_up)
+{
+    uint32 argv[1] = { 1000 };
+
+    /* Only called once, the loop back-edges make it hot */
+    EXPECT_TRUE(call("count", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 1000u);
+    ASSERT_TRUE(wait_compiled("count"));
+
+    /* The next call runs the llvm jit code from the entry */
+    lookup("count")->u.func->hotness = 0;
+    argv[0] = 100000;
+    EXPECT_TRUE(call("count", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 100000u);
+    EXPECT_EQ(hotness("count"), 0u);
+
+    /* The cold functions aren't compiled */
+    EXPECT_FALSE(is_compiled("add"));
+    EXPECT_FALSE(is_compiled("cold"));
+    argv[0] = 0;
+    EXPECT_TRUE(call("cold", 0, argv)) << exception;
+    EXPECT_EQ(argv[0], 42u);
+}
+
+TEST_F(TieredJitTest, return_call_to_llvm_jit)
+{
+    uint32 argv[1], i;
+
+    for (i = 0; i < WASM_TIERED_JIT_LLVM_JIT_THRESHOLD; i++) {
+        argv[0] = i;
+        ASSERT_TRUE(call("tail", 1, argv)) << exception;
+        EXPECT_EQ(argv[0], i + 1);
+    }
+    ASSERT_TRUE(wait_compiled("add"));
+
+    /* The tail call from the function called by native returns to
+       native */
+    lookup("add")->u.func->hotness = 0;
+    argv[0] = 41;
+    EXPECT_TRUE(call("tail", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 42u);
+    EXPECT_EQ(hotness("add"), 0u);
+}
+
+TEST_F(TieredJitTest, multi_value_results)
+{
+    uint32 argv[3], i;
+    uint64 value = 0x123456789abcdef0ULL;
+
+    for (i = 0; i <= WASM_TIERED_JIT_LLVM_JIT_THRESHOLD; i++) {
+        argv[0] = i;
+        memcpy(argv + 1, &value, sizeof(value));
+        ASSERT_TRUE(call("swap", 3, argv)) << exception;
+    }
+    ASSERT_TRUE(wait_compiled("swap"));
+
+    argv[0] = 7;
+    memcpy(argv + 1, &value, sizeof(value));
+    EXPECT_TRUE(call("swap", 3, argv)) << exception;
+    EXPECT_EQ(memcmp(argv, &value, sizeof(value)), 0);
+    EXPECT_EQ(argv[2], 7u);
+}
+
+TEST_F(TieredJitTest, trap_in_llvm_jit_code)
+{
+    uint32 argv[2], i;
+
+    for (i = 0; i <= WASM_TIERED_JIT_LLVM_JIT_THRESHOLD; i++) {
+        argv[0] = 100;
+        argv[1] = 7;
+        ASSERT_TRUE(call("div", 2, argv)) << exception;
+        EXPECT_EQ(argv[0], 14u);
+    }
+    ASSERT_TRUE(wait_compiled("div"));
+
+    argv[0] = 100;
+    argv[1] = 0;
+    EXPECT_FALSE(call("div", 2, argv));
+    EXPECT_EQ(exception, "Exception: integer divide by zero");
+
+    /* The instance still runs after the trap */
+    argv[0] = 100;
+    argv[1] = 7;
+    EXPECT_TRUE(call("div", 2, argv)) << exception;
+    EXPECT_EQ(argv[0], 14u);
+}
+
+TEST_F(TieredJitTest, interp_mode_does_not_count)
+{
+    uint32 argv[1] = { 1000 };
+
+    ASSERT_TRUE(wasm_runtime_set_running_mode(module_inst, Mode_Interp));
+    EXPECT_TRUE(call("sum", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 499500u);
+    EXPECT_EQ(hotness("add"), 0u);
+    EXPECT_EQ(hotness("sum"), 0u);
+}
+
+TEST_F(TieredJitTest, llvm_jit_mode)
+{
+    uint32 argv[1] = { 1000 };
+
+    /* All the functions run with llvm jit, they're compiled on their
+       first calls */
+    ASSERT_TRUE(wasm_runtime_set_running_mode(module_inst, Mode_LLVM_JIT));
+    EXPECT_TRUE(call("sum", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 499500u);
+    EXPECT_EQ(hotness("add"), 0u);
+    argv[0] = 0;
+    EXPECT_TRUE(call("cold", 0, argv)) << exception;
+    EXPECT_EQ(argv[0], 42u);
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_platform.h"
+
+/*
+ * (module
+ *   (import "env" "fail" (func $fail))
+ *   (memory 1)
+ *   (global $g (mut i32) (i32.const 0))
+ *   (func $trap (param i32) (result i32)
+ *     (if (i32.eqz (local.get 0)) (then unreachable))
+ *     (i32.add (call $trap (i32.sub (local.get 0) (i32.const 1)))
+ *              (i32.const 1)))
+ *   (func $count (param i32) (result i32)
+ *     (if (i32.eqz (local.get 0)) (then (return (i32.const 0))))
+ *     (i32.add (call $count (i32.sub (local.get 0) (i32.const 1)))
+ *              (i32.const 1)))
+ *   (func $load (param i32) (result i32) (i32.load (local.get 0)))
+ *   (func $div (param i32) (result i32)
+ *     (i32.div_s (i32.const 1) (local.get 0)))
+ *   (func $init (param i32) (result i32)
+ *     (memory.init $d (local.get 0) (i32.const 0) (i32.const 3))
+ *     (i32.const 0))
+ *   (func $recurse (param i32) (result i32)
+ *     (i32.sub (call $recurse (i32.add (local.get 0) (i32.const 1)))
+ *              (local.get 0)))
+ *   (func $native (param i32) (result i32) (call $fail) (i32.const 0))
+ *   ;; Each export calls the function above, then sets $g to 1, which
+ *   ;; must not happen when the callee traps
+ *   (func (export "deep_trap") (param i32) (result i32)
+ *     (call $trap (local.get 0)) (global.set $g (i32.const 1)))
+ *   (func (export "count") ...)        ;; calls $count
+ *   (func (export "load") ...)         ;; calls $load
+ *   (func (export "div") ...)          ;; calls $div
+ *   (func (export "memory_init") ...)  ;; calls $init
+ *   (func (export "overflow") ...)     ;; calls $recurse
+ *   (func (export "native_fail") ...)  ;; calls $native
+ *   (func (export "get_g") (result i32) (global.get $g))
+ *   (data $d "abc"))
+ */
+static uint8_t test_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0d, 0x03, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x02,
+    0x0c, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x66, 0x61, 0x69, 0x6c, 0x00,
+    0x01, 0x03, 0x10, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x05, 0x03, 0x01, 0x00, 0x01,
+    0x06, 0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x51, 0x08, 0x09,
+    0x64, 0x65, 0x65, 0x70, 0x5f, 0x74, 0x72, 0x61, 0x70, 0x00, 0x08, 0x05,
+    0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00, 0x09, 0x04, 0x6c, 0x6f, 0x61, 0x64,
+    0x00, 0x0a, 0x03, 0x64, 0x69, 0x76, 0x00, 0x0b, 0x0b, 0x6d, 0x65, 0x6d,
+    0x6f, 0x72, 0x79, 0x5f, 0x69, 0x6e, 0x69, 0x74, 0x00, 0x0c, 0x08, 0x6f,
+    0x76, 0x65, 0x72, 0x66, 0x6c, 0x6f, 0x77, 0x00, 0x0d, 0x0b, 0x6e, 0x61,
+    0x74, 0x69, 0x76, 0x65, 0x5f, 0x66, 0x61, 0x69, 0x6c, 0x00, 0x0e, 0x05,
+    0x67, 0x65, 0x74, 0x5f, 0x67, 0x00, 0x0f, 0x0c, 0x01, 0x01, 0x0a, 0xb0,
+    0x01, 0x0f, 0x13, 0x00, 0x20, 0x00, 0x45, 0x04, 0x40, 0x00, 0x0b, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x10, 0x01, 0x41, 0x01, 0x6a, 0x0b, 0x15, 0x00,
+    0x20, 0x00, 0x45, 0x04, 0x40, 0x41, 0x00, 0x0f, 0x0b, 0x20, 0x00, 0x41,
+    0x01, 0x6b, 0x10, 0x02, 0x41, 0x01, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00,
+    0x28, 0x02, 0x00, 0x0b, 0x07, 0x00, 0x41, 0x01, 0x20, 0x00, 0x6d, 0x0b,
+    0x0e, 0x00, 0x20, 0x00, 0x41, 0x00, 0x41, 0x03, 0xfc, 0x08, 0x00, 0x00,
+    0x41, 0x00, 0x0b, 0x0c, 0x00, 0x20, 0x00, 0x41, 0x01, 0x6a, 0x10, 0x06,
+    0x20, 0x00, 0x6b, 0x0b, 0x06, 0x00, 0x10, 0x00, 0x41, 0x00, 0x0b, 0x0a,
+    0x00, 0x20, 0x00, 0x10, 0x01, 0x41, 0x01, 0x24, 0x00, 0x0b, 0x0a, 0x00,
+    0x20, 0x00, 0x10, 0x02, 0x41, 0x01, 0x24, 0x00, 0x0b, 0x0a, 0x00, 0x20,
+    0x00, 0x10, 0x03, 0x41, 0x01, 0x24, 0x00, 0x0b, 0x0a, 0x00, 0x20, 0x00,
+    0x10, 0x04, 0x41, 0x01, 0x24, 0x00, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x10,
+    0x05, 0x41, 0x01, 0x24, 0x00, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x10, 0x06,
+    0x41, 0x01, 0x24, 0x00, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x10, 0x07, 0x41,
+    0x01, 0x24, 0x00, 0x0b, 0x04, 0x00, 0x23, 0x00, 0x0b, 0x0b, 0x06, 0x01,
+    0x01, 0x03, 0x61, 0x62, 0x63,
+};
+
+static void
+fail_native(wasm_exec_env_t exec_env)
+{
+    wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                               "native failed");
+}
+
+static NativeSymbol native_symbols[] = {
+    { "fail", (void *)fail_native, "()", NULL },
+};
+
+/* Whether the AOT code is compiled with --enable-trap-unwind, both
+   modes must trap the same way */
+class TrapUnwindTest : public testing::TestWithParam<bool>
+{
+  protected:
+    /* LLVM can't be initialized again once the runtime is destroyed, so
+       the runtime is shared by the tests */
+    static void SetUpTestCase()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        init_args.native_module_name = "env";
+        init_args.native_symbols = native_symbols;
+        init_args.n_native_symbols =
+            sizeof(native_symbols) / sizeof(NativeSymbol);
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    static void TearDownTestCase() { wasm_runtime_destroy(); }
+
+    virtual void SetUp()
+    {
+        memcpy(wasm_buf, test_wasm, sizeof(test_wasm));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        ASSERT_TRUE(compile_aot());
+        wasm_runtime_unload(module);
+        module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+    }
+
+    virtual void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_file_buf)
+            wasm_runtime_free(aot_file_buf);
+    }
+
+    /* Compile with the software bounds checks, with which the exception
+       is checked after each call unless the traps are unwound */
+    bool compile_aot()
+    {
+        AOTCompOption option = { 0 };
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 1;
+        option.enable_bulk_memory = true;
+        option.enable_trap_unwind = GetParam();
+
+        if (!(comp_data = aot_create_comp_data(module, NULL, false)))
+            return false;
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf =
+                aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+        EXPECT_NE(aot_file_buf, nullptr) << aot_get_last_error();
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        return aot_file_buf != nullptr;
+    }
+
+    /* Call the function of the instance, return false if it traps */
+    bool call(const char *name, uint32 argc, uint32 *argv)
+    {
+        wasm_function_inst_t func;
+
+        exception.clear();
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_NE(func, nullptr) << name;
+        if (!wasm_runtime_call_wasm(exec_env, func, argc, argv)) {
+            exception = wasm_runtime_get_exception(module_inst);
+            wasm_runtime_clear_exception(module_inst);
+            return false;
+        }
+        return true;
+    }
+
+    /* Whether the caller went on after the call */
+    uint32 get_g()
+    {
+        uint32 argv[1] = { 0 };
+
+        EXPECT_TRUE(call("get_g", 0, argv)) << exception;
+        return argv[0];
+    }
+
+  public:
+    static char global_heap_buf[512 * 1024];
+    char error_buf[128];
+    uint8_t wasm_buf[sizeof(test_wasm)];
+    uint8 *aot_file_buf = nullptr;
+    uint32 aot_file_size = 0;
+    wasm_module_t module = nullptr;
+    wasm_module_inst_t module_inst = nullptr;
+    wasm_exec_env_t exec_env = nullptr;
+    std::string exception;
+};
+
+char TrapUnwindTest::global_heap_buf[512 * 1024];
+
+TEST_P(TrapUnwindTest, no_trap)
+{
+    uint32 argv[1] = { 100 };
+
+    ASSERT_TRUE(call("count", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 100u);
+    EXPECT_EQ(get_g(), 1u);
+}
+
+TEST_P(TrapUnwindTest, deep_trap)
+{
+    uint32 argv[1] = { 100 };
+
+    EXPECT_FALSE(call("deep_trap", 1, argv));
+    EXPECT_EQ(exception, "Exception: unreachable");
+    EXPECT_EQ(get_g(), 0u);
+
+    /* The instance runs again after the trap */
+    argv[0] = 10;
+    ASSERT_TRUE(call("count", 1, argv)) << exception;
+    EXPECT_EQ(argv[0], 10u);
+    EXPECT_EQ(get_g(), 1u);
+}
+
+TEST_P(TrapUnwindTest, out_of_bounds_load)
+{
+    uint32 argv[1] = { 65535 };
+
+    EXPECT_FALSE(call("load", 1, argv));
+    EXPECT_EQ(exception, "Exception: out of bounds memory access");
+    EXPECT_EQ(get_g(), 0u);
+}
+
+TEST_P(TrapUnwindTest, divide_by_zero)
+{
+    uint32 argv[1] = { 0 };
+
+    EXPECT_FALSE(call("div", 1, argv));
+    EXPECT_EQ(exception, "Exception: integer divide by zero");
+    EXPECT_EQ(get_g(), 0u);
+}
+
+TEST_P(TrapUnwindTest, runtime_api_throws)
+{
+    uint32 argv[1] = { 65535 };
+
+    /* memory.init is done by the runtime, which throws the exception */
+    EXPECT_FALSE(call("memory_init", 1, argv));
+    EXPECT_EQ(exception, "Exception: out of bounds memory access");
+    EXPECT_EQ(get_g(), 0u);
+}
+
+TEST_P(TrapUnwindTest, stack_overflow)
+{
+    uint32 argv[1] = { 0 };
+
+    EXPECT_FALSE(call("overflow", 1, argv));
+    EXPECT_EQ(exception, "Exception: native stack overflow");
+    EXPECT_EQ(get_g(), 0u);
+}
+
+TEST_P(TrapUnwindTest, native_throws)
+{
+    uint32 argv[1] = { 0 };
+
+    /* The exception is still checked after calling the native */
+    EXPECT_FALSE(call("native_fail", 1, argv));
+    EXPECT_EQ(exception, "Exception: native failed");
+    EXPECT_EQ(get_g(), 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(TrapUnwind, TrapUnwindTest, testing::Bool());
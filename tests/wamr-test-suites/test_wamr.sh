@@ -919,8 +919,16 @@ function do_execute_in_running_mode()
     # keep alpha order
 
     if [[ ${ENABLE_EH} -eq 1 ]]; then
-        if [[ "${RUNNING_MODE}" != "classic-interp" ]]; then
-            echo "support exception handling in classic-interp"
+        if [[ "${RUNNING_MODE}" != "classic-interp" \
+                && "${RUNNING_MODE}" != "fast-interp" \
+                && "${RUNNING_MODE}" != "jit" \
+                && "${RUNNING_MODE}" != "aot" ]]; then
+            echo "support exception handling in both interp modes, llvm-jit mode and aot mode"
+            return 0;
+        fi
+
+        if [[ ${ENABLE_GC} -eq 1 && "${RUNNING_MODE}" == "fast-interp" ]]; then
+            echo "support exception handling with gc in classic-interp, llvm-jit mode and aot mode"
             return 0;
         fi
     fi
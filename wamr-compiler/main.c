@@ -106,6 +106,54 @@ unregister_and_unload_native_libs(uint32 native_lib_count,
 }
 #endif
 
+static void
+load_and_register_native_bitcodes(char **native_bitcode_list,
+                                  uint32 native_bitcode_count,
+                                  uint8 **native_bitcode_bufs)
+{
+    uint32 i, buf_size;
+    char *module_name, *file_name;
+
+    for (i = 0; i < native_bitcode_count; i++) {
+        /* the option is in the form of <module_name>:<file> */
+        module_name = native_bitcode_list[i];
+        file_name = strchr(module_name, ':');
+        bh_assert(file_name);
+        *file_name++ = '\0';
+
+        if (!(native_bitcode_bufs[i] =
+                  (uint8 *)bh_read_file_to_buffer(file_name, &buf_size))) {
+            LOG_WARNING("warning: failed to read native bitcode %s", file_name);
+            continue;
+        }
+
+        if (!wasm_runtime_register_native_bitcode(
+                module_name, native_bitcode_bufs[i], buf_size)) {
+            LOG_WARNING("warning: failed to register native bitcode %s",
+                        file_name);
+            wasm_runtime_free(native_bitcode_bufs[i]);
+            native_bitcode_bufs[i] = NULL;
+        }
+    }
+}
+
+static void
+unregister_and_free_native_bitcodes(char **native_bitcode_list,
+                                    uint32 native_bitcode_count,
+                                    uint8 **native_bitcode_bufs)
+{
+    uint32 i;
+
+    for (i = 0; i < native_bitcode_count; i++) {
+        if (!native_bitcode_bufs[i])
+            continue;
+
+        wasm_runtime_unregister_native_bitcode(native_bitcode_list[i],
+                                               native_bitcode_bufs[i]);
+        wasm_runtime_free(native_bitcode_bufs[i]);
+    }
+}
+
 /* clang-format off */
 static void
 print_help()
@@ -136,6 +184,9 @@ print_help()
     printf("                              1 - Medium code model\n");
     printf("                              2 - Kernel code model\n");
     printf("                              3 - Small code model\n");
+    printf("  --jobs=n                  Run the LLVM optimization passes in n threads (default is 1), the\n");
+    printf("                              module is split into shards which don't depend on n, so the\n");
+    printf("                              output is the same for any n\n");
     printf("  -sgx                      Generate code for SGX platform (Intel Software Guard Extensions)\n");
     printf("  --bounds-checks=1/0       Enable or disable the bounds checks for memory access:\n");
     printf("                              This flag controls bounds checking with a software check. \n"); 
@@ -150,6 +201,18 @@ print_help()
     printf("  --stack-bounds-checks=1/0 Enable or disable the bounds checks for native stack:\n");
     printf("                              if the option isn't set, the status is same as `--bounds-check`,\n");
     printf("                              if the option is set, the status is same as the option value\n");
+    printf("  --enable-trap-unwind      Don't check the exception after calls, the runtime unwinds the traps\n");
+    printf("                              to the entry of wasm function call instead. It is only supported\n");
+    printf("                              for 64-bit targets other than SGX and Windows, and requires a\n");
+    printf("                              runtime with the hardware bounds checks\n");
+    printf("  --enable-instruction-metering\n");
+    printf("                            Charge the instructions of each basic block from the instruction\n");
+    printf("                              count limit of exec_env, requires a runtime with the instruction\n");
+    printf("                              metering enabled\n");
+    printf("  --enable-epoch-interruption\n");
+    printf("                            Compare the global epoch with the epoch deadline of the module\n");
+    printf("                              instance at the loop back-edges, requires a runtime with the\n");
+    printf("                              epoch interruption enabled\n");
     printf("  --stack-usage=<file>      Generate a stack-usage file.\n");
     printf("                              Similarly to `clang -fstack-usage`.\n");
     printf("  --format=<format>         Specifies the format of the output file\n");
@@ -184,7 +247,12 @@ print_help()
     printf("  --enable-memory-profiling Enable memory usage profiling\n");
     printf("  --xip                     A shorthand of --enable-indirect-mode --disable-llvm-intrinsics\n");
     printf("  --enable-indirect-mode    Enable call function through symbol table but not direct call\n");
+    printf("  --shared-text             A shorthand of --xip with the code aligned to page size in the AOT file,\n");
+    printf("                              so that the code pages mapped from the file can be shared across\n");
+    printf("                              processes, refer to doc/xip.md for more details\n");
     printf("  --enable-gc               Enable GC (Garbage Collection) feature\n");
+    printf("  --enable-gc-tlab          Allocate the small GC objects inline from the thread-local allocation\n");
+    printf("                              buffer, requires --enable-gc and a runtime supporting it\n");
     printf("  --disable-llvm-intrinsics Disable the LLVM built-in intrinsics\n");
     printf("  --enable-builtin-intrinsics=<flags>\n");
     printf("                            Enable the specified built-in intrinsics, it will override the default\n");
@@ -194,6 +262,9 @@ print_help()
     printf("                            Use comma to separate, please refer to doc/xip.md for full list.\n");
     printf("  --disable-llvm-jump-tables Disable the LLVM jump tables similarly to clang's -fno-jump-tables\n");
     printf("  --disable-llvm-lto        Disable the LLVM link time optimization\n");
+    printf("  --disable-call-indirect-cache\n");
+    printf("                            Disable caching the functions which have passed the checks\n");
+    printf("                            at each call_indirect site\n");
     printf("  --enable-llvm-pgo         Enable LLVM PGO (Profile-Guided Optimization)\n");
     printf("  --enable-llvm-passes=<passes>\n");
     printf("                            Enable the specified LLVM passes, using comma to separate\n");
@@ -213,6 +284,10 @@ print_help()
     printf("                            are shared object (.so) files, for example:\n");
     printf("                              --native-lib=test1.so --native-lib=test2.so\n");
 #endif
+    printf("  --native-bitcode=<module>:<file>\n");
+    printf("                            Inline the host functions of the import module from an LLVM bitcode\n");
+    printf("                            file, e.g. --native-bitcode=env:hash.bc. The external functions in the\n");
+    printf("                            bitcode are matched with the import functions by name\n");
     printf("  --invoke-c-api-import     Treat unknown import function as wasm-c-api import function and\n");
     printf("                            quick call it from AOT code\n");
 #if WASM_ENABLE_LINUX_PERF != 0
@@ -414,12 +489,18 @@ main(int argc, char *argv[])
     void *native_handle_list[8] = { NULL };
     uint32 native_handle_count = 0;
 #endif
+    char *native_bitcode_list[8] = { NULL };
+    uint8 *native_bitcode_bufs[8] = { NULL };
+    uint32 native_bitcode_count = 0;
 #if WASM_ENABLE_LINUX_PERF != 0
     bool enable_linux_perf = false;
 #endif
 
     option.opt_level = 3;
     option.size_level = 3;
+    /* The module is always split into the same shards, so that the output
+       doesn't depend on the number of jobs */
+    option.jobs = 1;
     option.output_format = AOT_FORMAT_FILE;
     /* default value, enable or disable depends on the platform */
     option.bounds_checks = 2;
@@ -491,6 +572,13 @@ main(int argc, char *argv[])
                 option.size_level = 3;
             size_level_set = true;
         }
+        else if (!strncmp(argv[0], "--jobs=", 7)) {
+            if (argv[0][7] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.jobs = (uint32)atoi(argv[0] + 7);
+            if (option.jobs == 0)
+                PRINT_HELP_AND_EXIT();
+        }
         else if (!strcmp(argv[0], "-sgx")) {
             sgx_mode = true;
         }
@@ -500,6 +588,15 @@ main(int argc, char *argv[])
         else if (!strncmp(argv[0], "--stack-bounds-checks=", 22)) {
             option.stack_bounds_checks = (atoi(argv[0] + 22) == 1) ? 1 : 0;
         }
+        else if (!strcmp(argv[0], "--enable-trap-unwind")) {
+            option.enable_trap_unwind = true;
+        }
+        else if (!strcmp(argv[0], "--enable-instruction-metering")) {
+            option.enable_instruction_metering = true;
+        }
+        else if (!strcmp(argv[0], "--enable-epoch-interruption")) {
+            option.enable_epoch_interruption = true;
+        }
         else if (!strncmp(argv[0], "--stack-usage=", 14)) {
             option.stack_usage_file = argv[0] + 14;
         }
@@ -590,10 +687,18 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--enable-indirect-mode")) {
             option.is_indirect_mode = true;
         }
+        else if (!strcmp(argv[0], "--shared-text")) {
+            option.is_indirect_mode = true;
+            option.disable_llvm_intrinsics = true;
+            option.enable_shared_text = true;
+        }
         else if (!strcmp(argv[0], "--enable-gc")) {
             option.aux_stack_frame_type = AOT_STACK_FRAME_TYPE_STANDARD;
             option.enable_gc = true;
         }
+        else if (!strcmp(argv[0], "--enable-gc-tlab")) {
+            option.enable_gc_tlab = true;
+        }
         else if (!strcmp(argv[0], "--disable-llvm-intrinsics")) {
             option.disable_llvm_intrinsics = true;
         }
@@ -608,6 +713,9 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--disable-llvm-lto")) {
             option.disable_llvm_lto = true;
         }
+        else if (!strcmp(argv[0], "--disable-call-indirect-cache")) {
+            option.disable_call_indirect_cache = true;
+        }
         else if (!strcmp(argv[0], "--enable-llvm-pgo")) {
             option.enable_llvm_pgo = true;
         }
@@ -657,6 +765,18 @@ main(int argc, char *argv[])
             native_lib_list[native_lib_count++] = argv[0] + 13;
         }
 #endif
+        else if (!strncmp(argv[0], "--native-bitcode=", 17)) {
+            if (argv[0][17] == '\0' || argv[0][17] == ':'
+                || !strchr(argv[0] + 17, ':'))
+                PRINT_HELP_AND_EXIT();
+            if (native_bitcode_count
+                >= sizeof(native_bitcode_list) / sizeof(char *)) {
+                printf("Only allow max native bitcode number %d\n",
+                       (int)(sizeof(native_bitcode_list) / sizeof(char *)));
+                goto fail0;
+            }
+            native_bitcode_list[native_bitcode_count++] = argv[0] + 17;
+        }
         else if (!strcmp(argv[0], "--invoke-c-api-import")) {
             option.quick_invoke_c_api_import = true;
         }
@@ -757,6 +877,12 @@ main(int argc, char *argv[])
         option.enable_ref_types = false;
     }
 
+    if (option.enable_gc_tlab && !option.enable_gc) {
+        LOG_WARNING("GC TLAB is only supported when GC is enabled, the "
+                    "option --enable-gc-tlab is ignored.");
+        option.enable_gc_tlab = false;
+    }
+
     if (option.enable_shared_chain) {
         LOG_VERBOSE("Enable shared chain will overwrite shared heap and sw "
                     "bounds control");
@@ -811,6 +937,12 @@ main(int argc, char *argv[])
         native_lib_list, native_lib_count, native_handle_list);
 #endif
 
+    if (native_bitcode_count > 0) {
+        bh_print_time("Begin to load native bitcodes");
+        load_and_register_native_bitcodes(
+            native_bitcode_list, native_bitcode_count, native_bitcode_bufs);
+    }
+
     if (llvm_options_count > 0)
         LLVMParseCommandLineOptions(llvm_options_count,
                                     (const char **)llvm_options, "wamrc");
@@ -917,6 +1049,8 @@ fail2:
     }
 
 fail1:
+    unregister_and_free_native_bitcodes(
+        native_bitcode_list, native_bitcode_count, native_bitcode_bufs);
 #if BH_HAS_DLFCN
     unregister_and_unload_native_libs(native_handle_count, native_handle_list);
 #endif